@@ -3,10 +3,85 @@
 using namespace std;
 using namespace sss::pax;
 
-int main()
+// Time importing a header that holds a 200k-element double array and a 200k-element int32 array, against
+// reading the same numbers with strtod/strtol, the parsers the header reader used before from_chars.
+static void benchParse()
 {
+    const uint32_t count = 200000;
+    vector<double> doubles(count);
+    vector<int32_t> ints(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        doubles[i] = i * 1.000123456789;
+        ints[i] = static_cast<int32_t>(i * 7919) - 1000000;
+    }
+
+    vector<float> floatData{ 1.0f, 2.0f, 3.0f, 4.0f };
+    floatRasterFile arrayFile{ 2, 2, static_cast<void*>(floatData.data()) };
+    arrayFile.addMeta("doubles", meta_t{ paxMetaDataTypes::paxDouble, { count }, doubles.data() });
+    arrayFile.addMeta("ints", meta_t{ paxMetaDataTypes::paxInt32, { count }, ints.data() });
+    paxBufPtr arrayBuf;
+    arrayFile.writeToBuffer(arrayBuf);
+
+    const int reps = 10;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        floatRasterFile inFile;
+        inFile.import(arrayBuf);
+    }
+    double importMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / reps;
+
+    // the same text, NULL-terminated for strto*
+    string text(arrayBuf->data(), arrayBuf->size());
+    size_t doublePos = text.find("doubles");
+    size_t intPos = text.find("ints");
+    double sum = 0.0;
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        char * pos = &text[text.find("] = ", doublePos) + 4];
+        for (uint32_t i = 0; i < count; ++i) sum += strtod(pos, &pos);
+        pos = &text[text.find("] = ", intPos) + 4];
+        for (uint32_t i = 0; i < count; ++i) sum += strtol(pos, &pos, 0);
+    }
+    double strtoMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / reps;
+
+    cout << "header parse: " << arrayBuf->size() << " bytes, import " << importMs << " ms, strtod/strtol alone "
+         << strtoMs << " ms (checksum " << sum << ")" << endl;
+}
+
+// Time disabled log calls, which the parsing loops are full of, and formatting error messages.
+static void benchLog()
+{
+    const int calls = 10000000;
+    PaxStatic::setVerbosity(0);
+    volatile int sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        PAX_LOG(3, << "value " << i);
+        sink = sink + i;
+    }
+    double logNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / calls;
+
+    const int errors = 1000000;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < errors; ++i) {
+        PAX_LOG_ERROR(1, << "bad value " << i << " in metadata '" << "pi" << "'");
+    }
+    double errorNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / errors;
+    PaxStatic::setStatus(PAX_OK);
+
+    cout << "logging: disabled PAX_LOG " << logNs << " ns, PAX_LOG_ERROR " << errorNs << " ns" << endl;
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc > 1 && 0 == strcmp(argv[1], "bench")) {
+        benchParse();
+        benchLog();
+        return 0;
+    }
+
     vector<float> floatData{ 158.98166f, 171.61903f, 160.06989f, 148.83504f };
-    floatRasterFile floatFile{ 2, 2, static_cast<void*>(floatData.data()) };
+    floatRasterFile floatFile{ { 2, 2 }, floatData.data(), nullptr };  // a view: floatData outlives it
     float piVal = 3.1416f;
     floatFile.addMetaVal("pi", piVal);
 
@@ -85,26 +85,62 @@
  * @endverbatim
  *
  * Desired feature list:
- *  - Improve dimension index detection (tags such as '2st' shouldn't work)
  *  - International support
  *
  ***********************************************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
 #include <complex>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
 #ifdef _WIN32
 #include <direct.h>
 #include <fcntl.h>
 #include <io.h>
+#ifndef NOMINMAX
+#define NOMINMAX
 #endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define PAX_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#endif
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <map>
+#include <mutex>
 #include <numeric>
 #include <regex>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#if defined(_M_X64) || defined(__x86_64__)
+#define PAX_X86_64
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#endif
 
 /************************************************************************************************************
 *@defgroup PAX PAX : a C++17 library for manipulating PAX files
@@ -148,7 +184,7 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
 #define pax_open         _wopen
 #define pax_remove       _wremove
 #define pax_getcwd       _getcwd
-#define pax_lseek        _lseek
+#define pax_lseek        _lseeki64
 #define pax_read         _read
 #define pax_write        _write
 #define pax_close        _close
@@ -179,7 +215,7 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
 #define pax_open         _open
 #define pax_remove       remove
 #define pax_getcwd       _getcwd
-#define pax_lseek        _lseek
+#define pax_lseek        _lseeki64
 #define pax_read         _read
 #define pax_write        _write
 #define pax_close        _close
@@ -214,14 +250,14 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
 #define pax_strcpy       strcpy
 #define pax_strncpy      strncpy
 #define pax_sprintf      sprintf
-#define pax_open         open
+#define pax_open         ::open
 #define _open            open
 #define pax_remove       remove
 #define pax_getcwd       getcwd
-#define pax_lseek        lseek
-#define pax_read         read
-#define pax_write        write
-#define pax_close        close
+#define pax_lseek        ::lseek
+#define pax_read         ::read
+#define pax_write        ::write
+#define pax_close        ::close
 #define pax_stringstream std::stringstream
 #define pax_cout         std::cout
 #define pax_cerr         std::cerr
@@ -246,10 +282,11 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
     class PaxMeta;
     template <typename T>
     class PaxArray;
+    class PaxMap;
 
     using paxMetaRegionEnum_t       = uint32_t;                 ///< Type alias for meta region enum
     using paxMetaLoc_t              = size_t;                   ///< Type alias for meta location
-    using PaxMetaLocHash_t          = std::hash<std::string>;   ///< Type alias for meta hash
+    using PaxMetaLocHash_t          = size_t;                   ///< Type alias for meta hash (std::hash<std::string> value)
     using paxHeaderHashMap_t        =
         std::map<paxMetaLoc_t, std::list<PaxMetaLocHash_t>>;    ///< Type alias for hash storage in header
     using paxHeaderMetaMap_t        =
@@ -263,8 +300,12 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
     using paxBufData_t              = char;                         ///< Type alias for internal buffer type
     using paxBuf_t                  = PaxArray<paxBufData_t>;       ///< Type alias for a PAX buffer
     using paxBufPtr                 = std::shared_ptr<paxBuf_t>;    ///< Type alias for portable PAX buffer
+    using paxMapPtr                 = std::shared_ptr<PaxMap>;      ///< Type alias for a shared file mapping
+    using paxSegment_t              = std::pair<const char*, uint64_t>; ///< Type alias for one piece of a gather write
     typedef std::shared_ptr<rasterFileBase> rasterFileBasePtr;
     template <paxTypes_e E> using rasterFilePtr = std::shared_ptr<rasterFile<E>>;
+    template <typename _ET, paxVpe_t _VPE> struct PaxTypeOf;
+    inline constexpr paxTypes_e PAX_UNTYPED = static_cast<paxTypes_e>(-1);  ///< Same as ePAX_INVALID
 
     /********************************************************************************************************
     * @enum PaxLineType Line types in PAX files
@@ -284,6 +325,15 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
 ///@{
     inline constexpr uint32_t PAX_MAX_METADATA_STRING_LENGTH{ 256 };
     inline constexpr uint32_t MIN_PAX_LENGTH{ 128 };
+    inline constexpr uint32_t PAX_MAX_IO_LEN{ 1u << 30 };      ///< Largest single read/write request
+    inline constexpr uint32_t PAX_MAX_IOV{ 1024 };              ///< Largest gather list for one write call
+    inline constexpr uint64_t PAX_BATCH_BYTES{ 64u << 20 };     ///< Bytes PaxBatchWriter collects before writing them
+    inline constexpr uint32_t PAX_IO_DEPTH{ 32 };               ///< Writes PaxBatchWriter keeps in flight on io_uring
+    inline constexpr uint32_t PAX_MAX_DIMS{ 1u << 16 };         ///< Most dimensions accepted when parsing a header
+    inline constexpr uint64_t PAX_MAX_HEADER_LEN{ 256u << 20 }; ///< Most header bytes preview reads looking for DATA_LENGTH
+    inline constexpr uint64_t PAX_ALIGNMENT{ 64 };              ///< Alignment of buffer storage, enough for any SIMD load
+    inline constexpr uint64_t PAX_HUGE_PAGE{ 1u << 21 };        ///< Size of a huge page
+    inline constexpr uint64_t PAX_POOL_LIMIT{ 1ull << 30 };     ///< Default most bytes a buffer pool keeps for reuse
     inline constexpr char PAX_TAG[] { "PAX" };                  ///< Tag specifying the beginning of a block
     inline constexpr char BPV_TAG[]{ "BYTES_PER_VALUE" };       ///< Tag for number of bytes in one value
     inline constexpr char VPE_TAG[]{ "VALUES_PER_ELEMENT" };    ///< Tag for number of values in one element
@@ -292,6 +342,20 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
     inline constexpr char DIM1_TAG[]{ "ELEMENTS_IN_SEQUENTIAL_DIMENSION" }; ///< TEMPCODE: legacy 1st-dim tag
     inline constexpr char DIM2_TAG[]{ "ELEMENTS_IN_STRIDED_DIMENSION" };    ///< TEMPCODE: legacy 2nd-dim tag
     inline constexpr char DATALEN_TAG[]{ "DATA_LENGTH" };       ///< Tag at end of header, before raster data
+    inline constexpr char TILE_WIDTH_TAG[]{ "TILE_WIDTH" };     ///< Tag for elements per row of a tile (tiled layout only)
+    inline constexpr char TILE_HEIGHT_TAG[]{ "TILE_HEIGHT" };   ///< Tag for rows per tile (tiled layout only)
+    inline constexpr char COMPRESSION_TAG[]{ "COMPRESSION" };   ///< Tag naming the codec of a compressed raster
+    inline constexpr char COMPRESSION_BLOCK_TAG[]{ "COMPRESSION_BLOCK" };       ///< Tag for the uncompressed length of each block
+    inline constexpr char UNCOMPRESSED_LENGTH_TAG[]{ "UNCOMPRESSED_LENGTH" };   ///< Tag for the raster length before compression
+    inline constexpr uint64_t PAX_COMPRESSION_BLOCK{ 1u << 20 };        ///< Default uncompressed length of a compressed block
+    inline constexpr uint64_t PAX_MAX_COMPRESSION_BLOCK{ 1u << 30 };    ///< Largest compressed block
+    inline constexpr char CHECKSUM_TAG[]{ "CHECKSUM" };         ///< Tag for the CRC32C of the data following the header
+    inline constexpr char BLOCK_CHECKSUMS_TAG[]{ "BLOCK_CHECKSUMS" };   ///< Tag for the CRC32C of each tile or compressed block
+    inline constexpr char CRC32C_NAME[]{ "CRC32C" };            ///< Name of the checksum algorithm
+    inline constexpr char BUNDLE_TAG[]{ "PAX_BUNDLE" };         ///< Tag starting the table of contents of a bundle
+    inline constexpr char BUNDLE_INDEX_TAG[]{ "PAX_BUNDLE_INDEX" };     ///< Tag of the trailer locating the table of contents
+    inline constexpr uint32_t BUNDLE_TRAILER_LEN{ 40 };         ///< Length of the trailer: tag, delimiter, 20-digit offset, LF
+    inline constexpr char CATALOG_TAG[]{ "PAX_CATALOG" };       ///< Tag starting a header catalog
     inline constexpr char COMMENT_NAME_DELIM{ ';' };            ///< Delimiter used in comment names
     inline constexpr char PAX_WS[] { " \t\r" };                 ///< Legal whitespace characters
     inline constexpr char FIRST_POSTFIX[]{ "ST" };              ///< Postfix for 1st, first, etc.
@@ -318,6 +382,7 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
     inline constexpr char EIGHTEENTH_NUMERIC_TAG[]{ "EIGHTEENTH" };     ///< Tag for the 18th dimension
     inline constexpr char NINETEENTH_NUMERIC_TAG[]{ "NINETEENTH" };     ///< Tag for the 19th dimension
     inline constexpr char TWENTIETH_NUMERIC_TAG[]{ "TWENTIETH" };       ///< Tag for the 20th dimension
+    inline constexpr uint32_t NUMERIC_TAGS{ 20 };                       ///< Number of dimensions with a word tag
 ///@}
 
 /************************************************************************************************************
@@ -356,6 +421,55 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
         SKIP_ALL = _SKIP_DELIMITER | _SKIP_LINEFEED                     ///< skip everything
     } skipFlags_e;
 
+/************************************************************************************************************
+ * @enum paxCodec Codecs for compressed raster data (see PaxCodec).
+ ***********************************************************************************************************/
+/********************************************************************************************************
+ * @typedef paxCodec paxCodec_e
+ * Alias for paxCodec enumeration
+ *******************************************************************************************************/
+    typedef enum paxCodec {
+        CODEC_UNKNOWN = -1,     ///< unrecognized codec
+        CODEC_NONE = 0,         ///< raster data are not compressed
+        CODEC_LZ = 1,           ///< LZ-compressed blocks
+        CODEC_SHUFFLE_LZ = 2    ///< byte-shuffled, then LZ-compressed blocks
+    } paxCodec_e;
+
+/************************************************************************************************************
+ * @enum paxScalar The kinds of value PaxConvert converts between.
+ ***********************************************************************************************************/
+/********************************************************************************************************
+ * @typedef paxScalar paxScalar_e
+ * Alias for paxScalar enumeration
+ *******************************************************************************************************/
+    typedef enum paxScalar {
+        SCALAR_NONE = -1,       ///< not a convertible value
+        SCALAR_INT8,            ///< int8_t
+        SCALAR_UINT8,           ///< uint8_t
+        SCALAR_INT16,           ///< int16_t
+        SCALAR_UINT16,          ///< uint16_t
+        SCALAR_INT32,           ///< int32_t
+        SCALAR_UINT32,          ///< uint32_t
+        SCALAR_INT64,           ///< int64_t
+        SCALAR_UINT64,          ///< uint64_t
+        SCALAR_HALF,            ///< IEEE 754 half precision (paxHalf_t)
+        SCALAR_FLOAT,           ///< float
+        SCALAR_DOUBLE           ///< double
+    } paxScalar_e;
+
+/************************************************************************************************************
+ * @enum paxIoBackend How PaxBatchWriter hands its writes to the OS.
+ ***********************************************************************************************************/
+/********************************************************************************************************
+ * @typedef paxIoBackend paxIoBackend_e
+ * Alias for paxIoBackend enumeration
+ *******************************************************************************************************/
+    typedef enum paxIoBackend {
+        IO_AUTO,                ///< io_uring where the kernel has it, gather writes otherwise
+        IO_WRITEV,              ///< gather writes (writev), one batch at a time
+        IO_URING                ///< Linux io_uring, several batches in flight; falls back to IO_WRITEV
+    } paxIoBackend_e;
+
 /********************************************************************************************************
  * @enum paxMetaDataTypes Strongly-typed enum for identifying type of metadata.
  * Note that comments are a special type of unnamed metadata.
@@ -405,7 +519,14 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
         BPV,
         VPE,
         DIM,
-        DATALEN
+        DATALEN,
+        TILE_WIDTH,
+        TILE_HEIGHT,
+        COMPRESSION,
+        COMPRESSION_BLOCK,
+        UNCOMPRESSED_LENGTH,
+        CHECKSUM,
+        BLOCK_CHECKSUMS
     } hlType_t, headerLineType_t;
 
 /********************************************************************************************************
@@ -478,33 +599,266 @@ inline constexpr char   PAX_DATE[]{ "Dec 11, 2019" };
  ***********************************************************************************************************/
 #define PAX_LOG(level, chain) PAX_LOGX(level, chain)
 /************************************************************************************************************
- * @def PAX_LOG_ERROR Logging macro for errors.
+ * @def PAX_LOG_ERROR Logging macro for errors. The chain is evaluated once; the log line reuses the message.
  ***********************************************************************************************************/
 #define PAX_LOG_ERROR(level, chain)                                                                 \
-{   PaxStatic::setStatus(PAX_FAIL); PAX_LOG(level, << "ERROR: " chain); }
+{   PaxContext::errorStream() chain; PaxStatic::setError(PAX_FAIL, PaxContext::errorText());        \
+    PAX_LOG(level, << "ERROR: " << PaxContext::errorText()); }
 /************************************************************************************************************
- * @def PAX_LOG_ERRNO Logging macro for errors that adds errno.
+ * @def PAX_LOG_ERRNO Logging macro for errors that adds errno. errno is read before the chain can change it.
  ***********************************************************************************************************/
 #define PAX_LOG_ERRNO(level, chain)                                                                 \
-{   PaxStatic::setStatus(PAX_FAIL); PAX_LOG(level, << "ERROR: " << errno chain); }
+{   const int paxErrno = errno;                                                                     \
+    PaxContext::errorStream() << paxErrno chain; PaxStatic::setError(PAX_FAIL, PaxContext::errorText()); \
+    PAX_LOG(level, << "ERROR: " << PaxContext::errorText()); }
 /************************************************************************************************************
  * @def PAX_LOG_WARN Logging macro for warnings.
  ***********************************************************************************************************/
 #define PAX_LOG_WARN(level, chain)                                                                  \
 {   PaxStatic::setStatus(PAX_WARN); PAX_LOG(level, << " WARN: " chain); }
+/************************************************************************************************************
+ * @def PAX_MAX_LOG_LEVEL Highest log level compiled in. PAX_LOG calls above it compile to nothing, which
+ * removes them from the parsing loops entirely. Define it before including pax.h, e.g. to 1 for release.
+ ***********************************************************************************************************/
+#ifndef PAX_MAX_LOG_LEVEL
+#define PAX_MAX_LOG_LEVEL 4
+#endif
 /************************************************************************************************************
  * @def PAX_LOGX The macro that does the actual logging.
  ***********************************************************************************************************/
 #define PAX_LOGX(level, chain)                                                                      \
-if(PaxStatic::getVerbosity() >= level) {                                                            \
-    std::ostringstream oss; oss << PAX_LOG_TAG << "[" << std::setw(2) << level << "] " <<           \
-        std::left << std::setw(64) << __FUNCTION__ << " : " PAX_PAD ## level << std::right chain;   \
-    std::cout << oss.str() << std::endl << std::flush; }
+if constexpr ((level) <= PAX_MAX_LOG_LEVEL) { if (PaxContext::logEnabled(level)) {                  \
+    PaxContext::logStream() << PAX_LOG_TAG << "[" << std::setw(2) << level << "] " <<               \
+        std::left << std::setw(64) << __FUNCTION__ << " : " PAX_PAD ## level << std::right chain    \
+        << std::endl; } }
 ///@}
 
 #define PAX_MIN(x, y) (((x) < (y)) ? (x) : (y))
 #define PAX_MAX(x, y) (((x) < (y)) ? (y) : (x))
 
+/************************************************************************************************************
+ * @def PAX_TARGET Compiles one function for an instruction set extension, e.g. PAX_TARGET("avx2"), so it
+ * can be chosen at run time. MSVC needs no attribute to use the intrinsics.
+ ***********************************************************************************************************/
+#if defined(PAX_X86_64) && !defined(_MSC_VER)
+#define PAX_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PAX_TARGET(isa)
+#endif
+
+/************************************************************************************************************
+ * @class PaxLogBuf
+ * Stream buffer for log lines. Characters collect in a fixed array and are written to std::cout in one
+ * call on sync (std::endl) or when the array fills.
+ ***********************************************************************************************************/
+    class PaxLogBuf : public std::streambuf {
+
+    public:
+        PaxLogBuf() { setp(_buf, _buf + sizeof(_buf)); }
+
+    protected:
+        int overflow(int c) override {
+            sync();
+            if (traits_type::eof() != c) {
+                *pptr() = (char)c;
+                pbump(1);
+            }
+            return c;
+        }
+
+        int sync() override {
+            std::cout.write(pbase(), pptr() - pbase());
+            std::cout.flush();
+            setp(_buf, _buf + sizeof(_buf));
+            return 0;
+        }
+
+    private:
+        char            _buf[1024];     ///< Pending log text
+
+    }; // class PaxLogBuf
+
+
+/************************************************************************************************************
+ * @class PaxErrorBuf
+ * Stream buffer for error messages. Characters collect in a fixed array until reset; anything past the
+ * end of the array is dropped, so formatting an error never allocates.
+ ***********************************************************************************************************/
+    class PaxErrorBuf : public std::streambuf {
+
+    public:
+        PaxErrorBuf() { reset(); }
+
+        void reset() { setp(_buf, _buf + sizeof(_buf)); }
+        std::string_view text() const { return std::string_view(pbase(), pptr() - pbase()); }
+
+    protected:
+        int overflow(int c) override { return c; }
+
+    private:
+        char            _buf[512];      ///< Message text
+
+    }; // class PaxErrorBuf
+
+
+/************************************************************************************************************
+ * @class PaxContext
+ * Status, verbosity and last error for one importer or writer. Every thread gets its own context, so
+ * independent imports can run concurrently without sharing state.
+ ***********************************************************************************************************/
+    class PaxContext {
+
+    public:
+        int             status;         ///< Most recent status
+        std::string     lastError;      ///< Message of the most recent error
+
+/********************************************************************************************************
+ * Ctor. Starts without error at the process-wide default verbosity.
+ *******************************************************************************************************/
+        PaxContext() : status(PAX_OK), _verbosity(defaultVerbosity().load(std::memory_order_relaxed)) { track(_verbosity, 1); }
+        ~PaxContext() { track(_verbosity, -1); }
+        PaxContext(const PaxContext &) = delete;
+        PaxContext & operator = (const PaxContext &) = delete;
+
+/********************************************************************************************************
+ * Logging verbosity of this context
+ * @return          verbosity
+ *******************************************************************************************************/
+        int level() const { return _verbosity; }
+
+/********************************************************************************************************
+ * Sets the logging verbosity of this context only
+ * @param[in]       verb    desired verbosity
+ *******************************************************************************************************/
+        void setLevel(const int verb) {
+            track(_verbosity, -1);
+            _verbosity = verb;
+            track(_verbosity, 1);
+        }
+
+/********************************************************************************************************
+ * The context used by PaxStatic and the logging macros on this thread. Each thread has its own unless a
+ * Scope has installed another.
+ * @return          current context
+ *******************************************************************************************************/
+        static PaxContext & current() { return *currentPtr(); }
+
+/********************************************************************************************************
+ * Verbosity given to contexts when they are created
+ * @return          process-wide default verbosity
+ *******************************************************************************************************/
+        static std::atomic<int> & defaultVerbosity() {
+            static std::atomic<int> _verb{ 0 };
+            return _verb;
+        }
+
+/********************************************************************************************************
+ * Highest verbosity of any live context. Logging above it is rejected without touching the context.
+ * @return          process-wide verbosity ceiling
+ *******************************************************************************************************/
+        static std::atomic<int> & logCeiling() {
+            static std::atomic<int> _ceiling{ 0 };
+            return _ceiling;
+        }
+
+/********************************************************************************************************
+ * Sets the verbosity of the current context and the default for new contexts
+ * @param[in]       verb    desired verbosity
+ *******************************************************************************************************/
+        static void setVerbosity(const int verb) {
+            current().setLevel(verb);
+            defaultVerbosity().store(verb, std::memory_order_relaxed);
+        }
+
+/********************************************************************************************************
+ * Checks whether a message at the given level should be logged on this thread
+ * @param[in]       level   verbosity level of the message
+ * @return          true if the message should be written
+ *******************************************************************************************************/
+        static bool logEnabled(const int level) {
+            return level <= logCeiling().load(std::memory_order_relaxed) && level <= current()._verbosity;
+        }
+
+/********************************************************************************************************
+ * Stream for log lines on this thread. It formats into a fixed buffer that is written out on std::endl,
+ * so logging does not allocate.
+ * @return          log stream with default formatting
+ *******************************************************************************************************/
+        static std::ostream & logStream() {
+            thread_local PaxLogBuf buf;
+            thread_local std::ostream os(&buf);
+            os.flags(std::ios_base::dec | std::ios_base::skipws);
+            os.precision(6);
+            os.fill(' ');
+            return os;
+        }
+
+/********************************************************************************************************
+ * Stream for formatting an error message on this thread. Each call starts a new, empty message.
+ * @return          error stream with default formatting
+ *******************************************************************************************************/
+        static std::ostream & errorStream() {
+            thread_local std::ostream os(&errorBuf());
+            errorBuf().reset();
+            os.flags(std::ios_base::dec | std::ios_base::skipws);
+            os.precision(6);
+            os.fill(' ');
+            return os;
+        }
+
+/********************************************************************************************************
+ * Text written to errorStream() since it was last returned
+ * @return          error message
+ *******************************************************************************************************/
+        static std::string_view errorText() { return errorBuf().text(); }
+
+/********************************************************************************************************
+ * @class Scope
+ * Installs a context as current on this thread for the lifetime of the Scope.
+ *******************************************************************************************************/
+        class Scope {
+        public:
+            explicit Scope(PaxContext & context) : _prev(currentPtr()) { currentPtr() = &context; }
+            ~Scope() { currentPtr() = _prev; }
+            Scope(const Scope &) = delete;
+            Scope & operator = (const Scope &) = delete;
+        private:
+            PaxContext *    _prev;          ///< Context to restore
+        };
+
+    private:
+        static PaxContext *& currentPtr() {
+            thread_local PaxContext threadContext;
+            thread_local PaxContext * context = &threadContext;
+            return context;
+        }
+
+        static PaxErrorBuf & errorBuf() {
+            thread_local PaxErrorBuf buf;
+            return buf;
+        }
+
+        // count live contexts per verbosity, from -1 (silent) to PAX_MAX_LOG_LEVEL, and recompute the
+        // ceiling from the highest level still in use. Without a lock a scan can race a later change, so
+        // the scan is repeated until no count changed while it ran; the last writer stores a fresh value.
+        static void track(const int verb, const int delta) {
+            static std::atomic<int> counts[PAX_MAX_LOG_LEVEL + 2];
+            static std::atomic<unsigned> changes{ 0 };
+            counts[PAX_MAX(-1, PAX_MIN(verb, PAX_MAX_LOG_LEVEL)) + 1].fetch_add(delta);
+            changes.fetch_add(1);
+            unsigned seen;
+            do {
+                seen = changes.load();
+                int ceiling = PAX_MAX_LOG_LEVEL;
+                while (ceiling >= 0 && 0 == counts[ceiling + 1].load()) --ceiling;
+                logCeiling().store(ceiling);
+            } while (seen != changes.load());
+        }
+
+        int             _verbosity;     ///< Logging verbosity
+
+    }; // class PaxContext
+
 /************************************************************************************************************
  * @name SWAPPER Some cute little classes for temporary string manipulation. The primary
  * feature is allowing printing of a C-style substring in a char array without requiring
@@ -549,13 +903,13 @@ if(PaxStatic::getVerbosity() >= level) {
 
 /************************************************************************************************************
  * @class PaxStatic
- * Global static data. Use this class with global helper functions for non-threadsafe data.
+ * Static PAX data and functions. Status and verbosity are kept per thread in PaxContext.
  ***********************************************************************************************************/
     class PaxStatic {
     private:
 
    /********************************************************************************************************
- * Executes a verbosity operation
+ * Executes a verbosity operation on the current thread's context
  * Valid operations are:
  *  - 0: set verbosity
  *  - 1: get verbosity
@@ -566,26 +920,25 @@ if(PaxStatic::getVerbosity() >= level) {
  *******************************************************************************************************/
         static int verbosityOps(const int op, int &value) {
 
-            static int _verb = 0;
-
             switch (op) {
             case 0: ///< set verbosity
-                _verb = value;
+                PaxContext::setVerbosity(value);
                 break;
             case 1: // get verbosity
                 break;
             case 2: // compare given value to current
-                value = (int)(_verb >= value);
+                value = (int)(PaxContext::current().level() >= value);
                 break;
             }
 
-            return _verb;
+            return PaxContext::current().level();
 
         }
 
     public:
 /********************************************************************************************************
- * sets the verbosity to the given value
+ * sets the verbosity of the current context to the given value. Contexts created afterwards, e.g. by new
+ * threads, start at this verbosity too.
  * @param[in]       verb desired value
  * @return          current verbosity
  *******************************************************************************************************/
@@ -616,7 +969,7 @@ if(PaxStatic::getVerbosity() >= level) {
 
     private:
  /********************************************************************************************************
- * Executes a status operation
+ * Executes a status operation on the current thread's context
  * Valid operations are:
  *  - 0: set status
  *  - 1: get status
@@ -628,8 +981,7 @@ if(PaxStatic::getVerbosity() >= level) {
  *******************************************************************************************************/
         static int statusOps(const int op, int& value) {
 
-            static int _status = PAX_OK;
-            static bool _test = true;
+            int & _status = PaxContext::current().status;
 
             switch (op) {
             case 0: ///< case 0: set status
@@ -638,11 +990,9 @@ if(PaxStatic::getVerbosity() >= level) {
             case 1: ///< case 1: get status
                 break;
             case 2: ///< case 2: compare equal
-                _test = (_status == value);
-                return (int)_test;
+                return (int)(_status == value);
             case 3: ///< case 3: compare greater than
-                _test = (_status >= value);
-                return (int)_test;
+                return (int)(_status >= value);
             }
 
             return _status;
@@ -661,6 +1011,25 @@ if(PaxStatic::getVerbosity() >= level) {
             return statusOps(0, _status);
         }
 
+/********************************************************************************************************
+ * sets the status and records the error message in the current context
+ * @param[in]       status  Current status value
+ * @param[in]       message Description of the error
+ * @return          current status
+*******************************************************************************************************/
+        static int setError(const int status, std::string_view message) {
+            PaxContext::current().lastError.assign(message.data(), message.size());
+            return setStatus(status);
+        }
+
+/********************************************************************************************************
+ * gets the message of the most recent error in the current context
+ * @return          error message, empty if none was recorded
+*******************************************************************************************************/
+        static const std::string & getLastError() {
+            return PaxContext::current().lastError;
+        }
+
         // returns the current status
 /********************************************************************************************************
  * gets the current status
@@ -837,4354 +1206,10903 @@ if(PaxStatic::getVerbosity() >= level) {
 
         } // static const char * getMetaArrayIndexTag (int32_t index)
 
-    }; // class PaxStatic 
-
 
 /********************************************************************************************************
- * @class PaxArray
- * Wrapper for std::vector that can also accept a user buffer.
- * @tparam T type of the internal storage
+ * Case-insensitive check whether a buffer begins with the given tag. The buffer is not modified.
+ * @param[in]       pos     Buffer to be checked
+ * @param[in]       tag     NULL-terminated tag
+ * @param[in]       end     optional end of the buffer. If NULL, the buffer must be terminated.
+ * @return                  length of the tag if it matches, 0 otherwise
  *******************************************************************************************************/
-    template<typename T>
-    class PaxArray {
-    //private: // TODO: delete
-    //    PaxArray() {}  // size is required
+        static size_t matchTag(const char * pos, const char * tag, const char * end = NULL) {
+
+            size_t len = 0;
+            for (; tag[len]; ++len) {
+                if ((NULL != end && pos + len >= end) || std::toupper((unsigned char)pos[len]) != std::toupper((unsigned char)tag[len])) {
+                    return 0;
+                }
+            }
+
+            return len;
+
+        } // static size_t matchTag(const char * pos, const char * tag, const char * end = NULL)
 
-    public:
-/********************************************************************************************************
- * Ctor using std::vector of given size.
- * @param len Desired buffer size.
- *******************************************************************************************************/
-        PaxArray(const uint64_t len) : _buf(NULL), _len(len) { _vec.resize(len); }
-/********************************************************************************************************
- * Ctor using user buffer of given (minimum) size.
- * @param len Specified buffer size.
- *******************************************************************************************************/
-        PaxArray(T* buf, const uint64_t len) : _len(len), _buf(buf) { }
-/********************************************************************************************************
- * Dtor
- *******************************************************************************************************/
-        ~PaxArray() {}
 
-    public:
-/********************************************************************************************************
- * Get the buffer size.
- * @return Current buffer size.
- *******************************************************************************************************/
-        uint64_t size() { return _len; }
 /********************************************************************************************************
- * Direct buffer access.
- * @return Pointer to type of internal buffer.
+ * Returns the word tag (FIRST...TWENTIETH) for the given dimension index
+ * @param[in]       index   zero-based dimension index
+ * @return                  C-string word tag, or NULL if index is beyond the word tags
  *******************************************************************************************************/
-        T* data() { return useVec() ? _vec.data() : _buf; }
+        static const char * getNumericTag(const uint64_t index) {
+
+            static const char* numericTags[NUMERIC_TAGS] = {
+              FIRST_NUMERIC_TAG,        SECOND_NUMERIC_TAG,     THIRD_NUMERIC_TAG,      FOURTHNUMERIC_TAG,
+              FIFTH_NUMERIC_TAG,        SIXTH_NUMERIC_TAG,      SEVENTH_NUMERIC_TAG,    EIGHTH_NUMERIC_TAG,
+              NINTH_NUMERIC_TAG,        TENTH_NUMERIC_TAG,      ELEVENTH_NUMERIC_TAG,   TWELFTH_NUMERIC_TAG,
+              THIRTEENTH_NUMERIC_TAG,   FOURTEENTH_NUMERIC_TAG, FIFTEENTH_NUMERIC_TAG,  SIXTEENTH_NUMERIC_TAG,
+              SEVENTEENTH_NUMERIC_TAG,  EIGHTEENTH_NUMERIC_TAG, NINETEENTH_NUMERIC_TAG, TWENTIETH_NUMERIC_TAG
+            };
+
+            if (index >= NUMERIC_TAGS) {
+                return NULL;
+            }
+
+            return numericTags[index];
+
+        } // static const char * getNumericTag(const uint64_t index)
+
 
 /********************************************************************************************************
- * Resizes the vector. Does not modify user buffer. Shrink-only if using user buffer.
- * @param newSize 
+ * Returns the ordinal postfix (ST, ND, RD, TH) for the given one-based number
+ * @param[in]       number  one-based number
+ * @return                  C-string postfix
  *******************************************************************************************************/
-        uint64_t resize(const uint64_t newSize) {
-            if (useVec()) {
-                _vec.resize(newSize); _len = newSize; return _len;
-            } else {
-                if (newSize < _len) { _len = newSize; } return _len;
+        static const char * getOrdinalPostfix(const uint64_t number) {
+
+            if (number % 100 >= 11 && number % 100 <= 13) return FOURTH_POSTFIX;
+
+            switch (number % 10) {
+            case 1:     return FIRST_POSTFIX;
+            case 2:     return SECOND_POSTFIX;
+            case 3:     return THIRD_POSTFIX;
+            default:    return FOURTH_POSTFIX;
             }
-        }
+
+        } // static const char * getOrdinalPostfix(const uint64_t number)
+
 
 /********************************************************************************************************
- * Appends a vector. Does not modify user buffer. Does nothing if using user buffer.
+ * Returns the header tag for the given dimension. The first two dimensions use the legacy
+ * SEQUENTIAL/STRIDED tags, then words up to the 20th dimension, then <number><postfix>.
+ * @param[in]       index   zero-based dimension index
+ * @return                  dimension tag, e.g. ELEMENTS_IN_THIRD_DIMENSION
  *******************************************************************************************************/
-        size_t appendVector(PaxArray<T> &vec) {
-            if (useVec()) {
-                _vec.resize(_len + vec._len);
-                memcpy(_vec.data() + _len, vec.data(), vec._len);
-                _len += vec._len;
-                return _len;
+        static std::string getDimTag(const uint64_t index) {
+
+            if (0 == index) return DIM1_TAG;
+            if (1 == index) return DIM2_TAG;
+
+            std::string tag{ DIM_TAG };
+            if (const char * word = getNumericTag(index)) {
+                tag += word;
             } else {
-                return _len;
+                tag += std::to_string(index + 1) + getOrdinalPostfix(index + 1);
             }
-        }
-
-    private:
- /********************************************************************************************************
- * Is internal std::vector being used.
- * @return true if the std::vector is in use
- *******************************************************************************************************/
-        bool useVec() { return _buf == NULL; }
-        std::vector<T>  _vec;                   ///< The std::vector object
-        T*              _buf;                   ///< The user buffer
-        uint64_t        _len;                   ///< Current length of the buffer
+            tag += DIM_TAG_POST;
 
-    }; // class PaxArray 
+            return tag;
 
+        } // static std::string getDimTag(const uint64_t index)
 
 
 /********************************************************************************************************
- * @enum metaLoc
- * standard metadata locations
+ * Parses a dimension tag in any of its legal forms: SEQUENTIAL/STRIDED, FIRST...TWENTIETH, or
+ * <number><postfix>. The postfix must agree with the number, i.e. 2ND is legal but 2ST is not.
+ * The buffer is not modified.
+ * @param[in]       pos     Buffer pointing at the start of a header line
+ * @param[out]      index   zero-based dimension index
+ * @param[in]       end     optional end of the buffer. If NULL, the buffer must be terminated.
+ * @return                  length of the tag, or 0 if the line is not a dimension tag
  *******************************************************************************************************/
-    typedef enum metaLoc {
-        LOC_UNKNOWN = -1,   ///< Unknown or invalid location
-        LOC_BEGIN = 0,      ///< Beginning of file
-        LOC_AFTER_TAG = 0,  ///< immediately after PAX tag
-        LOC_AFTER_BPV = 1,  ///< after bytes per value tag
-        LOC_AFTER_VPE = 2,  ///< after values per element tag
-        LOC_AFTER_SEQ = 3,  ///< after sequential dimension tag
-        LOC_AFTER_STR1 = 4, ///< after strided dimension tag
-        LOC_END = 4,        ///< at end of file (before DATA_LENGTH tag)
-        LOC_DEFAULT = 4,    ///< default location
-        LOC_COUNT = 5       ///< number of defined locations
-    } metaLoc_e;
-
-    //////////////////////////////////////////////////////////////////////////
-    //
-    // helper function to get size of meta type
-    //
-    static size_t getMetaDataTypeSize(paxMetaDataTypes_e type) {
+        static size_t parseDimTag(const char * pos, uint64_t & index, const char * end = NULL) {
 
-        size_t size = 0;
+            size_t len = matchTag(pos, DIM_TAG, end);
+            if (0 == len) return 0;
 
-        switch (type) {
+            const char * ord = pos + len;
+            size_t ordLen = 0;
+            if (NULL != end && ord >= end) return 0;
 
-        case paxMetaDataTypes::paxDouble:
-        case paxMetaDataTypes::paxInt64:
-        case paxMetaDataTypes::paxUint64:
-            size = 8; break;
+            if (isdigit((unsigned char)*ord)) {
+                uint64_t number = 0;
+                while ((NULL == end || ord + ordLen < end) && isdigit((unsigned char)ord[ordLen])) {
+                    const uint64_t digit = ord[ordLen++] - '0';
+                    if (number > (UINT64_MAX - digit) / 10) return 0;   // a wrapped number could pass as a small one
+                    number = number * 10 + digit;
+                }
+                size_t postLen = matchTag(ord + ordLen, getOrdinalPostfix(number), end);
+                if (0 == number || 0 == postLen) return 0;
+                ordLen += postLen;
+                index = number - 1;
+            } else if ((ordLen = matchTag(ord, "SEQUENTIAL", end)) != 0) {
+                index = 0;
+            } else if ((ordLen = matchTag(ord, "STRIDED", end)) != 0) {
+                index = 1;
+            } else {
+                const char first = (char)std::toupper((unsigned char)*ord);
+                for (index = 0; index < NUMERIC_TAGS; ++index) {
+                    // numeric tags are upper case; skip those with a different first character
+                    if (first != getNumericTag(index)[0]) continue;
+                    // require the post-tag too, so e.g. FOURTH can't match the start of FOURTEENTH
+                    ordLen = matchTag(ord, getNumericTag(index), end);
+                    if (ordLen && matchTag(ord + ordLen, DIM_TAG_POST, end)) break;
+                }
+                if (NUMERIC_TAGS == index) return 0;
+            }
 
-        case paxMetaDataTypes::paxFloat:
-        case paxMetaDataTypes::paxInt32:
-        case paxMetaDataTypes::paxUint32:
-            size = 4; break;
+            size_t postLen = matchTag(ord + ordLen, DIM_TAG_POST, end);
+            if (0 == postLen) return 0;
 
-        case paxMetaDataTypes::paxInt16:
-        case paxMetaDataTypes::paxUint16:
-            size = 2; break;
+            return len + ordLen + postLen;
 
-        case paxMetaDataTypes::paxInt8:
-        case paxMetaDataTypes::paxUint8:
-            size = 1; break;
+        } // static size_t parseDimTag(const char * pos, uint64_t & index, const char * end = NULL)
 
-        default:
-            break;
 
-        } // switch (type)
+/********************************************************************************************************
+ * Classify a header line in a single case-insensitive pass. The fixed tags mostly begin with different
+ * characters, so the first character selects the few tags that can match. The input is never
+ * modified.
+ * @param[in]       pos     Start of the line, after any leading whitespace
+ * @param[out]      index   Zero-based dimension index, set only for DIM lines
+ * @param[in]       end     optional end of the buffer. If NULL, the buffer must be terminated.
+ * @return                  Line type, or UNKNOWN if no tag matches
+ *******************************************************************************************************/
+        static hlType_t classifyHeaderLine(const char * pos, uint64_t & index, const char * end = NULL) {
+
+            if (NULL != end && pos >= end) return hlType_t::UNKNOWN;
+
+            switch (std::toupper((unsigned char)pos[0])) {
+
+            case '#':   return hlType_t::COMMENT;
+            case '@':   return hlType_t::METADATA;
+            case 'P':   return matchTag(pos, PAX_TAG, end)      ? hlType_t::PAX     : hlType_t::UNKNOWN;
+            case 'B':   return matchTag(pos, BPV_TAG, end)      ? hlType_t::BPV
+                             : matchTag(pos, BLOCK_CHECKSUMS_TAG, end) ? hlType_t::BLOCK_CHECKSUMS : hlType_t::UNKNOWN;
+            case 'V':   return matchTag(pos, VPE_TAG, end)      ? hlType_t::VPE     : hlType_t::UNKNOWN;
+            case 'D':   return matchTag(pos, DATALEN_TAG, end)  ? hlType_t::DATALEN : hlType_t::UNKNOWN;
+            case 'E':   return parseDimTag(pos, index, end)     ? hlType_t::DIM     : hlType_t::UNKNOWN;
+            case 'T':   return matchTag(pos, TILE_WIDTH_TAG, end)  ? hlType_t::TILE_WIDTH
+                             : matchTag(pos, TILE_HEIGHT_TAG, end) ? hlType_t::TILE_HEIGHT : hlType_t::UNKNOWN;
+            case 'C':   // the block tag first, as it begins with the codec tag
+                        return matchTag(pos, COMPRESSION_BLOCK_TAG, end) ? hlType_t::COMPRESSION_BLOCK
+                             : matchTag(pos, COMPRESSION_TAG, end)       ? hlType_t::COMPRESSION
+                             : matchTag(pos, CHECKSUM_TAG, end)          ? hlType_t::CHECKSUM : hlType_t::UNKNOWN;
+            case 'U':   return matchTag(pos, UNCOMPRESSED_LENGTH_TAG, end) ? hlType_t::UNCOMPRESSED_LENGTH : hlType_t::UNKNOWN;
+            default:    return hlType_t::UNKNOWN;
 
-        // this shouldn't be called with non-numeric types
-        if (0 == size) {
-            PAX_LOG_ERROR(1, << "called getMetaDataTypeSize with invalid type = " << (int)type);
-        }
+            }
 
-        return size;
+        } // static hlType_t classifyHeaderLine(const char * pos, uint64_t & index, const char * end = NULL)
 
-    } // size_t getMetaDataTypeSize (paxMetaDataTypes_e type) 
+    }; // class PaxStatic 
 
 
 /********************************************************************************************************
- * @struct meta
- * structure for storing metadata
- * note: must be kept in sync with metaTypeTags in BufMan::getMeta() and the meta defines above
+ * @struct paxBlock_t
+ * Storage handed out by a PaxAllocator, to be handed back to it.
  *******************************************************************************************************/
+    struct paxBlock_t {
+        void *      data = NULL;        ///< PAX_ALIGNMENT-aligned storage, not initialized
+        uint64_t    capacity = 0;       ///< Usable length, at least the length asked for
+        uint64_t    mapped = 0;         ///< Length of the huge-page mapping holding the storage, 0 for the heap
+    };
+
 /********************************************************************************************************
- * @typedef meta meta_t
- * Alias for meta structure
+ * @class PaxAllocator
+ * Source of storage for PaxArray. Storage is aligned to PAX_ALIGNMENT, so SIMD code can use aligned loads,
+ * and is not initialized, so a buffer that is about to be filled is not written twice. This class
+ * allocates from the heap, and from huge pages for buffers above a threshold once setHugePages() has set
+ * one. Derive from it to take storage from elsewhere, e.g. PaxBufferPool, and install it with
+ * setDefault(). Allocation failure throws std::bad_alloc, as std::vector does.
  *******************************************************************************************************/
-    typedef struct meta {
-
-        metaLoc_e           loc;        ///< index of location within file
-        size_t              index;      ///< index within location
-        paxMetaDataTypes_e  type;       ///< metadata type
-        uint8_t             num_dims;   ///< number of dimensions. Use num_dims = 0 for scalar data.
+    class PaxAllocator {
 
+    public:
 /********************************************************************************************************
- * @union <unnamed>
- * for storing scalar/string/etc. data
+ * Dtor
  *******************************************************************************************************/
-        union {
-            float     f;
-            double    d;
-            uint64_t  u64;
-            int64_t   n64;
-            uint32_t  u32;
-            int32_t   n32;
-            uint16_t  u16;
-            int16_t   n16;
-            uint8_t   u8;
-            int8_t    n8;
-            char      s[PAX_MAX_METADATA_STRING_LENGTH];
-        };
+        virtual ~PaxAllocator() {}
 
-        bool                stripped;   ///< leading space was stripped off
-        bool                ownBuf;     ///< do I own the buffer
+/********************************************************************************************************
+ * Allocates storage.
+ * @param[in]       len         Bytes needed
+ * @return          The storage; empty for a length of 0
+ *******************************************************************************************************/
+        virtual paxBlock_t allocate(uint64_t len) {
 
-        // non-POD types must go here at the end
-        std::string         name;       ///< unique name of this meta
-        uint32_t *          dims;       ///< dimensions array
+            paxBlock_t block;
+            if (0 == len) {
+                return block;
+            }
+
+            const uint64_t threshold = hugePages().load(std::memory_order_relaxed);
+            if (0 != threshold && len >= threshold && allocateHuge(len, block)) {
+                return block;
+            }
+
+            block.capacity = (len + PAX_ALIGNMENT - 1) & ~(PAX_ALIGNMENT - 1);
+#ifdef _WIN32
+            block.data = _aligned_malloc(block.capacity, PAX_ALIGNMENT);
+#else
+            block.data = std::aligned_alloc(PAX_ALIGNMENT, block.capacity);
+#endif
+            if (NULL == block.data) {
+                throw std::bad_alloc();
+            }
+
+            return block;
+
+        } // virtual paxBlock_t allocate(uint64_t len)
 
 /********************************************************************************************************
- * @union <unnamed>
- * for storing array data
+ * Releases storage obtained from allocate().
+ * @param[in]       block       The storage
  *******************************************************************************************************/
-        union {
-            char *            buf;
-            float *           fb;
-            double *          db;
-            uint64_t *        u64b;
-            int64_t *         n64b;
-            uint32_t *        u32b;
-            int32_t *         n32b;
-            uint16_t *        u16b;
-            int16_t *         n16b;
-            uint8_t *         u8b;
-            int8_t *          n8b;
-        };
+        virtual void release(const paxBlock_t & block) {
+
+            if (NULL == block.data) {
+                return;
+            }
+#ifdef _WIN32
+            if (0 != block.mapped) {
+                VirtualFree(block.data, 0, MEM_RELEASE);
+            } else {
+                _aligned_free(block.data);
+            }
+#else
+            if (0 != block.mapped) {
+                munmap(block.data, block.mapped);
+            } else {
+                free(block.data);
+            }
+#endif
 
+        } // virtual void release(const paxBlock_t & block)
 
 /********************************************************************************************************
- * @name Construction/destruction
+ * The allocator of new buffers. Buffers keep the allocator they came from.
+ * @return          The allocator installed by setDefault(), the heap if none
  *******************************************************************************************************/
-///@{
+        static PaxAllocator & getDefault() {
+            PaxAllocator * alloc = defaultPtr().load(std::memory_order_acquire);
+            return (NULL != alloc) ? *alloc : heap();
+        }
+
 /********************************************************************************************************
- * Default Ctor
+ * Installs the allocator of new buffers. It must outlive every buffer it allocates.
+ * @param[in]       alloc       The allocator, or NULL for the heap
  *******************************************************************************************************/
-        meta() :
-            loc(LOC_UNKNOWN),
-            type{ paxMetaDataTypes_e::paxInvalid },
-            num_dims{ 0 },
-            d{ 0.0 },
-            stripped{ false },
-            ownBuf{ false },
-            name(""),
-            dims{ NULL },
-            buf{ s }
-        { }
+        static void setDefault(PaxAllocator * alloc) { defaultPtr().store(alloc, std::memory_order_release); }
 
 /********************************************************************************************************
- * Ctor with type and initializers
- * @param[in]       _type type of the metadata
- * @param[in]       list initializer_list used to construct std::vector
+ * The heap allocator.
+ * @return          The process-wide heap allocator
  *******************************************************************************************************/
-        meta(const paxMetaDataTypes_e _type, std::initializer_list<uint32_t> list) :
-            loc{ LOC_UNKNOWN },
-            type{ paxMetaDataTypes_e::paxInvalid },
-            num_dims{ 0 },
-            d{ 0.0 },
-            stripped{ false },
-            name{ "" },
-            dims{ NULL },
-            buf{ s }
-        {
-
-            initArray(_type, list);
-
+        static PaxAllocator & heap() {
+            static PaxAllocator alloc;
+            return alloc;
         }
 
 /********************************************************************************************************
- * Ctor with type and dimensions
- * @param[in]       _type type of the metadata
- * @param[in]       _dims dimensions of metadata array
+ * Backs buffers of at least the given length with huge pages: transparent huge pages on Linux, large
+ * pages on Windows, where the process needs the lock-pages privilege. Buffers fall back to the heap when
+ * huge pages cannot be had.
+ * @param[in]       threshold   Smallest buffer to back with huge pages; 0, the default, for none
  *******************************************************************************************************/
-        meta(const paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims) :
-            loc{ LOC_UNKNOWN },
-            type{ paxMetaDataTypes_e::paxInvalid },
-            num_dims{ 0 },
-            d{ 0.0 },
-            stripped{ false },
-            name{ "" },
-            dims{ NULL },
-            buf{ s }
-        {
-
-            initArray(_type, _dims);
-
-        } //         meta(const paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims) :
+        static void setHugePages(uint64_t threshold) { hugePages().store(threshold, std::memory_order_relaxed); }
 
+    private:
+        static std::atomic<PaxAllocator*> & defaultPtr() {
+            static std::atomic<PaxAllocator*> _alloc{ NULL };
+            return _alloc;
+        }
 
-/********************************************************************************************************
- * Ctor with type, initializers, and data
- * @param[in]       _type type of the metadata
- * @param[in]       list initializer_list used to construct std::vector
- * @param[in]       data Buffer containing the initial data (must be correct size!)
- *******************************************************************************************************/
-        meta(paxMetaDataTypes_e _type, std::initializer_list<uint32_t> list, const void* data) :
-            loc(LOC_UNKNOWN),
-            type(paxMetaDataTypes_e::paxInvalid),
-            num_dims{ 0 },
-            d{ 0.0 },
-            stripped{ false },
-            name(""),
-            dims{ NULL },
-            buf{ s }
-        {
+        static std::atomic<uint64_t> & hugePages() {
+            static std::atomic<uint64_t> _threshold{ 0 };
+            return _threshold;
+        }
 
-            initArray(_type, list, data);
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Map whole huge pages. On Linux the mapping is trimmed to a huge page
+        // boundary so the kernel can back it with huge pages from the start.
+        //
+        static bool allocateHuge(uint64_t len, paxBlock_t & block) {
+#ifdef _WIN32
+            const uint64_t page = GetLargePageMinimum();
+            if (0 == page) {
+                return false;
+            }
+            const uint64_t mapped = (len + page - 1) / page * page;
+            void * p = VirtualAlloc(NULL, mapped, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (NULL == p) {
+                return false;
+            }
+#else
+            const uint64_t mapped = (len + PAX_HUGE_PAGE - 1) & ~(PAX_HUGE_PAGE - 1);
+            char * raw = static_cast<char*>(mmap(NULL, mapped + PAX_HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (MAP_FAILED == raw) {
+                return false;
+            }
+            char * p = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(raw) + PAX_HUGE_PAGE - 1) & ~(PAX_HUGE_PAGE - 1));
+            if (p > raw) {
+                munmap(raw, p - raw);
+            }
+            munmap(p + mapped, raw + PAX_HUGE_PAGE - p);
+#ifdef MADV_HUGEPAGE
+            madvise(p, mapped, MADV_HUGEPAGE);
+#endif
+#endif
+            block.data = p;
+            block.capacity = len;
+            block.mapped = mapped;
+            return true;
+        }
 
-        } //         meta(paxMetaDataTypes_e _type, std::initializer_list<uint32_t> list, const void* data) :
+    }; // class PaxAllocator
 
 
 /********************************************************************************************************
- * Ctor with type, initializers, and data
- * @param[in]       _type type of the metadata
- * @param[in]       _dims dimensions of metadata array
- * @param[in]       data Buffer containing the initial data (must be correct size!)
+ * @class PaxBufferPool
+ * PaxAllocator that keeps released buffers for reuse, so repeated imports of same-sized rasters or tiles
+ * do not go back to the heap and fault their pages in again. Lengths are rounded up to size classes a
+ * quarter of a power of two apart, which wastes at most a fifth of a buffer. Up to a limit of retained
+ * bytes; beyond it, buffers go back to the heap. Thread-safe.
  *******************************************************************************************************/
-        meta(paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims, const void* data) :
-            loc(LOC_UNKNOWN),
-            index{ 0 },
-            type(paxMetaDataTypes_e::paxInvalid),
-            num_dims{ 0 },
-            d{ 0.0 },
-            stripped{ false },
-            name{ "" },
-            dims{ NULL },
-            buf{ s }
-        {
-
-            initArray(_type, _dims, data);
-
-        } //    meta(paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims, const void* data)
-
+    class PaxBufferPool : public PaxAllocator {
 
+    public:
 /********************************************************************************************************
- * Deep-copy ctor
- * @param[in]       _meta The source meta
+ * Ctor
+ * @param[in]       limit       Most bytes to keep for reuse
  *******************************************************************************************************/
-        meta(const meta& _meta) {
-
-            clone(_meta);
-
-        } //         meta(const meta& _meta) {
-
+        explicit PaxBufferPool(uint64_t limit = PAX_POOL_LIMIT) : _limit(limit), _retained(0), _reused(0) { }
 
 /********************************************************************************************************
- * Dtor
+ * Dtor. Frees the retained buffers; buffers still in use must not outlive the pool.
  *******************************************************************************************************/
-        ~meta() {
-            cleanup();
-        } // dtor
-///@}
+        ~PaxBufferPool() override { trim(); }
+
+        PaxBufferPool(const PaxBufferPool &) = delete;
+        PaxBufferPool & operator = (const PaxBufferPool &) = delete;
 
 /********************************************************************************************************
- * Assignment operator
- * @param[in]       _meta The source meta
- * @return          Self-reference
+ * Allocates storage, reusing a retained buffer of the same size class if there is one.
+ * @param[in]       len         Bytes needed
+ * @return          The storage; empty for a length of 0
  *******************************************************************************************************/
-        meta& operator = (const meta& _meta) {
+        paxBlock_t allocate(uint64_t len) override {
 
-            if (&_meta == this) {
-                return *this;
+            if (0 == len) {
+                return paxBlock_t();
             }
 
-            clone(_meta);
-
-            return *this;
+            const uint64_t size = sizeClass(len);
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                auto it = _free.find(size);
+                if (it != _free.end() && !it->second.empty()) {
+                    paxBlock_t block = it->second.back();
+                    it->second.pop_back();
+                    _retained -= size;
+                    ++_reused;
+                    return block;
+                }
+            }
 
-        } //         meta& operator = (const meta& _meta) {
+            return PaxAllocator::allocate(size);
 
+        } // paxBlock_t allocate(uint64_t len) override
 
 /********************************************************************************************************
- * Performs a deep-copy of the given meta
- * @param[in]       _meta The source meta
+ * Keeps storage for reuse, or frees it if the pool is full.
+ * @param[in]       block       The storage
  *******************************************************************************************************/
-        void clone(const meta& _meta) {
+        void release(const paxBlock_t & block) override {
 
-            int status = PaxStatic::getStatus();
-            if (!PaxStatic::paxNoError()) {
-                PAX_LOG_ERROR(1, << "attemping to clone meta from meta '" << _meta.name << "' with existing error = " << status);
+            if (NULL == block.data) {
+                return;
             }
 
-            copyPod(_meta);
-            name = _meta.name;
-
-            // always set allocated members so cleanup() doesn't crash
-            buf = s;
-            dims = NULL;
-
-            if (num_dims > 0) {
-                std::vector<uint32_t> _dims(num_dims);
-                memcpy(_dims.data(), _meta.dims, num_dims * sizeof(uint32_t));
-                initArray(type, _dims);
-                memcpy(buf, _meta.buf, bytes());
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                if (_retained + block.capacity <= _limit) {
+                    _free[block.capacity].push_back(block);
+                    _retained += block.capacity;
+                    return;
+                }
             }
 
-            PAX_LOG(3, << "cloned meta '" << name << "', num_dims = " << num_dims << ", bytes = " << bytes() << ". Status = " << PaxStatic::getStatus());
-
-        } // void clone (const meta& _meta) {
+            PaxAllocator::release(block);
 
+        } // void release(const paxBlock_t & block) override
 
 /********************************************************************************************************
- * Frees any allocated memory
+ * Frees every retained buffer.
  *******************************************************************************************************/
-        void cleanup() {
+        void trim() {
 
-            if (NULL != buf && s != buf) {
-                free(buf);
-                buf = NULL;
+            std::unordered_map<uint64_t, std::vector<paxBlock_t>> blocks;
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                blocks.swap(_free);
+                _retained = 0;
             }
-
-            if (NULL != dims) {
-                free(dims);
-                dims = NULL;
+            for (auto & size : blocks) {
+                for (auto & block : size.second) {
+                    PaxAllocator::release(block);
+                }
             }
-        } //         void cleanup() {
 
+        } // void trim()
 
 /********************************************************************************************************
- * Copies pod from the given meta
- * @param[in]       m       The source meta
+ * Bytes held for reuse.
+ * @return          Total capacity of the retained buffers
  *******************************************************************************************************/
-        void copyPod(const meta& m) {
-
-            size_t len = sizeof(meta) - sizeof(name) - sizeof(buf) - sizeof(dims); // don't copy non-POD members!
-            memcpy(this, &m, len);
-
-        } //         void copyPod(const meta& m) {
+        uint64_t getRetained() {
+            std::lock_guard<std::mutex> lock(_lock);
+            return _retained;
+        }
 
+/********************************************************************************************************
+ * Allocations served from retained buffers.
+ * @return          Number of reused buffers
+ *******************************************************************************************************/
+        uint64_t getReused() {
+            std::lock_guard<std::mutex> lock(_lock);
+            return _reused;
+        }
 
 /********************************************************************************************************
- * Initializes the object for array storage of the given dims and type.
- * @param[in]       _type   Type of the metadata
- * @param[in]       _dims   Dimensions of the metadata array
- * @param[in]       data    Input data
- * @return                  The total number of metadata elements
+ * The size class of a length: the next multiple of a quarter of the power of two below it, and at least
+ * PAX_ALIGNMENT.
+ * @param[in]       len         Bytes needed
+ * @return          Capacity of the buffers serving that length
  *******************************************************************************************************/
-        size_t initArray(paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims, const void* data = NULL) {
+        static uint64_t sizeClass(uint64_t len) {
+            if (len <= PAX_ALIGNMENT) {
+                return PAX_ALIGNMENT;
+            }
+            uint64_t top = PAX_ALIGNMENT;
+            while (top <= (len - 1) >> 1) {
+                top <<= 1;
+            }
+            const uint64_t step = PAX_MAX(top >> 2, PAX_ALIGNMENT);
+            return (len + step - 1) & ~(step - 1);
+        }
 
-            int status = PaxStatic::getStatus();
-            PAX_LOG(3, << "allocating meta array, initial status = " << status);
+/********************************************************************************************************
+ * A process-wide pool. It is never destroyed, so buffers may be released during static destruction.
+ * @return          The shared pool
+ *******************************************************************************************************/
+        static PaxBufferPool & shared() {
+            static PaxBufferPool * pool = new PaxBufferPool();
+            return *pool;
+        }
 
-            size_t _count = 1;
-            for (auto dim : _dims) { _count *= dim; }
+    private:
+        std::mutex                                              _lock;      ///< Guards the members below
+        std::unordered_map<uint64_t, std::vector<paxBlock_t>>   _free;      ///< Retained buffers by size class
+        uint64_t                                                _limit;     ///< Most bytes to retain
+        uint64_t                                                _retained;  ///< Bytes retained
+        uint64_t                                                _reused;    ///< Allocations served from _free
 
-            // cases that are not an array
-            if (_type < paxMetaDataTypes::paxNumericStart || _type > paxMetaDataTypes::paxNumericEnd || 1 >= _count) {
+    }; // class PaxBufferPool
 
-                num_dims = 0;
-                buf = NULL;
-                dims = NULL;
-                ownBuf = false;
 
-                PAX_LOG_WARN(3, << "Tried to initialize a meta array with invalid meta type = " << (int)_type << " and/or scalar data. count = " << _count);
+/********************************************************************************************************
+ * @class PaxArray
+ * Buffer of trivially copyable values, in storage from a PaxAllocator or in a user buffer. Owned storage
+ * is aligned to PAX_ALIGNMENT and is not initialized: the creator fills it.
+ * @tparam T type of the internal storage
+ *******************************************************************************************************/
+    template<typename T>
+    class PaxArray {
 
-                return 1;
+        static_assert(std::is_trivially_copyable_v<T>, "PaxArray holds trivially copyable values");
 
+    public:
+/********************************************************************************************************
+ * Ctor allocating uninitialized storage of given size.
+ * @param len Desired buffer size.
+ * @param alloc Allocator of the storage.
+ *******************************************************************************************************/
+        PaxArray(const uint64_t len, PaxAllocator & alloc = PaxAllocator::getDefault())
+            : _buf(NULL), _len(len), _alloc(&alloc), _block(alloc.allocate(len * sizeof(T))) { }
+/********************************************************************************************************
+ * Ctor using user buffer of given (minimum) size.
+ * @param len Specified buffer size.
+ *******************************************************************************************************/
+        PaxArray(T* buf, const uint64_t len) : _buf(buf), _len(len), _alloc(NULL) { }
+/********************************************************************************************************
+ * Copy ctor. Owned storage is copied; a user buffer is shared.
+ *******************************************************************************************************/
+        PaxArray(const PaxArray & other) : _buf(other._buf), _len(other._len), _alloc(other._alloc) {
+            if (owned() && _len > 0) {
+                _block = _alloc->allocate(_len * sizeof(T));
+                memcpy(_block.data, other._block.data, _len * sizeof(T));
             }
-
-            status = PaxStatic::getStatus();
-            PAX_LOG(4, << "allocating meta array, status after checking array = " << status);
-
-            size_t _size = getMetaDataTypeSize(_type) * _count;
-            if (0 == _size) {
-                type = paxMetaDataTypes::paxInvalid;
-                PAX_LOG_ERROR(3, << "Unknown size = 0 for meta type " << (int)_type);
-                return PAX_FAIL;
+        }
+/********************************************************************************************************
+ * Move ctor
+ *******************************************************************************************************/
+        PaxArray(PaxArray && other) noexcept : _buf(other._buf), _len(other._len), _alloc(other._alloc), _block(other._block) {
+            other._block = paxBlock_t();
+            other._len = 0;
+        }
+/********************************************************************************************************
+ * Assignment, by copy or by move.
+ *******************************************************************************************************/
+        PaxArray & operator = (PaxArray other) noexcept {
+            std::swap(_buf, other._buf);
+            std::swap(_len, other._len);
+            std::swap(_alloc, other._alloc);
+            std::swap(_block, other._block);
+            return *this;
+        }
+/********************************************************************************************************
+ * Dtor. Owned storage goes back to its allocator.
+ *******************************************************************************************************/
+        ~PaxArray() {
+            if (owned()) {
+                _alloc->release(_block);
             }
+        }
 
-            status = PaxStatic::getStatus();
-            PAX_LOG(4, << "allocating meta array, status after checking array = " << status);
-
-            cleanup();
-
-            status = PaxStatic::getStatus();
-            PAX_LOG(4, << "after meta array cleanup, status = " << status);
-
-            // store the dimensions (always allocated)
-            num_dims = (uint8_t)_dims.size();  // TODO: justify dimension count
-            dims = (uint32_t*)malloc(num_dims * sizeof(uint32_t));
-            for (int i = 0; i < num_dims; ++i) { dims[i] = _dims[i]; }
+    public:
+/********************************************************************************************************
+ * Get the buffer size.
+ * @return Current buffer size.
+ *******************************************************************************************************/
+        uint64_t size() { return _len; }
+/********************************************************************************************************
+ * Direct buffer access.
+ * @return Pointer to type of internal buffer.
+ *******************************************************************************************************/
+        T* data() { return owned() ? static_cast<T*>(_block.data) : _buf; }
 
-            // initialize the data buffer
-            ownBuf = _size > PAX_MAX_METADATA_STRING_LENGTH;
-            if (ownBuf) {
-                buf = (char*)malloc(_size);
+/********************************************************************************************************
+ * Resizes owned storage, keeping the contents; new values are not initialized. Shrink-only if using user
+ * buffer.
+ * @param newSize 
+ *******************************************************************************************************/
+        uint64_t resize(const uint64_t newSize) {
+            if (owned()) {
+                reserve(newSize); _len = newSize; return _len;
             } else {
-                buf = s;
+                if (newSize < _len) { _len = newSize; } return _len;
             }
+        }
 
-            type = _type;
-
-            if (data != NULL) {
-                memcpy(buf, data, _size);
+/********************************************************************************************************
+ * Appends a vector. Does not modify user buffer. Does nothing if using user buffer.
+ *******************************************************************************************************/
+        size_t appendVector(PaxArray<T> &vec) {
+            if (owned()) {
+                const uint64_t len = _len;
+                resize(_len + vec._len);
+                memcpy(data() + len, vec.data(), vec._len * sizeof(T));
+                return _len;
+            } else {
+                return _len;
             }
+        }
 
-            return _count;
-
-        } // size_t initArray(paxMetaDataTypes_e _type, ::std::vector<uint32_t> _dims) 
-
-/********************************************************************************************************
- * Initializes the object for array storage of the given dims and type.
- * @param[in]       _type   Type of the metadata
- * @param[in]       list    initializer_list, gets casted to std::vector
- * @param[in]       data    Input data
- * @return                  The total number of metadata elements
+    private:
+ /********************************************************************************************************
+ * Is the storage owned, rather than a user buffer.
+ * @return true if the storage came from the allocator
  *******************************************************************************************************/
-        size_t initArray(const paxMetaDataTypes_e _type, std::initializer_list<uint32_t> list,
+        bool owned() { return NULL != _alloc; }
 
-            const void* data = NULL) {
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Grow owned storage to hold len values, at least doubling it so that
+        // repeated appends stay linear
+        //
+        void reserve(const uint64_t len) {
+            if (len * sizeof(T) <= _block.capacity) {
+                return;
+            }
+            paxBlock_t block = _alloc->allocate(PAX_MAX(len * sizeof(T), 2 * _block.capacity));
+            if (_len > 0) {
+                memcpy(block.data, _block.data, _len * sizeof(T));
+            }
+            _alloc->release(_block);
+            _block = block;
+        }
 
-            std::vector<uint32_t> _dims(list);
-            size_t count = initArray(_type, _dims, data);
+        T*              _buf;                   ///< The user buffer
+        uint64_t        _len;                   ///< Current length of the buffer
+        PaxAllocator *  _alloc;                 ///< Source of owned storage, NULL for a user buffer
+        paxBlock_t      _block;                 ///< Owned storage
 
-            return count;
+    }; // class PaxArray 
 
-        } // size_t initArray(paxMetaDataTypes_e _type, ::std::vector<uint32_t> _dims, void* data) 
 
+/********************************************************************************************************
+ * @class PaxMap
+ * Memory mapping of an entire file, opened read-only. The view is writable but copy-on-write rather than
+ * read-only: header parsing in BufMan still writes temporary terminators (TempNull) into the buffer, and
+ * raster data referenced in place may be modified by the caller. Neither reaches the file, and only the
+ * pages actually written are copied. The mapping is released when the object is destroyed; buffers
+ * pointing into it should hold a paxMapPtr to keep it alive.
+ *******************************************************************************************************/
+    class PaxMap {
 
+    public:
 /********************************************************************************************************
- * Sets all values to zero
- * @return                  number of allocated bytes
+ * Default ctor. Nothing is mapped until map() is called.
  *******************************************************************************************************/
-        size_t zero() {
+        PaxMap() : _data(NULL), _len(0)
+#ifdef _WIN32
+            , _file(INVALID_HANDLE_VALUE), _mapping(NULL)
+#endif
+        { }
 
-            size_t _bytes = bytes();
+/********************************************************************************************************
+ * Dtor. Releases the mapping.
+ *******************************************************************************************************/
+        ~PaxMap() { unmap(); }
 
-            memset(buf, 0, _bytes);
+        PaxMap(const PaxMap&) = delete;
+        PaxMap& operator = (const PaxMap&) = delete;
 
-            return _bytes;
+/********************************************************************************************************
+ * Maps the given file.
+ * @param[in]       fileName    File to be mapped
+ * @return                      PAX_OK on success, PAX_FAIL otherwise
+ *******************************************************************************************************/
+        int map(const pax_filestring& fileName) {
 
-        } //         size_t zero() {
+            unmap();
 
+#ifdef _WIN32
+            _file = CreateFile(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+            if (INVALID_HANDLE_VALUE == _file) {
+                PAX_LOG_ERROR(1, << "opening file for mapping, error " << GetLastError());
+                return PAX_FAIL;
+            }
 
-/********************************************************************************************************
- * Returns the number of elements in the specified dimension or all dimensions
- * @param[in]       dim     optional dimension index
- * @return                  number of elements
- *******************************************************************************************************/
-        size_t count(const int8_t dim = -1) {
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(_file, &fileSize) || 0 == fileSize.QuadPart) {
+                PAX_LOG_ERROR(1, << "getting size of file to be mapped, error " << GetLastError());
+                unmap();
+                return PAX_FAIL;
+            }
+            _len = static_cast<uint64_t>(fileSize.QuadPart);
 
-            size_t _count = 1;
-            if (0 == num_dims) return 1;
+            // copy-on-write rather than read-only: parsing writes temporary terminators into the header
+            _mapping = CreateFileMapping(_file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+            if (NULL == _mapping) {
+                PAX_LOG_ERROR(1, << "creating file mapping, error " << GetLastError());
+                unmap();
+                return PAX_FAIL;
+            }
 
-            if (-1 == dim) {
-                for (int i = 0; i < num_dims; ++i) {
-                    _count *= dims[i];
-                }
-            } else if (dim < num_dims) {
-                return dims[dim];
-            } else {
-                PaxStatic::setStatus(PAX_FAIL);
-                return 0;
+            _data = static_cast<char*>(MapViewOfFile(_mapping, FILE_MAP_COPY, 0, 0, 0));
+            if (NULL == _data) {
+                PAX_LOG_ERROR(1, << "mapping view of file, error " << GetLastError());
+                unmap();
+                return PAX_FAIL;
+            }
+#else
+            int fd = pax_open(fileName.c_str(), O_BINARY | O_RDONLY, 0660);
+            if (-1 == fd) {
+                PAX_LOG_ERRNO(1, << " opening file for mapping.");
+                return PAX_FAIL;
             }
 
-            return _count;
+            struct stat info;
+            if (0 != fstat(fd, &info) || 0 == info.st_size) {
+                PAX_LOG_ERRNO(1, << " getting size of file to be mapped.");
+                pax_close(fd);
+                return PAX_FAIL;
+            }
+            _len = static_cast<uint64_t>(info.st_size);
+
+            // copy-on-write rather than read-only: parsing writes temporary terminators into the header
+            void * addr = mmap(NULL, _len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            pax_close(fd);  // the mapping holds its own reference to the file
+            if (MAP_FAILED == addr) {
+                PAX_LOG_ERRNO(1, << " mapping file.");
+                _len = 0;
+                return PAX_FAIL;
+            }
+            _data = static_cast<char*>(addr);
+#endif
 
-        } // size_t count(int8_t dim = -1) 
+            PAX_LOG(2, << "mapped " << _len << " bytes of " << fileName);
+
+            return PAX_OK;
 
+        } // int map(const pax_filestring& fileName)
 
 /********************************************************************************************************
- * Returns the size of the data in the specified dimension or all dimensions in bytes
- * @param[in]       dim     optional dimension index
- * @return                  number of elements
+ * Direct access to the mapped bytes.
+ * @return          Pointer to the start of the mapping, or NULL if nothing is mapped
  *******************************************************************************************************/
-        size_t bytes(const int8_t dim = -1) {
+        char * data() { return _data; }
 
-            size_t _count = count(dim);
-            if (0 == _count) {
-                return 0;
-            }
+/********************************************************************************************************
+ * Get the mapping size.
+ * @return          Length of the mapped file in bytes
+ *******************************************************************************************************/
+        uint64_t size() { return _len; }
 
-            if (paxMetaDataTypes::paxInvalid == type) {
-                return 0;
-            }
+    private:
+/********************************************************************************************************
+ * Releases the mapping and any handles.
+ *******************************************************************************************************/
+        void unmap() {
+#ifdef _WIN32
+            if (NULL != _data) UnmapViewOfFile(_data);
+            if (NULL != _mapping) CloseHandle(_mapping);
+            if (INVALID_HANDLE_VALUE != _file) CloseHandle(_file);
+            _mapping = NULL;
+            _file = INVALID_HANDLE_VALUE;
+#else
+            if (NULL != _data) munmap(_data, _len);
+#endif
+            _data = NULL;
+            _len = 0;
+        }
 
-            return _count * getMetaDataTypeSize(type);
+        char *          _data;                  ///< Start of the mapped view
+        uint64_t        _len;                   ///< Length of the mapped view
+#ifdef _WIN32
+        HANDLE          _file;                  ///< Handle of the mapped file
+        HANDLE          _mapping;               ///< Handle of the file mapping object
+#endif
 
-        } //         size_t bytes(const int8_t dim = -1) {
+    }; // class PaxMap
 
 
+#ifdef PAX_IO_URING
 /********************************************************************************************************
- * Returns the number of defined dimensions, including trivial ones
- * @return                  number of dimensions
+ * @class PaxIoRing
+ * A minimal io_uring: queues vectored writes at given offsets and collects their results. It drives the
+ * kernel interface directly, so no library is needed.
  *******************************************************************************************************/
-        size_t dimCount() {
+    class PaxIoRing {
 
-            return num_dims;
+    public:
+/********************************************************************************************************
+ * Ctor. Call open() before use.
+ *******************************************************************************************************/
+        PaxIoRing() { }
 
-        } // size_t dimCount() 
+/********************************************************************************************************
+ * Dtor. Writes still in flight complete in the kernel.
+ *******************************************************************************************************/
+        ~PaxIoRing() { close(); }
 
+        PaxIoRing(const PaxIoRing &) = delete;
+        PaxIoRing & operator = (const PaxIoRing &) = delete;
 
 /********************************************************************************************************
- * Calculates index into flattened array of the specified element 
- * @param[in]       indices Indices of desired element
- * @return                  flattened index
+ * Sets up the ring.
+ * @param[in]       entries     Most writes queued at once
+ * @return          PAX_OK on success, PAX_FAIL if the kernel does not provide io_uring
  *******************************************************************************************************/
-        size_t getMetaArrayIndex(const std::vector<uint32_t> &indices) {
+        int open(uint32_t entries) {
+
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            _fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+            if (_fd < 0) {
+                _fd = -1;
+                PAX_LOG(2, << "io_uring is not available: errno " << errno);
+                return PAX_FAIL;
+            }
 
-            if (indices.size() > num_dims) {
-                PaxStatic::setStatus(PAX_FAIL);
-                return 0; // std::numeric_limits<size_t>::max();
+            _sqLen = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+            _cqLen = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single = 0 != (params.features & IORING_FEAT_SINGLE_MMAP);
+            if (single) {
+                _sqLen = _cqLen = PAX_MAX(_sqLen, _cqLen);
             }
 
-            size_t index = 0;   ///< flattened index
-            size_t mul = 1;     ///< multiplier for this dimension's data
+            _sq = map(_sqLen, IORING_OFF_SQ_RING);
+            _cq = single ? _sq : map(_cqLen, IORING_OFF_CQ_RING);
+            _sqes = static_cast<io_uring_sqe*>(static_cast<void*>(map(params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES)));
+            _sqeLen = params.sq_entries * sizeof(io_uring_sqe);
+            if (NULL == _sq || NULL == _cq || NULL == _sqes) {
+                PAX_LOG_ERRNO(1, << " mapping the io_uring queues");
+                close();
+                return PAX_FAIL;
+            }
 
-            for (size_t i = 0; i < indices.size(); ++i) {
+            _sqHead = reinterpret_cast<uint32_t*>(_sq + params.sq_off.head);
+            _sqTail = reinterpret_cast<uint32_t*>(_sq + params.sq_off.tail);
+            _sqMask = *reinterpret_cast<uint32_t*>(_sq + params.sq_off.ring_mask);
+            _sqArray = reinterpret_cast<uint32_t*>(_sq + params.sq_off.array);
+            _cqHead = reinterpret_cast<uint32_t*>(_cq + params.cq_off.head);
+            _cqTail = reinterpret_cast<uint32_t*>(_cq + params.cq_off.tail);
+            _cqMask = *reinterpret_cast<uint32_t*>(_cq + params.cq_off.ring_mask);
+            _cqes = reinterpret_cast<io_uring_cqe*>(_cq + params.cq_off.cqes);
+            _entries = params.sq_entries;
 
-                if (indices[i] >= dims[i]) {
-                    PaxStatic::setStatus(PAX_FAIL); // index out of range
-                    return 0;
-                }
+            return PAX_OK;
 
-                index += indices[i] * mul;
-                mul *= dims[i];
+        } // int open(uint32_t entries)
+
+/********************************************************************************************************
+ * Releases the ring.
+ *******************************************************************************************************/
+        void close() {
+            if (NULL != _sqes) munmap(_sqes, _sqeLen);
+            if (NULL != _cq && _cq != _sq) munmap(_cq, _cqLen);
+            if (NULL != _sq) munmap(_sq, _sqLen);
+            if (-1 != _fd) ::close(_fd);
+            _fd = -1;
+            _sq = _cq = NULL;
+            _sqes = NULL;
+        }
+
+/********************************************************************************************************
+ * Queues a vectored write. The segments must stay valid until it completes.
+ * @param[in]       fd          Output file
+ * @param[in]       iov         Segments to write
+ * @param[in]       count       Number of segments
+ * @param[in]       offset      File offset of the first byte
+ * @param[in]       tag         Returned with the result
+ * @return          false if the queue is full
+ *******************************************************************************************************/
+        bool writev(int fd, const struct iovec * iov, uint32_t count, uint64_t offset, uint64_t tag) {
 
+            const uint32_t tail = *_sqTail;
+            if (tail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE) >= _entries) {
+                return false;
             }
 
-            return index;
+            io_uring_sqe & sqe = _sqes[tail & _sqMask];
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_WRITEV;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<uint64_t>(iov);
+            sqe.len = count;
+            sqe.off = offset;
+            sqe.user_data = tag;
+            _sqArray[tail & _sqMask] = tail & _sqMask;
+            __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+            ++_unsubmitted;
 
-        } //         size_t getMetaArrayIndex(const std::vector<uint32_t> &indices) {
+            return true;
 
+        } // bool writev(...)
 
 /********************************************************************************************************
- * Calculates index into flattened array of the specified element (shorthand version)
- * @param[in]       indices Indices of desired element
- * @return                  flattened index
+ * Hands the queued writes to the kernel and optionally waits for results.
+ * @param[in]       wait        Number of results to wait for
+ * @return          PAX_OK on success, PAX_FAIL on error
  *******************************************************************************************************/
-        size_t I(std::vector<uint32_t> &indices) {
+        int submit(uint32_t wait) {
 
-            return getMetaArrayIndex(indices);
+            while (true) {
+                long ret = syscall(__NR_io_uring_enter, _fd, _unsubmitted, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+                if (ret >= 0) {
+                    _unsubmitted -= (uint32_t)PAX_MIN((uint32_t)ret, _unsubmitted);
+                    return PAX_OK;
+                }
+                if (EINTR != errno) {
+                    PAX_LOG_ERRNO(1, << " submitting to io_uring");
+                    return PAX_FAIL;
+                }
+            }
 
-        } //         size_t I(std::vector<uint32_t> &indices) {
+        } // int submit(uint32_t wait)
+
+/********************************************************************************************************
+ * Takes back the writes queued since the last successful submit(). The kernel has not seen them.
+ * @return          Number of writes taken back
+ *******************************************************************************************************/
+        uint32_t retract() {
+
+            const uint32_t count = _unsubmitted;
+            __atomic_store_n(_sqTail, *_sqTail - count, __ATOMIC_RELEASE);
+            _unsubmitted = 0;
+
+            return count;
 
+        } // uint32_t retract()
 
 /********************************************************************************************************
- * Returns the pointer to the internal array buffer
- * @return                  pointer to internal buffer
+ * Takes the next result, if there is one.
+ * @param[out]      tag         Tag of the finished write
+ * @param[out]      result      Bytes written, or a negative errno
+ * @return          true if a result was taken
  *******************************************************************************************************/
-        void * bufPtr() {
+        bool result(uint64_t & tag, int32_t & result) {
 
-            if (!isArray()) {
-                PaxStatic::setStatus(PAX_FAIL);
-                return NULL;
+            const uint32_t head = *_cqHead;
+            if (head == __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE)) {
+                return false;
             }
-            // its less work to handle the non-numeric types since all numeric type buffers are in a union
-            switch (type) {
 
-            case paxMetaDataTypes::paxComment:
-            case paxMetaDataTypes::paxInvalid:
-            case paxMetaDataTypes::paxString:
-                return NULL;
+            const io_uring_cqe & cqe = _cqes[head & _cqMask];
+            tag = cqe.user_data;
+            result = cqe.res;
+            __atomic_store_n(_cqHead, head + 1, __ATOMIC_RELEASE);
 
-            default:
-                return (void*)u64b;
+            return true;
 
-            }
+        } // bool result(uint64_t & tag, int32_t & result)
 
-            return (void*)buf;
+    private:
+        char * map(size_t len, off_t offset) {
+            void * p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, offset);
+            return (MAP_FAILED == p) ? NULL : static_cast<char*>(p);
+        }
 
-        } //         void * bufPtr() {
+        int             _fd = -1;           ///< The ring
+        char *          _sq = NULL;         ///< Submission ring mapping
+        char *          _cq = NULL;         ///< Completion ring mapping, possibly the same
+        io_uring_sqe *  _sqes = NULL;       ///< Submission entries
+        size_t          _sqLen = 0;         ///< Length of the submission ring mapping
+        size_t          _cqLen = 0;         ///< Length of the completion ring mapping
+        size_t          _sqeLen = 0;        ///< Length of the submission entries
+        uint32_t *      _sqHead = NULL;     ///< Submission ring head, advanced by the kernel
+        uint32_t *      _sqTail = NULL;     ///< Submission ring tail
+        uint32_t *      _sqArray = NULL;    ///< Submission ring slots
+        uint32_t        _sqMask = 0;        ///< Submission ring index mask
+        uint32_t *      _cqHead = NULL;     ///< Completion ring head
+        uint32_t *      _cqTail = NULL;     ///< Completion ring tail, advanced by the kernel
+        io_uring_cqe *  _cqes = NULL;       ///< Completion entries
+        uint32_t        _cqMask = 0;        ///< Completion ring index mask
+        uint32_t        _entries = 0;       ///< Submission ring size
+        uint32_t        _unsubmitted = 0;   ///< Writes queued but not yet handed to the kernel
+
+    }; // class PaxIoRing
+#endif
 
 
 /********************************************************************************************************
- * Generate a standard name for a comment to be stored at the given location
- * @param[in]       loc     location index
- * @param[in]       index   index within location
- * @return                  string name
+ * @class PaxThreadPool
+ * A fixed set of worker threads for running independent jobs, such as importing many files. Work is
+ * handed out one index at a time from a shared counter, so a worker that finishes early simply takes the
+ * next job instead of idling behind a slow one. The calling thread joins in until the batch is done.
  *******************************************************************************************************/
-        static std::string&& getCommentName(size_t loc, size_t index) {
-
-            std::stringstream ss;
+    class PaxThreadPool {
 
-            // comments get a name starting with a character that is invalid at beginning of metadata name
-            ss << COMMENT_NAME_DELIM << loc << COMMENT_NAME_DELIM << index;
-            std::string name = ss.str();
+    public:
+/********************************************************************************************************
+ * Ctor. Starts the worker threads.
+ * @param[in]       threads Total number of threads to use, including the caller; 0 for one per core
+ *******************************************************************************************************/
+        explicit PaxThreadPool(size_t threads = 0) {
+            if (0 == threads) threads = std::thread::hardware_concurrency();
+            if (0 == threads) threads = 1;
+            for (size_t t = 1; t < threads; ++t) {
+                _workers.emplace_back([this] { workerLoop(); });
+            }
+        }
 
-            return std::move(name);
+/********************************************************************************************************
+ * Dtor. Waits for the workers to exit.
+ *******************************************************************************************************/
+        ~PaxThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _wake.notify_all();
+            for (auto & worker : _workers) worker.join();
+        }
 
-        } //         static std::string&& getCommentName(size_t loc, size_t index) {
+        PaxThreadPool(const PaxThreadPool &) = delete;
+        PaxThreadPool & operator = (const PaxThreadPool &) = delete;
 
+/********************************************************************************************************
+ * Number of threads that run jobs, including the caller
+ * @return          thread count
+ *******************************************************************************************************/
+        size_t size() const { return _workers.size() + 1; }
 
 /********************************************************************************************************
- * Generate and store the standard name for a comment to be stored at the current internal location.
- * @return                  string name
+ * Runs job(0) ... job(count - 1) across the pool and returns when all of them have finished. Batches
+ * from different threads are run one after another. A job that calls parallelFor itself runs the inner
+ * batch on its own thread, since the pool is already busy with the outer one.
+ * @param[in]       count   Number of jobs
+ * @param[in]       job     Function to call with each job index; it must not throw
  *******************************************************************************************************/
-        std::string commentName() {
+        void parallelFor(size_t count, const std::function<void(size_t)> & job) {
+            if (0 == count) return;
 
-            name = getCommentName(loc, index);
+            if (1 == count || inJob() || _workers.empty()) {
+                for (size_t index = 0; index < count; ++index) job(index);
+                return;
+            }
 
-            return name;
-        } //        std::string commentName() {
+            std::lock_guard<std::mutex> batchLock(_batchMutex);
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _job = &job;
+                _count = count;
+                _next.store(0, std::memory_order_relaxed);
+                _done = 0;
+                ++_batch;
+            }
+            _wake.notify_all();
+
+            runJobs(job, count);
 
+            std::unique_lock<std::mutex> lock(_mutex);
+            _finished.wait(lock, [this] { return _done == _count && 0 == _active; });
+            _job = nullptr;
+        }
 
 /********************************************************************************************************
- * Return a string representation of the metadata
- * @return                  string flattened string representation of the metadata
+ * A pool sized to the machine, created on first use and shared by the batch helpers
+ * @return          the shared pool
  *******************************************************************************************************/
-        std::string value() {
+        static PaxThreadPool & shared() {
+            static PaxThreadPool pool;
+            return pool;
+        }
 
-            std::stringstream ss;
+    private:
+        static bool & inJob() {
+            thread_local bool _inJob = false;
+            return _inJob;
+        }
 
-            switch (type)
-            {
-            case paxMetaDataTypes_e::paxDouble:
-                ss << d;
-                break;
-            case paxMetaDataTypes_e::paxString:
-            case paxMetaDataTypes_e::paxComment:
-                ss << s;
-                break;
-            default:
-                break;
+        void runJobs(const std::function<void(size_t)> & job, size_t count) {
+            size_t ran = 0;
+            inJob() = true;
+            for (size_t index = _next.fetch_add(1); index < count; index = _next.fetch_add(1)) {
+                job(index);
+                ++ran;
+            }
+            inJob() = false;
+            if (ran) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _done += ran;
+                if (_done == _count) _finished.notify_all();
             }
+        }
 
-            std::string val = ss.str();
+        void workerLoop() {
+            uint64_t seen = 0;
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true) {
+                _wake.wait(lock, [&] { return _stop || (_job && _batch != seen); });
+                if (_stop) return;
 
-            return val;
+                seen = _batch;
+                const std::function<void(size_t)> & job = *_job;
+                size_t count = _count;
+                ++_active;
+                lock.unlock();
 
-        } //         std::string value() {
+                runJobs(job, count);
+
+                lock.lock();
+                if (0 == --_active) _finished.notify_all();
+            }
+        }
+
+        std::vector<std::thread>    _workers;                   ///< Worker threads; the caller is the extra one
+        std::mutex                  _batchMutex;                ///< Serializes batches
+        std::mutex                  _mutex;                     ///< Guards the batch state below
+        std::condition_variable     _wake;                      ///< Signals workers that a batch is ready
+        std::condition_variable     _finished;                  ///< Signals the caller that the batch is done
+        const std::function<void(size_t)> * _job = nullptr;     ///< Job of the current batch
+        size_t                      _count = 0;                 ///< Number of jobs in the current batch
+        std::atomic<size_t>         _next{ 0 };                 ///< Next job index to hand out
+        size_t                      _done = 0;                  ///< Jobs finished in the current batch
+        size_t                      _active = 0;                ///< Workers still inside the current batch
+        uint64_t                    _batch = 0;                 ///< Batch counter, so a worker runs each batch once
+        bool                        _stop = false;              ///< Set when the pool is shutting down
+
+    }; // class PaxThreadPool
 
 
 /********************************************************************************************************
- * less-than operator, needed for std::sort
- * @param[in]       rt  meta being compared to
- * @return              true if less than given meta, false otherwise
+ * @class PaxCodec
+ * The built-in lossless codec for raster data. The data are cut into blocks that are compressed
+ * independently, so they can be compressed and decompressed in parallel. The compressed payload is a
+ * table of block lengths (32-bit little-endian, one per block) followed by the blocks. A block that
+ * would not shrink is stored as is; its length then equals the uncompressed block length.
+ *
+ * CODEC_SHUFFLE_LZ first shuffles each block so that byte k of every value lies in plane k. Floats
+ * vary slowly in their high bytes, so the planes hold long runs that LZ finds easily.
+ *
+ * The LZ format is a byte-oriented LZ77 in the style of LZ4: each sequence is a token (literal count in
+ * the high nibble, match length - 4 in the low one, 15 meaning more length bytes follow), the literals,
+ * and a 16-bit little-endian match offset. The last sequence holds literals only.
  *******************************************************************************************************/
-        bool operator < (const meta &rt) const { return loc < rt.loc && index < rt.index; }
-
+    class PaxCodec {
 
+    public:
 /********************************************************************************************************
- * is the meta an array?
- * @return              true if array, false otherwise
+ * Compresses raster data.
+ * @param[in]       codec       Codec to use
+ * @param[in]       width       Bytes per value, for shuffling
+ * @param[in]       blockLen    Uncompressed length of each block; the last may be shorter
+ * @param[in]       data        Data to compress
+ * @param[in]       len         Length of the data
+ * @param[out]      out         Compressed payload
+ * @param[in]       pool        Threads to compress on
+ * @return          PAX_OK upon success, PAX_FAIL if memory runs out
  *******************************************************************************************************/
-        bool isArray() { return num_dims != 0; }
-
-    } meta_t;   // typedef struct meta
+        static int compress(paxCodec_e codec, uint32_t width, uint64_t blockLen, const char * data, uint64_t len,
+                            std::vector<char> & out, PaxThreadPool & pool = PaxThreadPool::shared()) {
 
+            if (!isCodec(codec) || CODEC_NONE == codec || 0 == blockLen || blockLen > PAX_MAX_COMPRESSION_BLOCK) {
+                PAX_LOG_ERROR(1, << "Cannot compress with codec " << (int)codec << " in blocks of " << blockLen);
+                return PAX_FAIL;
+            }
 
-/************************************************************************************************************
- * @class BufMan
- * PAX buffer manipulation object.
- ***********************************************************************************************************/
-    class BufMan {
-    public:
-/************************************************************************************************************
- * Ctor for internal type.
- * @param[in]       buf     Shared pointer to the buffer
- * @param[in]       len     Buffer length
- ***********************************************************************************************************/
-        BufMan(paxBufPtr buf, const size_t len) :
-            _buf{ buf },
-            _pos{ NULL },
-            _len{ len },
-            _metaLoc{ metaLoc::LOC_AFTER_TAG }
-        {
+            const uint64_t blocks = (len + blockLen - 1) / blockLen;
+            std::vector<std::vector<char>> packed(blocks);
+
+            // pool jobs must not throw; an allocation failure fails the block
+            std::atomic<uint64_t> failed{ 0 };
+            pool.parallelFor(blocks, [&](size_t b) {
+                const uint64_t raw = PAX_MIN(blockLen, len - b * blockLen);
+                const char * src = data + b * blockLen;
+
+                try {
+                    std::vector<char> shuffled;
+                    if (CODEC_SHUFFLE_LZ == codec && width > 1) {
+                        shuffled.resize(raw);
+                        shuffle(src, shuffled.data(), raw, width);
+                        src = shuffled.data();
+                    }
 
-            if (buf) _pos = buf->data();
-            _start = _pos;
-            PAX_LOG(2, << "created buf of length " << len);
+                    packed[b].resize(lzBound(raw));
+                    uint64_t size = lzCompress(src, raw, packed[b].data());
+                    if (size >= raw) {
+                        // store the block as is
+                        packed[b].assign(data + b * blockLen, data + b * blockLen + raw);
+                    } else {
+                        packed[b].resize(size);
+                    }
+                } catch (const std::bad_alloc &) {
+                    failed.store(b + 1);
+                }
+            });
 
-        } // BufMan(paxBufPtr buf, const size_t len)
+            if (failed.load()) {
+                PAX_LOG_ERROR(1, << "Out of memory compressing block " << failed.load() - 1);
+                return PAX_FAIL;
+            }
 
+            uint64_t total = 4 * blocks;
+            for (auto & block : packed) total += block.size();
 
-/************************************************************************************************************
- * Ctor for raw buffer
- * @param[in]       buf     Buffer address
- * @param[in]       len     Buffer length
- ***********************************************************************************************************/
-        BufMan(paxBufData_t *buf, const size_t len) :
-            _buf{ nullptr },
-            _pos{ buf },
-            _len{ len },
-            _metaLoc{ metaLoc::LOC_AFTER_TAG }
-        {
+            out.resize(total);
+            char * pos = out.data() + 4 * blocks;
+            for (uint64_t b = 0; b < blocks; ++b) {
+                write32(out.data() + 4 * b, (uint32_t)packed[b].size());
+                memcpy(pos, packed[b].data(), packed[b].size());
+                pos += packed[b].size();
+            }
 
-            _start = _pos;
-            PAX_LOG(2, << "imported buf of length " << len);
+            PAX_LOG(2, << "Compressed " << len << " bytes to " << total << " in " << blocks << " blocks");
 
-        } // BufMan(paxBufData_t *buf, const size_t len)
+            return PAX_OK;
 
+        } // static int compress(...)
 
-/************************************************************************************************************
- * Tests the buffer for end-of-file
- * @param[in]       pos     Optional buffer address. If NULL, uses internal buffer
- * @return                  true if end-of-file found, false otherwise
- ***********************************************************************************************************/
-        bool eof(char *pos = NULL) {
+/********************************************************************************************************
+ * Decompresses raster data. The payload is checked, so a damaged one fails rather than overrunning.
+ * @param[in]       codec       Codec the data were compressed with
+ * @param[in]       width       Bytes per value, for shuffling
+ * @param[in]       blockLen    Uncompressed length of each block
+ * @param[in]       payload     Compressed payload
+ * @param[in]       payloadLen  Length of the payload
+ * @param[out]      out         Buffer receiving the data
+ * @param[in]       len         Uncompressed length of the data
+ * @param[in]       pool        Threads to decompress on
+ * @return          PAX_OK upon success, PAX_INVALID if the payload is damaged, PAX_FAIL if memory runs out
+ *******************************************************************************************************/
+        static int decompress(paxCodec_e codec, uint32_t width, uint64_t blockLen, const char * payload, uint64_t payloadLen,
+                              char * out, uint64_t len, PaxThreadPool & pool = PaxThreadPool::shared()) {
 
-            if (!pos) pos = _pos;
-            return (pos - _start) >= (int64_t)_len;
+            if (!isCodec(codec) || CODEC_NONE == codec || 0 == blockLen) {
+                PAX_LOG_ERROR(1, << "Cannot decompress codec " << (int)codec << " in blocks of " << blockLen);
+                return PAX_INVALID;
+            }
 
-        } // bool eof(char *pos = NULL) {
+            std::vector<uint64_t> offsets;
+            if (PAX_OK != getBlockOffsets(blockLen, payload, payloadLen, len, offsets)) {
+                return PAX_INVALID;
+            }
+            const uint64_t blocks = offsets.size() - 1;
+
+            // pool jobs must not throw; an allocation failure fails the block
+            std::atomic<uint64_t> failed{ 0 };
+            std::atomic<uint64_t> outOfMemory{ 0 };
+            pool.parallelFor(blocks, [&](size_t b) {
+                const uint64_t raw = PAX_MIN(blockLen, len - b * blockLen);
+                const uint64_t size = offsets[b + 1] - offsets[b];
+                const char * src = payload + offsets[b];
+                char * dst = out + b * blockLen;
+
+                if (size == raw) {
+                    memcpy(dst, src, raw);
+                    return;
+                }
 
+                std::vector<char> shuffled;
+                bool unshuffle = CODEC_SHUFFLE_LZ == codec && width > 1;
+                if (unshuffle) {
+                    try {
+                        shuffled.resize(raw);
+                    } catch (const std::bad_alloc &) {
+                        outOfMemory.store(b + 1);
+                        return;
+                    }
+                }
 
-/************************************************************************************************************
- * Sets the current location and index for storing metadata.
- * @param[in]       raster  Index of the raster for the next metadata.
- * @param[in]       index   Index within the raster.
- * @return                  status
- ***********************************************************************************************************/
-        int setLoc(const metaLoc_e loc, const paxMetaLoc_t index) {
+                if (lzDecompress(src, size, unshuffle ? shuffled.data() : dst, raw) != (int64_t)raw) {
+                    failed.store(b + 1);
+                    return;
+                }
+                if (unshuffle) PaxCodec::unshuffle(shuffled.data(), dst, raw, width);
+            });
 
-            _metaLoc = loc;
-            _metaIdx = index;
+            if (outOfMemory.load()) {
+                PAX_LOG_ERROR(1, << "Out of memory decompressing block " << outOfMemory.load() - 1);
+                return PAX_FAIL;
+            }
+            if (failed.load()) {
+                PAX_LOG_ERROR(1, << "Compressed block " << failed.load() - 1 << " is damaged");
+                return PAX_INVALID;
+            }
 
             return PAX_OK;
 
-        } // int setLoc(const paxMetaLoc_t loc, const paxMetaLoc_t index) {
-
+        } // static int decompress(...)
 
 /********************************************************************************************************
- * Advance the internal buffer past the next LF
- * @return                  true if end-of-file found, false otherwise
+ * Locates the blocks of a compressed payload from its table of block lengths.
+ * @param[in]       blockLen    Uncompressed length of each block
+ * @param[in]       payload     Compressed payload
+ * @param[in]       payloadLen  Length of the payload
+ * @param[in]       len         Uncompressed length of the data
+ * @param[out]      offsets     Offset of each block in the payload, then the payload length
+ * @return          PAX_OK upon success, PAX_INVALID if the table does not fit the payload
  *******************************************************************************************************/
-        bool skipLine() {
+        static int getBlockOffsets(uint64_t blockLen, const char * payload, uint64_t payloadLen, uint64_t len,
+                                   std::vector<uint64_t> & offsets) {
 
-            char * oldpos = _pos;
-            _pos = strchr(_pos, '\n') + 1;
-            PAX_LOG(3, << "skipLine advanced " << _pos - oldpos << " characters");
+            const uint64_t blocks = (len + blockLen - 1) / blockLen;
+            if (blocks > payloadLen / 4) {
+                PAX_LOG_ERROR(1, << "Compressed payload of " << payloadLen << " bytes is too short for " << blocks << " blocks");
+                return PAX_INVALID;
+            }
 
-            return eof();
+            offsets.resize(blocks + 1);
+            offsets[0] = 4 * blocks;
+            for (uint64_t b = 0; b < blocks; ++b) {
+                offsets[b + 1] = offsets[b] + read32(payload + 4 * b);
+            }
+            if (offsets[blocks] != payloadLen) {
+                PAX_LOG_ERROR(1, << "Compressed blocks hold " << offsets[blocks] << " bytes but the payload has " << payloadLen);
+                return PAX_INVALID;
+            }
 
-        } // bool skipLine() {
+            return PAX_OK;
 
+        } // static int getBlockOffsets(...)
 
 /********************************************************************************************************
- * Advance past the next LF
- * @param[in,out]   pos     Buffer to be advanced
- * @return                  true
+ * Codec names, as written in the header
  *******************************************************************************************************/
-        static bool skipLine(char *&pos) {
-
-            char * oldpos = pos;
-            pos = strchr(pos, '\n') + 1;
-            PAX_LOG(3, << "skipLine advanced " << pos - oldpos << " characters");
-
-            return true;
+        static const char * getName(paxCodec_e codec) {
+            switch (codec) {
+            case CODEC_NONE:        return "NONE";
+            case CODEC_LZ:          return "LZ";
+            case CODEC_SHUFFLE_LZ:  return "SHUFFLE_LZ";
+            default:                return "UNKNOWN";
+            }
+        }
 
-        } // static bool skipLine(char *&pos) {
+        static paxCodec_e getCodec(const char * name, const char * end = NULL) {
+            // SHUFFLE_LZ first, as the tags are matched by prefix
+            for (paxCodec_e codec : { CODEC_SHUFFLE_LZ, CODEC_LZ, CODEC_NONE }) {
+                if (PaxStatic::matchTag(name, getName(codec), end)) return codec;
+            }
+            return CODEC_UNKNOWN;
+        }
 
+        static bool isCodec(paxCodec_e codec) { return codec >= CODEC_NONE && codec <= CODEC_SHUFFLE_LZ; }
 
 /********************************************************************************************************
- * Advance past the next chunk of whitespace. LF's are skipped if the 2nd argument is true
- * @param[in,out]   pos     Buffer to be advanced
- * @param[in]       skipLF  optional flag to skip linefeeds
-  *******************************************************************************************************/
-        static void skipWS(char *& pos, const bool skipLF = true) {
-
-            char * oldpos = pos;
-
-            while (*pos == ' ' || *pos == '\t' || *pos == '\r' || (skipLF && *pos == '\n')) ++pos;
-            if (pos != oldpos) PAX_LOG(3, << "skipped " << (pos - oldpos) << " whitespace characters");
+ * Byte shuffle: byte k of value i moves to plane k, position i. Trailing bytes that do not fill a
+ * value are copied as is.
+ *******************************************************************************************************/
+        static void shuffle(const char * in, char * out, uint64_t len, uint32_t width) {
+            const uint64_t n = len / width;
+            for (uint64_t i = 0; i < n; ++i) {
+                for (uint32_t k = 0; k < width; ++k) {
+                    out[k * n + i] = in[i * width + k];
+                }
+            }
+            memcpy(out + n * width, in + n * width, len - n * width);
+        }
 
-        } // static void skipWS(char *& pos, const bool skipLF = true) {
+        static void unshuffle(const char * in, char * out, uint64_t len, uint32_t width) {
+            const uint64_t n = len / width;
+            for (uint64_t i = 0; i < n; ++i) {
+                for (uint32_t k = 0; k < width; ++k) {
+                    out[i * width + k] = in[k * n + i];
+                }
+            }
+            memcpy(out + n * width, in + n * width, len - n * width);
+        }
 
+/********************************************************************************************************
+ * Largest LZ output for an input of the given length
+ *******************************************************************************************************/
+        static uint64_t lzBound(uint64_t len) { return len + len / 255 + 16; }
 
 /********************************************************************************************************
- * Advance to the next chunk of whitespace, delimiter, or brace. LF's are skipped if the 2nd arg is true.
- * @param[in,out]   pos     Buffer to be advanced
- * @param[in]       skipLF  optional flag to skip linefeeds
+ * LZ-compresses one block.
+ * @param[in]       src     Data
+ * @param[in]       len     Length of the data, below 4 GB
+ * @param[out]      dst     Output of at least lzBound(len) bytes
+ * @return          compressed length
  *******************************************************************************************************/
-        static void skipJunk(char *& pos, bool skipLF = true) {
+        static uint64_t lzCompress(const char * src, uint64_t len, char * dst) {
+
+            const uint8_t * in = reinterpret_cast<const uint8_t*>(src);
+            uint8_t * op = reinterpret_cast<uint8_t*>(dst);
+            std::vector<uint32_t> table(size_t(1) << LZ_HASH_BITS, UINT32_MAX);
+
+            // leave room at the end so a match never needs to look past the data
+            const uint64_t limit = len > LZ_MIN_MATCH + 8 ? len - LZ_MIN_MATCH - 8 : 0;
+            uint64_t anchor = 0;
+            uint64_t ip = 0;
+
+            while (ip < limit) {
+                uint32_t seq = read32(src + ip);
+                uint32_t & slot = table[(seq * 2654435761u) >> (32 - LZ_HASH_BITS)];
+                uint64_t ref = slot;
+                slot = (uint32_t)ip;
+
+                if (UINT32_MAX == ref || ip - ref > LZ_MAX_OFFSET || read32(src + ref) != seq) {
+                    // step faster through data that does not compress
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
 
-            char * oldpos = pos;
+                uint64_t match = LZ_MIN_MATCH;
+                while (ip + match < len && in[ref + match] == in[ip + match]) ++match;
 
-            // LF terminates the junk, so we check for it at the end
-            while (*pos != '#' && *pos != '@' && *pos != ' ' && *pos != '\t' && *pos != '\r' && *pos != ':' && *pos != '=' && *pos != '[' && *pos != ']' && /*(skipLF ||*/ *pos != '\n'/*)*/) {
-                ++pos;
-            }
+                uint8_t * token = op;
+                op = writeLiterals(op, in + anchor, ip - anchor);
+                *op++ = (uint8_t)(ip - ref);
+                *op++ = (uint8_t)((ip - ref) >> 8);
+                *token |= (uint8_t)PAX_MIN(match - LZ_MIN_MATCH, (uint64_t)15);
+                op = writeLength(op, match - LZ_MIN_MATCH);
 
-            if (skipLF && *pos == '\n') {
-                ++pos;
+                ip += match;
+                anchor = ip;
             }
 
-            if (pos != oldpos) PAX_LOG(3, << "skipped " << (pos - oldpos) << " junk characters");
+            op = writeLiterals(op, in + anchor, len - anchor);
 
-        } // static void skipJunk(char *& pos, bool skipLF = true) {
+            return op - reinterpret_cast<uint8_t*>(dst);
 
+        } // static uint64_t lzCompress(const char * src, uint64_t len, char * dst)
 
 /********************************************************************************************************
- * Advance past the next chunk of junk and whitespace. LF's are skipped if the 2nd arg is true.
- * @param[in,out]   pos     Buffer to be advanced
- * @param[in]       skipLF  optional flag to skip linefeeds
+ * LZ-decompresses one block, checking every length and offset against the buffers.
+ * @param[in]       src     Compressed block
+ * @param[in]       srcLen  Length of the compressed block
+ * @param[out]      dst     Output
+ * @param[in]       dstLen  Size of the output
+ * @return          decompressed length, or -1 if the block is damaged
  *******************************************************************************************************/
-        static void skipJunkAndWS(char *& pos, bool skipLF = true) {
+        static int64_t lzDecompress(const char * src, uint64_t srcLen, char * dst, uint64_t dstLen) {
 
-            skipJunk(pos, skipLF);
-            skipWS(pos, skipLF);
+            const uint8_t * in = reinterpret_cast<const uint8_t*>(src);
+            uint64_t ip = 0;
+            uint64_t op = 0;
 
-        } // static void skipJunkAndWS(char *& pos, bool skipLF = true) {
+            while (ip < srcLen) {
+                const uint8_t token = in[ip++];
 
+                uint64_t literals = token >> 4;
+                if (15 == literals && !readLength(in, srcLen, ip, literals)) return -1;
+                if (literals > srcLen - ip || literals > dstLen - op) return -1;
+                memcpy(dst + op, src + ip, literals);
+                ip += literals;
+                op += literals;
 
-/********************************************************************************************************
- * Advance past whitespace, delimiter, whitespace. LF's are also skipped if the 2nd arg is true.
- * @param[in,out]   pos     Buffer to be advanced
- * @param[in]       skipLF  optional flag to skip linefeeds
- *******************************************************************************************************/
-        static void skipDelimiter(char *& pos, bool skipLF = true) {
-
-            skipWS(++pos, skipLF);
-            while (*pos != ':' && *pos != '=') ++pos;
-            skipWS(++pos, skipLF);
+                if (ip == srcLen) break;    // the last sequence has no match
 
-        } // static void skipDelimiter(char *& pos, bool skipLF = true) {
+                if (srcLen - ip < 2) return -1;
+                const uint64_t offset = in[ip] | (uint64_t)in[ip + 1] << 8;
+                ip += 2;
 
+                uint64_t match = token & 15;
+                if (15 == match && !readLength(in, srcLen, ip, match)) return -1;
+                match += LZ_MIN_MATCH;
+                if (0 == offset || offset > op || match > dstLen - op) return -1;
 
-/********************************************************************************************************
- * Jump Advance junk, whitespace, specified char, whitespace. LF's are skipped if the 2nd arg is true.
- * @param[in]       skipme  character to be skipped
- * @param[in,out]   pos     Buffer to be advanced
- * @param[in]       skipLF  optional flag to skip linefeeds
- *******************************************************************************************************/
-        static void skipChar(const char skipme, char *& pos, const bool skipLF = true) {
+                if (offset >= match) {
+                    memcpy(dst + op, dst + op - offset, match);
+                } else {
+                    // overlapping copy repeats the last offset bytes
+                    for (uint64_t i = 0; i < match; ++i) dst[op + i] = dst[op + i - offset];
+                }
+                op += match;
+            }
 
-            skipJunkAndWS(pos, skipLF);
-            // TODO: failure if next character is not closing brace?
-            if (*pos != skipme) return;
-            skipWS(++pos, skipLF);
+            return (int64_t)op;
 
-        } // static void skipChar(const char skipme, char *& pos, const bool skipLF = true) {
+        } // static int64_t lzDecompress(const char * src, uint64_t srcLen, char * dst, uint64_t dstLen)
 
+    private:
+        static constexpr uint32_t LZ_HASH_BITS = 16;       ///< Size of the match finder's hash table
+        static constexpr uint64_t LZ_MIN_MATCH = 4;        ///< Shortest match worth encoding
+        static constexpr uint64_t LZ_MAX_OFFSET = 65535;   ///< Farthest match the 16-bit offset reaches
 
-/********************************************************************************************************
- * String-insensitive comparison of the internal buffer.
- * @param[in]       str     NULL-terminated string to be compared
- * @return                  true if strings match, false otherwise
- *******************************************************************************************************/
-        bool compare(const char * str) {
+        static uint32_t read32(const char * p) {
+            const uint8_t * b = reinterpret_cast<const uint8_t*>(p);
+            return b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+        }
 
-            // Both strings must be null-terminated for stricmp.
-            int len = (int)strlen(str);
-            TempNull tn(&_pos[len]);
+        static void write32(char * p, uint32_t v) {
+            for (int i = 0; i < 4; ++i) p[i] = (char)(v >> (8 * i));
+        }
 
-            int res = _stricmp(_pos, str);
+        // token holding the literal count, then the literals; the caller adds the match
+        static uint8_t * writeLiterals(uint8_t * op, const uint8_t * literals, uint64_t count) {
+            *op++ = (uint8_t)(PAX_MIN(count, (uint64_t)15) << 4);
+            op = writeLength(op, count);
+            memcpy(op, literals, count);
+            return op + count;
+        }
 
-            PAX_LOG(4, << "result of comparing '" << _pos << "' and '" << str << "': " << res);
+        // bytes extending a length whose nibble is 15
+        static uint8_t * writeLength(uint8_t * op, uint64_t len) {
+            if (len < 15) return op;
+            for (len -= 15; len >= 255; len -= 255) *op++ = 255;
+            *op++ = (uint8_t)len;
+            return op;
+        }
 
-            return res != 0;
+        static bool readLength(const uint8_t * in, uint64_t inLen, uint64_t & ip, uint64_t & len) {
+            uint8_t b;
+            do {
+                if (ip >= inLen) return false;
+                b = in[ip++];
+                len += b;
+            } while (255 == b);
+            return true;
+        }
 
-        } // bool compare(const char * str) {
+    }; // class PaxCodec
 
 
-/***************************************************************************************************
- * Classify the line the internal buffer is currently pointing at.
- * @return                  PAX linetype
- **************************************************************************************************/
-        headerLineType_t getHeaderLineType() {
+/********************************************************************************************************
+ * @class PaxChecksum
+ * CRC32C (Castagnoli) checksums of raster data. On x86-64 processors with SSE4.2 the CRC32 instruction
+ * is used, chosen at run time; elsewhere a portable slicing-by-8 table computes the same values.
+ * Checksums chain: crc32c(b, crc32c(a)) is the checksum of a followed by b.
+ *******************************************************************************************************/
+    class PaxChecksum {
 
-            skipWS(_pos);
-            if ('#' == _pos[0]) {
-                PAX_LOG(3, << "found comment line");
-                return headerLineType_t::COMMENT;
+    public:
+/********************************************************************************************************
+ * Checksums data.
+ * @param[in]       data        Data to checksum
+ * @param[in]       len         Length of the data
+ * @param[in]       crc         Checksum of the data preceding these, if any
+ * @return          CRC32C of the data
+ *******************************************************************************************************/
+        static uint32_t crc32c(const char * data, uint64_t len, uint32_t crc = 0) {
+#ifdef PAX_X86_64
+            if (hardware()) {
+                return ~crc32cSse42(~crc, reinterpret_cast<const uint8_t*>(data), len);
             }
+#endif
+            return crc32cPortable(data, len, crc);
+        }
 
-            if ('@' == _pos[0]) {
-                PAX_LOG(3, << "found metadata line");
-                return headerLineType_t::METADATA;
+/********************************************************************************************************
+ * Checksums data while copying them, a cache-sized chunk at a time, so each byte is read from memory
+ * only once.
+ * @param[out]      dst         Destination of the copy
+ * @param[in]       src         Data to copy and checksum
+ * @param[in]       len         Length of the data
+ * @param[in]       crc         Checksum of the data preceding these, if any
+ * @return          CRC32C of the data
+ *******************************************************************************************************/
+        static uint32_t crc32cCopy(char * dst, const char * src, uint64_t len, uint32_t crc = 0) {
+            constexpr uint64_t chunk = 1u << 14;
+            for (uint64_t done = 0; done < len; done += chunk) {
+                uint64_t n = PAX_MIN(chunk, len - done);
+                crc = crc32c(src + done, n, crc);
+                memcpy(dst + done, src + done, n);
             }
+            return crc;
+        }
 
-            if (!compare(PAX_TAG))      return hlType_t::PAX;
-            if (!compare(BPV_TAG))      return hlType_t::BPV;
-            if (!compare(VPE_TAG))      return hlType_t::VPE;
-            if (!compare(DATALEN_TAG))  return hlType_t::DATALEN;
-
-            // TODO: search for dim tags in generic fashion; for now revert to old 2-dimensional form
-            if (!compare(DIM1_TAG)) {
-                _dimTagIndex = 0;
-                return hlType_t::DIM;
-            }
-            if (!compare(DIM2_TAG)) {
-                _dimTagIndex = 1;
-                return hlType_t::DIM;
+/********************************************************************************************************
+ * Checksums data without the CRC32 instruction.
+ * @param[in]       data        Data to checksum
+ * @param[in]       len         Length of the data
+ * @param[in]       crc         Checksum of the data preceding these, if any
+ * @return          CRC32C of the data
+ *******************************************************************************************************/
+        static uint32_t crc32cPortable(const char * data, uint64_t len, uint32_t crc = 0) {
+            const uint32_t (&t)[8][256] = tables().t;
+            const uint8_t * p = reinterpret_cast<const uint8_t*>(data);
+
+            crc = ~crc;
+            for (; len >= 8; len -= 8, p += 8) {
+                crc ^= (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+                crc = t[7][crc & 0xff] ^ t[6][(crc >> 8) & 0xff] ^ t[5][(crc >> 16) & 0xff] ^ t[4][crc >> 24] ^
+                      t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
             }
-
-            // output a chunk of data upon failure
-            if (PaxStatic::getVerbosity() >= 2) {
-                TempNull tn(_pos + 32);
-                PAX_LOG_ERROR(0, << "Unknown header line: " << _pos);
+            while (len--) {
+                crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
             }
 
-            return hlType_t::UNKNOWN;
-
-        } // headerLineType_t getHeaderLineType () 
-
+            return ~crc;
+        }
 
 /********************************************************************************************************
- * @def GETVAL_DEFAULTSKIP Default skip behavior
+ * Tells whether the CRC32 instruction is used.
+ * @return          true if checksums are computed in hardware
  *******************************************************************************************************/
-#define GETVAL_DEFAULTSKIP skipFlags::SKIP_DELIMITER
+        static bool hardware() {
+#ifdef PAX_X86_64
+            static const bool sse42 = [] {
+#ifdef _MSC_VER
+                int info[4];
+                __cpuid(info, 1);
+                return 0 != (info[2] & (1 << 20));
+#else
+                return 0 != __builtin_cpu_supports("sse4.2");
+#endif
+            }();
+            return sse42;
+#else
+            return false;
+#endif
+        }
 
 /********************************************************************************************************
- * Extract a delimited float from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
+ * Formats a checksum as it is written in a header.
+ * @param[in]       crc         Checksum
+ * @return          The checksum as 0x followed by 8 hex digits
  *******************************************************************************************************/
-        float getFloat(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
-
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
-
-            float val = strtof(_pos, &_pos);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
-
-            PAX_LOG(3, << "read a float from buffer: " << val);
-
-            return val;
-
-        } // float getFloat(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        static std::string toString(uint32_t crc) {
+            char text[11];
+            snprintf(text, sizeof(text), "0x%08X", crc);
+            return text;
+        }
 
+    private:
+        static constexpr uint32_t CRC32C_POLY = 0x82F63B78;    ///< Castagnoli polynomial, bit-reversed
 
-/********************************************************************************************************
- * Extract a delimited double from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
- *******************************************************************************************************/
-        double getDouble(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Tables for slicing-by-8: t[k][b] is the CRC of byte b followed by k zero bytes
+        //
+        struct crcTables {
+            uint32_t t[8][256];
 
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
+            crcTables() {
+                for (uint32_t b = 0; b < 256; ++b) {
+                    uint32_t crc = b;
+                    for (int bit = 0; bit < 8; ++bit) {
+                        crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+                    }
+                    t[0][b] = crc;
+                }
+                for (uint32_t b = 0; b < 256; ++b) {
+                    for (int k = 1; k < 8; ++k) {
+                        t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xff];
+                    }
+                }
+            }
+        };
 
-            double val = strtod(_pos, &_pos);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
+        static const crcTables & tables() {
+            static const crcTables tables;
+            return tables;
+        }
 
-            PAX_LOG(3, << "read a double from buffer: " << val);
+#ifdef PAX_X86_64
+        PAX_TARGET("sse4.2")
+        static uint32_t crc32cSse42(uint32_t crc, const uint8_t * p, uint64_t len) {
+            for (; len >= 8; len -= 8, p += 8) {
+                uint64_t v;
+                memcpy(&v, p, 8);
+                crc = (uint32_t)_mm_crc32_u64(crc, v);
+            }
+            while (len--) {
+                crc = _mm_crc32_u8(crc, *p++);
+            }
+            return crc;
+        }
+#endif
 
-            return val;
+    }; // class PaxChecksum
 
-        } // double getDouble(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
 
 
 /********************************************************************************************************
- * Extract a delimited int64 from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
+ * @enum metaLoc
+ * standard metadata locations
  *******************************************************************************************************/
-        int64_t getInt64(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
-
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
-
-            int64_t val = strtoll(_pos, &_pos, 0);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
+    typedef enum metaLoc {
+        LOC_UNKNOWN = -1,   ///< Unknown or invalid location
+        LOC_BEGIN = 0,      ///< Beginning of file
+        LOC_AFTER_TAG = 0,  ///< immediately after PAX tag
+        LOC_AFTER_BPV = 1,  ///< after bytes per value tag
+        LOC_AFTER_VPE = 2,  ///< after values per element tag
+        LOC_AFTER_SEQ = 3,  ///< after sequential dimension tag
+        LOC_AFTER_STR1 = 4, ///< after strided dimension tag
+        LOC_END = 4,        ///< at end of file (before DATA_LENGTH tag)
+        LOC_DEFAULT = 4,    ///< default location
+        LOC_COUNT = 5       ///< number of defined locations
+    } metaLoc_e;
 
-            PAX_LOG(3, << "read an int64_t from buffer: " << val);
+    //////////////////////////////////////////////////////////////////////////
+    //
+    // helper function to get size of meta type
+    //
+    static size_t getMetaDataTypeSize(paxMetaDataTypes_e type) {
 
-            return val;
+        size_t size = 0;
 
-        } // int64_t getInt64(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        switch (type) {
 
+        case paxMetaDataTypes::paxDouble:
+        case paxMetaDataTypes::paxInt64:
+        case paxMetaDataTypes::paxUint64:
+            size = 8; break;
 
-/********************************************************************************************************
- * Extract a delimited uint64 from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
- *******************************************************************************************************/
-        uint64_t getUint64(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        case paxMetaDataTypes::paxFloat:
+        case paxMetaDataTypes::paxInt32:
+        case paxMetaDataTypes::paxUint32:
+            size = 4; break;
 
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
+        case paxMetaDataTypes::paxInt16:
+        case paxMetaDataTypes::paxUint16:
+            size = 2; break;
 
-            uint64_t val = strtoull(_pos, &_pos, 0);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
+        case paxMetaDataTypes::paxInt8:
+        case paxMetaDataTypes::paxUint8:
+            size = 1; break;
 
-            PAX_LOG(3, << "read a uint64_t from buffer: " << val);
+        default:
+            break;
 
-            return val;
+        } // switch (type)
 
-        } // uint64_t getUint64(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        // this shouldn't be called with non-numeric types
+        if (0 == size) {
+            PAX_LOG_ERROR(1, << "called getMetaDataTypeSize with invalid type = " << (int)type);
+        }
 
+        return size;
 
-/********************************************************************************************************
- * Extract a delimited int32 from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
- *******************************************************************************************************/
-        int32_t getInt32(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+    } // size_t getMetaDataTypeSize (paxMetaDataTypes_e type) 
 
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
 
-            int32_t val = strtol(_pos, &_pos, 0);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
+/********************************************************************************************************
+ * @class PaxMetaArena
+ * Append-only storage for metadata strings and array payloads. Small allocations are packed into shared
+ * chunks, so a file's metadata costs a few chunks instead of one heap block per value. Nothing is freed
+ * until the arena itself is destroyed. Owners report payloads they no longer use with release(), and
+ * move their live payloads to a fresh arena once needsCompaction() says most of this one is garbage.
+ *******************************************************************************************************/
+    class PaxMetaArena {
 
-            PAX_LOG(3, << "read an int32_t from buffer: " << val);
+    public:
+        static constexpr size_t CHUNK_SIZE{ 4096 };     ///< Default chunk size
+        static constexpr size_t ALIGNMENT{ 8 };         ///< Alignment of every allocation
 
-            return val;
+/********************************************************************************************************
+ * Number of arena bytes taken by an allocation of the given size.
+ * @param[in]       bytes   Number of bytes requested
+ * @return                  Bytes consumed, including alignment padding
+ *******************************************************************************************************/
+        static size_t footprint(const size_t bytes) {
 
-        } // int32_t getInt32(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+            return (PAX_MAX(bytes, (size_t)1) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
 
+        } // static size_t footprint(const size_t bytes)
 
 /********************************************************************************************************
- * Extract a delimited uint32 from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
+ * Allocate uninitialized storage from the arena.
+ * @param[in]       bytes   Number of bytes needed
+ * @return                  Pointer to 8-byte aligned storage
  *******************************************************************************************************/
-        uint32_t getUint32(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        char * alloc(const size_t bytes) {
 
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
+            size_t len = footprint(bytes);
 
-            uint32_t val = strtoul(_pos, &_pos, 0);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
+            // large payloads get a chunk of their own so the current chunk keeps its free space
+            if (len > CHUNK_SIZE / 4) {
+                _chunks.emplace_back(new char[len]);
+                _bytes += len;
+                return _chunks.back().get();
+            }
 
-            PAX_LOG(3, << "read a uint32_t from buffer: " << val);
+            if (_used + len > _capacity) {
+                _chunks.emplace_back(new char[CHUNK_SIZE]);
+                _head = _chunks.back().get();
+                _used = 0;
+                _capacity = CHUNK_SIZE;
+                _bytes += CHUNK_SIZE;
+            }
 
-            return val;
+            char * ptr = _head + _used;
+            _used += len;
 
-        } // uint32_t getUint32(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+            return ptr;
 
+        } // char * alloc(const size_t bytes)
 
 /********************************************************************************************************
- * Extract a delimited int16 from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
+ * Store a NULL-terminated copy of a string.
+ * @param[in]       str     Source characters (need not be NULL-terminated)
+ * @param[in]       len     Number of characters to copy
+ * @return                  Pointer to the stored copy
  *******************************************************************************************************/
-        int16_t getInt16(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        char * intern(const char * str, const size_t len) {
 
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
+            char * ptr = alloc(len + 1);
+            memcpy(ptr, str, len);
+            ptr[len] = '\0';
 
-            int16_t val = (int16_t)strtol(_pos, &_pos, 0);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
+            return ptr;
 
-            PAX_LOG(3, << "read an int16_t from buffer: " << val);
+        } // char * intern(const char * str, const size_t len)
 
-            return val;
+/********************************************************************************************************
+ * Total bytes reserved by the arena.
+ * @return                  Number of bytes held in chunks
+ *******************************************************************************************************/
+        size_t bytes() const { return _bytes; }
 
-        } // int16_t getInt16(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+/********************************************************************************************************
+ * Record that an allocation is no longer used. The storage stays reserved until the arena goes away.
+ * @param[in]       bytes   Footprint of the abandoned allocation
+ *******************************************************************************************************/
+        void release(const size_t bytes) { _released += bytes; }
 
+/********************************************************************************************************
+ * Total bytes reported through release().
+ * @return                  Number of abandoned bytes
+ *******************************************************************************************************/
+        size_t released() const { return _released; }
 
 /********************************************************************************************************
- * Extract a delimited uint16 from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
+ * Whether abandoned payloads make up most of the arena, so copying the live ones out is worthwhile.
+ * @return                  true if the owner should compact
  *******************************************************************************************************/
-        uint16_t getUint16(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        bool needsCompaction() const { return _bytes > CHUNK_SIZE && 2 * _released > _bytes; }
 
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
+    private:
+        std::vector<std::unique_ptr<char[]>> _chunks;   ///< All chunks, freed with the arena
+        char *          _head{ NULL };          ///< Chunk currently being filled
+        size_t          _used{ 0 };             ///< Bytes used in the current chunk
+        size_t          _capacity{ 0 };         ///< Size of the current chunk
+        size_t          _bytes{ 0 };            ///< Bytes reserved over all chunks
+        size_t          _released{ 0 };         ///< Bytes abandoned by their owners
 
-            uint16_t val = (uint16_t)strtoul(_pos, &_pos, 0);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
+    }; // class PaxMetaArena
 
-            PAX_LOG(3, << "read a uint16_t from buffer: " << val);
+    using paxMetaArenaPtr = std::shared_ptr<PaxMetaArena>;    ///< Type alias for shared metadata arena
 
-            return val;
 
-        } // uint16_t getUint16(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+/********************************************************************************************************
+ * @class PaxMetaName
+ * Metadata name interned in a process-wide table. Each distinct name is stored once however many files
+ * carry it, and a handle is a single pointer, so equality and hashing never touch the characters.
+ * Handles convert to and from std::string. Constructing a handle interns the name, so only names that
+ * are stored get constructed; lookups go through lookup(), which never adds to the table. Interned names
+ * are never released; files share a small vocabulary of names, so the table stays small.
+ *******************************************************************************************************/
+    class PaxMetaName {
 
+    public:
 
 /********************************************************************************************************
- * Extract a delimited int8 from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
+ * Hash functor for unordered containers keyed by name
  *******************************************************************************************************/
-        int8_t getInt8(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        struct hash {
+            size_t operator()(const PaxMetaName & name) const { return std::hash<const std::string*>()(name._name); }
+        };
 
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
+        PaxMetaName() : _name(&intern(std::string_view())) { }
+        PaxMetaName(const std::string & name) : _name(&intern(name)) { }
+        PaxMetaName(const char * name) : _name(&intern(name)) { }
 
-            int8_t val = (int8_t)strtol(_pos, &_pos, 0);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
+        operator const std::string & () const { return *_name; }
+        const std::string & str() const { return *_name; }
+        const char * c_str() const { return _name->c_str(); }
+        size_t length() const { return _name->length(); }
+        bool empty() const { return _name->empty(); }
 
-            PAX_LOG(3, << "read an int8_t from buffer: " << val);
+        bool operator==(const PaxMetaName & rhs) const { return _name == rhs._name; }
+        bool operator!=(const PaxMetaName & rhs) const { return _name != rhs._name; }
+        bool operator<(const PaxMetaName & rhs) const { return *_name < *rhs._name; }
 
-            return val;
+        friend std::ostream & operator<<(std::ostream & os, const PaxMetaName & name) { return os << *name._name; }
 
-        } // int8_t getInt8(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+/********************************************************************************************************
+ * Find a name without interning it.
+ * @param[in]       name    Name to look up
+ * @return                  The interned handle, or one that equals no interned name if the name is unknown
+ *******************************************************************************************************/
+        static PaxMetaName lookup(std::string_view name) {
+
+            static const std::string unknown;
+
+            nameTable_t & table = names();
+            std::shared_lock<std::shared_mutex> reader(table.lock);
+            auto iter = table.names.find(name);
+
+            return PaxMetaName(table.names.end() == iter ? &unknown : iter->second.get());
 
+        } // static PaxMetaName lookup(std::string_view name)
 
 /********************************************************************************************************
- * Extract a delimited uint8 from the internal buffer.
- * @param[in]       skip    skip behavior
- * @return                  extracted value
+ * Number of names interned so far.
+ * @return                  Size of the process-wide table
  *******************************************************************************************************/
-        uint8_t getUint8(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+        static size_t count() {
 
-            if (skip & skipFlags::SKIP_DELIMITER) {
-                skipDelimiter(_pos);
-            } // else: strto* extracts WS so we don't need to
+            nameTable_t & table = names();
+            std::shared_lock<std::shared_mutex> reader(table.lock);
 
-            uint8_t val = (uint8_t)strtoul(_pos, &_pos, 0);
-            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED));  // whitespace or LF required after value.
+            return table.names.size();
 
-            PAX_LOG(3, << "read a uint8_t from buffer: " << val);
+        } // static size_t count()
 
-            return val;
+    private:
 
-        } // uint8_t getUint8(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+/********************************************************************************************************
+ * @struct nameTable_t
+ * Interned names keyed by their own characters, so lookups need no temporary string
+ *******************************************************************************************************/
+        struct nameTable_t {
+            std::shared_mutex lock;
+            std::unordered_map<std::string_view, std::unique_ptr<std::string>> names;
+        };
 
+        explicit PaxMetaName(const std::string * name) : _name(name) { }
+
+        static nameTable_t & names() {
+            static nameTable_t table;
+            return table;
+        }
 
 /********************************************************************************************************
- * Extract an name/metadata pair from the buffer.
- * @return                  pair containing name and meta
+ * Find or add a name in the table. Lookups of known names only take the lock shared.
+ * @param[in]       name    Name to intern
+ * @return                  The table's copy, valid for the life of the process
  *******************************************************************************************************/
-        std::pair <std::string, meta_t> getMeta() {
+        static const std::string & intern(std::string_view name) {
 
-            meta_t meta1;
-            std::string name;
-            static std::pair <std::string, meta_t> badMeta{ "", meta_t{} };
+            nameTable_t & table = names();
 
-            // our current pos should be at the "#" or "##"
-            if ('#' != *_pos && '@' != *_pos) {
-                PAX_LOG_ERROR(1, << "Attempted to extract metadata but no marker found.");
-                return badMeta;
+            {
+                std::shared_lock<std::shared_mutex> reader(table.lock);
+                auto iter = table.names.find(name);
+                if (table.names.end() != iter) return *iter->second;
             }
 
-            char * pos = _pos;
+            std::unique_lock<std::shared_mutex> writer(table.lock);
+            auto iter = table.names.find(name);
+            if (table.names.end() != iter) return *iter->second;
 
-            if ('#' == *pos) {
-                ///////////////////////////////////////////////////////////////////////////
-                // read the comment
-                //
-                char * eol = strchr(pos, '\n');
+            std::unique_ptr<std::string> stored(new std::string(name));
+            std::string_view key(*stored);
+            return *table.names.emplace(key, std::move(stored)).first->second;
 
-                // check for buffer overrun
-                if (eof(eol)) {
-                    PAX_LOG_ERROR(1, << "Unexpected EOF reading PAX buffer. This may be expected if previewing a long header.");
-                    return badMeta;
-                }
+        } // static const std::string & intern(std::string_view name)
 
-                name = meta::getCommentName(_metaLoc, _metaIdx);
+        const std::string * _name;      ///< Interned characters
 
-                int len = (int)(eol - pos);
-                if (len >= PAX_MAX_METADATA_STRING_LENGTH) len = PAX_MAX_METADATA_STRING_LENGTH - 1;
-                if (pos[len - 1] == '\r') --len;
+    }; // class PaxMetaName
 
-                // trim the leading space if it is there
-                if (' ' == pos[0]) {
-                    ++pos;
-                    --len;
-                    meta1.stripped = true;
-                }
 
-                meta1.type = paxMetaDataTypes_e::paxComment;
-                meta1.s[0] = '\0';
-                pax_strncat(meta1.s, pos, len);
+/********************************************************************************************************
+ * @struct meta
+ * structure for storing metadata. Scalars are held in an 8-byte slot; strings and arrays live in a
+ * PaxMetaArena, usually the one of the file holding the meta. A copy gets its own storage, so it can be
+ * changed without affecting the source; a move takes the storage over. The name is not stored here; it
+ * is the interned PaxMetaName keying the map holding the meta.
+ * note: must be kept in sync with metaTypeTags in BufMan::getMeta() and the meta defines above
+ *******************************************************************************************************/
+/********************************************************************************************************
+ * @typedef meta meta_t
+ * Alias for meta structure
+ *******************************************************************************************************/
+    typedef struct meta {
 
-                // set buffer pointer past end of line
-                _pos = eol + 1;
+        metaLoc_e           loc;        ///< index of location within file
+        paxMetaDataTypes_e  type;       ///< metadata type
+        size_t              index;      ///< index within location
+        uint8_t             num_dims;   ///< number of dimensions. Use num_dims = 0 for scalar data.
+        bool                stripped;   ///< leading space was stripped off
 
-            } else {
-                ///////////////////////////////////////////////////////////////////////////
-                // metadata
-                //
-                ++pos; // skip the marker
-                skipChar('[', pos);  // skip past the opening brace
-                meta1.type = paxMetaDataTypes_e::paxInvalid;
-                char typeTag[METATYPE_MAX_TAG_LEN + 1];
+/********************************************************************************************************
+ * @union <unnamed>
+ * for storing scalar data
+ *******************************************************************************************************/
+        union {
+            float     f;
+            double    d;
+            uint64_t  u64;
+            int64_t   n64;
+            uint32_t  u32;
+            int32_t   n32;
+            uint16_t  u16;
+            int16_t   n16;
+            uint8_t   u8;
+            int8_t    n8;
+        };
 
-                // extract and identify the type
-                for (int i = (int)paxMetaDataTypes::paxMetaStart; i <= (int)paxMetaDataTypes::paxMetaEnd; ++i) {
+        uint32_t *          dims;       ///< dimensions array (in arena)
 
-                    paxMetaDataTypes_e type = (paxMetaDataTypes_e)i;
-                    const char * tag = PaxStatic::getMetaTypeTag(type);
-                    TempNull tn(pos + strlen(tag));
+/********************************************************************************************************
+ * @union <unnamed>
+ * for storing string and array data (in arena)
+ *******************************************************************************************************/
+        union {
+            char *            s;
+            char *            buf;
+            float *           fb;
+            double *          db;
+            uint64_t *        u64b;
+            int64_t *         n64b;
+            uint32_t *        u32b;
+            int32_t *         n32b;
+            uint16_t *        u16b;
+            int16_t *         n16b;
+            uint8_t *         u8b;
+            int8_t *          n8b;
+        };
 
-                    if (0 == _stricmp(tag, pos)) {
+        paxMetaArenaPtr     arena;      ///< owner of the string/array storage
 
-                        meta1.type = type;
-                        pax_strcpy(typeTag, pos);
-                        PAX_LOG(4, << "Metadata type match! " << pos << " = type " << (int)meta1.type);
-                        tn.restore();
-                        skipChar(']', pos);
+/********************************************************************************************************
+ * Empty string shared by all metas without string storage
+ * @return                  pointer to a NULL character
+ *******************************************************************************************************/
+        static char * emptyString() {
+            static char empty[1] = { '\0' };
+            return empty;
+        }
 
-                        break;
 
-                    }
+/********************************************************************************************************
+ * @name Construction/destruction
+ *******************************************************************************************************/
+///@{
+/********************************************************************************************************
+ * Default Ctor
+ *******************************************************************************************************/
+        meta() :
+            loc(LOC_UNKNOWN),
+            type{ paxMetaDataTypes_e::paxInvalid },
+            index{ 0 },
+            num_dims{ 0 },
+            stripped{ false },
+            d{ 0.0 },
+            dims{ NULL },
+            s{ emptyString() }
+        { }
 
-                }
+/********************************************************************************************************
+ * Ctor with type and initializers
+ * @param[in]       _type type of the metadata
+ * @param[in]       list initializer_list used to construct std::vector
+ *******************************************************************************************************/
+        meta(const paxMetaDataTypes_e _type, std::initializer_list<uint32_t> list) : meta()
+        {
 
-                // bad metadata type
-                if (paxMetaDataTypes_e::paxInvalid == meta1.type) {
+            initArray(_type, list);
 
-                    TempNull tn(pos + strlen(METATYPE_DOUBLE_TAG));
-                    PAX_LOG_ERROR(0, << "Metadata type not found: " << pos);
-                    skipLine(_pos);
+        }
 
-                    return badMeta;
-
-                }
-
-                // Read the meta name. Whitespace, delimiter, or opening brace stops the search.
-                int len = 0;
-                while (pos[len] != ' ' && pos[len] != '\t' && pos[len] != ':' && pos[len] != '=' && pos[len] != '[') {
-                    ++len;
-                }
+/********************************************************************************************************
+ * Ctor with type and dimensions
+ * @param[in]       _type type of the metadata
+ * @param[in]       _dims dimensions of metadata array
+ *******************************************************************************************************/
+        meta(const paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims) : meta()
+        {
 
-                name.append(pos, len);
-                PAX_LOG(3, << "Metadata name is " << name.c_str() << ", type is " << (int)meta1.type);
+            initArray(_type, _dims);
 
-                _pos = pos + len; // skip the name, swich back to internal buffer pointer
-                skipWS(_pos);
+        } //         meta(const paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims) :
 
-                size_t values = 1;
-                // Check for an array
-                if ('[' == _pos[0]) {
-                    skipWS(++_pos); // skip the opening brace and WS
 
-                    // search for indexes in order
-                    static const char * metaArrayIndexTags[METAARRAYINDEXES] = {
-                      METAARRAYINDEX_FIRST_TAG,
-                      METAARRAYINDEX_SECOND_TAG,
-                      METAARRAYINDEX_THIRD_TAG,
-                      METAARRAYINDEX_FOURTH_TAG
-                    };
+/********************************************************************************************************
+ * Ctor with type, initializers, and data
+ * @param[in]       _type type of the metadata
+ * @param[in]       list initializer_list used to construct std::vector
+ * @param[in]       data Buffer containing the initial data (must be correct size!)
+ *******************************************************************************************************/
+        meta(paxMetaDataTypes_e _type, std::initializer_list<uint32_t> list, const void* data) : meta()
+        {
 
-                    std::vector<uint32_t> dims;
-                    int indexes = 0;
+            initArray(_type, list, data);
 
-                    for (int i = 0; i < METAARRAYINDEXES; ++i) {
+        } //         meta(paxMetaDataTypes_e _type, std::initializer_list<uint32_t> list, const void* data) :
 
-                        const char * tag = PaxStatic::getMetaArrayIndexTag(i);
-                        TempNull tn(_pos + strlen(tag));
 
-                        if (0 == pax_stricmp(tag, _pos)) {
-                          // found the ith index; skip to value
-                            tn.restore();
-                            uint32_t dim = getUint32();
-                            PAX_LOG(4, << "    (meta array) " << std::setw(6) << tag << " dim = " << dim);
-                            dims.push_back(dim);
-                        } else {
-                            break;
-                        }
-                    }
+/********************************************************************************************************
+ * Ctor with type, initializers, and data
+ * @param[in]       _type type of the metadata
+ * @param[in]       _dims dimensions of metadata array
+ * @param[in]       data Buffer containing the initial data (must be correct size!)
+ *******************************************************************************************************/
+        meta(paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims, const void* data) : meta()
+        {
 
-                    skipChar(']', _pos); // skip any extra stuff in the index list
+            initArray(_type, _dims, data);
 
-                    values = meta1.initArray(meta1.type, dims);
+        } //    meta(paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims, const void* data)
 
-                } // if ('[' == pos[0]) (meta array input)
+/********************************************************************************************************
+ * Copy Ctor. The string/array storage is copied into a new arena.
+ * @param[in]       _meta The source meta
+ *******************************************************************************************************/
+        meta(const meta & _meta) : meta()
+        {
 
-                while (*_pos != ':' && *_pos != '=') ++_pos;    // skip the delimiter ':' or '='
-                ++_pos;
-                char *eol;
+            clone(_meta);
 
-                // Should be pointing at the data now (or perhaps whitespace)
-                if (1 == values) {
+        }
 
-                    switch (meta1.type) {
+/********************************************************************************************************
+ * Move Ctor. Takes over the string/array storage and leaves the source empty.
+ * @param[in]       _meta The source meta
+ *******************************************************************************************************/
+        meta(meta && _meta) noexcept : meta()
+        {
 
-                    case paxMetaDataTypes_e::paxString:
-                        eol = strchr(_pos, '\n');
-                        len = (int)(eol - _pos);
-                        if (len >= PAX_MAX_METADATA_STRING_LENGTH) len = PAX_MAX_METADATA_STRING_LENGTH - 1;
-                        if (_pos[len - 1] == '\r') len--;
+            take(_meta);
 
-                        // trim the leading space if it is there
-                        if (' ' == _pos[0]) {
-                            ++_pos;
-                            --len;
-                            meta1.stripped = true;
-                        }
+        }
 
-                        meta1.s[0] = '\0';
-                        pax_strncat(meta1.s, _pos, len);
+/********************************************************************************************************
+ * Copy assignment. The string/array storage is copied into a new arena.
+ * @param[in]       _meta The source meta
+ * @return                  this meta
+ *******************************************************************************************************/
+        meta & operator=(const meta & _meta) {
 
-                        // set buffer pointer at end of this line
-                        _pos = eol;
-                        break;
+            if (this != &_meta) {
+                clone(_meta);
+            }
 
-                    case paxMetaDataTypes_e::paxFloat:
-                        meta1.f = getFloat(skipFlags::SKIP_NOTHING);
-                        break;
+            return *this;
 
-                    case paxMetaDataTypes_e::paxDouble:
-                        meta1.d = getDouble(skipFlags::SKIP_NOTHING);
-                        break;
+        } // meta & operator=(const meta & _meta)
 
-                    case paxMetaDataTypes_e::paxInt64:
-                    case paxMetaDataTypes_e::paxInt32:
-                    case paxMetaDataTypes_e::paxInt16:
-                    case paxMetaDataTypes_e::paxInt8:
-                        // read and store as 64-bit and trust the user to call the right accessor fn
-                        meta1.n64 = getInt64(skipFlags::SKIP_NOTHING);
-                        break;
+/********************************************************************************************************
+ * Move assignment. Takes over the string/array storage and leaves the source empty.
+ * @param[in]       _meta The source meta
+ * @return                  this meta
+ *******************************************************************************************************/
+        meta & operator=(meta && _meta) noexcept {
 
-                    case paxMetaDataTypes_e::paxUint64:
-                    case paxMetaDataTypes_e::paxUint32:
-                    case paxMetaDataTypes_e::paxUint16:
-                    case paxMetaDataTypes_e::paxUint8:
-                        // read and store as 64-bit and trust the user to call the right accessor fn
-                        meta1.u64 = getUint64(skipFlags::SKIP_NOTHING);
-                        break;
+            if (this != &_meta) {
+                take(_meta);
+            }
 
-                    default:
-                        PAX_LOG_ERROR(1, << "I don't know how to import metadata of type " << typeTag << "yet! skipping it...");
-                        skipJunkAndWS(_pos, false);
-                        break;
-                    }
+            return *this;
 
-                } else {
+        } // meta & operator=(meta && _meta)
+///@}
 
-                    // KLUDGE: skip LF's as data is read in, then roll back one char
-                    for (size_t i = 0; i < values; ++i) {
 
-                        // all types should leave the buffer pointer at the beginning of the next element or the end of the line
-                        switch (meta1.type) {
+/********************************************************************************************************
+ * Performs a deep copy of the given meta.
+ * @param[in]       _meta   The source meta
+ * @param[in]       _arena  Arena receiving the string/array storage, or NULL for a new one
+ *******************************************************************************************************/
+        void clone(const meta& _meta, const paxMetaArenaPtr & _arena = nullptr) {
+
+            loc = _meta.loc;
+            type = _meta.type;
+            index = _meta.index;
+            num_dims = _meta.num_dims;
+            stripped = _meta.stripped;
+            u64 = _meta.u64;
+            dims = _meta.dims;
+            buf = _meta.buf;
+
+            // still pointing at the source's storage, so rehome copies it
+            arena = nullptr;
+            if (hasPayload()) {
+                rehome(nullptr != _arena ? _arena : std::make_shared<PaxMetaArena>());
+            } else {
+                arena = _arena;
+            }
 
-                        case paxMetaDataTypes_e::paxFloat:
-                            meta1.fb[i] = getFloat(skipFlags::SKIP_NOTHING);
-                            break;
+            PAX_LOG(3, << "cloned meta, num_dims = " << num_dims << ", bytes = " << bytes() << ". Status = " << PaxStatic::getStatus());
 
-                        case paxMetaDataTypes_e::paxDouble:
-                            meta1.db[i] = getDouble(skipFlags::SKIP_NOTHING);
-                            break;
+        } // void clone (const meta& _meta, const paxMetaArenaPtr & _arena)
 
-                        case paxMetaDataTypes_e::paxInt64:
-                            meta1.n64b[i] = getInt64(skipFlags::SKIP_NOTHING);
-                            break;
 
-                        case paxMetaDataTypes_e::paxInt32:
-                            meta1.n32b[i] = getInt32(skipFlags::SKIP_NOTHING);
-                            break;
+/********************************************************************************************************
+ * Takes over the given meta's storage and leaves it empty.
+ * @param[in]       _meta   The source meta
+ *******************************************************************************************************/
+        void take(meta & _meta) {
 
-                        case paxMetaDataTypes_e::paxInt16:
-                            meta1.n16b[i] = getInt16(skipFlags::SKIP_NOTHING);
-                            break;
+            loc = _meta.loc;
+            type = _meta.type;
+            index = _meta.index;
+            num_dims = _meta.num_dims;
+            stripped = _meta.stripped;
+            u64 = _meta.u64;
+            dims = _meta.dims;
+            buf = _meta.buf;
+            arena = std::move(_meta.arena);
 
-                        case paxMetaDataTypes_e::paxInt8:
-                            meta1.n8b[i] = getInt8(skipFlags::SKIP_NOTHING);
-                            break;
+            _meta.type = paxMetaDataTypes_e::paxInvalid;
+            _meta.num_dims = 0;
+            _meta.dims = NULL;
+            _meta.s = emptyString();
+            _meta.arena = nullptr;
 
-                        case paxMetaDataTypes_e::paxUint64:
-                            meta1.u64b[i] = getUint64(skipFlags::SKIP_NOTHING);
-                            break;
+        } // void take(meta & _meta)
 
-                        case paxMetaDataTypes_e::paxUint32:
-                            meta1.u32b[i] = getUint32(skipFlags::SKIP_NOTHING);
-                            break;
 
-                        case paxMetaDataTypes_e::paxUint16:
-                            meta1.u16b[i] = getUint16(skipFlags::SKIP_NOTHING);
-                            break;
+/********************************************************************************************************
+ * Whether a string or array payload is stored in the arena.
+ * @return                  true if there is arena storage
+ *******************************************************************************************************/
+        bool hasPayload() {
 
-                        case paxMetaDataTypes_e::paxUint8:
-                            meta1.u8b[i] = getUint8(skipFlags::SKIP_NOTHING);
-                            break;
+            return isArray() || (emptyString() != s && (paxMetaDataTypes_e::paxString == type || paxMetaDataTypes_e::paxComment == type));
 
-                        default:
-                            PAX_LOG_ERROR(1, << "I don't know how to import array metadata of type " <<
-                                typeTag << "yet! skipping it...");
-                            skipJunkAndWS(_pos);
-                            break;
-                        }
-                    } // for (size_t i = 0; i < values; ++i) {
+        } // bool hasPayload()
 
-                } // if (...) : reading array data
 
-                skipLine(_pos);
+/********************************************************************************************************
+ * Moves the string/array storage into the given arena, unless it is already there.
+ * @param[in]       _arena  Destination arena
+ *******************************************************************************************************/
+        void rehome(const paxMetaArenaPtr & _arena) {
 
-            } // reading metadata
+            if (arena == _arena) {
+                return;
+            }
 
-            meta1.loc   = _metaLoc;
-            meta1.index = _metaIdx;
-            meta1.name  = std::move(name);
-            ++_metaIdx;
+            if (isArray()) {
+                uint32_t * _dims = reinterpret_cast<uint32_t*>(_arena->alloc(num_dims * sizeof(uint32_t)));
+                memcpy(_dims, dims, num_dims * sizeof(uint32_t));
+                char * _buf = _arena->alloc(bytes());
+                memcpy(_buf, buf, bytes());
+                dims = _dims;
+                buf = _buf;
+            } else if (emptyString() != s && (paxMetaDataTypes_e::paxString == type || paxMetaDataTypes_e::paxComment == type)) {
+                s = _arena->intern(s, strlen(s));
+            }
 
-            return { meta1.name, meta1 };
+            arena = _arena;
 
-        }   // std::pair <std::string, meta_t>&& getMeta() {
+        } // void rehome(const paxMetaArenaPtr & _arena)
 
 
 /********************************************************************************************************
- * Copy binary raster data to the given buffer.
- * @param[out]      buf     User-supplied output buffer
- * @param[in]       len     bytes to be copied
- * @return                  number of bytes copied
+ * Arena bytes held by the string/array storage.
+ * @return                  Footprint in the arena, 0 if nothing is stored there
  *******************************************************************************************************/
-        size_t copyData(char * buf, const size_t len)   {
-
-            ptrdiff_t remain = _len - (_pos - _start);
-            if (len > static_cast<size_t>(remain)) {
-
-                PAX_LOG_ERROR(1, << " insufficient buffer length. " << remain << " bytes remain but " <<
-                    len << " requested");
+        size_t footprint() {
 
+            if (nullptr == arena) {
                 return 0;
+            } else if (isArray()) {
+                return PaxMetaArena::footprint(num_dims * sizeof(uint32_t)) + PaxMetaArena::footprint(bytes());
+            } else if (emptyString() != s && (paxMetaDataTypes_e::paxString == type || paxMetaDataTypes_e::paxComment == type)) {
+                return PaxMetaArena::footprint(strlen(s) + 1);
             }
 
-            memcpy(buf, _pos, len);
-            _pos += len;
-            PAX_LOG(2, << "copied " << len << " bytes of raster data from buffer. " << remain - len <<
-                " bytes remaining.");
-
-            return len;
+            return 0;
 
-        } // size_t copyData(char * buf, const size_t len)
+        } // size_t footprint()
 
 
 /********************************************************************************************************
- * Direct access to the internal buffer.
- * @return                  reference to the internal buffer
+ * Stores a string value, truncated to PAX_MAX_METADATA_STRING_LENGTH - 1 characters.
+ * @param[in]       str     Source characters (need not be NULL-terminated)
+ * @param[in]       len     Number of characters
  *******************************************************************************************************/
-        char *& pos() { return _pos; }
-
+        void setString(const char * str, size_t len) {
 
-/********************************************************************************************************
- * Get the current buffer offset
- * @return                  Internal buffer position in bytes
- *******************************************************************************************************/
-        size_t offset() {
-            if (_start > _pos) {
-                PaxStatic::setStatus(PAX_FAIL);
-                return 0;
-            }
+            if (len >= PAX_MAX_METADATA_STRING_LENGTH) len = PAX_MAX_METADATA_STRING_LENGTH - 1;
+            if (nullptr == arena) arena = std::make_shared<PaxMetaArena>();
 
-            return _pos - _start;
+            s = arena->intern(str, len);
 
-        } // size_t offset() {
+        } // void setString(const char * str, size_t len)
 
 
 /********************************************************************************************************
- * Temporary buffer access
- * @return                  Pointer to internal buffer
+ * Initializes the object for array storage of the given dims and type.
+ * @param[in]       _type   Type of the metadata
+ * @param[in]       _dims   Dimensions of the metadata array
+ * @param[in]       data    Input data
+ * @return                  The total number of metadata elements
  *******************************************************************************************************/
-        char * operator()() { return _pos; }
+        size_t initArray(paxMetaDataTypes_e _type, std::vector<uint32_t> &_dims, const void* data = NULL) {
 
+            int status = PaxStatic::getStatus();
+            PAX_LOG(3, << "allocating meta array, initial status = " << status);
 
-/********************************************************************************************************
- * Direct byte-by-byte data access.
- * @param[in]       pos     Desired offset
- * @return                  Reference to the byte at requested buffer offset
- *******************************************************************************************************/
-        char &operator[](const size_t pos) { return _pos[pos]; }
+            size_t _count = 1;
+            for (auto dim : _dims) { _count *= dim; }
 
-/********************************************************************************************************
- * Artificially truncates the buffer if applicable. Throws warning if buffer is not long enough.
- * @param[in]       pos     Desired buffer length
- * @return                  Resulting buffer length
- *******************************************************************************************************/
-        size_t truncate(const size_t pos) {
+            // cases that are not an array
+            if (_type < paxMetaDataTypes::paxNumericStart || _type > paxMetaDataTypes::paxNumericEnd || 1 >= _count) {
 
-            if (_len >= pos) {
-                _len = pos;
-            } else {
-                PAX_LOG_WARN(2, << "Tried to truncate a PAX buffer that is not long enough.");
-            }
+                num_dims = 0;
+                s = emptyString();
+                dims = NULL;
 
-            return _len;
+                PAX_LOG_WARN(3, << "Tried to initialize a meta array with invalid meta type = " << (int)_type << " and/or scalar data. count = " << _count);
 
-        } // size_t truncate(const size_t pos) {
+                return 1;
 
+            }
 
-/********************************************************************************************************
- * Returns the last detected dimension index
- * @param[in]       pos     Desired buffer length
- * @return                  Resulting buffer length
- *******************************************************************************************************/
-        size_t getDimTagIndex() {
+            status = PaxStatic::getStatus();
+            PAX_LOG(4, << "allocating meta array, status after checking array = " << status);
 
-            return _dimTagIndex;
+            size_t _size = getMetaDataTypeSize(_type) * _count;
+            if (0 == _size) {
+                type = paxMetaDataTypes::paxInvalid;
+                PAX_LOG_ERROR(3, << "Unknown size = 0 for meta type " << (int)_type);
+                return PAX_FAIL;
+            }
 
-        } // size_t getDimTagIndex() {
+            if (nullptr == arena) arena = std::make_shared<PaxMetaArena>();
 
-    protected:
+            // store the dimensions (always allocated)
+            num_dims = (uint8_t)_dims.size();  // TODO: justify dimension count
+            dims = reinterpret_cast<uint32_t*>(arena->alloc(num_dims * sizeof(uint32_t)));
+            for (int i = 0; i < num_dims; ++i) { dims[i] = _dims[i]; }
 
-        paxBufPtr       _buf;           ///< The buffer
-        paxBufData_t *  _pos;           ///< Current buffer offset
-        paxBufData_t *  _start;         ///< Pointer to start of buffer
-        size_t          _len;           ///< Current buffer length
-        //PaxMetaLoc      _metaLoc;     // TODO: PaxMetaLoc
-        metaLoc_e       _metaLoc;       ///< Current location for storing metadata
-        size_t          _metaIdx;       ///< Current index for storing metadata within current location
-        size_t          _dimTagIndex;   ///< TEMPCODE: index of last identified dimension tag
+            // initialize the data buffer
+            buf = arena->alloc(_size);
 
-    };  // class BufMan
+            type = _type;
 
-/************************************************************************************************************
- * @class PaxHeader
- * Defines and manipulates the PAX file header.
- ***********************************************************************************************************/
-    class PaxHeader {
+            if (data != NULL) {
+                memcpy(buf, data, _size);
+            }
 
-    public:
-/************************************************************************************************************
- * Default Ctor
- ***********************************************************************************************************/
-        PaxHeader() { }
+            return _count;
 
-    private:
-        
-        paxHeaderHashMap_t _hash;       ///< stores hashes for each raster, in the order they will be rendered
-        paxHeaderMetaMap_t _meta;       ///< stores meta for each raster
+        } // size_t initArray(paxMetaDataTypes_e _type, ::std::vector<uint32_t> _dims) 
 
-    }; // class PaxHeader
+/********************************************************************************************************
+ * Initializes the object for array storage of the given dims and type.
+ * @param[in]       _type   Type of the metadata
+ * @param[in]       list    initializer_list, gets casted to std::vector
+ * @param[in]       data    Input data
+ * @return                  The total number of metadata elements
+ *******************************************************************************************************/
+        size_t initArray(const paxMetaDataTypes_e _type, std::initializer_list<uint32_t> list,
 
-/************************************************************************************************************
- * @class PaxMetaLoc
- * Location information for a PAX metadata object.
- ***********************************************************************************************************/
-    class PaxMetaLoc {
+            const void* data = NULL) {
 
-    public:
-/*******************************************************************************************************
- * Default Ctor.
- ******************************************************************************************************/
-        PaxMetaLoc() : _raster(0), _index(0) { }
-/*******************************************************************************************************
- * Ctor with raster and index.
- * @param[in]       raster  The raster index
- * @param[in]       index   Index within this raster
-******************************************************************************************************/
-        PaxMetaLoc(const paxMetaLoc_t raster, const paxMetaLoc_t index) : _raster(raster), _index(index) { }
+            std::vector<uint32_t> _dims(list);
+            size_t count = initArray(_type, _dims, data);
 
-    protected:
-        paxMetaLoc_t _raster;       ///< Index of the raster this location refers to (TODO: always 0)
-        paxMetaLoc_t _index;        ///< Region-specific index
+            return count;
 
-    }; // class PaxMetaLoc
+        } // size_t initArray(paxMetaDataTypes_e _type, ::std::vector<uint32_t> _dims, void* data) 
 
 
-/************************************************************************************************************
- * @class PaxBuf
- * Defines and manipulates a buffer containing a PAX file. TODO: merge with BufMan.
- ***********************************************************************************************************/
-    class PaxBuf {
-    public:
+/********************************************************************************************************
+ * Sets all values to zero
+ * @return                  number of allocated bytes
+ *******************************************************************************************************/
+        size_t zero() {
 
-/*******************************************************************************************************
- * Ctor accepting a PaxArray.
- * @param[in]       inBuf   xvalue identifying the buffer containing the file to be loaded.
- ******************************************************************************************************/
-        PaxBuf(paxBuf_t &&inBuf) : _buf(inBuf) { }
+            size_t _bytes = bytes();
 
-    private:
+            if (isArray()) {
+                memset(buf, 0, _bytes);
+            } else {
+                u64 = 0;
+            }
 
-    protected:
-        paxBuf_t _buf;                      ///< The buffer
-        char * _pos;                        ///< Iterator addressing the current buffer position
-        size_t _headerLen;                  ///< The length of the header (0 if not yet known)
+            return _bytes;
 
-    };  // class PaxBuf
+        } //         size_t zero() {
 
-/************************************************************************************************************
- * @class PaxMeta
- * Defines and manipulates PAX metadata objects
- ***********************************************************************************************************/
-    class PaxMeta {
 
-    public:
-        /************************************************************************************************************
-        * Ctor accepting a paxMeta_t
-        * @tparam _valueIn Generic-typed value
-        ***********************************************************************************************************/
-        PaxMeta(paxMeta_t _valueIn) {
-            _data = std::move(_valueIn);
-        }
+/********************************************************************************************************
+ * Returns the number of elements in the specified dimension or all dimensions
+ * @param[in]       dim     optional dimension index
+ * @return                  number of elements
+ *******************************************************************************************************/
+        size_t count(const int8_t dim = -1) {
 
-    protected:
-        PaxMetaLoc      _loc;       ///< Location of this meta object
-        paxMeta_t       _data;      ///< The metadata
-    }; // class PaxMeta
+            size_t _count = 1;
+            if (0 == num_dims) return 1;
 
+            if (-1 == dim) {
+                for (int i = 0; i < num_dims; ++i) {
+                    _count *= dims[i];
+                }
+            } else if (dim < num_dims) {
+                return dims[dim];
+            } else {
+                PaxStatic::setStatus(PAX_FAIL);
+                return 0;
+            }
 
-/************************************************************************************************************
- * @class paxMeta_td
- * Defines and manipulates strongly-typed PAX metadata objects.
- * @tparam T Internal type of the metadata
- ***********************************************************************************************************/
-    template <class T>
-    class paxMeta_td : public PaxMeta{
+            return _count;
 
-    public:
+        } // size_t count(int8_t dim = -1) 
 
-        /************************************************************************************************************
-         * Ctor accepting a parameter of generic type
-         * @tparam valueIn Generic-typed value
-         ***********************************************************************************************************/
-        paxMeta_td(T valueIn) : PaxMeta({ valueIn }) { }
 
-        /************************************************************************************************************
-         * Extract value
-         * @return Generic-type value
-         ***********************************************************************************************************/
-        T get() { return std::get<T>(_data); }
+/********************************************************************************************************
+ * Returns the size of the data in the specified dimension or all dimensions in bytes
+ * @param[in]       dim     optional dimension index
+ * @return                  number of elements
+ *******************************************************************************************************/
+        size_t bytes(const int8_t dim = -1) {
 
-    private:
-    }; // class paxMeta_td
+            size_t _count = count(dim);
+            if (0 == _count) {
+                return 0;
+            }
 
+            if (paxMetaDataTypes::paxInvalid == type) {
+                return 0;
+            }
 
-/************************************************************************************************************
- * @class Pax
- * The fundamental container class for raster data of arbitrary type.
- * @tparam _BPV Number of Bytes Per Value
- * @tparam _VPE Number of Values Per Element
- **********************************************************************************************************/
-    template <paxBpv_t _BPV, paxVpe_t _VPE>
-    class Pax {
+            return _count * getMetaDataTypeSize(type);
 
-    public:
+        } //         size_t bytes(const int8_t dim = -1) {
 
-/************************************************************************************************************
- * Ctor accepting dimensions and optional data buffer.
- * If the buffer is supplied, copies the data into internal storage.
- * @param[in]       dimsIn  The new raster dimensions.
- * @param[in]       dataIn  Optional input buffer. Must be at least as large as all of the data.
- ***********************************************************************************************************/
-        Pax(const std::vector <paxDim_t>& dimsIn, const void * dataIn = NULL) {
 
-            initHeader();
-            size_t bytes = resize(dimsIn);
+/********************************************************************************************************
+ * Returns the number of defined dimensions, including trivial ones
+ * @return                  number of dimensions
+ *******************************************************************************************************/
+        size_t dimCount() {
 
-            if (NULL != dataIn) {
-                memcpy(rawData.data(), dataIn, bytes);
+            return num_dims;
+
+        } // size_t dimCount() 
+
+
+/********************************************************************************************************
+ * Calculates index into flattened array of the specified element 
+ * @param[in]       indices Indices of desired element
+ * @return                  flattened index
+ *******************************************************************************************************/
+        size_t getMetaArrayIndex(const std::vector<uint32_t> &indices) {
+
+            if (indices.size() > num_dims) {
+                PaxStatic::setStatus(PAX_FAIL);
+                return 0; // std::numeric_limits<size_t>::max();
             }
 
-        } // Pax(...)
+            size_t index = 0;   ///< flattened index
+            size_t mul = 1;     ///< multiplier for this dimension's data
 
-/************************************************************************************************************
- * Ctor accepting a file buffer.
- * @param[in]       inBuf   The buffer containing the file to be loaded.
- ***********************************************************************************************************/
-        Pax(PaxBuf inBuf) {
-            // TODO: implement
-        } // Pax(string file)
+            for (size_t i = 0; i < indices.size(); ++i) {
 
-/************************************************************************************************************
- * Ctor accepting a file name.
- * @param[in]       inFile  The file to be loaded.
- ***********************************************************************************************************/
-        Pax(const std::string& inFile) {
+                if (indices[i] >= dims[i]) {
+                    PaxStatic::setStatus(PAX_FAIL); // index out of range
+                    return 0;
+                }
 
-        } // Pax(string file)
+                index += indices[i] * mul;
+                mul *= dims[i];
 
-/************************************************************************************************************
- * Get the total size of the raster.
- * @return Total size of the raster in bytes
- ***********************************************************************************************************/
-        size_t size() {
+            }
 
-            size_t _elements = elements();
-            size_t bytes = _elements * _BPV * _VPE;
+            return index;
 
-            return bytes;
+        } //         size_t getMetaArrayIndex(const std::vector<uint32_t> &indices) {
 
-        } // size()
 
-/************************************************************************************************************
- * Get the total number of elements in the raster.
- * @return Total number of elements in the raster
- ***********************************************************************************************************/
-        size_t elements() {
+/********************************************************************************************************
+ * Calculates index into flattened array of the specified element (shorthand version)
+ * @param[in]       indices Indices of desired element
+ * @return                  flattened index
+ *******************************************************************************************************/
+        size_t I(std::vector<uint32_t> &indices) {
 
-            size_t _elements = std::reduce(dims.begin(), dims.end(), 1, std::multiplies<size_t>());
+            return getMetaArrayIndex(indices);
 
-            return _elements;
+        } //         size_t I(std::vector<uint32_t> &indices) {
 
-        } // elements()
 
-/************************************************************************************************************
- * Header access.
- * @return Reference to the header object
- ***********************************************************************************************************/
-        auto header() -> PaxHeader & {
+/********************************************************************************************************
+ * Returns the pointer to the internal array buffer
+ * @return                  pointer to internal buffer
+ *******************************************************************************************************/
+        void * bufPtr() {
 
-            return *hdr;
+            if (!isArray()) {
+                PaxStatic::setStatus(PAX_FAIL);
+                return NULL;
+            }
+            // its less work to handle the non-numeric types since all numeric type buffers are in a union
+            switch (type) {
 
-        } // header()
+            case paxMetaDataTypes::paxComment:
+            case paxMetaDataTypes::paxInvalid:
+            case paxMetaDataTypes::paxString:
+                return NULL;
 
-    protected:
+            default:
+                return (void*)u64b;
 
-/************************************************************************************************************
- * Header initialization.
- ***********************************************************************************************************/
-        void initHeader() {
+            }
 
-        }
+            return (void*)buf;
+
+        } //         void * bufPtr() {
 
-        std::unique_ptr<PaxHeader>  hdr;        ///< The header for this PAX file
-        std::vector <paxDim_t>      dims;       ///< The dimensions of the raster
-        std::vector <uint8_t>       rawData;    ///< Single buffer for raster data
 
 /********************************************************************************************************
- * Resizes the raster, preserving existing data.
- * Warning, does not preserve index. If interior dimensions change, the data will NOT aligned correctly.
- * @param[in]       dimsIn  The new raster dimensions.
- * @return                  The total number of elements in the raster.
- ********************************************************************************************************/
-        size_t resize(const std::vector <paxDim_t>& dimsIn) {
+ * Generate a standard name for a comment to be stored at the given location
+ * @param[in]       loc     location index
+ * @param[in]       index   index within location
+ * @return                  string name
+ *******************************************************************************************************/
+        static std::string getCommentName(size_t loc, size_t index) {
 
-            dims = dimsIn;
-            size_t bytes = size();
+            std::stringstream ss;
 
-            if (0 == bytes) {
-                dims = { 0 };
-                return 0;
-            }
+            // comments get a name starting with a character that is invalid at beginning of metadata name
+            ss << COMMENT_NAME_DELIM << loc << COMMENT_NAME_DELIM << index;
 
-            rawData.resize(bytes);
+            return ss.str();
 
-            return bytes;
+        } //         static std::string getCommentName(size_t loc, size_t index) {
 
-        } // resize
 
-    }; // class Pax
+/********************************************************************************************************
+ * Generate the standard name for a comment to be stored at the current internal location.
+ * @return                  string name
+ *******************************************************************************************************/
+        std::string commentName() {
+
+            return getCommentName(loc, index);
+
+        } //        std::string commentName() {
 
 
 /********************************************************************************************************
- * @class PaxScalar
- * The primary container class for rasters containing scalar data (single value per element).
- * @tparam _ET The type of each element
+ * Return a string representation of the metadata
+ * @return                  string flattened string representation of the metadata
  *******************************************************************************************************/
-    template <typename _ET>
-    class PaxScalar : Pax <sizeof(_ET), 1> {
+        std::string value() {
 
-    public:
-/*******************************************************************************************************
- * Ctor accepting dimensions and optional data buffer.
- * If the buffer is supplied, copies the data into internal storage.
- * @param[in]       dimsIn  The new raster dimensions.
- * @param[in]       dataIn  Optional input buffer. Must be at least as large as all of the data.
- ******************************************************************************************************/
-        PaxScalar(const std::vector <paxDim_t>& dimsIn, void * dataIn = NULL) :
-            Pax<sizeof(_ET), 1>(dimsIn, dataIn) { }
+            std::stringstream ss;
 
-    protected:
+            switch (type)
+            {
+            case paxMetaDataTypes_e::paxDouble:
+                ss << d;
+                break;
+            case paxMetaDataTypes_e::paxString:
+            case paxMetaDataTypes_e::paxComment:
+                ss << s;
+                break;
+            default:
+                break;
+            }
 
-    }; // class PaxScalar
+            std::string val = ss.str();
 
+            return val;
 
-/*******************************************************************************************************
- * @class PaxVector
- * The primary container class for rasters containing vector data (multiple values per element).
- * @tparam _ET The type of each element
- * @tparam _VPE Number of values per element
- ******************************************************************************************************/
-    template <typename _ET, paxVpe_t _VPE>
-    class PaxVector : public Pax<sizeof(_ET), _VPE> {
+        } //         std::string value() {
 
-    public:
-/*******************************************************************************************************
- * Ctor accepting dimensions and optional data buffer. If
- * the buffer is supplied, copies the data into internal storage.
- * @param[in]       dimsIn  The new raster dimensions.
- * @param[in]       dataIn  Optional input buffer. Must be at least as large as all of the data.
- ******************************************************************************************************/
-        PaxVector(const std::vector<paxDim_t>& dimsIn, void * dataIn = NULL) :
-            Pax<sizeof(_ET), _VPE>(dimsIn, dataIn) { }
 
-    }; // class PaxVector
+/********************************************************************************************************
+ * less-than operator, needed for std::sort
+ * @param[in]       rt  meta being compared to
+ * @return              true if less than given meta, false otherwise
+ *******************************************************************************************************/
+        bool operator < (const meta &rt) const { return loc < rt.loc && index < rt.index; }
 
 
 /********************************************************************************************************
- * @name PAX_LEGACY the following code is part of the original C++ library that will eventually be
- * replaced by the Pax, PaxScalar, PaxVector, etc. classes.
+ * is the meta an array?
+ * @return              true if array, false otherwise
  *******************************************************************************************************/
-///@{
+        bool isArray() { return num_dims != 0; }
 
-  //////////////////////////////////////////////////////////////////////////
-  //
-  // PAX value spaces: defines values per element for various types of data.
-  //
-    typedef class ValueSpaceStatic
-    {
+    } meta_t;   // typedef struct meta
+
+    using paxMetaMap_t = std::unordered_map<PaxMetaName, meta_t, PaxMetaName::hash>;    ///< Metadata by name
 
-    public:
 
-      //////////////////////////////////////////////////////////////////////////
-      //
-      // REAL*, IMAGINARY*, COMPLEX* specify value-interleaved multidimensional data.
-      //
-      // An example of REAL3 data would be latitude, longitude, elevation for a grid of pixels.
-      // An example of COMPLEX2 data would be signal for a two-channel system.
-      // An example of POLAR4 data would be 8-bit mag/phase for a four-channel radar system.
-      // Note that data such as GFF IQ2 requires separate buffers for REAL and IMAGINARY.
-      // BITS is not directly supported, but can be used for packed binary data.
-      //    Value space name,     enum,  vpe
 /************************************************************************************************************
- * @def PAX_VALUE_SPACE_DATA Conglomerate used with X-macros to generate value_space data
+ * @class BufMan
+ * PAX buffer manipulation object.
  ***********************************************************************************************************/
-#define PAX_VALUE_SPACE_DATA                                      \
-      /* generic numbers */                                       \
-      X(REAL,                   0,    1                         ) \
-      X(IMAGINARY,              1,    1                         ) \
-      X(COMPLEX,                2,    2                         ) \
-      X(POLAR,                  3,    2                         ) \
-      X(REAL2,                  4,    2                         ) \
-      X(IMAGINARY2,             5,    2                         ) \
-      X(COMPLEX2,               6,    4                         ) \
-      X(POLAR2,                 7,    4                         ) \
-      X(REAL3,                  8,    3                         ) \
-      X(IMAGINARY3,             9,    3                         ) \
-      X(COMPLEX3,              10,    6                         ) \
-      X(POLAR3,                11,    6                         ) \
-      X(REAL4,                 12,    4                         ) \
-      X(IMAGINARY4,            13,    4                         ) \
-      X(COMPLEX4,              14,    8                         ) \
-      X(POLAR4,                15,    8                         ) \
-      X(BITS,                  19,    1                         ) \
-      /* SAR data */                                              \
-      X(MAG,                   20,    1                         ) \
-      X(PHASE,                 21,    1                         ) \
-      X(MAGPHASE,              22,    2                         ) \
-      X(IQ,                    23,    2                         ) \
-      /* color spaces */                                          \
-      X(RGB,                   31,    3                         ) \
-      X(HSV,                   32,    3                         ) \
-      /* misc */                                                  \
-      X(ONE,                  901,    1                         ) \
-      X(TWO,                  902,    2                         ) \
-      X(THREE,                903,    3                         ) \
-      X(FOUR,                 904,    4                         ) \
-      X(FIVE,                 905,    5                         ) \
-      X(SIX,                  906,    6                         ) \
-      X(UNDEFINED,            999,    0                         )
-
+    class BufMan {
+    public:
 /************************************************************************************************************
- * @def X X-macro to generate value_space
+ * Ctor for internal type.
+ * @param[in]       buf     Shared pointer to the buffer
+ * @param[in]       len     Buffer length
  ***********************************************************************************************************/
-#define X(name, val, vpe) eVS_ ## name = val,
+        BufMan(paxBufPtr buf, const size_t len) :
+            _buf{ buf },
+            _pos{ NULL },
+            _len{ len },
+            _metaLoc{ metaLoc::LOC_AFTER_TAG }
+        {
 
-/********************************************************************************************************
-* @enum value_space Value space name definitions
-********************************************************************************************************/
-        enum value_space {
-            PAX_VALUE_SPACE_DATA
-        };
+            if (buf) _pos = buf->data();
+            _start = _pos;
+            PAX_LOG(2, << "created buf of length " << len);
+
+        } // BufMan(paxBufPtr buf, const size_t len)
 
-#undef X
 
 /************************************************************************************************************
- * @def X X-macro to generate vpe
+ * Ctor for raw buffer
+ * @param[in]       buf     Buffer address
+ * @param[in]       len     Buffer length
  ***********************************************************************************************************/
-#define X(name, val, vpe) eVPE_ ## name = vpe,
+        BufMan(paxBufData_t *buf, const size_t len) :
+            _buf{ nullptr },
+            _pos{ buf },
+            _len{ len },
+            _metaLoc{ metaLoc::LOC_AFTER_TAG }
+        {
 
-/********************************************************************************************************
-* @enum vpe Values per element for value spaces
-********************************************************************************************************/
-        enum vpe {
-            PAX_VALUE_SPACE_DATA
-        };
+            _start = _pos;
+            PAX_LOG(2, << "imported buf of length " << len);
 
-#undef X
+        } // BufMan(paxBufData_t *buf, const size_t len)
 
-        static inline vpe lookupVpe(enum value_space vs) {
 
 /************************************************************************************************************
- * @def X X-macro to generate cases for lookupVpe
+ * Tests the buffer for end-of-file
+ * @param[in]       pos     Optional buffer address. If NULL, uses internal buffer
+ * @return                  true if end-of-file found, false otherwise
  ***********************************************************************************************************/
-#define X(name, val, vpe) case eVS_ ## name : return eVPE_ ## name;
+        bool eof(char *pos = NULL) {
 
-            switch (vs)
-            {
-                PAX_VALUE_SPACE_DATA
-            default: return eVPE_UNDEFINED;
-            }
+            if (!pos) pos = _pos;
+            return (pos - _start) >= (int64_t)_len;
 
-#undef X
-        }
+        } // bool eof(char *pos = NULL) {
 
-        vpe getVpe() { return lookupVpe(_vs); }
 
-    protected:
-        value_space _vs;
+/************************************************************************************************************
+ * Returns the end of the buffer. Scanning stops here, as the buffer need not be terminated.
+ * @return                  One past the last character of the buffer
+ ***********************************************************************************************************/
+        const char * bufEnd() const {
 
-    } ValueSpace;  // class ValueSpaceStatic
+            return _start + _len;
 
-    typedef enum ValueSpace::value_space  value_space_e;
+        } // const char * bufEnd() const {
+
+
+/************************************************************************************************************
+ * Sets the current location and index for storing metadata.
+ * @param[in]       raster  Index of the raster for the next metadata.
+ * @param[in]       index   Index within the raster.
+ * @return                  status
+ ***********************************************************************************************************/
+        int setLoc(const metaLoc_e loc, const paxMetaLoc_t index) {
+
+            _metaLoc = loc;
+            _metaIdx = index;
+
+            return PAX_OK;
+
+        } // int setLoc(const paxMetaLoc_t loc, const paxMetaLoc_t index) {
+
+
+/************************************************************************************************************
+ * Sets the arena that receives the strings and arrays of extracted metadata. If not set, each meta
+ * gets an arena of its own.
+ * @param[in]       arena   Destination arena
+ ***********************************************************************************************************/
+        void setArena(const paxMetaArenaPtr & arena) {
+
+            _arena = arena;
+
+        } // void setArena(const paxMetaArenaPtr & arena)
+
+
+/********************************************************************************************************
+ * Advance the internal buffer past the next LF
+ * @return                  true if end-of-file found, false otherwise
+ *******************************************************************************************************/
+        bool skipLine() {
+
+            char * oldpos = _pos;
+            skipLine(_pos, bufEnd());
+            PAX_LOG(3, << "skipLine advanced " << _pos - oldpos << " characters");
+
+            return eof();
+
+        } // bool skipLine() {
+
+
+/********************************************************************************************************
+ * Advance past the next LF. Without an LF before the end, the buffer is advanced to the end.
+ * @param[in,out]   pos     Buffer to be advanced
+ * @param[in]       end     optional end of the buffer. If NULL, the buffer must hold an LF or be terminated.
+ * @return                  true
+ *******************************************************************************************************/
+        static bool skipLine(char *&pos, const char * end = NULL) {
+
+            char * oldpos = pos;
+            char * eol = (NULL == end) ? strchr(pos, '\n') : static_cast<char*>(memchr(pos, '\n', PAX_MAX(end - pos, (ptrdiff_t)0)));
+            pos = (NULL != eol) ? eol + 1 : (NULL == end) ? pos + strlen(pos) : const_cast<char*>(PAX_MAX(end, (const char *)pos));
+            PAX_LOG(3, << "skipLine advanced " << pos - oldpos << " characters");
+
+            return true;
+
+        } // static bool skipLine(char *&pos, const char * end = NULL) {
+
+
+/********************************************************************************************************
+ * Advance past the next chunk of whitespace. LF's are skipped if the 2nd argument is true
+ * @param[in,out]   pos     Buffer to be advanced
+ * @param[in]       skipLF  optional flag to skip linefeeds
+ * @param[in]       end     optional end of the buffer. If NULL, the buffer must be terminated.
+  *******************************************************************************************************/
+        static void skipWS(char *& pos, const bool skipLF = true, const char * end = NULL) {
+
+            char * oldpos = pos;
+
+            while ((NULL == end || pos < end) && (*pos == ' ' || *pos == '\t' || *pos == '\r' || (skipLF && *pos == '\n'))) ++pos;
+            if (pos != oldpos) PAX_LOG(3, << "skipped " << (pos - oldpos) << " whitespace characters");
+
+        } // static void skipWS(char *& pos, const bool skipLF = true, const char * end = NULL) {
+
+
+/********************************************************************************************************
+ * Advance to the next chunk of whitespace, delimiter, or brace. LF's are skipped if the 2nd arg is true.
+ * @param[in,out]   pos     Buffer to be advanced
+ * @param[in]       skipLF  optional flag to skip linefeeds
+ * @param[in]       end     optional end of the buffer. If NULL, the buffer must be terminated.
+ *******************************************************************************************************/
+        static void skipJunk(char *& pos, bool skipLF = true, const char * end = NULL) {
+
+            char * oldpos = pos;
+
+            // LF terminates the junk, so we check for it at the end; so does the end of a terminated buffer
+            while ((NULL == end || pos < end) && *pos != '\0' && *pos != '#' && *pos != '@' && *pos != ' ' && *pos != '\t' && *pos != '\r' && *pos != ':' && *pos != '=' && *pos != '[' && *pos != ']' && /*(skipLF ||*/ *pos != '\n'/*)*/) {
+                ++pos;
+            }
+
+            if (skipLF && (NULL == end || pos < end) && *pos == '\n') {
+                ++pos;
+            }
+
+            if (pos != oldpos) PAX_LOG(3, << "skipped " << (pos - oldpos) << " junk characters");
+
+        } // static void skipJunk(char *& pos, bool skipLF = true, const char * end = NULL) {
+
+
+/********************************************************************************************************
+ * Advance past the next chunk of junk and whitespace. LF's are skipped if the 2nd arg is true.
+ * @param[in,out]   pos     Buffer to be advanced
+ * @param[in]       skipLF  optional flag to skip linefeeds
+ * @param[in]       end     optional end of the buffer. If NULL, the buffer must be terminated.
+ *******************************************************************************************************/
+        static void skipJunkAndWS(char *& pos, bool skipLF = true, const char * end = NULL) {
+
+            skipJunk(pos, skipLF, end);
+            skipWS(pos, skipLF, end);
+
+        } // static void skipJunkAndWS(char *& pos, bool skipLF = true, const char * end = NULL) {
+
+
+/********************************************************************************************************
+ * Advance past whitespace, delimiter, whitespace. LF's are also skipped if the 2nd arg is true.
+ * @param[in,out]   pos     Buffer to be advanced
+ * @param[in]       skipLF  optional flag to skip linefeeds
+ * @param[in]       end     optional end of the buffer. If NULL, the buffer must hold a delimiter.
+ *******************************************************************************************************/
+        static void skipDelimiter(char *& pos, bool skipLF = true, const char * end = NULL) {
+
+            if (NULL != end && pos >= end) return;
+            skipWS(++pos, skipLF, end);
+            while ((NULL == end || pos < end) && *pos != ':' && *pos != '=') ++pos;
+            if (NULL != end && pos >= end) return;
+            skipWS(++pos, skipLF, end);
+
+        } // static void skipDelimiter(char *& pos, bool skipLF = true, const char * end = NULL) {
+
+
+/********************************************************************************************************
+ * Jump Advance junk, whitespace, specified char, whitespace. LF's are skipped if the 2nd arg is true.
+ * @param[in]       skipme  character to be skipped
+ * @param[in,out]   pos     Buffer to be advanced
+ * @param[in]       skipLF  optional flag to skip linefeeds
+ * @param[in]       end     optional end of the buffer. If NULL, the buffer must be terminated.
+ *******************************************************************************************************/
+        static void skipChar(const char skipme, char *& pos, const bool skipLF = true, const char * end = NULL) {
+
+            skipJunkAndWS(pos, skipLF, end);
+            // TODO: failure if next character is not closing brace?
+            if ((NULL != end && pos >= end) || *pos != skipme) return;
+            skipWS(++pos, skipLF, end);
+
+        } // static void skipChar(const char skipme, char *& pos, const bool skipLF = true, const char * end = NULL) {
+
+
+/********************************************************************************************************
+ * String-insensitive comparison of the internal buffer.
+ * @param[in]       str     NULL-terminated string to be compared
+ * @return                  true if strings match, false otherwise
+ *******************************************************************************************************/
+        bool compare(const char * str) {
+
+            bool res = 0 == PaxStatic::matchTag(_pos, str, bufEnd());
+
+            PAX_LOG(4, << "result of comparing buffer and '" << str << "': " << res);
+
+            return res;
+
+        } // bool compare(const char * str) {
+
+
+/***************************************************************************************************
+ * Classify the line the internal buffer is currently pointing at.
+ * @return                  PAX linetype
+ **************************************************************************************************/
+        headerLineType_t getHeaderLineType() {
+
+            skipWS(_pos, true, bufEnd());
+
+            hlType_t type = PaxStatic::classifyHeaderLine(_pos, _dimTagIndex, bufEnd());
+            PAX_LOG(3, << "found header line type " << (int)type);
+
+            // output a chunk of data upon failure
+            if (hlType_t::UNKNOWN == type && PaxStatic::getVerbosity() >= 2) {
+                std::string chunk(_pos, PAX_MIN((size_t)32, _len - offset()));
+                PAX_LOG_ERROR(0, << "Unknown header line: " << chunk);
+            }
+
+            return type;
+
+        } // headerLineType_t getHeaderLineType () 
+
+
+/********************************************************************************************************
+ * @def GETVAL_DEFAULTSKIP Default skip behavior
+ *******************************************************************************************************/
+#define GETVAL_DEFAULTSKIP skipFlags::SKIP_DELIMITER
+
+/********************************************************************************************************
+ * Extract a delimited numeric value from the internal buffer. Parsing is locale-independent and never
+ * reads past the end of the buffer. Leading whitespace and LFs are skipped, as strto* did. Integers are
+ * decimal unless prefixed with 0x; a negative value read as unsigned wraps, as strtoul did.
+ * @tparam          T       numeric type
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value, or 0 if none could be parsed
+ *******************************************************************************************************/
+        template <typename T>
+        T getValue(const skipFlags_e skip) {
+
+            if (skip & skipFlags::SKIP_DELIMITER) {
+                skipDelimiter(_pos, true, bufEnd());
+            }
+
+            const char * end = bufEnd();
+            while (_pos < end && (' ' == *_pos || '\t' == *_pos || '\r' == *_pos || '\n' == *_pos)) ++_pos;
+            if (_pos < end && '+' == *_pos) ++_pos;
+
+            T val = 0;
+            std::from_chars_result res{ _pos, std::errc() };
+
+            if constexpr (std::is_floating_point_v<T>) {
+#ifdef __cpp_lib_to_chars
+                res = std::from_chars(_pos, end, val);
+#else
+                // no floating-point from_chars in this library; parse a bounded, terminated copy of the token
+                char text[64];
+                size_t len = PAX_MIN((size_t)(end - _pos), sizeof(text) - 1);
+                memcpy(text, _pos, len);
+                text[len] = '\0';
+                char * stop;
+                val = std::is_same_v<T, float> ? strtof(text, &stop) : strtod(text, &stop);
+                res.ptr = _pos + (stop - text);
+#endif
+            } else {
+                bool negative = std::is_unsigned_v<T> && _pos < end && '-' == *_pos;
+                const char * pos = _pos + (negative ? 1 : 0);
+                int base = 10;
+                if (end - pos > 2 && '0' == pos[0] && ('x' == pos[1] || 'X' == pos[1])) {
+                    pos += 2;
+                    base = 16;
+                }
+                res = std::from_chars(pos, end, val, base);
+                if (negative) val = (T)(0 - val);
+            }
+
+            if (std::errc::result_out_of_range == res.ec) {
+                PAX_LOG_WARN(1, << "numeric value out of range in PAX buffer at offset " << offset());
+            }
+
+            _pos = const_cast<char*>(res.ptr);
+            skipJunkAndWS(_pos, skipFlags::SKIP_NOTHING != (skip & skipFlags::SKIP_LINEFEED), end);  // whitespace or LF required after value.
+
+            return val;
+
+        } // T getValue(const skipFlags_e skip)
+
+
+/********************************************************************************************************
+ * Extract a delimited float from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        float getFloat(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            float val = getValue<float>(skip);
+
+            PAX_LOG(3, << "read a float from buffer: " << val);
+
+            return val;
+
+        } // float getFloat(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Extract a delimited double from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        double getDouble(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            double val = getValue<double>(skip);
+
+            PAX_LOG(3, << "read a double from buffer: " << val);
+
+            return val;
+
+        } // double getDouble(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Extract a delimited int64 from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        int64_t getInt64(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            int64_t val = getValue<int64_t>(skip);
+
+            PAX_LOG(3, << "read an int64_t from buffer: " << val);
+
+            return val;
+
+        } // int64_t getInt64(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Extract a delimited uint64 from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        uint64_t getUint64(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            uint64_t val = getValue<uint64_t>(skip);
+
+            PAX_LOG(3, << "read a uint64_t from buffer: " << val);
+
+            return val;
+
+        } // uint64_t getUint64(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Extract a delimited int32 from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        int32_t getInt32(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            int32_t val = getValue<int32_t>(skip);
+
+            PAX_LOG(3, << "read an int32_t from buffer: " << val);
+
+            return val;
+
+        } // int32_t getInt32(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Extract a delimited uint32 from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        uint32_t getUint32(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            uint32_t val = getValue<uint32_t>(skip);
+
+            PAX_LOG(3, << "read a uint32_t from buffer: " << val);
+
+            return val;
+
+        } // uint32_t getUint32(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Extract a delimited int16 from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        int16_t getInt16(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            int16_t val = getValue<int16_t>(skip);
+
+            PAX_LOG(3, << "read an int16_t from buffer: " << val);
+
+            return val;
+
+        } // int16_t getInt16(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Extract a delimited uint16 from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        uint16_t getUint16(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            uint16_t val = getValue<uint16_t>(skip);
+
+            PAX_LOG(3, << "read a uint16_t from buffer: " << val);
+
+            return val;
+
+        } // uint16_t getUint16(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Extract a delimited int8 from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        int8_t getInt8(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            int8_t val = getValue<int8_t>(skip);
+
+            PAX_LOG(3, << "read an int8_t from buffer: " << val);
+
+            return val;
+
+        } // int8_t getInt8(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Extract a delimited uint8 from the internal buffer.
+ * @param[in]       skip    skip behavior
+ * @return                  extracted value
+ *******************************************************************************************************/
+        uint8_t getUint8(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+            uint8_t val = getValue<uint8_t>(skip);
+
+            PAX_LOG(3, << "read a uint8_t from buffer: " << val);
+
+            return val;
+
+        } // uint8_t getUint8(const skipFlags_e skip = GETVAL_DEFAULTSKIP) {
+
+
+/********************************************************************************************************
+ * Identify the metadata line at the current position without decoding its value. Assigns the location
+ * and index exactly as getMeta() would. The buffer position is not moved.
+ * @param[out]      name    Metadata name, or the generated name of a comment
+ * @param[out]      loc     Location of the metadata
+ * @param[out]      index   Index within the location
+ * @return                  PAX_OK on success, PAX_FAIL if no metadata marker was found
+ *******************************************************************************************************/
+        int indexMeta(std::string & name, metaLoc_e & loc, paxMetaLoc_t & index) {
+
+            if ('#' != *_pos && '@' != *_pos) {
+                PAX_LOG_ERROR(1, << "Attempted to index metadata but no marker found.");
+                return PAX_FAIL;
+            }
+
+            if ('#' == *_pos) {
+                name = meta::getCommentName(_metaLoc, _metaIdx);
+            } else {
+                char * pos = _pos + 1;      // skip the marker
+                skipChar('[', pos, true, bufEnd());     // skip past the opening brace
+                skipChar(']', pos, true, bufEnd());     // skip the type tag and closing brace
+
+                int len = 0;
+                while (!eof(pos + len) && pos[len] != ' ' && pos[len] != '\t' && pos[len] != ':' && pos[len] != '=' && pos[len] != '[' && pos[len] != '\n') {
+                    ++len;
+                }
+                name.assign(pos, len);
+            }
+
+            loc = _metaLoc;
+            index = _metaIdx++;
+            PAX_LOG(3, << "Indexed metadata " << name.c_str() << " at offset " << offset());
+
+            return PAX_OK;
+
+        } // int indexMeta(std::string & name, metaLoc_e & loc, paxMetaLoc_t & index)
+
+
+/********************************************************************************************************
+ * Extract an name/metadata pair from the buffer.
+ * @return                  pair containing name and meta
+ *******************************************************************************************************/
+        std::pair <std::string, meta_t> getMeta() {
+
+            meta_t meta1;
+            std::string name;
+            static std::pair <std::string, meta_t> badMeta{ "", meta_t{} };
+
+            // our current pos should be at the "#" or "##"
+            if ('#' != *_pos && '@' != *_pos) {
+                PAX_LOG_ERROR(1, << "Attempted to extract metadata but no marker found.");
+                return badMeta;
+            }
+
+            char * pos = _pos;
+
+            if ('#' == *pos) {
+                ///////////////////////////////////////////////////////////////////////////
+                // read the comment
+                //
+                char * eol = static_cast<char*>(memchr(pos, '\n', bufEnd() - pos));
+
+                // check for buffer overrun
+                if (NULL == eol) {
+                    PAX_LOG_ERROR(1, << "Unexpected EOF reading PAX buffer. This may be expected if previewing a long header.");
+                    _pos = _start + _len;
+                    return badMeta;
+                }
+
+                name = meta::getCommentName(_metaLoc, _metaIdx);
+
+                int len = (int)(eol - pos);
+                if (len >= PAX_MAX_METADATA_STRING_LENGTH) len = PAX_MAX_METADATA_STRING_LENGTH - 1;
+                if (pos[len - 1] == '\r') --len;
+
+                // trim the leading space if it is there
+                if (' ' == pos[0]) {
+                    ++pos;
+                    --len;
+                    meta1.stripped = true;
+                }
+
+                meta1.type = paxMetaDataTypes_e::paxComment;
+                meta1.arena = _arena;
+                meta1.setString(pos, len);
+
+                // set buffer pointer past end of line
+                _pos = eol + 1;
+
+            } else {
+                ///////////////////////////////////////////////////////////////////////////
+                // metadata
+                //
+                ++pos; // skip the marker
+                skipChar('[', pos, true, bufEnd());  // skip past the opening brace
+                meta1.type = paxMetaDataTypes_e::paxInvalid;
+                char typeTag[METATYPE_MAX_TAG_LEN + 1];
+
+                // extract and identify the type
+                for (int i = (int)paxMetaDataTypes::paxMetaStart; i <= (int)paxMetaDataTypes::paxMetaEnd; ++i) {
+
+                    paxMetaDataTypes_e type = (paxMetaDataTypes_e)i;
+                    const char * tag = PaxStatic::getMetaTypeTag(type);
+
+                    if (0 != PaxStatic::matchTag(pos, tag, bufEnd())) {
+
+                        meta1.type = type;
+                        pax_strcpy(typeTag, tag);
+                        PAX_LOG(4, << "Metadata type match! " << tag << " = type " << (int)meta1.type);
+                        skipChar(']', pos, true, bufEnd());
+
+                        break;
+
+                    }
+
+                }
+
+                // bad metadata type
+                if (paxMetaDataTypes_e::paxInvalid == meta1.type) {
+
+                    std::string chunk(pos, PAX_MIN(strlen(METATYPE_DOUBLE_TAG), (size_t)(bufEnd() - pos)));
+                    PAX_LOG_ERROR(0, << "Metadata type not found: " << chunk);
+                    skipLine();
+
+                    return badMeta;
+
+                }
+
+                // Read the meta name. Whitespace, delimiter, or opening brace stops the search.
+                int len = 0;
+                while (!eof(pos + len) && pos[len] != ' ' && pos[len] != '\t' && pos[len] != ':' && pos[len] != '=' && pos[len] != '[') {
+                    ++len;
+                }
+
+                name.append(pos, len);
+                PAX_LOG(3, << "Metadata name is " << name.c_str() << ", type is " << (int)meta1.type);
+
+                _pos = pos + len; // skip the name, swich back to internal buffer pointer
+                skipWS(_pos, true, bufEnd());
+
+                size_t values = 1;
+                // Check for an array
+                if (!eof() && '[' == _pos[0]) {
+                    skipWS(++_pos, true, bufEnd()); // skip the opening brace and WS
+
+                    // search for indexes in order
+                    static const char * metaArrayIndexTags[METAARRAYINDEXES] = {
+                      METAARRAYINDEX_FIRST_TAG,
+                      METAARRAYINDEX_SECOND_TAG,
+                      METAARRAYINDEX_THIRD_TAG,
+                      METAARRAYINDEX_FOURTH_TAG
+                    };
+
+                    std::vector<uint32_t> dims;
+                    int indexes = 0;
+
+                    for (int i = 0; i < METAARRAYINDEXES; ++i) {
+
+                        const char * tag = PaxStatic::getMetaArrayIndexTag(i);
+
+                        if (0 != PaxStatic::matchTag(_pos, tag, bufEnd())) {
+                          // found the ith index; skip to value
+                            uint32_t dim = getUint32();
+                            PAX_LOG(4, << "    (meta array) " << std::setw(6) << tag << " dim = " << dim);
+                            dims.push_back(dim);
+                        } else {
+                            break;
+                        }
+                    }
+
+                    skipChar(']', _pos, true, bufEnd()); // skip any extra stuff in the index list
+
+                    // each value takes at least a digit and a separator, so a larger array can't be in the buffer
+                    uint64_t count = 1;
+                    for (uint32_t dim : dims) count = (0 == dim || count <= (uint64_t)_len / dim) ? count * dim : (uint64_t)_len + 1;
+                    if (count > (uint64_t)(bufEnd() - _pos) / 2 + 1) {
+                        PAX_LOG_ERROR(1, << "Metadata array " << name.c_str() << " holds more values than the PAX buffer");
+                        skipLine();
+                        return badMeta;
+                    }
+
+                    meta1.arena = _arena;
+                    values = meta1.initArray(meta1.type, dims);
+
+                } // if ('[' == pos[0]) (meta array input)
+
+                while (!eof() && *_pos != ':' && *_pos != '=') ++_pos;    // skip the delimiter ':' or '='
+                if (eof()) {
+                    PAX_LOG_ERROR(1, << "Unexpected EOF reading metadata " << name.c_str());
+                    return badMeta;
+                }
+                ++_pos;
+                char *eol;
+
+                // Should be pointing at the data now (or perhaps whitespace)
+                if (1 == values) {
+
+                    switch (meta1.type) {
+
+                    case paxMetaDataTypes_e::paxString:
+                        eol = static_cast<char*>(memchr(_pos, '\n', bufEnd() - _pos));
+                        if (NULL == eol) eol = _pos + (bufEnd() - _pos);
+                        len = (int)(eol - _pos);
+                        if (len >= PAX_MAX_METADATA_STRING_LENGTH) len = PAX_MAX_METADATA_STRING_LENGTH - 1;
+                        if (_pos[len - 1] == '\r') len--;
+
+                        // trim the leading space if it is there
+                        if (' ' == _pos[0]) {
+                            ++_pos;
+                            --len;
+                            meta1.stripped = true;
+                        }
+
+                        meta1.arena = _arena;
+                        meta1.setString(_pos, len);
+
+                        // set buffer pointer at end of this line
+                        _pos = eol;
+                        break;
+
+                    case paxMetaDataTypes_e::paxFloat:
+                        meta1.f = getFloat(skipFlags::SKIP_NOTHING);
+                        break;
+
+                    case paxMetaDataTypes_e::paxDouble:
+                        meta1.d = getDouble(skipFlags::SKIP_NOTHING);
+                        break;
+
+                    case paxMetaDataTypes_e::paxInt64:
+                    case paxMetaDataTypes_e::paxInt32:
+                    case paxMetaDataTypes_e::paxInt16:
+                    case paxMetaDataTypes_e::paxInt8:
+                        // read and store as 64-bit and trust the user to call the right accessor fn
+                        meta1.n64 = getInt64(skipFlags::SKIP_NOTHING);
+                        break;
+
+                    case paxMetaDataTypes_e::paxUint64:
+                    case paxMetaDataTypes_e::paxUint32:
+                    case paxMetaDataTypes_e::paxUint16:
+                    case paxMetaDataTypes_e::paxUint8:
+                        // read and store as 64-bit and trust the user to call the right accessor fn
+                        meta1.u64 = getUint64(skipFlags::SKIP_NOTHING);
+                        break;
+
+                    default:
+                        PAX_LOG_ERROR(1, << "I don't know how to import metadata of type " << typeTag << "yet! skipping it...");
+                        skipJunkAndWS(_pos, false, bufEnd());
+                        break;
+                    }
+
+                } else {
+
+                    // KLUDGE: skip LF's as data is read in, then roll back one char
+                    for (size_t i = 0; i < values; ++i) {
+
+                        // all types should leave the buffer pointer at the beginning of the next element or the end of the line
+                        switch (meta1.type) {
+
+                        case paxMetaDataTypes_e::paxFloat:
+                            meta1.fb[i] = getFloat(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        case paxMetaDataTypes_e::paxDouble:
+                            meta1.db[i] = getDouble(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        case paxMetaDataTypes_e::paxInt64:
+                            meta1.n64b[i] = getInt64(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        case paxMetaDataTypes_e::paxInt32:
+                            meta1.n32b[i] = getInt32(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        case paxMetaDataTypes_e::paxInt16:
+                            meta1.n16b[i] = getInt16(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        case paxMetaDataTypes_e::paxInt8:
+                            meta1.n8b[i] = getInt8(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        case paxMetaDataTypes_e::paxUint64:
+                            meta1.u64b[i] = getUint64(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        case paxMetaDataTypes_e::paxUint32:
+                            meta1.u32b[i] = getUint32(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        case paxMetaDataTypes_e::paxUint16:
+                            meta1.u16b[i] = getUint16(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        case paxMetaDataTypes_e::paxUint8:
+                            meta1.u8b[i] = getUint8(skipFlags::SKIP_NOTHING);
+                            break;
+
+                        default:
+                            PAX_LOG_ERROR(1, << "I don't know how to import array metadata of type " <<
+                                typeTag << "yet! skipping it...");
+                            skipJunkAndWS(_pos, true, bufEnd());
+                            break;
+                        }
+                    } // for (size_t i = 0; i < values; ++i) {
+
+                } // if (...) : reading array data
+
+                skipLine();
+
+            } // reading metadata
+
+            meta1.loc   = _metaLoc;
+            meta1.index = _metaIdx;
+            ++_metaIdx;
+
+            return { std::move(name), std::move(meta1) };
+
+        }   // std::pair <std::string, meta_t>&& getMeta() {
+
+
+/********************************************************************************************************
+ * Copy binary raster data to the given buffer.
+ * @param[out]      buf     User-supplied output buffer
+ * @param[in]       len     bytes to be copied
+ * @return                  number of bytes copied
+ *******************************************************************************************************/
+        size_t copyData(char * buf, const size_t len)   {
+
+            ptrdiff_t remain = _len - (_pos - _start);
+            if (len > static_cast<size_t>(remain)) {
+
+                PAX_LOG_ERROR(1, << " insufficient buffer length. " << remain << " bytes remain but " <<
+                    len << " requested");
+
+                return 0;
+            }
+
+            memcpy(buf, _pos, len);
+            _pos += len;
+            PAX_LOG(2, << "copied " << len << " bytes of raster data from buffer. " << remain - len <<
+                " bytes remaining.");
+
+            return len;
+
+        } // size_t copyData(char * buf, const size_t len)
+
+
+/********************************************************************************************************
+ * Get a pointer to the binary raster data in place, without copying it.
+ * @param[in]       len     bytes of raster data expected
+ * @return                  pointer to the raster data, or NULL if the buffer is too short
+ *******************************************************************************************************/
+        char * viewData(const size_t len) {
+
+            ptrdiff_t remain = _len - (_pos - _start);
+            if (len > static_cast<size_t>(remain)) {
+
+                PAX_LOG_ERROR(1, << " insufficient buffer length. " << remain << " bytes remain but " <<
+                    len << " requested");
+
+                return NULL;
+            }
+
+            char * data = _pos;
+            _pos += len;
+            PAX_LOG(2, << "viewing " << len << " bytes of raster data in place. " << remain - len <<
+                " bytes remaining.");
+
+            return data;
+
+        } // char * viewData(const size_t len)
+
+
+/********************************************************************************************************
+ * Direct access to the internal buffer.
+ * @return                  reference to the internal buffer
+ *******************************************************************************************************/
+        char *& pos() { return _pos; }
+
+
+/********************************************************************************************************
+ * Get the current buffer offset
+ * @return                  Internal buffer position in bytes
+ *******************************************************************************************************/
+        size_t offset() {
+            if (_start > _pos) {
+                PaxStatic::setStatus(PAX_FAIL);
+                return 0;
+            }
+
+            return _pos - _start;
+
+        } // size_t offset() {
+
+
+/********************************************************************************************************
+ * Move to the given offset from the start of the buffer.
+ * @param[in]       pos     Desired offset; clamped to the buffer length
+ * @return                  Resulting offset
+ *******************************************************************************************************/
+        size_t seek(const size_t pos) {
+
+            _pos = _start + PAX_MIN(pos, _len);
+
+            return _pos - _start;
+
+        } // size_t seek(const size_t pos)
+
+
+/********************************************************************************************************
+ * Temporary buffer access
+ * @return                  Pointer to internal buffer
+ *******************************************************************************************************/
+        char * operator()() { return _pos; }
+
+
+/********************************************************************************************************
+ * Direct byte-by-byte data access.
+ * @param[in]       pos     Desired offset
+ * @return                  Reference to the byte at requested buffer offset
+ *******************************************************************************************************/
+        char &operator[](const size_t pos) { return _pos[pos]; }
+
+/********************************************************************************************************
+ * Artificially truncates the buffer if applicable. Throws warning if buffer is not long enough.
+ * @param[in]       pos     Desired buffer length
+ * @return                  Resulting buffer length
+ *******************************************************************************************************/
+        size_t truncate(const size_t pos) {
+
+            if (_len >= pos) {
+                _len = pos;
+            } else {
+                PAX_LOG_WARN(2, << "Tried to truncate a PAX buffer that is not long enough.");
+            }
+
+            return _len;
+
+        } // size_t truncate(const size_t pos) {
+
+
+/********************************************************************************************************
+ * Returns the last detected dimension index
+ * @return                  Zero-based dimension index
+ *******************************************************************************************************/
+        uint64_t getDimTagIndex() {
+
+            return _dimTagIndex;
+
+        } // uint64_t getDimTagIndex() {
+
+    protected:
+
+        paxBufPtr       _buf;           ///< The buffer
+        paxBufData_t *  _pos;           ///< Current buffer offset
+        paxBufData_t *  _start;         ///< Pointer to start of buffer
+        size_t          _len;           ///< Current buffer length
+        //PaxMetaLoc      _metaLoc;     // TODO: PaxMetaLoc
+        metaLoc_e       _metaLoc;       ///< Current location for storing metadata
+        size_t          _metaIdx;       ///< Current index for storing metadata within current location
+        uint64_t        _dimTagIndex;   ///< Zero-based index of last identified dimension tag
+        paxMetaArenaPtr _arena;         ///< Storage for metadata strings and arrays
+
+    };  // class BufMan
+
+/************************************************************************************************************
+ * @class PaxHeader
+ * Defines and manipulates the PAX file header. The type, shape, and metadata are held by a rasterFileBase,
+ * so parsing and rendering share the code used by rasterFile. Members that need the complete
+ * rasterFileBase are defined after it.
+ ***********************************************************************************************************/
+    class PaxHeader {
+
+    public:
+/************************************************************************************************************
+ * Default Ctor
+ ***********************************************************************************************************/
+        PaxHeader();
+/************************************************************************************************************
+ * Ctor for a header of the given type
+ * @param[in]       type    PAX type of the raster
+ ***********************************************************************************************************/
+        PaxHeader(paxTypes_e type);
+
+/************************************************************************************************************
+ * Get the PAX type.
+ * @return          PAX type of the raster
+ ***********************************************************************************************************/
+        paxTypes_e type();
+
+/************************************************************************************************************
+ * Get the raster dimensions.
+ * @return          Length of each dimension, sequential first
+ ***********************************************************************************************************/
+        const std::vector<uint64_t> & dims();
+
+/************************************************************************************************************
+ * Set the PAX type and raster dimensions.
+ * @param[in]       type    PAX type of the raster
+ * @param[in]       dimsIn  Length of each dimension, sequential first
+ ***********************************************************************************************************/
+        void setShape(paxTypes_e type, const std::vector<paxDim_t>& dimsIn);
+
+/************************************************************************************************************
+ * Metadata access. The returned object provides the full addMeta/getMeta interface.
+ * @return          Reference to the raster describing this header
+ ***********************************************************************************************************/
+        rasterFileBase & raster();
+
+/************************************************************************************************************
+ * Parse a header from a buffer. On success the buffer is positioned at the raster data.
+ * @param[in,out]   buf     Buffer manager positioned at the PAX tag
+ * @param[out]      dataLen Length of the raster data declared by the header
+ * @return                  PAX_OK on success, error code otherwise
+ ***********************************************************************************************************/
+        int read(BufMan & buf, uint64_t & dataLen);
+
+/************************************************************************************************************
+ * Render the header, up to and including DATA_LENGTH.
+ * @param[out]      out     Header text
+ * @return                  PAX_OK on success, error code otherwise
+ ***********************************************************************************************************/
+        int write(std::string & out);
+
+/************************************************************************************************************
+ * Lay out row-major raster data as the header describes them: tiled, compressed and checksummed as set.
+ * Call before write(), which records the payload.
+ * @param[in]       rowMajor    Raster data
+ * @param[out]      scratch     Storage for the payload if it differs from the data
+ * @param[out]      payloadLen  Length of the payload
+ * @return                      The payload, NULL on failure
+ ***********************************************************************************************************/
+        const char * encode(const char * rowMajor, std::vector<char> & scratch, uint64_t & payloadLen);
+
+/************************************************************************************************************
+ * Convert a payload read after the header into row-major raster data, verifying its checksums.
+ * @param[in]       payload     Payload following the header
+ * @param[in]       payloadLen  Length of the payload
+ * @param[out]      rowMajor    Raster data
+ * @return                      PAX_OK on success, error code otherwise
+ ***********************************************************************************************************/
+        int decode(const char * payload, uint64_t payloadLen, char * rowMajor);
+
+/************************************************************************************************************
+ * Get the bytes per value of a PAX type.
+ * @param[in]       type    PAX type
+ * @return                  Bytes per value, 0 if the type is invalid
+ ***********************************************************************************************************/
+        static int32_t bpv(paxTypes_e type);
+
+/************************************************************************************************************
+ * Get the values per element of a PAX type.
+ * @param[in]       type    PAX type
+ * @return                  Values per element, 0 if the type is invalid
+ ***********************************************************************************************************/
+        static int32_t vpe(paxTypes_e type);
+
+/************************************************************************************************************
+ * Read a whole file.
+ * @param[in]       fileName    Input file
+ * @return                      Buffer holding the file, or nullptr on error
+ ***********************************************************************************************************/
+        static paxBufPtr readFile(const pax_filestring & fileName);
+
+/************************************************************************************************************
+ * Write segments to a new file in a single gather write.
+ * @param[in]       fileName    Output file
+ * @param[in]       segs        Segments to be written, in order
+ * @param[in]       count       Number of segments
+ * @return                      PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        static int writeFile(const pax_filestring & fileName, const paxSegment_t * segs, size_t count);
+
+    private:
+
+        rasterFileBasePtr  _raster;     ///< type, shape, and metadata
+        paxHeaderHashMap_t _hash;       ///< stores hashes for each raster, in the order they will be rendered
+        paxHeaderMetaMap_t _meta;       ///< stores meta for each raster
+
+    }; // class PaxHeader
+
+/************************************************************************************************************
+ * @class PaxMetaLoc
+ * Location information for a PAX metadata object.
+ ***********************************************************************************************************/
+    class PaxMetaLoc {
+
+    public:
+/*******************************************************************************************************
+ * Default Ctor.
+ ******************************************************************************************************/
+        PaxMetaLoc() : _raster(0), _index(0) { }
+/*******************************************************************************************************
+ * Ctor with raster and index.
+ * @param[in]       raster  The raster index
+ * @param[in]       index   Index within this raster
+******************************************************************************************************/
+        PaxMetaLoc(const paxMetaLoc_t raster, const paxMetaLoc_t index) : _raster(raster), _index(index) { }
+
+    protected:
+        paxMetaLoc_t _raster;       ///< Index of the raster this location refers to (TODO: always 0)
+        paxMetaLoc_t _index;        ///< Region-specific index
+
+    }; // class PaxMetaLoc
+
+
+/************************************************************************************************************
+ * @class PaxBuf
+ * Defines and manipulates a buffer containing a PAX file. TODO: merge with BufMan.
+ ***********************************************************************************************************/
+    class PaxBuf {
+    public:
+
+/*******************************************************************************************************
+ * Ctor accepting a PaxArray.
+ * @param[in]       inBuf   xvalue identifying the buffer containing the file to be loaded.
+ ******************************************************************************************************/
+        PaxBuf(paxBuf_t &&inBuf) : _buf(std::make_shared<paxBuf_t>(std::move(inBuf))), _headerLen(0) { _pos = _buf->data(); }
+
+/*******************************************************************************************************
+ * Ctor sharing an existing buffer.
+ * @param[in]       inBuf   The buffer containing the file to be loaded.
+ ******************************************************************************************************/
+        PaxBuf(paxBufPtr inBuf) : _buf(inBuf), _headerLen(0) { _pos = _buf ? _buf->data() : NULL; }
+
+/*******************************************************************************************************
+ * Direct buffer access.
+ * @return          Pointer to the start of the buffer
+ ******************************************************************************************************/
+        char * data() { return _buf ? _buf->data() : NULL; }
+
+/*******************************************************************************************************
+ * Get the buffer size.
+ * @return          Buffer size in bytes
+ ******************************************************************************************************/
+        uint64_t size() { return _buf ? _buf->size() : 0; }
+
+/*******************************************************************************************************
+ * Get the header length.
+ * @return          Length of the header in bytes (0 if not yet known)
+ ******************************************************************************************************/
+        size_t headerLength() { return _headerLen; }
+
+/*******************************************************************************************************
+ * Record the header length once it has been parsed.
+ * @param[in]       len     Length of the header in bytes
+ ******************************************************************************************************/
+        void setHeaderLength(size_t len) { _headerLen = len; _pos = data() + len; }
+
+    private:
+
+    protected:
+        paxBufPtr _buf;                     ///< The buffer
+        char * _pos;                        ///< Iterator addressing the current buffer position
+        size_t _headerLen;                  ///< The length of the header (0 if not yet known)
+
+    };  // class PaxBuf
+
+/************************************************************************************************************
+ * @class PaxMeta
+ * Defines and manipulates PAX metadata objects
+ ***********************************************************************************************************/
+    class PaxMeta {
+
+    public:
+        /************************************************************************************************************
+        * Ctor accepting a paxMeta_t
+        * @tparam _valueIn Generic-typed value
+        ***********************************************************************************************************/
+        PaxMeta(paxMeta_t _valueIn) {
+            _data = std::move(_valueIn);
+        }
+
+    protected:
+        PaxMetaLoc      _loc;       ///< Location of this meta object
+        paxMeta_t       _data;      ///< The metadata
+    }; // class PaxMeta
+
+
+/************************************************************************************************************
+ * @class paxMeta_td
+ * Defines and manipulates strongly-typed PAX metadata objects.
+ * @tparam T Internal type of the metadata
+ ***********************************************************************************************************/
+    template <class T>
+    class paxMeta_td : public PaxMeta{
+
+    public:
+
+        /************************************************************************************************************
+         * Ctor accepting a parameter of generic type
+         * @tparam valueIn Generic-typed value
+         ***********************************************************************************************************/
+        paxMeta_td(T valueIn) : PaxMeta({ valueIn }) { }
+
+        /************************************************************************************************************
+         * Extract value
+         * @return Generic-type value
+         ***********************************************************************************************************/
+        T get() { return std::get<T>(_data); }
+
+    private:
+    }; // class paxMeta_td
+
+
+/************************************************************************************************************
+ * @class Pax
+ * The fundamental container class for raster data of arbitrary type. The element size is fixed at
+ * compile time, so element access needs no runtime type lookups or bounds checks.
+ * @tparam _BPV Number of Bytes Per Value
+ * @tparam _VPE Number of Values Per Element
+ **********************************************************************************************************/
+    template <paxBpv_t _BPV, paxVpe_t _VPE>
+    class Pax {
+
+    public:
+
+/************************************************************************************************************
+ * Default ctor. Creates an empty, untyped raster.
+ ***********************************************************************************************************/
+        Pax() : _type(PAX_UNTYPED) {
+
+            initHeader();
+            resize({ 0 });
+
+        } // Pax()
+
+/************************************************************************************************************
+ * Ctor accepting dimensions and optional data buffer.
+ * If the buffer is supplied, copies the data into internal storage.
+ * @param[in]       dimsIn  The new raster dimensions.
+ * @param[in]       dataIn  Optional input buffer. Must be at least as large as all of the data.
+ ***********************************************************************************************************/
+        Pax(const std::vector <paxDim_t>& dimsIn, const void * dataIn = NULL) : Pax(PAX_UNTYPED, dimsIn, dataIn) { }
+
+/************************************************************************************************************
+ * Ctor accepting a file buffer. Throws if the buffer does not hold a compatible PAX file.
+ * @param[in]       inBuf   The buffer containing the file to be loaded.
+ ***********************************************************************************************************/
+        Pax(PaxBuf inBuf) : Pax() {
+
+            if (PAX_OK != import(inBuf)) {
+                std::runtime_error e("PAX import: invalid or incompatible PAX buffer");
+                throw (e);
+            }
+
+        } // Pax(PaxBuf inBuf)
+
+/************************************************************************************************************
+ * Ctor accepting a file name. Throws if the file does not hold a compatible PAX file.
+ * @param[in]       inFile  The file to be loaded.
+ ***********************************************************************************************************/
+        Pax(const pax_filestring& inFile) : Pax() {
+
+            if (PAX_OK != importFile(inFile)) {
+                std::runtime_error e("PAX import: invalid or incompatible PAX file");
+                throw (e);
+            }
+
+        } // Pax(string file)
+
+/************************************************************************************************************
+ * Get the total size of the raster.
+ * @return Total size of the raster in bytes
+ ***********************************************************************************************************/
+        size_t size() {
+
+            size_t _elements = elements();
+            size_t bytes = _elements * _BPV * _VPE;
+
+            return bytes;
+
+        } // size()
+
+/************************************************************************************************************
+ * Get the total number of elements in the raster.
+ * @return Total number of elements in the raster
+ ***********************************************************************************************************/
+        size_t elements() {
+
+            size_t _elements = std::reduce(dims.begin(), dims.end(), (size_t)1, std::multiplies<size_t>());
+
+            return _elements;
+
+        } // elements()
+
+/************************************************************************************************************
+ * Get the raster dimensions.
+ * @return Length of each dimension, sequential first
+ ***********************************************************************************************************/
+        const std::vector <paxDim_t> & getDims() {
+
+            return dims;
+
+        } // getDims()
+
+/************************************************************************************************************
+ * Get the stride table.
+ * @return Number of elements between consecutive indexes in each dimension
+ ***********************************************************************************************************/
+        const std::vector <paxDim_t> & getStrides() {
+
+            return strides;
+
+        } // getStrides()
+
+/************************************************************************************************************
+ * Get the PAX type.
+ * @return PAX type of the raster, or PAX_UNTYPED
+ ***********************************************************************************************************/
+        paxTypes_e type() {
+
+            return _type;
+
+        } // type()
+
+/************************************************************************************************************
+ * Raw data access.
+ * @return Pointer to the first byte of raster data
+ ***********************************************************************************************************/
+        uint8_t * rawPtr() {
+
+            return rawData.data();
+
+        } // rawPtr()
+
+/************************************************************************************************************
+ * Header access.
+ * @return Reference to the header object
+ ***********************************************************************************************************/
+        auto header() -> PaxHeader & {
+
+            return *hdr;
+
+        } // header()
+
+/************************************************************************************************************
+ * Import a PAX file from a buffer. The type in the file must have the same BPV and VPE as this raster
+ * and, if this raster is typed, the same PAX type.
+ * @param[in]       inBuf   The buffer containing the file to be loaded.
+ * @return                  PAX_OK on success, error code otherwise
+ ***********************************************************************************************************/
+        int import(PaxBuf & inBuf) {
+
+            BufMan buf(inBuf.data(), inBuf.size());
+
+            std::unique_ptr<PaxHeader> inHdr = std::make_unique<PaxHeader>(_type);
+            uint64_t dataLen = 0;
+            int ret = inHdr->read(buf, dataLen);
+            if (PAX_OK != ret) {
+                return ret;
+            }
+
+            paxTypes_e inType = inHdr->type();
+            if (!isCompatible(inType)) {
+                PAX_LOG_ERROR(1, << "PAX type " << (int)inType << " is not compatible with a " << _BPV << "x" << _VPE << " raster of type " << (int)_type);
+                return PAX_FAIL;
+            }
+
+            inBuf.setHeaderLength(buf.offset());
+            const std::vector<uint64_t> &inDims = inHdr->dims();
+            resize(std::vector<paxDim_t>(inDims.begin(), inDims.end()));
+            // decompress, rearrange the tiles into rows and verify; the layout is kept for writing
+            const char * payload = buf.viewData(dataLen);
+            if (NULL == payload || PAX_OK != inHdr->decode(payload, dataLen, reinterpret_cast<char*>(rawData.data()))) {
+                resize({ 0 });
+                return PAX_FAIL;
+            }
+
+            _type = inType;
+            hdr = std::move(inHdr);
+
+            return PAX_OK;
+
+        } // int import(PaxBuf & inBuf)
+
+/************************************************************************************************************
+ * Import a PAX file from disk.
+ * @param[in]       inFile  The file to be loaded.
+ * @return                  PAX_OK on success, error code otherwise
+ ***********************************************************************************************************/
+        int importFile(const pax_filestring & inFile) {
+
+            paxBufPtr fileBuf = PaxHeader::readFile(inFile);
+            if (!fileBuf) {
+                return PAX_FAIL;
+            }
+
+            PaxBuf inBuf(fileBuf);
+
+            return import(inBuf);
+
+        } // int importFile(const pax_filestring & inFile)
+
+/************************************************************************************************************
+ * Render the raster as a PAX file in a new buffer.
+ * @param[out]      outBuf  Buffer holding the complete file
+ * @return                  PAX_OK on success, error code otherwise
+ ***********************************************************************************************************/
+        int writeToBuffer(paxBufPtr & outBuf) {
+
+            std::string header;
+            std::vector<char> scratch;
+            paxSegment_t payload;
+            int ret = writeHeader(header, scratch, payload);
+            if (PAX_OK != ret) {
+                return ret;
+            }
+
+            outBuf = std::make_shared<paxBuf_t>(header.length() + payload.second);
+            memcpy(outBuf->data(), header.c_str(), header.length());
+            if (payload.second > 0) {
+                memcpy(outBuf->data() + header.length(), payload.first, payload.second);
+            }
+
+            return PAX_OK;
+
+        } // int writeToBuffer(paxBufPtr & outBuf)
+
+/************************************************************************************************************
+ * Write the raster to a PAX file, gathering the header and data into a single write.
+ * @param[in]       fileName    Output file
+ * @return                      PAX_OK on success, error code otherwise
+ ***********************************************************************************************************/
+        int writeToFile(const pax_filestring & fileName) {
+
+            std::string header;
+            std::vector<char> scratch;
+            paxSegment_t payload;
+            int ret = writeHeader(header, scratch, payload);
+            if (PAX_OK != ret) {
+                return ret;
+            }
+
+            paxSegment_t segs[2] = { { header.c_str(), header.length() }, payload };
+
+            return PaxHeader::writeFile(fileName, segs, (payload.second > 0) ? 2 : 1);
+
+        } // int writeToFile(const pax_filestring & fileName)
+
+    protected:
+
+/************************************************************************************************************
+ * Ctor used by typed rasters.
+ * @param[in]       type    PAX type of the raster
+ * @param[in]       dimsIn  The new raster dimensions.
+ * @param[in]       dataIn  Optional input buffer. Must be at least as large as all of the data.
+ ***********************************************************************************************************/
+        Pax(paxTypes_e type, const std::vector <paxDim_t>& dimsIn, const void * dataIn = NULL) : _type(type) {
+
+            initHeader();
+            size_t bytes = resize(dimsIn);
+
+            if (NULL != dataIn && bytes > 0) {
+                memcpy(rawData.data(), dataIn, bytes);
+            }
+
+        } // Pax(type, dims, data)
+
+/************************************************************************************************************
+ * Header initialization.
+ ***********************************************************************************************************/
+        void initHeader() {
+
+            hdr = std::make_unique<PaxHeader>(_type);
+
+        }
+
+/************************************************************************************************************
+ * Check whether a PAX type may be loaded into this raster.
+ * @param[in]       inType  PAX type read from a file
+ * @return                  true if compatible
+ ***********************************************************************************************************/
+        bool isCompatible(paxTypes_e inType) {
+
+            if (PAX_UNTYPED != _type) {
+                return inType == _type;
+            }
+
+            return PaxHeader::bpv(inType) == (int32_t)_BPV && PaxHeader::vpe(inType) == (int32_t)_VPE;
+
+        }
+
+/************************************************************************************************************
+ * Render the header for the current shape, and the raster data laid out as the header describes.
+ * @param[out]      out     Header text
+ * @param[out]      scratch Storage for the data if they are tiled or compressed
+ * @param[out]      payload The data following the header
+ * @return                  PAX_OK on success, error code otherwise
+ ***********************************************************************************************************/
+        int writeHeader(std::string & out, std::vector<char> & scratch, paxSegment_t & payload) {
+
+            if (PAX_UNTYPED == _type) {
+                PAX_LOG_ERROR(1, << "cannot write an untyped " << _BPV << "x" << _VPE << " raster");
+                return PAX_FAIL;
+            }
+
+            hdr->setShape(_type, dims);
+
+            payload = { NULL, 0 };
+            payload.first = hdr->encode(reinterpret_cast<const char*>(rawData.data()), scratch, payload.second);
+            if (NULL == payload.first && payload.second > 0) {
+                return PAX_FAIL;
+            }
+
+            return hdr->write(out);
+
+        }
+
+        paxTypes_e                  _type;      ///< The PAX type, or PAX_UNTYPED
+        std::unique_ptr<PaxHeader>  hdr;        ///< The header for this PAX file
+        std::vector <paxDim_t>      dims;       ///< The dimensions of the raster
+        std::vector <paxDim_t>      strides;    ///< Elements between consecutive indexes in each dimension
+        std::vector <uint8_t>       rawData;    ///< Single buffer for raster data
+
+/********************************************************************************************************
+ * Resizes the raster, preserving existing data.
+ * Warning, does not preserve index. If interior dimensions change, the data will NOT aligned correctly.
+ * @param[in]       dimsIn  The new raster dimensions.
+ * @return                  The total number of elements in the raster.
+ ********************************************************************************************************/
+        size_t resize(const std::vector <paxDim_t>& dimsIn) {
+
+            dims = dimsIn;
+            size_t bytes = size();
+
+            if (0 == bytes) {
+                dims = { 0 };
+                strides = { 1 };
+                rawData.clear();
+                return 0;
+            }
+
+            strides.resize(dims.size());
+            size_t stride = 1;
+            for (size_t i = 0; i < dims.size(); ++i) {
+                strides[i] = stride;
+                stride *= dims[i];
+            }
+
+            rawData.resize(bytes);
+
+            return bytes;
+
+        } // resize
+
+    }; // class Pax
+
+
+/********************************************************************************************************
+ * @class PaxScalar
+ * The primary container class for rasters containing scalar data (single value per element).
+ * Element access is unchecked; loops over data() vectorize.
+ * @tparam _ET The type of each element
+ *******************************************************************************************************/
+    template <typename _ET>
+    class PaxScalar : public Pax <sizeof(_ET), 1> {
+
+        using base_t = Pax<sizeof(_ET), 1>;
+
+    public:
+/*******************************************************************************************************
+ * Default ctor. Creates an empty raster.
+ ******************************************************************************************************/
+        PaxScalar() : base_t(PaxTypeOf<_ET, 1>::value, { 0 }) { }
+
+/*******************************************************************************************************
+ * Ctor accepting dimensions and optional data buffer.
+ * If the buffer is supplied, copies the data into internal storage.
+ * @param[in]       dimsIn  The new raster dimensions.
+ * @param[in]       dataIn  Optional input buffer. Must be at least as large as all of the data.
+ ******************************************************************************************************/
+        PaxScalar(const std::vector <paxDim_t>& dimsIn, const void * dataIn = NULL) :
+            base_t(PaxTypeOf<_ET, 1>::value, dimsIn, dataIn) { }
+
+/*******************************************************************************************************
+ * Ctor accepting a file name. Throws if the file does not hold a PAX file of this type.
+ * @param[in]       inFile  The file to be loaded.
+ ******************************************************************************************************/
+        PaxScalar(const pax_filestring& inFile) : PaxScalar() {
+
+            if (PAX_OK != this->importFile(inFile)) {
+                std::runtime_error e("PAX import: invalid or incompatible PAX file");
+                throw (e);
+            }
+
+        }
+
+/*******************************************************************************************************
+ * Typed data access.
+ * @return          Pointer to the first element
+ ******************************************************************************************************/
+        _ET * data() { return reinterpret_cast<_ET*>(this->rawData.data()); }
+
+/*******************************************************************************************************
+ * Unchecked element access by flat index.
+ * @param[in]       i       Element index
+ * @return                  Reference to the element
+ ******************************************************************************************************/
+        _ET & operator[](size_t i) { return data()[i]; }
+
+/*******************************************************************************************************
+ * Unchecked 2-D element access.
+ * @param[in]       x       Sequential index
+ * @param[in]       y       Strided index
+ * @return                  Reference to the element
+ ******************************************************************************************************/
+        _ET & at(size_t x, size_t y = 0) { return data()[x + y * this->dims[0]]; }
+
+/*******************************************************************************************************
+ * Unchecked N-D element access, sequential index first.
+ * @param[in]       idx     Index in each dimension
+ * @return                  Reference to the element
+ ******************************************************************************************************/
+        _ET & at(std::initializer_list<size_t> idx) {
+
+            size_t index = 0, i = 0;
+            for (size_t v : idx) index += v * this->strides[i++];
+
+            return data()[index];
+
+        }
+
+    protected:
+
+    }; // class PaxScalar
+
+
+/*******************************************************************************************************
+ * @class PaxVector
+ * The primary container class for rasters containing vector data (multiple values per element).
+ * Values of an element are interleaved. Element access is unchecked.
+ * @tparam _ET The type of each element
+ * @tparam _VPE Number of values per element
+ ******************************************************************************************************/
+    template <typename _ET, paxVpe_t _VPE>
+    class PaxVector : public Pax<sizeof(_ET), _VPE> {
+
+        using base_t = Pax<sizeof(_ET), _VPE>;
+
+    public:
+/*******************************************************************************************************
+ * Default ctor. Creates an empty raster.
+ ******************************************************************************************************/
+        PaxVector() : base_t(PaxTypeOf<_ET, _VPE>::value, { 0 }) { }
+
+/*******************************************************************************************************
+ * Ctor accepting dimensions and optional data buffer. If
+ * the buffer is supplied, copies the data into internal storage.
+ * @param[in]       dimsIn  The new raster dimensions.
+ * @param[in]       dataIn  Optional input buffer. Must be at least as large as all of the data.
+ ******************************************************************************************************/
+        PaxVector(const std::vector<paxDim_t>& dimsIn, const void * dataIn = NULL) :
+            base_t(PaxTypeOf<_ET, _VPE>::value, dimsIn, dataIn) { }
+
+/*******************************************************************************************************
+ * Typed data access.
+ * @return          Pointer to the first value of the first element
+ ******************************************************************************************************/
+        _ET * data() { return reinterpret_cast<_ET*>(this->rawData.data()); }
+
+/*******************************************************************************************************
+ * Unchecked element access by flat index.
+ * @param[in]       i       Element index
+ * @return                  Pointer to the first of the element's _VPE values
+ ******************************************************************************************************/
+        _ET * operator[](size_t i) { return data() + i * _VPE; }
+
+/*******************************************************************************************************
+ * Unchecked value access.
+ * @param[in]       i       Element index
+ * @param[in]       v       Value index within the element
+ * @return                  Reference to the value
+ ******************************************************************************************************/
+        _ET & at(size_t i, size_t v) { return data()[i * _VPE + v]; }
+
+    }; // class PaxVector
+
+
+/********************************************************************************************************
+ * @name PAX_LEGACY the following code is part of the original C++ library that will eventually be
+ * replaced by the Pax, PaxScalar, PaxVector, etc. classes.
+ *******************************************************************************************************/
+///@{
+
+  //////////////////////////////////////////////////////////////////////////
+  //
+  // PAX value spaces: defines values per element for various types of data.
+  //
+    typedef class ValueSpaceStatic
+    {
+
+    public:
+
+      //////////////////////////////////////////////////////////////////////////
+      //
+      // REAL*, IMAGINARY*, COMPLEX* specify value-interleaved multidimensional data.
+      //
+      // An example of REAL3 data would be latitude, longitude, elevation for a grid of pixels.
+      // An example of COMPLEX2 data would be signal for a two-channel system.
+      // An example of POLAR4 data would be 8-bit mag/phase for a four-channel radar system.
+      // Note that data such as GFF IQ2 requires separate buffers for REAL and IMAGINARY.
+      // BITS is not directly supported, but can be used for packed binary data.
+      //    Value space name,     enum,  vpe
+/************************************************************************************************************
+ * @def PAX_VALUE_SPACE_DATA Conglomerate used with X-macros to generate value_space data
+ ***********************************************************************************************************/
+#define PAX_VALUE_SPACE_DATA                                      \
+      /* generic numbers */                                       \
+      X(REAL,                   0,    1                         ) \
+      X(IMAGINARY,              1,    1                         ) \
+      X(COMPLEX,                2,    2                         ) \
+      X(POLAR,                  3,    2                         ) \
+      X(REAL2,                  4,    2                         ) \
+      X(IMAGINARY2,             5,    2                         ) \
+      X(COMPLEX2,               6,    4                         ) \
+      X(POLAR2,                 7,    4                         ) \
+      X(REAL3,                  8,    3                         ) \
+      X(IMAGINARY3,             9,    3                         ) \
+      X(COMPLEX3,              10,    6                         ) \
+      X(POLAR3,                11,    6                         ) \
+      X(REAL4,                 12,    4                         ) \
+      X(IMAGINARY4,            13,    4                         ) \
+      X(COMPLEX4,              14,    8                         ) \
+      X(POLAR4,                15,    8                         ) \
+      X(BITS,                  19,    1                         ) \
+      /* SAR data */                                              \
+      X(MAG,                   20,    1                         ) \
+      X(PHASE,                 21,    1                         ) \
+      X(MAGPHASE,              22,    2                         ) \
+      X(IQ,                    23,    2                         ) \
+      /* color spaces */                                          \
+      X(RGB,                   31,    3                         ) \
+      X(HSV,                   32,    3                         ) \
+      /* misc */                                                  \
+      X(ONE,                  901,    1                         ) \
+      X(TWO,                  902,    2                         ) \
+      X(THREE,                903,    3                         ) \
+      X(FOUR,                 904,    4                         ) \
+      X(FIVE,                 905,    5                         ) \
+      X(SIX,                  906,    6                         ) \
+      X(UNDEFINED,            999,    0                         )
+
+/************************************************************************************************************
+ * @def X X-macro to generate value_space
+ ***********************************************************************************************************/
+#define X(name, val, vpe) eVS_ ## name = val,
+
+/********************************************************************************************************
+* @enum value_space Value space name definitions
+********************************************************************************************************/
+        enum value_space {
+            PAX_VALUE_SPACE_DATA
+        };
+
+#undef X
+
+/************************************************************************************************************
+ * @def X X-macro to generate vpe
+ ***********************************************************************************************************/
+#define X(name, val, vpe) eVPE_ ## name = vpe,
+
+/********************************************************************************************************
+* @enum vpe Values per element for value spaces
+********************************************************************************************************/
+        enum vpe {
+            PAX_VALUE_SPACE_DATA
+        };
+
+#undef X
+
+        static inline vpe lookupVpe(enum value_space vs) {
+
+/************************************************************************************************************
+ * @def X X-macro to generate cases for lookupVpe
+ ***********************************************************************************************************/
+#define X(name, val, vpe) case eVS_ ## name : return eVPE_ ## name;
+
+            switch (vs)
+            {
+                PAX_VALUE_SPACE_DATA
+            default: return eVPE_UNDEFINED;
+            }
+
+#undef X
+        }
+
+        vpe getVpe() { return lookupVpe(_vs); }
+
+    protected:
+        value_space _vs;
+
+    } ValueSpace;  // class ValueSpaceStatic
+
+    typedef enum ValueSpace::value_space  value_space_e;
     typedef enum ValueSpace::vpe          vpe_e;
 
-    typedef struct pax_float3
-    {
-        float x, y, z;
-        bool operator==(const pax_float3 & rt) { return (x == rt.x && y == rt.y && z == rt.z); }
-    } pax_float3_t;
+    typedef struct pax_float3
+    {
+        float x, y, z;
+        bool operator==(const pax_float3 & rt) { return (x == rt.x && y == rt.y && z == rt.z); }
+    } pax_float3_t;
+
+
+#define PAX_TYPE_DATA                                                         \
+/*    PAX type Name              enum  bpv    vpe                        */   \
+    X(INVALID,                    -1,   0,    ValueSpace::eVPE_UNDEFINED    ) \
+    X(SF_MAG_UCHAR,                0,   1,    ValueSpace::eVPE_MAG          ) \
+    X(SF_MAG_PHASE_USHORT,         1,   2,    ValueSpace::eVPE_MAGPHASE     ) \
+    X(SF_COMPLEX_USHORT,           2,   2,    ValueSpace::eVPE_COMPLEX      ) \
+    X(SF_COMPLEX_UINT,             3,   4,    ValueSpace::eVPE_COMPLEX      ) \
+    X(SF_COMPLEX_ULONG,            4,   8,    ValueSpace::eVPE_COMPLEX      ) \
+    X(SF_MAG_CHAR,                 5,   1,    ValueSpace::eVPE_MAG          ) \
+    X(SF_MAG_PHASE_SHORT,          6,   2,    ValueSpace::eVPE_MAGPHASE     ) \
+    X(SF_COMPLEX_SHORT,            7,   2,    ValueSpace::eVPE_COMPLEX      ) \
+    X(SF_COMPLEX_INT,              8,   4,    ValueSpace::eVPE_COMPLEX      ) \
+    X(SF_COMPLEX_LONG,             9,   8,    ValueSpace::eVPE_COMPLEX      ) \
+    X(SF_COMPLEX_SINGLE,          10,   4,    ValueSpace::eVPE_COMPLEX      ) \
+    X(SF_COMPLEX_DOUBLE,          11,   8,    ValueSpace::eVPE_COMPLEX      ) \
+    X(SF_MAG_PHASE_UCHAR,         12,   1,    ValueSpace::eVPE_MAGPHASE     ) \
+    X(SF_MAG_PHASE_CHAR,          13,   1,    ValueSpace::eVPE_MAGPHASE     ) \
+    X(SF_RGB_UCHAR,               14,   1,    ValueSpace::eVPE_RGB          ) \
+    X(SF_HSV_UCHAR,               15,   1,    ValueSpace::eVPE_HSV          ) \
+    X(SF_UNDEFINED_PIXEL_TYPE,    16,   0,    0                             ) \
+                                                                              \
+    X(CUSTOM,                     99,   0,    ValueSpace::eVPE_UNDEFINED    ) \
+    X(CHAR,                      100,   1,    ValueSpace::eVPE_ONE          ) \
+    X(UCHAR,                     101,   1,    ValueSpace::eVPE_ONE          ) \
+    X(SHORT,                     102,   2,    ValueSpace::eVPE_ONE          ) \
+    X(USHORT,                    103,   2,    ValueSpace::eVPE_ONE          ) \
+    X(INT,                       104,   4,    ValueSpace::eVPE_ONE          ) \
+    X(UINT,                      105,   4,    ValueSpace::eVPE_ONE          ) \
+    X(LONG,                      106,   8,    ValueSpace::eVPE_ONE          ) \
+    X(ULONG,                     107,   8,    ValueSpace::eVPE_ONE          ) \
+    X(HALF,                      108,   2,    ValueSpace::eVPE_ONE          ) \
+    X(FLOAT,                     109,   4,    ValueSpace::eVPE_ONE          ) \
+    X(DOUBLE,                    110,   8,    ValueSpace::eVPE_ONE          ) \
+    X(QUADRUPLE,                 111,  16,    ValueSpace::eVPE_ONE          ) \
+                                                                              \
+    X(META_ONLY,                 199,   0,    ValueSpace::eVPE_UNDEFINED    ) \
+    X(FLOAT3,                    200,   4,    ValueSpace::eVPE_REAL3        ) \
+                                                                              \
+/* NOTE: using PBM_BINARY would require changing bpv to bits per value */     \
+    X(PBM_ASCII,                1001,   1,    ValueSpace::eVPE_BITS         ) \
+    X(PGM_ASCII,                1002,   1,    ValueSpace::eVPE_REAL         ) \
+    X(PPM_ASCII,                1003,   1,    ValueSpace::eVPE_RGB          ) \
+    X(PBM_BINARY,               1004,   1,    ValueSpace::eVPE_BITS         ) \
+    X(PGM_BINARY,               1005,   1,    ValueSpace::eVPE_REAL         ) \
+    X(PPM_BINARY,               1006,   1,    ValueSpace::eVPE_RGB          ) \
+
+#define X(name,val,bpv,vpe) ePAX_ ## name = val,
+    enum class paxTypes : std::int32_t {
+        PAX_TYPE_DATA
+    };
+#undef X
+
+    typedef std::complex<float>           csingle;
+    typedef std::complex<double>          cdouble;
+
+    static_assert(PAX_UNTYPED == paxTypes::ePAX_INVALID, "PAX_UNTYPED must match ePAX_INVALID");
+
+/************************************************************************************************************
+ * @struct paxHalf_t
+ * An IEEE 754 half-precision value, kept as its 16 bits. PaxConvert converts it to and from float.
+ ***********************************************************************************************************/
+    struct paxHalf_t {
+        uint16_t    bits;       ///< Sign, 5-bit exponent and 10-bit mantissa
+
+/************************************************************************************************************
+ * The value as a float, which holds every half exactly.
+ * @return          The value
+ ***********************************************************************************************************/
+        float toFloat() const;
+
+/************************************************************************************************************
+ * The half nearest a float, ties to even.
+ * @param[in]       f           Float value
+ * @return          The nearest half-precision value
+ ***********************************************************************************************************/
+        static paxHalf_t fromFloat(float f);
+    };
+
+/********************************************************************************************************
+ * @struct PaxTypeOf
+ * Maps an element type and value count to its PAX type at compile time. Unmapped combinations are
+ * PAX_UNTYPED; they can be used in memory but not written.
+ * @tparam _ET  The type of each value
+ * @tparam _VPE Number of values per element
+ *******************************************************************************************************/
+    template <typename _ET, paxVpe_t _VPE>
+    struct PaxTypeOf { static constexpr paxTypes_e value = PAX_UNTYPED; };
+
+#define PAX_TYPE_OF(et, vpe, e) \
+    template <> struct PaxTypeOf<et, vpe> { static constexpr paxTypes_e value = paxTypes::e; };
+    PAX_TYPE_OF(int8_t,     1,  ePAX_CHAR)
+    PAX_TYPE_OF(uint8_t,    1,  ePAX_UCHAR)
+    PAX_TYPE_OF(int16_t,    1,  ePAX_SHORT)
+    PAX_TYPE_OF(uint16_t,   1,  ePAX_USHORT)
+    PAX_TYPE_OF(int32_t,    1,  ePAX_INT)
+    PAX_TYPE_OF(uint32_t,   1,  ePAX_UINT)
+    PAX_TYPE_OF(int64_t,    1,  ePAX_LONG)
+    PAX_TYPE_OF(uint64_t,   1,  ePAX_ULONG)
+    PAX_TYPE_OF(paxHalf_t,  1,  ePAX_HALF)
+    PAX_TYPE_OF(float,      1,  ePAX_FLOAT)
+    PAX_TYPE_OF(double,     1,  ePAX_DOUBLE)
+    PAX_TYPE_OF(float,      3,  ePAX_FLOAT3)
+    PAX_TYPE_OF(int16_t,    2,  ePAX_SF_COMPLEX_SHORT)
+    PAX_TYPE_OF(int32_t,    2,  ePAX_SF_COMPLEX_INT)
+    PAX_TYPE_OF(float,      2,  ePAX_SF_COMPLEX_SINGLE)
+    PAX_TYPE_OF(double,     2,  ePAX_SF_COMPLEX_DOUBLE)
+    PAX_TYPE_OF(uint8_t,    3,  ePAX_SF_RGB_UCHAR)
+#undef PAX_TYPE_OF
+
+    using   floatRasterFile = rasterFile<paxTypes::ePAX_FLOAT>;
+    using   floatRasterFilePtr = rasterFilePtr<paxTypes::ePAX_FLOAT>;
+    using   charRasterFile = rasterFile<paxTypes::ePAX_CHAR>;
+    using   charRasterFilePtr = rasterFilePtr<paxTypes::ePAX_CHAR>;
+    using   ucharRasterFile = rasterFile<paxTypes::ePAX_UCHAR>;
+    using   ucharRasterFilePtr = rasterFilePtr<paxTypes::ePAX_UCHAR>;
+    using   float3RasterFile = rasterFile<paxTypes::ePAX_FLOAT3>;
+    using   float3RasterFilePtr = rasterFilePtr<paxTypes::ePAX_FLOAT3>;
+    using   halfRasterFile = rasterFile<paxTypes::ePAX_HALF>;
+    using   halfRasterFilePtr = rasterFilePtr<paxTypes::ePAX_HALF>;
+
+
+/************************************************************************************************************
+ * @struct paxConvert_t
+ * Options for PaxConvert. Each value becomes value * scale + offset in the destination type.
+ ***********************************************************************************************************/
+    struct paxConvert_t {
+        double      scale = 1.0;        ///< Factor applied to each value
+        double      offset = 0.0;       ///< Added to each value after scaling
+        bool        saturate = true;    ///< Clamp integers to the destination range; otherwise they wrap
+        bool        round = false;      ///< Round to the nearest integer (ties to even); otherwise truncate
+    };
+
+
+/************************************************************************************************************
+ * @class PaxConvert
+ * Converts values between the scalar PAX types (CHAR to DOUBLE and HALF) and the components of the SF_*
+ * types, which convert value by value. The arithmetic is done in float when both types are at most 16-bit
+ * integers, HALF or FLOAT, and in double otherwise; integers converted without scale or offset never go
+ * through floating point at all. NaN converts to integer 0.
+ *
+ * The common 8- and 16-bit integer, HALF and float conversions run in AVX2, with F16C for HALF, when the
+ * processor has them, chosen at run time, and give the same results as the portable loops that handle
+ * everything else. Large arrays are converted in chunks on the shared thread pool.
+ ***********************************************************************************************************/
+    class PaxConvert {
+
+    public:
+/************************************************************************************************************
+ * Converts values between PAX types. The types must be of the same kind of element, e.g. both complex;
+ * this is not checked.
+ * @param[in]       from        PAX type of the source
+ * @param[in]       src         Source values
+ * @param[in]       to          PAX type of the destination
+ * @param[out]      dst         Destination values
+ * @param[in]       count       Number of values (elements times values per element)
+ * @param[in]       options     Scale, offset, saturation and rounding
+ * @param[in]       pool        Threads to convert on
+ * @return          PAX_OK on success, PAX_INVALID if a type cannot be converted
+ ***********************************************************************************************************/
+        static int convert(paxTypes_e from, const void * src, paxTypes_e to, void * dst, uint64_t count,
+                           const paxConvert_t & options = paxConvert_t(), PaxThreadPool & pool = PaxThreadPool::shared()) {
+
+            return convert(getScalar(from), src, getScalar(to), dst, count, options, pool);
+
+        } // static int convert(paxTypes_e from, ...)
+
+/************************************************************************************************************
+ * Converts values between scalar kinds.
+ * @param[in]       from        Kind of the source values
+ * @param[in]       src         Source values
+ * @param[in]       to          Kind of the destination values
+ * @param[out]      dst         Destination values
+ * @param[in]       count       Number of values
+ * @param[in]       options     Scale, offset, saturation and rounding
+ * @param[in]       pool        Threads to convert on
+ * @return          PAX_OK on success, PAX_INVALID if a kind cannot be converted
+ ***********************************************************************************************************/
+        static int convert(paxScalar_e from, const void * src, paxScalar_e to, void * dst, uint64_t count,
+                           const paxConvert_t & options = paxConvert_t(), PaxThreadPool & pool = PaxThreadPool::shared()) {
+
+            if (SCALAR_NONE == from || SCALAR_NONE == to) {
+                PAX_LOG_ERROR(1, << "Cannot convert scalar kind " << (int)from << " to " << (int)to);
+                return PAX_INVALID;
+            }
+
+            const uint64_t fromLen = getSize(from), toLen = getSize(to);
+            if (from == to && !isAffine(options)) {
+                memcpy(dst, src, count * fromLen);
+                return PAX_OK;
+            }
+
+            const uint64_t chunks = (count + PAX_CONVERT_CHUNK - 1) / PAX_CONVERT_CHUNK;
+            pool.parallelFor(chunks, [&](size_t c) {
+                const uint64_t first = c * PAX_CONVERT_CHUNK;
+                convertRange(from, static_cast<const char*>(src) + first * fromLen, to, static_cast<char*>(dst) + first * toLen,
+                             PAX_MIN(PAX_CONVERT_CHUNK, count - first), options);
+            });
+
+            return PAX_OK;
+
+        } // static int convert(paxScalar_e from, ...)
+
+/************************************************************************************************************
+ * The kind of the values of a PAX type.
+ * @param[in]       type        PAX type
+ * @return          Kind of each value, SCALAR_NONE if the type cannot be converted
+ ***********************************************************************************************************/
+        static paxScalar_e getScalar(paxTypes_e type) {
+
+            switch (type) {
+            case paxTypes::ePAX_CHAR:
+            case paxTypes::ePAX_SF_MAG_CHAR:
+            case paxTypes::ePAX_SF_MAG_PHASE_CHAR:      return SCALAR_INT8;
+            case paxTypes::ePAX_UCHAR:
+            case paxTypes::ePAX_SF_MAG_UCHAR:
+            case paxTypes::ePAX_SF_MAG_PHASE_UCHAR:
+            case paxTypes::ePAX_SF_RGB_UCHAR:
+            case paxTypes::ePAX_SF_HSV_UCHAR:           return SCALAR_UINT8;
+            case paxTypes::ePAX_SHORT:
+            case paxTypes::ePAX_SF_MAG_PHASE_SHORT:
+            case paxTypes::ePAX_SF_COMPLEX_SHORT:       return SCALAR_INT16;
+            case paxTypes::ePAX_USHORT:
+            case paxTypes::ePAX_SF_MAG_PHASE_USHORT:
+            case paxTypes::ePAX_SF_COMPLEX_USHORT:      return SCALAR_UINT16;
+            case paxTypes::ePAX_INT:
+            case paxTypes::ePAX_SF_COMPLEX_INT:         return SCALAR_INT32;
+            case paxTypes::ePAX_UINT:
+            case paxTypes::ePAX_SF_COMPLEX_UINT:        return SCALAR_UINT32;
+            case paxTypes::ePAX_LONG:
+            case paxTypes::ePAX_SF_COMPLEX_LONG:        return SCALAR_INT64;
+            case paxTypes::ePAX_ULONG:
+            case paxTypes::ePAX_SF_COMPLEX_ULONG:       return SCALAR_UINT64;
+            case paxTypes::ePAX_HALF:                   return SCALAR_HALF;
+            case paxTypes::ePAX_FLOAT:
+            case paxTypes::ePAX_FLOAT3:
+            case paxTypes::ePAX_SF_COMPLEX_SINGLE:      return SCALAR_FLOAT;
+            case paxTypes::ePAX_DOUBLE:
+            case paxTypes::ePAX_SF_COMPLEX_DOUBLE:      return SCALAR_DOUBLE;
+            default:                                    return SCALAR_NONE;
+            }
+
+        } // static paxScalar_e getScalar(paxTypes_e type)
+
+/************************************************************************************************************
+ * Bytes in one value of a kind.
+ * @param[in]       kind        Scalar kind
+ * @return          Size of the value, 0 for SCALAR_NONE
+ ***********************************************************************************************************/
+        static uint32_t getSize(paxScalar_e kind) {
+            return (kind > SCALAR_NONE && kind <= SCALAR_DOUBLE) ? sizes[kind] : 0;
+        }
+
+/************************************************************************************************************
+ * Converts a half-precision value to float. Every half is exactly representable; NaN is made quiet.
+ * @param[in]       h           Half-precision value
+ * @return          The value as a float
+ ***********************************************************************************************************/
+        static float halfToFloat(paxHalf_t h) {
+
+            uint32_t sign = (uint32_t)(h.bits & 0x8000) << 16;
+            uint32_t exp = (h.bits >> 10) & 0x1f;
+            uint32_t man = h.bits & 0x3ff;
+
+            uint32_t bits;
+            if (0x1f == exp) {
+                bits = sign | 0x7f800000 | man << 13;           // infinity or NaN
+                if (0 != man) {
+                    bits |= 0x400000;                           // NaN is quieted, as F16C does
+                }
+            } else if (0 != exp) {
+                bits = sign | (exp + 127 - 15) << 23 | man << 13;
+            } else if (0 == man) {
+                bits = sign;
+            } else {
+                // subnormal: normalize the mantissa
+                exp = 127 - 15 + 1;
+                while (0 == (man & 0x400)) {
+                    man <<= 1;
+                    --exp;
+                }
+                bits = sign | exp << 23 | (man & 0x3ff) << 13;
+            }
+
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            return f;
+
+        } // static float halfToFloat(paxHalf_t h)
+
+/************************************************************************************************************
+ * Converts a float to half precision, rounding to nearest even. Values too large become infinite.
+ * @param[in]       f           Float value
+ * @return          The nearest half-precision value
+ ***********************************************************************************************************/
+        static paxHalf_t floatToHalf(float f) {
+
+            uint32_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            const uint16_t sign = (bits >> 16) & 0x8000;
+            const uint32_t mag = bits & 0x7fffffff;
+
+            if (mag > 0x7f800000) {
+                return { (uint16_t)(sign | 0x7e00 | ((mag >> 13) & 0x3ff)) };     // quiet NaN
+            }
+            if (mag >= 0x47800000) {
+                return { (uint16_t)(sign | 0x7c00) };                               // 65536 and up
+            }
+            if (mag < 0x33000000) {
+                return { sign };                                                    // below half the smallest subnormal
+            }
+
+            uint32_t half, rem, mid;
+            if (mag < 0x38800000) {
+                // subnormal: shift the mantissa, with its implicit bit, into units of 2^-24
+                const uint32_t shift = 126 - (mag >> 23);
+                const uint32_t man = (mag & 0x7fffff) | 0x800000;
+                half = man >> shift;
+                rem = man & ((1u << shift) - 1);
+                mid = 1u << (shift - 1);
+            } else {
+                half = ((mag >> 23) - 127 + 15) << 10 | (mag & 0x7fffff) >> 13;
+                rem = mag & 0x1fff;
+                mid = 0x1000;
+            }
+            if (rem > mid || (rem == mid && (half & 1))) {
+                ++half;                                                             // may carry into the exponent
+            }
+
+            return { (uint16_t)(sign | half) };
+
+        } // static paxHalf_t floatToHalf(float f)
+
+/************************************************************************************************************
+ * Converts an array of half-precision values to float.
+ * @param[in]       src         Half-precision values
+ * @param[out]      dst         Float values
+ * @param[in]       count       Number of values
+ * @return          PAX_OK
+ ***********************************************************************************************************/
+        static int halfToFloat(const paxHalf_t * src, float * dst, uint64_t count) {
+            return convert(SCALAR_HALF, src, SCALAR_FLOAT, dst, count);
+        }
+
+/************************************************************************************************************
+ * Converts an array of floats to half precision, rounding to nearest even.
+ * @param[in]       src         Float values
+ * @param[out]      dst         Half-precision values
+ * @param[in]       count       Number of values
+ * @return          PAX_OK
+ ***********************************************************************************************************/
+        static int floatToHalf(const float * src, paxHalf_t * dst, uint64_t count) {
+            return convert(SCALAR_FLOAT, src, SCALAR_HALF, dst, count);
+        }
+
+/************************************************************************************************************
+ * Tells whether the AVX2 kernels are used.
+ * @return          true if the processor and operating system support AVX2
+ ***********************************************************************************************************/
+        static bool avx2() {
+#ifdef PAX_X86_64
+            static const bool avx2 = [] {
+#ifdef _MSC_VER
+                int info[4];
+                __cpuid(info, 1);
+                const bool osxsave = 0 != (info[2] & (1 << 27)), avx = 0 != (info[2] & (1 << 28));
+                if (!osxsave || !avx || 6 != (_xgetbv(0) & 6)) {
+                    return false;
+                }
+                __cpuidex(info, 7, 0);
+                return 0 != (info[1] & (1 << 5));
+#else
+                return 0 != __builtin_cpu_supports("avx2");
+#endif
+            }();
+            return avx2;
+#else
+            return false;
+#endif
+        }
+
+/************************************************************************************************************
+ * Tells whether the AVX2 kernels convert HALF in hardware.
+ * @return          true if the processor supports F16C
+ ***********************************************************************************************************/
+        static bool f16c() {
+#ifdef PAX_X86_64
+            static const bool f16c = [] {
+#ifdef _MSC_VER
+                int info[4];
+                __cpuid(info, 1);
+                return 0 != (info[2] & (1 << 29));
+#else
+                return 0 != __builtin_cpu_supports("f16c");
+#endif
+            }();
+            return f16c;
+#else
+            return false;
+#endif
+        }
+
+    private:
+        static constexpr uint64_t PAX_CONVERT_CHUNK = 1u << 16;    ///< Values converted per thread pool job
+        static constexpr uint32_t sizes[]{ 1, 1, 2, 2, 4, 4, 8, 8, 2, 4, 8 };  ///< Bytes per value of each kind
+
+        static bool isAffine(const paxConvert_t & options) { return 1.0 != options.scale || 0.0 != options.offset; }
+        static bool isInteger(paxScalar_e kind) { return kind <= SCALAR_UINT64; }
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Convert one chunk: the AVX2 kernel takes what it can, the portable
+        // loop the rest
+        //
+        static void convertRange(paxScalar_e from, const char * src, paxScalar_e to, char * dst, uint64_t count,
+                                 const paxConvert_t & options) {
+
+            uint64_t done = 0;
+#ifdef PAX_X86_64
+            if (avx2()) {
+                done = convertAvx2(from, src, to, dst, count, options);
+            }
+#endif
+            if (done < count) {
+                convertFrom(from, src + done * getSize(from), to, dst + done * getSize(to), count - done, options);
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Portable conversion, one switch per type to reach the typed loop
+        //
+        static void convertFrom(paxScalar_e from, const char * src, paxScalar_e to, char * dst, uint64_t count,
+                                const paxConvert_t & options) {
+
+            switch (from) {
+            case SCALAR_INT8:   convertTo<int8_t>(src, to, dst, count, options); break;
+            case SCALAR_UINT8:  convertTo<uint8_t>(src, to, dst, count, options); break;
+            case SCALAR_INT16:  convertTo<int16_t>(src, to, dst, count, options); break;
+            case SCALAR_UINT16: convertTo<uint16_t>(src, to, dst, count, options); break;
+            case SCALAR_INT32:  convertTo<int32_t>(src, to, dst, count, options); break;
+            case SCALAR_UINT32: convertTo<uint32_t>(src, to, dst, count, options); break;
+            case SCALAR_INT64:  convertTo<int64_t>(src, to, dst, count, options); break;
+            case SCALAR_UINT64: convertTo<uint64_t>(src, to, dst, count, options); break;
+            case SCALAR_HALF:   convertTo<paxHalf_t>(src, to, dst, count, options); break;
+            case SCALAR_FLOAT:  convertTo<float>(src, to, dst, count, options); break;
+            case SCALAR_DOUBLE: convertTo<double>(src, to, dst, count, options); break;
+            default:            break;
+            }
+        }
+
+        template <typename S>
+        static void convertTo(const char * src, paxScalar_e to, char * dst, uint64_t count, const paxConvert_t & options) {
+
+            switch (to) {
+            case SCALAR_INT8:   convertValues<S, int8_t>(src, dst, count, options); break;
+            case SCALAR_UINT8:  convertValues<S, uint8_t>(src, dst, count, options); break;
+            case SCALAR_INT16:  convertValues<S, int16_t>(src, dst, count, options); break;
+            case SCALAR_UINT16: convertValues<S, uint16_t>(src, dst, count, options); break;
+            case SCALAR_INT32:  convertValues<S, int32_t>(src, dst, count, options); break;
+            case SCALAR_UINT32: convertValues<S, uint32_t>(src, dst, count, options); break;
+            case SCALAR_INT64:  convertValues<S, int64_t>(src, dst, count, options); break;
+            case SCALAR_UINT64: convertValues<S, uint64_t>(src, dst, count, options); break;
+            case SCALAR_HALF:   convertValues<S, paxHalf_t>(src, dst, count, options); break;
+            case SCALAR_FLOAT:  convertValues<S, float>(src, dst, count, options); break;
+            case SCALAR_DOUBLE: convertValues<S, double>(src, dst, count, options); break;
+            default:            break;
+            }
+        }
+
+        template <typename T> static constexpr paxScalar_e kindOf() {
+            return std::is_same_v<T, paxHalf_t> ? SCALAR_HALF : std::is_same_v<T, float> ? SCALAR_FLOAT
+                 : std::is_same_v<T, double> ? SCALAR_DOUBLE : SCALAR_INT8;
+        }
+
+        template <typename S, typename D>
+        static void convertValues(const char * src, char * dst, uint64_t count, const paxConvert_t & options) {
+
+            const S * in = reinterpret_cast<const S*>(src);
+            D * out = reinterpret_cast<D*>(dst);
+
+            if constexpr (std::is_integral_v<S> && std::is_integral_v<D>) {
+                if (!isAffine(options)) {
+                    // integers stay integers
+                    for (uint64_t i = 0; i < count; ++i) {
+                        out[i] = options.saturate ? clampInt<D>(in[i]) : (D)in[i];
+                    }
+                    return;
+                }
+            }
+
+            constexpr bool narrow = (std::is_integral_v<S> ? sizeof(S) <= 2 : kindOf<S>() != SCALAR_DOUBLE) &&
+                                    (std::is_integral_v<D> ? sizeof(D) <= 2 : kindOf<D>() != SCALAR_DOUBLE);
+            using W = std::conditional_t<narrow, float, double>;
+
+            const W scale = (W)options.scale, offset = (W)options.offset;
+            const bool affine = isAffine(options);
+            for (uint64_t i = 0; i < count; ++i) {
+                W v = load<W>(in[i]);
+                if (affine) {
+                    v = v * scale;
+                    v = v + offset;
+                }
+                out[i] = store<D>(v, options);
+            }
+        }
+
+        template <typename W, typename S> static W load(S s) {
+            if constexpr (std::is_same_v<S, paxHalf_t>) {
+                return (W)halfToFloat(s);
+            } else {
+                return (W)s;
+            }
+        }
+
+        template <typename D, typename W> static D store(W v, const paxConvert_t & options) {
+
+            if constexpr (std::is_same_v<D, paxHalf_t>) {
+                return floatToHalf((float)v);
+            } else if constexpr (std::is_floating_point_v<D>) {
+                return (D)v;
+            } else {
+                if (v != v) {
+                    return 0;
+                }
+                if (options.round) {
+                    v = std::nearbyint(v);
+                }
+                if (options.saturate) {
+                    if (v >= (W)std::numeric_limits<D>::max()) return std::numeric_limits<D>::max();
+                    if (v <= (W)std::numeric_limits<D>::min()) return std::numeric_limits<D>::min();
+                    return (D)v;
+                }
+                // wrap through 64 bits, like an integer cast
+                if (v >= (W)9223372036854775808.0) {
+                    return (D)(uint64_t)PAX_MIN(v, (W)18446744073709549568.0);
+                }
+                return (D)(int64_t)PAX_MAX(v, (W)-9223372036854775808.0);
+            }
+        }
+
+        template <typename D, typename S> static D clampInt(S s) {
+            if constexpr (std::is_signed_v<S> && !std::is_signed_v<D>) {
+                if (s < 0) return 0;
+            }
+            if constexpr (std::is_signed_v<S> && std::is_signed_v<D> && sizeof(S) > sizeof(D)) {
+                if (s < (S)std::numeric_limits<D>::min()) return std::numeric_limits<D>::min();
+            }
+            if constexpr (sizeof(S) > sizeof(D) || (sizeof(S) == sizeof(D) && !std::is_signed_v<S> && std::is_signed_v<D>)) {
+                if ((std::make_unsigned_t<S>)s > (std::make_unsigned_t<D>)std::numeric_limits<D>::max() && s >= 0) {
+                    return std::numeric_limits<D>::max();
+                }
+            }
+            return (D)s;
+        }
+
+#ifdef PAX_X86_64
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // AVX2 kernels: eight values at a time through float, for the 8- and
+        // 16-bit integers, HALF and float. Returns how many values were
+        // converted.
+        //
+        PAX_TARGET("avx2,f16c")
+        static uint64_t convertAvx2(paxScalar_e from, const char * src, paxScalar_e to, char * dst, uint64_t count,
+                                    const paxConvert_t & options) {
+
+            if ((isInteger(to) && !options.saturate) || ((SCALAR_HALF == from || SCALAR_HALF == to) && !f16c())) {
+                return 0;
+            }
+
+            switch (from) {
+            case SCALAR_INT8:   return kernelTo<SCALAR_INT8>(src, to, dst, count, options);
+            case SCALAR_UINT8:  return kernelTo<SCALAR_UINT8>(src, to, dst, count, options);
+            case SCALAR_INT16:  return kernelTo<SCALAR_INT16>(src, to, dst, count, options);
+            case SCALAR_UINT16: return kernelTo<SCALAR_UINT16>(src, to, dst, count, options);
+            case SCALAR_HALF:   return kernelTo<SCALAR_HALF>(src, to, dst, count, options);
+            case SCALAR_FLOAT:  return kernelTo<SCALAR_FLOAT>(src, to, dst, count, options);
+            default:            return 0;
+            }
+        }
+
+        template <paxScalar_e F>
+        PAX_TARGET("avx2,f16c")
+        static uint64_t kernelTo(const char * src, paxScalar_e to, char * dst, uint64_t count, const paxConvert_t & options) {
+
+            switch (to) {
+            case SCALAR_INT8:   return kernel<F, SCALAR_INT8>(src, dst, count, options);
+            case SCALAR_UINT8:  return kernel<F, SCALAR_UINT8>(src, dst, count, options);
+            case SCALAR_INT16:  return kernel<F, SCALAR_INT16>(src, dst, count, options);
+            case SCALAR_UINT16: return kernel<F, SCALAR_UINT16>(src, dst, count, options);
+            case SCALAR_HALF:   return kernel<F, SCALAR_HALF>(src, dst, count, options);
+            case SCALAR_FLOAT:  return kernel<F, SCALAR_FLOAT>(src, dst, count, options);
+            default:            return 0;
+            }
+        }
+
+        template <paxScalar_e F, paxScalar_e T>
+        PAX_TARGET("avx2,f16c")
+        static uint64_t kernel(const char * src, char * dst, uint64_t count, const paxConvert_t & options) {
+
+            const bool affine = isAffine(options);
+            const __m256 scale = _mm256_set1_ps((float)options.scale);
+            const __m256 offset = _mm256_set1_ps((float)options.offset);
+            constexpr uint32_t fromLen = sizes[F], toLen = sizes[T];
+
+            uint64_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256 v = load8<F>(src + i * fromLen);
+                if (affine) {
+                    v = _mm256_add_ps(_mm256_mul_ps(v, scale), offset);
+                }
+                store8<T>(dst + i * toLen, v, options.round);
+            }
+
+            return i;
+        }
+
+        template <paxScalar_e F>
+        PAX_TARGET("avx2,f16c")
+        static __m256 load8(const char * p) {
+            if constexpr (SCALAR_FLOAT == F) {
+                return _mm256_loadu_ps(reinterpret_cast<const float*>(p));
+            } else if constexpr (SCALAR_HALF == F) {
+                return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            } else if constexpr (SCALAR_INT8 == F) {
+                return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+            } else if constexpr (SCALAR_UINT8 == F) {
+                return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+            } else if constexpr (SCALAR_INT16 == F) {
+                return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+            } else {
+                return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+            }
+        }
+
+        template <paxScalar_e T>
+        PAX_TARGET("avx2,f16c")
+        static void store8(char * p, __m256 v, bool round) {
+            if constexpr (SCALAR_FLOAT == T) {
+                _mm256_storeu_ps(reinterpret_cast<float*>(p), v);
+            } else if constexpr (SCALAR_HALF == T) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+            } else {
+                constexpr float lo = (SCALAR_INT8 == T) ? -128.0f : (SCALAR_INT16 == T) ? -32768.0f : 0.0f;
+                constexpr float hi = (SCALAR_INT8 == T) ? 127.0f : (SCALAR_UINT8 == T) ? 255.0f : (SCALAR_INT16 == T) ? 32767.0f : 65535.0f;
+
+                // NaN to 0, then round or truncate, then clamp
+                v = _mm256_and_ps(v, _mm256_cmp_ps(v, v, _CMP_ORD_Q));
+                v = round ? _mm256_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+                          : _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+                v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(lo)), _mm256_set1_ps(hi));
+
+                __m256i n = _mm256_cvttps_epi32(v);
+                __m128i lo4 = _mm256_castsi256_si128(n), hi4 = _mm256_extracti128_si256(n, 1);
+                if constexpr (SCALAR_INT16 == T) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(lo4, hi4));
+                } else if constexpr (SCALAR_UINT16 == T) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_packus_epi32(lo4, hi4));
+                } else if constexpr (SCALAR_INT8 == T) {
+                    __m128i w = _mm_packs_epi32(lo4, hi4);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packs_epi16(w, w));
+                } else {
+                    __m128i w = _mm_packs_epi32(lo4, hi4);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(w, w));
+                }
+            }
+        }
+#endif
+
+    }; // class PaxConvert
+
+    inline float paxHalf_t::toFloat() const { return PaxConvert::halfToFloat(*this); }
+    inline paxHalf_t paxHalf_t::fromFloat(float f) { return PaxConvert::floatToHalf(f); }
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // 
+  // rasterFile: The templated class associated with raster data files.
+  //
+  // Sample PAX file follows
+  /*
+
+PAX101 : PAX_UCHAR
+#
+# <pax root>/test/data/gold/pax_sample.pax
+# This is a sample PAX file containing metadata. The metadata type is given in square brackets. There is no default type.
+#
+# As PAX is a self-documenting format, use of blank comments is strongly suggested to improve readability.
+#
+# Metadata names never begin with whitespace and are unique. Repeated names cause earlier data to be overwritten and lost.
+# Comments are simply a special type of metadata not having a user-defined name and not requiring the leading description.
+#
+BYTES_PER_VALUE : 1
+VALUES_PER_ELEMENT : 1
+#
+#  This file is a simple 2x2 byte array
+## [double]   total_elements = 4
+#
+ELEMENTS_IN_SEQUENTIAL_DIMENSION : 2
+ELEMENTS_IN_STRIDED_DIMENSION : 2
+#
+#  You can use scientific notation, hex, etc.
+#  For floating-point data, it lets the C++ strstream choose how many significant figures, up to 15.
+#  Additional digits are ignored.
+#  Hex data can be read but not written. Caution, hex values can get weird though, since they are stored as double. Don't use more than ~52 bits!
+#
+## [double]   pi              = 3.1415926535897932384
+## [double]   alpha_centauri  = 4.12E16
+## [double]   crc32_checksum  = 0xFB29C8B3
+#
+DATA_LENGTH : 4
+cHaR
+  */
+  //
+
+
+  //////////////////////////////////////////////////////////////////////////
+  // rasterFileBase: A simple parent class to support rasterFile portability
+  //
+    class rasterFileBase
+    {
+      // CXXTest Classes
+        friend class TestRead;
+        friend class TestWrite;
+        friend class NewTestRead;
+        friend class NewTestWrite;
+        friend class TestUtility;
+        friend class PaxHeader;
+        template <paxTypes_e> friend class PaxWriter;
+
+        typedef std::shared_ptr<paxMetaMap_t>    paxMetaDataPtr;
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Location of a metadata line that has not been decoded yet
+        //
+        typedef struct lazyMeta {
+            size_t          offset;     ///< Offset of the line in _headerBuf
+            metaLoc_e       loc;        ///< Location assigned on import
+            paxMetaLoc_t    index;      ///< Index within the location
+        } lazyMeta_t;
+
+    public:
+
+      //typedef std::shared_ptr<std::vector<char>>                        paxDataBufPtr;
+
+        rasterFileBase() : _dataType(paxTypes::ePAX_INVALID), _version(PAX_VERSION), _numValues(0), _numSequential(0), _numStrided(0), _lazyMeta(false), _metaLoc(LOC_END), _metaLocCount{}, _tileWidth(0), _tileHeight(0), _codec(CODEC_NONE), _blockLength(PAX_COMPRESSION_BLOCK), _payloadLength(0), _checksum(false), _payloadCrc(0) { _importedLength = 0; }
+        rasterFileBase(paxTypes_e dataType) : _version(PAX_VERSION), _numValues(0), _numSequential(0), _numStrided(0), _lazyMeta(false), _metaLoc(LOC_END), _metaLocCount{}, _tileWidth(0), _tileHeight(0), _codec(CODEC_NONE), _blockLength(PAX_COMPRESSION_BLOCK), _payloadLength(0), _checksum(false), _payloadCrc(0) { _dataType = dataType; _importedLength = 0; }
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Return the PAX type
+        //
+        paxTypes_e getType() {
+            return _dataType;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Attempt to validate the given type
+        //
+        static bool isPaxType(int32_t t) {
+            paxTypes_e pax = static_cast<paxTypes_e> (t);
+
+            if (pax == paxTypes_e::ePAX_INVALID) {
+                PAX_LOG(2, << "found PAX type PAX_INVALID");
+                return false;
+            }
+
+#define X(name,val,bpv,vpe) || (t == val)
+            bool ret = false
+                PAX_TYPE_DATA
+                ;
+#undef X
+
+            PAX_LOG(2, << (ret ? "found valid PAX type: " : "found invalid PAX type: ") << t);
+
+            return ret;
+        }
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // check that the given string is a valid PAX tag. If the end of the
+        // buffer is given, the tag line must end with a LF before it.
+        //
+        static bool validatePaxTag(char *& pos, paxTypes_e &type, float &version, const char * end = NULL) {
+
+            if (NULL == pos || (NULL != end && pos >= end)) {
+                PAX_LOG(2, << "ERROR! empty PAX buffer!");
+                return false;
+            }
+
+          // temporarily terminate at the end of line
+            char * eol = (NULL == end) ? strchr(pos, '\n') : static_cast<char*>(memchr(pos, '\n', end - pos));
+            if (NULL != end && NULL == eol) {
+                PAX_LOG(2, << "ERROR! PAX buffer ends within the PAX tag!");
+                return false;
+            }
+            TempNull tn(eol);
+            size_t tagLen = strlen(PAX_TAG);
+            paxTypes_e paxType = paxTypes::ePAX_INVALID;
+
+            // 'valid' is used for conditional debug output
+            bool valid = (0 == strncmp(pos, PAX_TAG, tagLen));
+            PAX_LOG(2, << (valid ? "found PAX tag" : "ERROR! invalid PAX tag!"));
+            if (!valid) {
+                return false;
+            }
+
+            // get type
+            pos += tagLen;
+            char *oldPos = pos;
+            long ntype = strtol(pos, &pos, 10);
+            valid = (0L != ntype && LONG_MAX != ntype && LONG_MIN != ntype) || (0L == ntype && '0' == *oldPos);
+
+            if (valid) {
+                paxType = getPaxType(ntype);
+                valid = paxTypes_e::ePAX_INVALID != paxType;
+            }
+
+            { // local scope for TempNull to facilitate printing the converted character(s)
+                TempNull tn2(pos);
+                PAX_LOG(2, << (valid ? "found valid PAX type: " : "ERROR! invalid PAX type: ") << oldPos);
+            }
+
+            if (paxTypes_e::ePAX_INVALID == paxType) {
+                PAX_LOG_ERROR(1, << "invalid PAX type discovered");
+                return false;
+            }
+
+            BufMan::skipDelimiter(pos, false, eol);
+
+            // read version if it is given (did not exist prior to library version 1.0)
+            if (*pos == 'v' || *pos == 'V') {
+                BufMan::skipWS(++pos, true, eol);
+                version = strtof(pos, &pos);
+                // TODO: verify version
+                BufMan::skipDelimiter(pos, false, eol);
+            }
+
+            // TODO: verify that PAX type text matches the tag
+            //buf.skipWS (buf.pos ());
+            //assert (':' == buf[0]);
+            //buf.pos ()++;
+            //buf.skipWS (buf.pos ());
+
+            type = paxType;
+            tn.restore();
+            BufMan::skipLine(pos);
+
+            return valid;
+        } // bool validatePaxTag (char *& pos, paxTypes_e &type, float &version, const char * end = NULL)
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // convert an int to PAX type if possible
+        //
+        static paxTypes_e getPaxType(int32_t t) {
+            if (!isPaxType(t))  return paxTypes_e::ePAX_INVALID;
+            paxTypes_e pax = static_cast<paxTypes_e> (t);
+            return pax;
+        } // paxTypes_e getPaxType (int32_t t)
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Read the PAX type from the given filename
+        //
+        static paxTypes_e getPaxFileType(const std::string& path) {
+            paxBufPtr bufPtr = readFileChunk(path);
+
+            PAX_LOG(2, << "Identifying PAX type in file " << path);
+            paxTypes_e paxType = getPaxFileType(bufPtr);
+
+            return paxType;
+        } // paxTypes_e getPaxFileType (const std::string& path)
+
+
+          //////////////////////////////////////////////////////////////////////////
+          //
+          // Read the PAX type from the given filename
+          //
+        static paxTypes_e getPaxFileType(paxBufPtr bufPtr, float *version = NULL) {
+            BufMan buf(bufPtr->data(), bufPtr->size());
+
+            paxTypes_e paxType = paxTypes::ePAX_INVALID;
+            float      _version = PaxStatic::defaultVersion();
+            bool valid = validatePaxTag(buf.pos(), paxType, _version, buf.bufEnd());
+
+            if (version != NULL) {
+                *version = _version;
+            }
+
+            PAX_LOG(2, << (valid ? "Found PAX type " : "Invalid PAX type: ") << getTypeName(paxType));
+
+            return paxType;
+        } // paxTypes_e getPaxFileType (const std::string& path)
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // extract values per element for given type
+        //
+        static int32_t getVPE(paxTypes_e e) {
+          // sanity check on enum
+            int type = (int)e;
+            if (!isPaxType(type))  return 0;
+
+            int32_t _vpe = 0;
+
+#define X(name,val,bpv,vpe) case (paxTypes_e::ePAX_ ## name): _vpe = vpe; break;
+
+            switch (e) {
+                PAX_TYPE_DATA
+            }
+
+#undef X
+
+            return _vpe;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // extract bytes per value for given type
+        //
+        static int32_t getBPV(paxTypes_e e) {
+          // sanity check on enum
+            int type = (int)e;
+            if (!isPaxType(type))  return 0;
+
+            int32_t _bpv = 0;
+
+#define X(name,val,bpv,VPE) if (val == type) { PAX_LOG (2, << "bpv for pax type " << val << " is " << bpv); _bpv = bpv; }
+
+            PAX_TYPE_DATA
+
+#undef X        
+
+                return _bpv;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // extract PAX type name for given type
+        //
+        static std::string getTypeName(paxTypes_e e) {
+          // sanity check on enum
+            int type = (int)e;
+            if (!isPaxType(type))  e = paxTypes_e::ePAX_INVALID;
+
+            std::string name;
+
+#define XX(name)            #name
+#define X(name,val,bpv,vpe) case (paxTypes_e::ePAX_ ## name): return XX(PAX_ ## name); \
+
+
+            switch (e) {
+                PAX_TYPE_DATA
+            }
+
+#undef X
+#undef XX
+
+      // it's impossible to get here but some compilers doesn't know that and it removes the warnings
+            return std::string();
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query length of sequential dimension
+        //
+        uint64_t getNumSequential()
+        {
+            return _numSequential;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query length of strided dimension
+        //
+        uint64_t getNumStrided()
+        {
+            return _numStrided;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query number of elements
+        //
+        uint64_t getNumElements()
+        {
+            return _numValues;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query total number of values in all elements
+        //
+        uint64_t getNumValues()
+        {
+            return _numValues * getVPE(_dataType);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query number of rows, i.e. runs of sequential elements. For N-D
+        // rasters this spans all dimensions above the sequential one.
+        //
+        uint64_t getNumRows()
+        {
+            return _numSequential ? _numValues / _numSequential : 0;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query number of dimensions. Rasters always have at least two.
+        //
+        size_t getNumDims()
+        {
+            return _dims.size();
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query length of the given dimension (0 = sequential). Dimensions
+        // beyond the last one have length 1.
+        //
+        uint64_t getDim(size_t dim)
+        {
+            return dim < _dims.size() ? _dims[dim] : 1;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query all dimension lengths, sequential first
+        //
+        const std::vector<uint64_t> & getDims()
+        {
+            return _dims;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query the stride table: the number of elements between consecutive
+        // indexes in each dimension
+        //
+        const std::vector<uint64_t> & getStrides()
+        {
+            return _strides;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Tiled layout. The raster is viewed as getNumSequential() elements by
+        // getNumRows() rows and stored in tiles of tileWidth x tileHeight
+        // elements: row-major within each tile, and the tiles themselves
+        // row-major across the grid. Edge tiles are padded with zeros to full
+        // size, so every tile sits at a fixed offset. Tiling only changes how
+        // the raster is stored in a file; in memory it is always row-major.
+        // Set 0, 0 to store row-major again. Once the shape is set, a tile
+        // may not be larger than the raster, and the tiled data must be
+        // addressable in 64 bits.
+        //
+        int setTiling(uint64_t tileWidth, uint64_t tileHeight)
+        {
+            if ((0 == tileWidth) != (0 == tileHeight) ||
+                (0 != _numValues && (tileWidth > _numSequential || tileHeight > getNumRows()))) {
+                PAX_LOG_ERROR(1, << "Tile of " << tileWidth << "x" << tileHeight << " elements is invalid");
+                return PAX_INVALID;
+            }
+
+            const uint64_t oldWidth = _tileWidth, oldHeight = _tileHeight;
+            _tileWidth = tileWidth;
+            _tileHeight = tileHeight;
+            if (0 != _numValues && UINT64_MAX == getFileDataLength()) {
+                PAX_LOG_ERROR(1, << "Tiles of " << tileWidth << "x" << tileHeight << " elements are too large to address");
+                _tileWidth = oldWidth;
+                _tileHeight = oldHeight;
+                return PAX_INVALID;
+            }
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query the tiled layout
+        //
+        bool isTiled() { return 0 != _tileWidth; }
+        uint64_t getTileWidth() { return _tileWidth; }
+        uint64_t getTileHeight() { return _tileHeight; }
+        uint64_t getTilesAcross() { return isTiled() ? _numSequential / _tileWidth + (0 != _numSequential % _tileWidth) : 0; }
+        uint64_t getTilesDown() { return isTiled() ? getNumRows() / _tileHeight + (0 != getNumRows() % _tileHeight) : 0; }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Multiply, saturating at UINT64_MAX instead of wrapping
+        //
+        static uint64_t mulSaturated(uint64_t a, uint64_t b) { return (0 != a && b > UINT64_MAX / a) ? UINT64_MAX : a * b; }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query length of the raster data as stored in a file, including any
+        // tile padding. UINT64_MAX if the tiled data cannot be addressed.
+        //
+        uint64_t getFileDataLength()
+        {
+            uint64_t elemLen = (uint64_t)getBPV(_dataType) * getVPE(_dataType);
+            if (!isTiled()) {
+                return _numValues * elemLen;
+            }
+            uint64_t len = elemLen;
+            for (uint64_t factor : { getTilesAcross(), getTilesDown(), _tileWidth, _tileHeight }) {
+                len = mulSaturated(len, factor);
+            }
+            return len;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Byte offset of element x of the given row within tiled data
+        //
+        uint64_t getTiledOffset(uint64_t x, uint64_t row)
+        {
+            uint64_t elemLen = (uint64_t)getBPV(_dataType) * getVPE(_dataType);
+            uint64_t tile = mulSaturated(row / _tileHeight, getTilesAcross()) + x / _tileWidth;
+            uint64_t elem = mulSaturated(mulSaturated(tile, _tileHeight) + row % _tileHeight, _tileWidth) + x % _tileWidth;
+            return mulSaturated(elem, elemLen);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Copy w elements of the given row, starting at element x0, out of
+        // raster data laid out as in a file (tiled or not) into out
+        //
+        void copyFileRow(const char * data, uint64_t x0, uint64_t row, uint64_t w, char * out)
+        {
+            uint64_t elemLen = (uint64_t)getBPV(_dataType) * getVPE(_dataType);
+            if (!isTiled()) {
+                memcpy(out, data + (row * _numSequential + x0) * elemLen, w * elemLen);
+                return;
+            }
+
+            while (w) {
+                // a row stays contiguous up to the right edge of its tile
+                uint64_t run = PAX_MIN(w, _tileWidth - x0 % _tileWidth);
+                memcpy(out, data + getTiledOffset(x0, row), run * elemLen);
+                out += run * elemLen;
+                x0 += run;
+                w -= run;
+            }
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Convert between a row-major raster and its tiled layout. tiled holds
+        // getFileDataLength() bytes.
+        //
+        void untileData(const char * tiled, char * rowMajor)
+        {
+            uint64_t rowLen = _numSequential * getBPV(_dataType) * getVPE(_dataType);
+            for (uint64_t row = 0; row < getNumRows(); ++row) {
+                copyFileRow(tiled, 0, row, _numSequential, rowMajor + row * rowLen);
+            }
+        }
+
+        void tileData(const char * rowMajor, char * tiled)
+        {
+            uint64_t elemLen = (uint64_t)getBPV(_dataType) * getVPE(_dataType);
+            memset(tiled, 0, getFileDataLength());
+            for (uint64_t row = 0; row < getNumRows(); ++row) {
+                for (uint64_t x = 0; x < _numSequential; x += _tileWidth) {
+                    uint64_t run = PAX_MIN(_tileWidth, _numSequential - x);
+                    memcpy(tiled + getTiledOffset(x, row), rowMajor + (row * _numSequential + x) * elemLen, run * elemLen);
+                }
+            }
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Compressed layout. The raster data, tiled or not, are compressed by
+        // PaxCodec in blocks of blockLength bytes, which are best a multiple
+        // of the element size. DATA_LENGTH then counts the compressed payload
+        // and UNCOMPRESSED_LENGTH the data it holds. Like tiling, compression
+        // only changes the file; in memory the raster is uncompressed.
+        // Set CODEC_NONE to store it uncompressed again.
+        //
+        int setCompression(paxCodec_e codec, uint64_t blockLength = PAX_COMPRESSION_BLOCK)
+        {
+            if (!PaxCodec::isCodec(codec) || 0 == blockLength || blockLength > PAX_MAX_COMPRESSION_BLOCK) {
+                PAX_LOG_ERROR(1, << "Cannot compress with codec " << (int)codec << " in blocks of " << blockLength);
+                return PAX_INVALID;
+            }
+
+            _codec = codec;
+            _blockLength = blockLength;
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query the compressed layout
+        //
+        bool isCompressed() { return CODEC_NONE != _codec; }
+        paxCodec_e getCompression() { return _codec; }
+        uint64_t getCompressionBlockLength() { return _blockLength; }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query length of the raster data following the header in a file: the
+        // compressed payload of the last write or import, or the (tiled) data
+        //
+        uint64_t getPayloadLength()
+        {
+            return isCompressed() ? _payloadLength : getFileDataLength();
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // encodeData: lay out row-major raster data as they are stored in a
+        // file, tiling and compressing as set. Returns the payload, which is
+        // rowMajor itself if there is nothing to do and scratch otherwise.
+        // The payload length is remembered for writeHeader, so encode first.
+        //
+        const char * encodeData(const char * rowMajor, std::vector<char> & scratch, uint64_t & payloadLen)
+        {
+            const char * layout = rowMajor;
+            std::vector<char> tiles;
+            if (isTiled()) {
+                tiles.resize(getFileDataLength());
+                tileData(rowMajor, tiles.data());
+                layout = tiles.data();
+            }
+
+            const char * payload = layout;
+            if (!isCompressed()) {
+                scratch.swap(tiles);
+                payloadLen = getFileDataLength();
+                payload = isTiled() ? scratch.data() : rowMajor;
+            } else if (PAX_OK != PaxCodec::compress(_codec, getBPV(_dataType), _blockLength, layout, getFileDataLength(), scratch)) {
+                return NULL;
+            } else {
+                payloadLen = _payloadLength = scratch.size();
+                payload = scratch.data();
+            }
+
+            checksumPayload(payload, payloadLen);
+
+            return payload;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // decompressData: the raster data in their file layout (tiled or not)
+        // from a payload read after the header. Returns the payload itself if
+        // it is not compressed, otherwise scratch; NULL if it is damaged.
+        //
+        const char * decompressData(const char * payload, uint64_t payloadLen, std::vector<char> & scratch)
+        {
+            if (!isCompressed()) {
+                return payload;
+            }
+
+            scratch.resize(getFileDataLength());
+            if (PAX_OK != PaxCodec::decompress(_codec, getBPV(_dataType), _blockLength, payload, payloadLen, scratch.data(), scratch.size())) {
+                return NULL;
+            }
+
+            return scratch.data();
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // decodeData: convert a payload read after the header into row-major
+        // raster data of bpv * vpe * elements bytes, verifying its checksum.
+        // A plain payload is checksummed in the same pass that copies it.
+        //
+        int decodeData(const char * payload, uint64_t payloadLen, char * rowMajor)
+        {
+            if (!isTiled() && !isCompressed()) {
+                if (!_checksum) {
+                    // an empty raster may have no buffer to copy into
+                    if (0 != payloadLen) memcpy(rowMajor, payload, payloadLen);
+                    return PAX_OK;
+                }
+                return checkCrc(PaxChecksum::crc32cCopy(rowMajor, payload, payloadLen));
+            }
+
+            if (PAX_OK != verifyPayload(payload, payloadLen)) {
+                return PAX_INVALID;
+            }
+
+            // an empty raster has nothing to decode and no buffer to decode into
+            if (0 == getFileDataLength()) {
+                return PAX_OK;
+            }
+
+            std::vector<char> scratch;
+            const char * layout = decompressData(payload, payloadLen, scratch);
+            if (NULL == layout) {
+                return PAX_INVALID;
+            }
+
+            if (isTiled()) {
+                untileData(layout, rowMajor);
+            } else {
+                memcpy(rowMajor, layout, getFileDataLength());
+            }
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Payload checksums. When set, the CRC32C of the data following the
+        // header is written as CHECKSUM and verified on import. A tiled or
+        // compressed payload also gets the CRC32C of each block in
+        // BLOCK_CHECKSUMS, a block being a tile or a compressed block (the
+        // first one including the table of block lengths). Damage is then
+        // pinned to a block, and a tile is verified without the others.
+        //
+        void setChecksum(bool checksum = true)
+        {
+            _checksum = checksum;
+            _blockCrcs.clear();
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query the checksums of the last write or import
+        //
+        bool hasChecksum() { return _checksum; }
+        uint32_t getChecksum() { return _payloadCrc; }
+        const std::vector<uint32_t> & getBlockChecksums() { return _blockCrcs; }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Offsets of the blocks of a payload, followed by its length: the tiles
+        // of a tiled payload, the blocks of a compressed one, or the payload
+        // as a single block
+        //
+        int getPayloadBlocks(const char * payload, uint64_t payloadLen, std::vector<uint64_t> & offsets)
+        {
+            if (isCompressed()) {
+                if (PAX_OK != PaxCodec::getBlockOffsets(_blockLength, payload, payloadLen, getFileDataLength(), offsets)) {
+                    return PAX_INVALID;
+                }
+                offsets[0] = 0;
+            } else if (isTiled()) {
+                uint64_t tiles = getTilesAcross() * getTilesDown();
+                uint64_t tileLen = _tileWidth * _tileHeight * getBPV(_dataType) * getVPE(_dataType);
+                offsets.resize(tiles + 1);
+                for (uint64_t t = 0; t <= tiles; ++t) {
+                    offsets[t] = t * tileLen;
+                }
+            } else {
+                offsets = { 0, payloadLen };
+            }
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // verifyPayload: check a payload read after the header against its
+        // checksums, block by block if it has them. Damaged blocks are
+        // reported.
+        //
+        int verifyPayload(const char * payload, uint64_t payloadLen)
+        {
+            if (!_checksum) {
+                return PAX_OK;
+            }
+            if (_blockCrcs.empty()) {
+                return checkCrc(PaxChecksum::crc32c(payload, payloadLen));
+            }
+
+            std::vector<uint64_t> offsets;
+            if (PAX_OK != getPayloadBlocks(payload, payloadLen, offsets)) {
+                return PAX_INVALID;
+            }
+
+            std::vector<char> damaged(_blockCrcs.size());
+            PaxThreadPool::shared().parallelFor(_blockCrcs.size(), [&](size_t b) {
+                damaged[b] = _blockCrcs[b] != PaxChecksum::crc32c(payload + offsets[b], offsets[b + 1] - offsets[b]);
+            });
+
+            std::string blocks;
+            for (size_t b = 0; b < damaged.size(); ++b) {
+                if (damaged[b]) {
+                    blocks.append(" ").append(std::to_string(b));
+                }
+            }
+            if (!blocks.empty()) {
+                PAX_LOG_ERROR(1, << "PAX payload checksum mismatch in block(s)" << blocks);
+                return PAX_INVALID;
+            }
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // verifyTile: check one tile of an uncompressed tiled payload against
+        // its block checksum. Without one there is nothing to check.
+        //
+        int verifyTile(const char * payload, uint64_t tile)
+        {
+            if (!_checksum || isCompressed() || tile >= _blockCrcs.size()) {
+                return PAX_OK;
+            }
+
+            uint64_t tileLen = _tileWidth * _tileHeight * getBPV(_dataType) * getVPE(_dataType);
+            if (_blockCrcs[tile] != PaxChecksum::crc32c(payload + tile * tileLen, tileLen)) {
+                PAX_LOG_ERROR(1, << "PAX payload checksum mismatch in block " << tile);
+                return PAX_INVALID;
+            }
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // verifyRegion: check the tiles of an uncompressed tiled payload that
+        // overlap w x h elements at (x0, y0) in each plane
+        //
+        int verifyRegion(const char * payload, uint64_t x0, uint64_t y0, uint64_t w, uint64_t h)
+        {
+            if (!_checksum || isCompressed() || !isTiled() || _blockCrcs.empty()) {
+                return PAX_OK;
+            }
+
+            const uint64_t rows = _dims.size() > 1 ? _dims[1] : 1;
+            const uint64_t planes = getNumRows() / rows;
+            for (uint64_t plane = 0; plane < planes; ++plane) {
+                for (uint64_t j = (plane * rows + y0) / _tileHeight; j <= (plane * rows + y0 + h - 1) / _tileHeight; ++j) {
+                    for (uint64_t i = x0 / _tileWidth; i <= (x0 + w - 1) / _tileWidth; ++i) {
+                        if (PAX_OK != verifyTile(payload, j * getTilesAcross() + i)) {
+                            return PAX_INVALID;
+                        }
+                    }
+                }
+            }
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // checksumPayload: record the checksums of a payload about to be
+        // written, if they are enabled
+        //
+        void checksumPayload(const char * payload, uint64_t payloadLen)
+        {
+            _blockCrcs.clear();
+            if (!_checksum) {
+                return;
+            }
+
+            _payloadCrc = PaxChecksum::crc32c(payload, payloadLen);
+            if (!isTiled() && !isCompressed()) {
+                return;
+            }
+
+            std::vector<uint64_t> offsets;
+            getPayloadBlocks(payload, payloadLen, offsets);
+            _blockCrcs.resize(offsets.size() - 1);
+            PaxThreadPool::shared().parallelFor(_blockCrcs.size(), [&](size_t b) {
+                _blockCrcs[b] = PaxChecksum::crc32c(payload + offsets[b], offsets[b + 1] - offsets[b]);
+            });
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // checkCrc: compare the CRC32C computed over a whole payload with CHECKSUM
+        //
+        int checkCrc(uint32_t crc)
+        {
+            if (crc != _payloadCrc) {
+                PAX_LOG_ERROR(1, << "PAX payload checksum mismatch: computed " << PaxChecksum::toString(crc) << " but the header holds " << PaxChecksum::toString(_payloadCrc));
+                return PAX_INVALID;
+            }
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Convert an N-D index (sequential first) to a flat element index.
+        // Missing trailing indexes are 0. Returns false if out of bounds.
+        //
+        bool elementIndex(const uint64_t * idx, size_t count, uint64_t & index)
+        {
+            if (count > _dims.size()) {
+                return false;
+            }
+
+            index = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (idx[i] >= _dims[i]) {
+                    return false;
+                }
+                index += idx[i] * _strides[i];
+            }
+
+            return true;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Query length of file that was imported
+        //
+        size_t importedLength()
+        {
+            return _importedLength;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Direct metadata access. Decodes any metadata still pending from a
+        // lazy import.
+        //
+        std::shared_ptr<paxMetaMap_t> & meta()
+        {
+            resolveAllMeta();
+            return _meta;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Enable or disable lazy metadata. In lazy mode importHeader only
+        // records the name and offset of each metadata line, and the value is
+        // decoded the first time it is requested. The header text is kept
+        // until every entry has been decoded.
+        //
+        void setLazyMeta(bool lazy)
+        {
+            _lazyMeta = lazy;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Find metadata by name, decoding it first if it is still pending.
+        // Returns NULL if not found.
+        //
+        meta_t * findMeta(const std::string & key)
+        {
+            PaxMetaName name = PaxMetaName::lookup(key);
+
+            if (_meta) {
+                auto iter = _meta->find(name);
+                if (_meta->end() != iter) {
+                    return &iter->second;
+                }
+            }
+
+            auto lazy = _lazyIndex.find(name);
+            if (_lazyIndex.end() == lazy) {
+                return NULL;
+            }
+
+            return resolveMeta(lazy);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Number of metadata entries still waiting to be decoded
+        //
+        size_t getPendingMetaCount()
+        {
+            return _lazyIndex.size();
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Check for metadata
+        //
+        paxMetaDataTypes_e getMetaType(std::string key)
+        {
+            meta_t * found = findMeta(key);
+            bool hasit = (NULL != found);
+            if (hasit) {
+                PAX_LOG(2, << "found " << key.c_str() << " of type " << (int)found->type << " in metadata");
+            } else {
+                PAX_LOG_ERROR(1, << "could not find " << key.c_str() << " in metadata");
+            }
+
+            if (!hasit) {
+                return paxMetaDataTypes_e::paxInvalid;
+            }
+
+            return found->type;
+        } // getMetaType(std::string key)
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract float from metadata
+        //
+        float getMetaFloat(std::string key)
+        {
+            meta_t * found = findMeta(key);
+            float val = std::numeric_limits<float>::quiet_NaN();
+            bool hasit = (NULL != found);
+            if (!hasit) {
+                PAX_LOG_ERROR(1, << "getting float metadata, could not find '" << key.c_str() << "'");
+                PaxStatic::setStatus(PAX_FAIL);
+                return val;
+            }
+
+            bool validType = found->type != paxMetaDataTypes::paxInvalid;
+            if (!validType) {
+                PAX_LOG_ERROR(1, << "getting float metadata, invalid type found for '" << key.c_str() << "'");
+                PaxStatic::setStatus(PAX_FAIL);
+                return val;
+            }
+
+            // If the meta is an array the value will be nonsensical. Just let this happen.
+            if (found->isArray()) {
+                PAX_LOG_ERROR(1, << "getting float metadata, accessing array data as scalar for '" << key.c_str() << "'");
+                val = found->fb[0];
+            } else {
+                val = found->f;
+            }
+
+            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << val);
+
+            return val;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract float from metadata (array)
+        //
+        float getMetaFloat(std::string key, std::vector<uint32_t> &indices)
+        {
+            meta_t * found = findMeta(key);
+            float val = std::numeric_limits<float>::quiet_NaN();
+            bool hasit = (NULL != found);
+            if (!hasit) {
+                PAX_LOG_ERROR(1, << "getting float metadata, could not find '" << key.c_str() << "'");
+                PaxStatic::setStatus(PAX_FAIL);
+                return val;
+            }
+
+            bool validType = found->type != paxMetaDataTypes::paxInvalid;
+            if (!validType) {
+                PAX_LOG_ERROR(1, << "getting float metadata, invalid type found for '" << key.c_str() << "'");
+                PaxStatic::setStatus(PAX_FAIL);
+                return val;
+            }
+
+            // If the meta is not an array the value will probably be nonsensical. Just let this happen.
+            if (!(found->num_dims == indices.size())) {
+                PAX_LOG_ERROR(1, << "getting float metadata, accessing scalar data with indexes for '" << key.c_str() << "'");
+                return val;
+            }
+
+            size_t index = found->I(indices);
+            if (!PaxStatic::paxNoError()) {
+                return val;
+            }
+            val = found->fb[index];
+            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << val);
+
+            return val;
+
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract float from metadata (array)
+        //
+        float getMetaFloat(std::string key, std::initializer_list<uint32_t> list)
+        {
+            std::vector<uint32_t> indices(list);
+            return getMetaFloat(key, indices);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract double from metadata
+        //
+        double getMetaDouble(std::string key)
+        {
+            meta_t * found = findMeta(key);
+            double val = std::numeric_limits<double>::quiet_NaN();
+            bool hasit = (NULL != found);
+            if (!hasit) {
+                PAX_LOG_ERROR(1, << "getting double metadata, could not find '" << key.c_str() << "'");
+                PaxStatic::setStatus(PAX_FAIL);
+                return val;
+            }
+
+            bool validType = found->type != paxMetaDataTypes::paxInvalid;
+            if (!validType) {
+                PAX_LOG_ERROR(1, << "getting double metadata, invalid type found for '" << key.c_str() << "'");
+                PaxStatic::setStatus(PAX_FAIL);
+                return val;
+            }
+
+            // If the meta is an array the value will be nonsensical. Just let this happen.
+            if (found->isArray()) {
+                PAX_LOG_ERROR(1, << "getting double metadata, accessing array data as scalar for '" << key.c_str() << "'");
+            }
+
+            val = found->d;
+            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << val);
+
+            return val;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract double from metadata (array)
+        //
+        double getMetaDouble(std::string key, std::vector<uint32_t> &indices)
+        {
+            meta_t * found = findMeta(key);
+            double val = std::numeric_limits<double>::quiet_NaN();
+            bool hasit = (NULL != found);
+            if (!hasit) {
+                PAX_LOG_ERROR(1, << "getting double metadata, could not find '" << key.c_str() << "'");
+                return val;
+            }
+
+            bool validType = found->type != paxMetaDataTypes::paxInvalid;
+            if (!validType) {
+                PAX_LOG_ERROR(1, << "getting double metadata, invalid type found for '" << key.c_str() << "'");
+                return val;
+            }
+
+            // If the meta is not an array the value will probably be nonsensical.
+            if (!(found->num_dims == indices.size())) {
+                PAX_LOG_ERROR(1, << "getting double metadata, accessing scalar data with indexes for '" << key.c_str() << "'");
+                return val;
+            }
+
+            size_t index = found->I(indices);
+            if (!PaxStatic::paxNoError()) {
+                return val;
+            }
+            val = found->db[index];
+            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << val);
+
+            return val;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract float from metadata (array)
+        //
+        double getMetaDouble(std::string key, std::initializer_list<uint32_t> list)
+        {
+            std::vector<uint32_t> indices(list);
+            return getMetaDouble(key, indices);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract integer types from metadata
+        //
+        template <typename T>
+        T getMetaInteger(std::string key) {
+
+            T errorcode = std::numeric_limits<T>::max();
+            meta_t * found = findMeta(key);
+            bool hasit = (NULL != found);
+            if (!hasit) {
+                PAX_LOG_ERROR(1, << "getting integer metadata, could not find '" << key.c_str() << "'");
+                return errorcode;
+            }
+
+            bool validType = found->type != paxMetaDataTypes::paxInvalid;
+            if (!validType) {
+                PAX_LOG_ERROR(1, << "getting integer metadata, invalid type found for '" << key.c_str() << "'");
+                return errorcode;
+            }
+
+            // If the meta is an array the value will probably be nonsensical.
+            T val = errorcode;
+            if (found->isArray()) {
+                PAX_LOG_ERROR(1, << "getting integer metadata, accessing array data as scalar for '" << key.c_str() << "'");
+                val = static_cast<T>(found->u64b[0]); // static_cast doesn't care about signed-ness. TODO: endian problems though.
+
+            } else {
+
+                val = static_cast<T>(found->u64); // static_cast doesn't care about signed-ness. TODO: endian problems though.
+
+            }
+
+            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << +val);
+
+            return val;
+
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract integer types from metadata (array)
+        //
+        template <typename T>
+        T getMetaInteger(std::string key, std::vector<uint32_t> &indices) {
+
+            T errorcode = std::numeric_limits<T>::max();
+            meta_t * found = findMeta(key);
+            bool hasit = (NULL != found);
+            if (!hasit) {
+                PAX_LOG_ERROR(1, << "getting integer metadata, could not find '" << key.c_str() << "'");
+                PaxStatic::setStatus(PAX_FAIL);
+                return errorcode;
+            }
+
+            bool validType = found->type != paxMetaDataTypes::paxInvalid;
+            if (!validType) {
+                PAX_LOG_ERROR(1, << "getting integer metadata, invalid type found for '" << key.c_str() << "'");
+                PaxStatic::setStatus(PAX_FAIL);
+                return errorcode;
+            }
+
+            // If the meta is not an array the value will probably be nonsensical.
+            if (!(found->num_dims == indices.size())) {
+                PAX_LOG_ERROR(1, << "getting integer metadata, accessing array data as scalar for '" << key.c_str() << "'");
+                return errorcode;
+            }
+
+            T *bufPtr = static_cast<T*>(found->bufPtr());
+            size_t index = found->I(indices);
+            if (!PaxStatic::paxNoError()) {
+                return errorcode;
+            }
+            T val = bufPtr[index];
+            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << +val);
+
+            return val;
+
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract integer types from metadata (array)
+        //
+        template <typename T>
+        T getMetaInteger(std::string key, std::initializer_list<uint32_t> list) {
+            std::vector<uint32_t> indices(list);
+            return getMetaInteger<T>(key, indices);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract specific scalar types from metadata
+        //
+        int64_t  getMetaInt64(std::string key) { return getMetaInteger<int64_t>(key); }
+        uint64_t getMetaUint64(std::string key) { return getMetaInteger<uint64_t>(key); }
+        int32_t  getMetaInt32(std::string key) { return getMetaInteger<int32_t>(key); }
+        uint32_t getMetaUint32(std::string key) { return getMetaInteger<uint32_t>(key); }
+        int16_t  getMetaInt16(std::string key) { return getMetaInteger<int16_t>(key); }
+        uint16_t getMetaUint16(std::string key) { return getMetaInteger<uint16_t>(key); }
+        int8_t  getMetaInt8(std::string key) { return getMetaInteger<int8_t>(key); }
+        uint8_t getMetaUint8(std::string key) { return getMetaInteger<uint8_t>(key); }
+
+        // array index via vector
+        int64_t  getMetaInt64(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<int64_t>(key, indices); }
+        uint64_t getMetaUint64(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<uint64_t>(key, indices); }
+        int32_t  getMetaInt32(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<int32_t>(key, indices); }
+        uint32_t getMetaUint32(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<uint32_t>(key, indices); }
+        int16_t  getMetaInt16(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<int16_t>(key, indices); }
+        uint16_t getMetaUint16(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<uint16_t>(key, indices); }
+        int8_t  getMetaInt8(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<int8_t>(key, indices); }
+        uint8_t getMetaUint8(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<uint8_t>(key, indices); }
+
+        //// array index via initializer list
+        //int64_t  getMetaInt64 (std::string key, std::initializer_list<uint32_t> list)    { return getMetaInteger<int64_t> (key, list); }
+        //uint64_t getMetaUint64 (std::string key, std::initializer_list<uint32_t> list)   { return getMetaInteger<uint64_t> (key, list); }
+        //int64_t  getMetaInt32 (std::string key, std::initializer_list<uint32_t> list)    { return getMetaInteger<int32_t> (key, list); }
+        //uint64_t getMetaUint32 (std::string key, std::initializer_list<uint32_t> list)   { return getMetaInteger<uint32_t> (key, list); }
+        //int64_t  getMetaInt16 (std::string key, std::initializer_list<uint32_t> list)    { return getMetaInteger<int16_t> (key, list); }
+        //uint64_t getMetaUint16 (std::string key, std::initializer_list<uint32_t> list)   { return getMetaInteger<uint16_t> (key, list); }
+        //int64_t  getMetaInt8 (std::string key, std::initializer_list<uint32_t> list)     { return getMetaInteger<int8_t> (key, list); }
+        //uint64_t getMetaUint8 (std::string key, std::initializer_list<uint32_t> list)    { return getMetaInteger<uint8_t> (key, list); }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Extract string from metadata
+        //
+        std::string getMetaString(std::string key)
+        {
+            meta_t * found = findMeta(key);
+            bool hasit = (NULL != found);
+            if (!hasit) {
+                PAX_LOG_ERROR(1, << "getting metadata, could not find '" << key.c_str() << "'");
+                return "";
+            }
+
+            std::string str = found->s;
+            PAX_LOG(2, << "getting metadata: '" << key << "' = " << str);
+
+            return str;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Convert the data to float, value by value. Returns nullptr if the
+        // type cannot be converted.
+        //
+        static std::shared_ptr<float> getFloatData(rasterFileBase *paxIn)
+        {
+            if (NULL == paxIn) return nullptr;
+
+            std::shared_ptr<float> floatData(new float[paxIn->getNumValues()], std::default_delete<float[]>());
+            if (PAX_OK != convert(paxIn, paxTypes::ePAX_FLOAT, floatData.get())) {
+                return nullptr;
+            }
+
+            return floatData;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Convert the data of any raster to another type with the same values
+        // per element (see rasterFile::convertTo)
+        //
+        static int convert(rasterFileBase *paxIn, paxTypes_e type, void * out, const paxConvert_t & options = paxConvert_t())
+        {
+            switch (paxIn->getType()) {
+
+#define X(name,val,bpv,vpe) case paxTypes::ePAX_ ## name : return convertAs<paxTypes::ePAX_ ## name> (paxIn, type, out, options);
+                PAX_TYPE_DATA
+#undef X
+
+            default:
+                PAX_LOG_ERROR(1, << "Unsupported PAX type " << getTypeName(paxIn->getType()));
+                return PAX_INVALID;
+            }
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Checks for existence of the given directory
+        //
+        static bool isDirExist(const std::string& path)
+        {
+            struct pax_stat info;
+            if (pax_stat(path.c_str(), &info) != 0)
+            {
+                return false;
+            }
+            return (info.st_mode & pax_ifdir) != 0;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // makes the full given path
+        //
+        static bool makePath(const std::string& path)
+        {
+#ifndef _WIN32
+            mode_t mode = 0755;
+#endif
+            int ret = pax_mkdir(path.c_str(), mode);
+            if (ret == 0)
+                return true;
+
+            switch (errno)
+            {
+            case ENOENT:
+              // parent didn't exist, try to create it
+            {
+                size_t pos = path.find_last_of('/');
+                if (pos == std::string::npos)
+#if defined(_WIN32)
+                    pos = path.find_last_of('\\');
+                if (pos == std::string::npos)
+#endif
+                    return false;
+                if (!makePath(path.substr(0, pos)))
+                    return false;
+            }
+            // now, try to create again
+            return 0 == pax_mkdir(path.c_str(), mode);
+
+            case EEXIST:
+              // done!
+                return isDirExist(path);
+
+            default:
+                return false;
+            }
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // output given PAX buffer to file
+        //
+        static int writeToFile(std::ostringstream & oss, pax_filestring fileName) {
+            // TODO: PAX improve writeToFile(ostringstream), needs 2 copies
+            std::string str = oss.str();
+            paxBufPtr buf = std::make_shared<paxBuf_t>(str.length());
+            memcpy(buf->data(), str.c_str(), str.length());
+            return writeToFile(buf, fileName);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // output given PAX buffer to file
+        //
+        static int writeToFile(paxBufPtr &buf, pax_filestring fileName) {
+            PAX_LOG(1, << "Writing PAX buffer " << "of size " << buf->size() << " to " << fileName);
+
+            int fd = openForWrite(fileName);
+            if (-1 == fd) {
+                return PAX_FAIL;
+            }
+
+            paxSegment_t seg{ buf->data(), buf->size() };
+            int64_t ret = writeSegments(fd, &seg, 1);
+            pax_close(fd);
+
+            if (ret != (int64_t)buf->size()) {
+                PAX_LOG_ERROR(1, << "Failure. Wrote " << ret << " bytes but expected " << buf->size() << ".");
+                return PAX_FAIL;
+            }
+
+            PAX_LOG(1, << "Successfully wrote " << buf->size() << " bytes.");
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // open the given file and read its contents on a chunk-by-chunk basis
+        //
+        // note that CHUNK_LEN is tied to size of file read in test_previewmeta_only_multichunk
+        //
+#define CHUNK_LEN 16384
+        static paxBufPtr readFileChunk(pax_filestring fileName, int nChunk = 0) {
+
+            PAX_LOG(2, << "Reading chunk " << nChunk << " from " << fileName);
+
+            // open the file
+            int fd = pax_open(fileName.c_str(), O_BINARY | O_RDONLY, 0660);
+            if (-1 == fd) {
+                PAX_LOG_ERRNO(1, << " opening input file.");
+                return nullptr;
+            }
+
+            PAX_LOG(2, << "successfully opened file");
+
+            // get file size, create buffer
+            int64_t fileLength = pax_lseek(fd, 0, SEEK_END);
+            if (-1 == fileLength) {
+                PAX_LOG_ERRNO(1, << " getting size of input file.");
+                pax_close(fd);
+                return nullptr;
+            }
+
+            PAX_LOG(2, << "file length is " << fileLength);
+
+            int64_t start = (int64_t)nChunk * CHUNK_LEN;
+
+            // trivial case: start is past EOF
+            if (start > fileLength) {
+                PAX_LOG_WARN(2, << "start of chunk " << nChunk << " is beyond length of file. Returning empty buffer.");
+                return std::make_shared<paxBuf_t>(0);
+            }
+
+            int64_t length = CHUNK_LEN;
+
+            // check for partial chunk
+            if (start + CHUNK_LEN > fileLength) {
+                length = fileLength - start;
+                PAX_LOG_WARN(2, << "End of chunk " << nChunk << " is beyond length of file. Returning partial chunk of length " << length);
+            }
+
+            // allocate buffer for input file
+            paxBufPtr inBuf = std::make_shared<paxBuf_t>(length);
+            if (!inBuf) {
+                PAX_LOG_ERROR(1, << "Failed allocating input buffer. Returning null.");
+                return nullptr;
+            }
+
+            // read the file into buffer
+            pax_lseek(fd, start, SEEK_SET);
+            char *buf = inBuf->data();
+            int64_t readRet = readFully(fd, buf, length);
+
+            // close the file
+            pax_close(fd);
+            if (readRet != length) {
+                PAX_LOG_ERROR(1, << " reading input file.");
+                return nullptr;
+            }
+
+            PAX_LOG(2, << "readFile done");
+
+            return inBuf;
+
+        } // paxBufPtr readFile (pax_filestring fileName)
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // open the given file and read its contents
+        //
+        static paxBufPtr readFile(pax_filestring fileName) {
+
+            PAX_LOG(1, << "Reading " << fileName);
+
+            // open the file
+            int fd = pax_open(fileName.c_str(), O_BINARY | O_RDONLY, 0660);
+            if (-1 == fd) {
+                PAX_LOG_ERRNO(1, << " opening input file.");
+                return nullptr;
+            }
+
+            PAX_LOG(2, << "successfully opened file");
+
+            // get file size, create buffer
+            int64_t length = pax_lseek(fd, 0, SEEK_END);
+            if (-1 == length) {
+                PAX_LOG_ERRNO(1, << " getting size of input file.");
+                pax_close(fd);
+                return nullptr;
+            }
+
+            PAX_LOG(2, << "file length is " << length);
+
+            // allocate buffer for input file
+            paxBufPtr inBuf = std::make_shared<paxBuf_t>(length);
+            if (!inBuf) {
+                PAX_LOG_ERROR(1, << "Failed allocating input buffer.");
+                return nullptr;
+            }
+
+            // read the file into buffer
+            pax_lseek(fd, 0, SEEK_SET);
+            char *buf = inBuf->data();
+            int64_t readRet = readFully(fd, buf, length);
+
+            // close the file
+            pax_close(fd);
+            if (readRet != length) {
+                PAX_LOG_ERROR(1, << " reading input file.");
+                return nullptr;
+            }
+
+            PAX_LOG(2, << "readFile done");
+
+            return inBuf;
+
+        } // paxBufPtr readFile (pax_filestring fileName)
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Append a number to the header text in its shortest form that reads
+        // back exactly
+        //
+        template <typename T>
+        static void appendNumber(std::string & out, const T val) {
+
+            char text[32];
+            char * end = text;
+
+            if constexpr (std::is_floating_point_v<T>) {
+#ifdef __cpp_lib_to_chars
+                end = std::to_chars(text, text + sizeof(text), val).ptr;
+#else
+                end += snprintf(text, sizeof(text), "%.*g", std::numeric_limits<T>::max_digits10, (double)val);
+#endif
+            } else {
+                end = std::to_chars(text, text + sizeof(text), val).ptr;
+            }
+
+            out.append(text, end - text);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Append a header line of the form "TAG : value"
+        //
+        static void appendTag(std::string & out, const char * tag, const uint64_t val) {
+            out += tag;
+            out += " : ";
+            appendNumber(out, val);
+            out += '\n';
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Append the elements of a metadata array. Multidimensional arrays
+        // begin on a new line and are indented.
+        //
+        template <typename T>
+        static void appendMetaValues(std::string & out, const T * vals, const size_t count, const size_t rowlength, const bool rows) {
+            for (size_t i = 0; i < count; ++i) {
+                if (rows && 0 == (i % rowlength)) {
+                    out += "\n ";
+                }
+                out += ' ';
+                appendNumber(out, vals[i]);
+            }
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Helper function to write metadata. Assumes the given data have been sorted.
+        //
+        int writeMeta(std::string &out, std::vector<std::pair<std::string, meta_t *>> &metavec) {
+
+            for (auto & meta : metavec) {
+
+                meta_t & m = *meta.second;
+                paxMetaDataTypes_e type = m.type;
+
+                // handle trivial and nonnumeric types first
+                switch (type) {
+
+                case paxMetaDataTypes_e::paxComment:
+                    out += (m.stripped ? "# " : "#");
+                    out += m.s;
+                    out += '\n';
+                    continue;
+
+                case paxMetaDataTypes_e::paxString:
+                    out += "@ [";
+                    out += METATYPE_STRING_TAG;
+                    out += "]   ";
+                    out += meta.first;
+                    out += (m.stripped ? " = " : " =");
+                    out += m.s;
+                    out += '\n';
+                    continue;
+
+                case paxMetaDataTypes_e::paxInvalid:
+                    continue;
+
+                default: break;
+
+                } // switch (type), trivial types
+
+                // scalars are written through the same pointers as arrays
+                const char * data = m.isArray() ? m.buf : reinterpret_cast<const char*>(&m.u64);
+
+                size_t count = m.count();
+                size_t rowlength = 1;
+
+                // write the type tag, padded to 11 characters, and name
+                size_t start = out.length();
+                out += "@ [";
+                out += PaxStatic::getMetaTypeTag(type);
+                out += ']';
+                out.append(PAX_MAX((size_t)13, out.length() - start + 1) - (out.length() - start), ' ');
+                out += meta.first;
+
+                if (m.dimCount() >= 1) {
+
+                  // choose a reasonable length for separating data into rows
+                    for (int i = 0; i < m.num_dims && rowlength < 16; ++i) {
+                        rowlength *= m.dims[i];
+                    }
+
+                    // write the array index tags and values
+                    out += " [";
+                    for (size_t i = 0; i < m.dimCount(); ++i) {
+                        out += ' ';
+                        out += PaxStatic::getMetaArrayIndexTag((uint32_t)i);
+                        out += " = ";
+                        appendNumber(out, m.dims[i]);
+                    }
+                    out += " ]";
+
+                }
+
+                out += " ="; // write delimiter
+
+                bool rows = m.dimCount() > 1;
+                switch (type) {
+
+                case paxMetaDataTypes_e::paxFloat:  appendMetaValues(out, reinterpret_cast<const float*>(data), count, rowlength, rows);     break;
+
+                case paxMetaDataTypes_e::paxDouble: appendMetaValues(out, reinterpret_cast<const double*>(data), count, rowlength, rows);    break;
+
+                case paxMetaDataTypes_e::paxInt64:  appendMetaValues(out, reinterpret_cast<const int64_t*>(data), count, rowlength, rows);   break;
+
+                case paxMetaDataTypes_e::paxUint64: appendMetaValues(out, reinterpret_cast<const uint64_t*>(data), count, rowlength, rows);  break;
+
+                case paxMetaDataTypes_e::paxInt32:  appendMetaValues(out, reinterpret_cast<const int32_t*>(data), count, rowlength, rows);   break;
+
+                case paxMetaDataTypes_e::paxUint32: appendMetaValues(out, reinterpret_cast<const uint32_t*>(data), count, rowlength, rows);  break;
+
+                case paxMetaDataTypes_e::paxInt16:  appendMetaValues(out, reinterpret_cast<const int16_t*>(data), count, rowlength, rows);   break;
+
+                case paxMetaDataTypes_e::paxUint16: appendMetaValues(out, reinterpret_cast<const uint16_t*>(data), count, rowlength, rows);  break;
+
+                case paxMetaDataTypes_e::paxInt8:   appendMetaValues(out, reinterpret_cast<const int8_t*>(data), count, rowlength, rows);    break;
+
+                case paxMetaDataTypes_e::paxUint8:  appendMetaValues(out, reinterpret_cast<const uint8_t*>(data), count, rowlength, rows);   break;
+
+                default: break;
+
+                } // switch (type)
+
+                out += '\n';
+
+            } // for (auto meta : metavec) 
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Set the dimensions and rebuild the stride table. Fewer than two
+        // dimensions are padded with 1's; an empty raster clears the shape.
+        // Returns PAX_INVALID, and clears the shape, if the number of data
+        // bytes would not fit in 64 bits.
+        //
+        int setShape(const std::vector<uint64_t> & dims) {
+
+            _dims = dims;
+            while (!_dims.empty() && _dims.size() < 2) {
+                _dims.push_back(1);
+            }
+
+            const uint64_t elemBytes = PAX_MAX((uint64_t)getBPV(_dataType) * getVPE(_dataType), (uint64_t)1);
+            _strides.resize(_dims.size());
+            uint64_t count = _dims.empty() ? 0 : 1;
+            bool overflow = false;
+            for (size_t i = 0; i < _dims.size(); ++i) {
+                _strides[i] = count;
+                overflow = overflow || (0 != _dims[i] && count > UINT64_MAX / elemBytes / _dims[i]);
+                count *= _dims[i];
+            }
+
+            if (overflow) {
+                PAX_LOG_ERROR(1, << "PAX raster of " << _dims.size() << " dimensions is too large to address");
+                count = 0;
+            }
+            if (0 == count) {
+                _dims.clear();
+                _strides.clear();
+            }
+
+            _numValues = count;
+            _numSequential = getDim(0) * (count != 0);
+            _numStrided = getDim(1) * (count != 0);
+
+            return overflow ? PAX_INVALID : PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // writeHeader: writes the PAX header, up to and including DATA_LENGTH.
+        // A raster with data encodes them first, so the payload length and
+        // checksums in the header are those of the data as they stand.
+        // (base class implementation has no data)
+        //
+        virtual int writeHeader(std::string &out) {
+            return renderHeader(out);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // writeHeader: writes the PAX header to a stream
+        //
+        int writeHeader(pax_stringstream &ss) {
+
+            std::string header;
+            int ret = writeHeader(header);
+            ss << header;
+
+            return ret;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // writeHeader: renders the header and locates the payload that
+        // follows it, tiled and compressed as set. The payload points into
+        // the raster, or into scratch if it had to be rearranged, so nothing
+        // is copied for a plain raster. (base class implementation has no
+        // payload)
+        //
+        virtual int writeHeader(std::string &out, std::vector<char> &/*scratch*/, paxSegment_t &payload) {
+            payload = { NULL, 0 };
+            return renderHeader(out);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // writeToBuffer: writes PAX to a buffer (base class implementation writes header only)
+        // 
+        virtual int writeToBuffer(paxBufPtr &outBuf) {
+
+            std::string header;
+            renderHeader(header);
+
+            outBuf = std::make_shared<paxBuf_t>(header.length());
+            memcpy(outBuf->data(), header.c_str(), header.length());
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // open (and truncate) the given file for writing
+        //
+        static int openForWrite(pax_filestring fileName) {
+
+            pax_remove(fileName.c_str());
+            int fd = pax_open(fileName.c_str(), O_BINARY | O_CREAT | O_WRONLY | _O_TRUNC, 0660);
+            if (-1 == fd) {
+                PAX_LOG_ERRNO(1, << "Error " << errno << " opening output file.");
+            }
+
+            return fd;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // write the given segments to an open file, in order, at the current
+        // file position. Uses a single gather call (writev) where the platform
+        // has one, and retries until everything is written.
+        // Returns the number of bytes written or -1 on error.
+        //
+        static int64_t writeSegments(int fd, const paxSegment_t *segs, size_t count) {
+
+            int64_t total = 0;
+
+#ifdef _WIN32
+            for (size_t i = 0; i < count; ++i) {
+                const char * data = segs[i].first;
+                uint64_t left = segs[i].second;
+                while (left > 0) {
+                    unsigned int len = (unsigned int)PAX_MIN(left, (uint64_t)PAX_MAX_IO_LEN);
+                    int ret = pax_write(fd, data, len);
+                    if (ret <= 0) {
+                        PAX_LOG_ERRNO(1, << " writing segment " << i << " of " << count);
+                        return -1;
+                    }
+                    data += ret;
+                    left -= ret;
+                    total += ret;
+                }
+            }
+#else
+            std::vector<struct iovec> iov;
+            iov.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                if (segs[i].second > 0) {
+                    iov.push_back({ const_cast<char*>(segs[i].first), (size_t)segs[i].second });
+                }
+            }
+
+            size_t first = 0;
+            while (first < iov.size()) {
+                int n = (int)PAX_MIN(iov.size() - first, (size_t)PAX_MAX_IOV);
+                ssize_t ret = writev(fd, iov.data() + first, n);
+                if (ret < 0 && EINTR == errno) {
+                    continue;
+                }
+                if (ret <= 0) {
+                    PAX_LOG_ERRNO(1, << " writing " << n << " segments");
+                    return -1;
+                }
+                total += ret;
+
+                // step past what was written; a partial write leaves us inside a segment
+                size_t done = (size_t)ret;
+                while (first < iov.size() && done >= iov[first].iov_len) {
+                    done -= iov[first].iov_len;
+                    ++first;
+                }
+                if (first < iov.size()) {
+                    iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + done;
+                    iov[first].iov_len -= done;
+                }
+            }
+#endif
+
+            return total;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // write the given segments to an open file at the given offset
+        //
+        static int64_t writeSegmentsAt(int fd, uint64_t offset, const paxSegment_t *segs, size_t count) {
+
+            if (-1 == pax_lseek(fd, offset, SEEK_SET)) {
+                PAX_LOG_ERRNO(1, << " seeking to offset " << offset);
+                return -1;
+            }
+
+            return writeSegments(fd, segs, count);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // read exactly len bytes from an open file at the current file
+        // position, looping over partial reads. Each read is capped at
+        // PAX_MAX_IO_LEN since the CRT read takes a 32-bit count.
+        // Returns the number of bytes read (short only at EOF) or -1 on error.
+        //
+        static int64_t readFully(int fd, char *buf, uint64_t len) {
+
+            int64_t total = 0;
+            while ((uint64_t)total < len) {
+                unsigned int chunk = (unsigned int)PAX_MIN(len - total, (uint64_t)PAX_MAX_IO_LEN);
+                int64_t ret = pax_read(fd, buf + total, chunk);
+                if (ret < 0 && EINTR == errno) {
+                    continue;
+                }
+                if (ret < 0) {
+                    PAX_LOG_ERRNO(1, << " reading " << chunk << " bytes at offset " << total);
+                    return -1;
+                }
+                if (0 == ret) {
+                    break;
+                }
+                total += ret;
+            }
+
+            return total;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // record the metadata line at the current buffer position for lazy
+        // decoding
+        //
+        void indexMeta(BufMan & buf) {
+
+            std::string name;
+            lazyMeta_t entry;
+            entry.offset = buf.offset();
+            if (PAX_OK == buf.indexMeta(name, entry.loc, entry.index)) {
+                auto iter = _meta->find(name);
+                if (_meta->end() != iter) {
+                    releaseMeta(iter->second);
+                    _meta->erase(iter);
+                }
+                _lazyIndex[name] = entry;
+            }
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // importHeader: import an PAX header from a buffer
+        // 
+        int importHeader(BufMan & buf, uint64_t &dataLen, bool fastImport = false) {
+          // DEVCODE: verbosityLevel in importHeader
+#define verbosityLevel 2
+
+      // sanity check
+            paxTypes_e  paxType = paxTypes_e::ePAX_INVALID;
+            float       version = 0.0f;
+            if (!validatePaxTag(buf.pos(), paxType, version, buf.bufEnd())) {
+                PAX_LOG_ERROR(1, << "not a valid PAX file");
+                return PAX_FAIL;
+            }
+
+            _dataType = paxType;
+            _version = version;
+
+            PAX_LOG(2, << "validatePaxTag done");
+            //if (buf.skipLine ()) { reportEOF (); return -1; }
+            PAX_LOG(2, << "begin parsing header lines");
+
+            int32_t bpv = 0, vpe = 0, datalencount = 0;
+            uint64_t tileWidth = 0, tileHeight = 0;
+            paxCodec_e codec = CODEC_NONE;
+            uint64_t blockLength = PAX_COMPRESSION_BLOCK, uncompressedLength = 0;
+            bool checksum = false;
+            uint32_t payloadCrc = 0;
+            std::vector<uint32_t> blockCrcs;
+            std::vector<uint64_t> dims;
+            std::vector<int32_t> dimcounts;
+
+            metaMap();
+            buf.setArena(metaArena());
+            _lazyIndex.clear();
+            _headerBuf = nullptr;
+
+            hlType_t type = HEADERLINETYPE::NOT_CHECKED;
+
+            // Begin parsing header lines. Check for EOF each line.
+            while (!buf.eof()) {
+
+                bool headerDone = false;
+                bool nextLine = false;
+                std::pair <std::string, meta_t> meta1;
+
+                if (HEADERLINETYPE::NOT_CHECKED == type) {
+                    type = buf.getHeaderLineType(); // returns the line type but no further checking
+                }
+
+                switch (type) {
+                case hlType_t::UNKNOWN:
+                default:
+                    PAX_LOG(verbosityLevel, << "Skipping line of type " << (int)type);
+                    nextLine = true;
+                    break;
+
+                case hlType_t::PAX:
+                    PAX_LOG(verbosityLevel, << "Skipping line of type " << (int)type);
+                    buf.setLoc(metaLoc::LOC_AFTER_TAG, _metaLocCount[LOC_AFTER_TAG]);
+                    nextLine = true;
+                    break;
+
+                case hlType_t::BPV:
+                    bpv = buf.getUint32(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
+                    PAX_LOG(verbosityLevel, << "Read BPV = " << bpv);
+                    buf.setLoc(metaLoc::LOC_AFTER_TAG, /*LOC_AFTER_BPV, */_metaLocCount[LOC_AFTER_TAG/*LOC_AFTER_BPV*/]);    // TEMPCODE: single meta location
+                    break;
+
+                case hlType_t::VPE:
+                    vpe = buf.getUint32(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
+                    PAX_LOG(verbosityLevel, << "Read VPE = " << vpe);
+                    buf.setLoc(metaLoc::LOC_AFTER_TAG, /*LOC_AFTER_VPE, */_metaLocCount[LOC_AFTER_TAG/*LOC_AFTER_VPE*/]);    // TEMPCODE: single meta location
+                    break;
+
+                case hlType_t::DIM: {
+                    uint64_t dim = buf.getDimTagIndex();
+                    if (dim >= PAX_MAX_DIMS) {
+                        PAX_LOG_ERROR(1, << "Dimension " << dim + 1 << " exceeds the supported maximum of " << PAX_MAX_DIMS);
+                        return PAX_INVALID;
+                    }
+                    if (dim >= dims.size()) {
+                        dims.resize(dim + 1, 0);
+                        dimcounts.resize(dim + 1, 0);
+                    }
+                    dims[dim] = buf.getUint64(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
+                    PAX_LOG(verbosityLevel, << "Read DIM" << dim + 1 << " = " << dims[dim]);
+                    buf.setLoc(metaLoc::LOC_AFTER_TAG, _metaLocCount[LOC_AFTER_TAG]);    // TEMPCODE: single meta location
+                    ++dimcounts[dim];
+                    break;
+                }
+
+                case hlType_t::TILE_WIDTH:
+                    tileWidth = buf.getUint64(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
+                    PAX_LOG(verbosityLevel, << "Read TILE_WIDTH = " << tileWidth);
+                    break;
+
+                case hlType_t::TILE_HEIGHT:
+                    tileHeight = buf.getUint64(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
+                    PAX_LOG(verbosityLevel, << "Read TILE_HEIGHT = " << tileHeight);
+                    break;
+
+                case hlType_t::COMPRESSION: {
+                    char * pos = buf.pos();
+                    BufMan::skipDelimiter(pos, false, buf.bufEnd());
+                    codec = PaxCodec::getCodec(pos, buf.bufEnd());
+                    PAX_LOG(verbosityLevel, << "Read COMPRESSION = " << PaxCodec::getName(codec));
+                    nextLine = true;
+                    break;
+                }
+
+                case hlType_t::COMPRESSION_BLOCK:
+                    blockLength = buf.getUint64(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
+                    PAX_LOG(verbosityLevel, << "Read COMPRESSION_BLOCK = " << blockLength);
+                    break;
+
+                case hlType_t::UNCOMPRESSED_LENGTH:
+                    uncompressedLength = buf.getUint64(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
+                    PAX_LOG(verbosityLevel, << "Read UNCOMPRESSED_LENGTH = " << uncompressedLength);
+                    break;
+
+                case hlType_t::CHECKSUM: {
+                    char * pos = buf.pos();
+                    BufMan::skipDelimiter(pos, false, buf.bufEnd());
+                    size_t nameLen = PaxStatic::matchTag(pos, CRC32C_NAME, buf.bufEnd());
+                    if (0 == nameLen) {
+                        PAX_LOG_ERROR(1, << "Unknown PAX checksum algorithm");
+                        return PAX_INVALID;
+                    }
+                    buf.pos() = pos + nameLen;
+                    payloadCrc = buf.getUint32(skipFlags::SKIP_LINEFEED);
+                    checksum = true;
+                    PAX_LOG(verbosityLevel, << "Read CHECKSUM = " << PaxChecksum::toString(payloadCrc));
+                    break;
+                }
+
+                case hlType_t::BLOCK_CHECKSUMS: {
+                    // the tiling or compression lines come first and fix the number of blocks
+                    uint64_t blocks = 0;
+                    if (CODEC_NONE != codec) {
+                        blocks = (0 == blockLength) ? 0 : uncompressedLength / blockLength + (0 != uncompressedLength % blockLength);
+                    } else if (0 != tileWidth && 0 != tileHeight && dims.size() >= 2) {
+                        // the rows are every dimension above the first, as getNumRows() counts them
+                        uint64_t rows = 1;
+                        for (size_t i = 1; i < dims.size(); ++i) rows = mulSaturated(rows, dims[i]);
+                        blocks = mulSaturated(dims[0] / tileWidth + (0 != dims[0] % tileWidth), rows / tileHeight + (0 != rows % tileHeight));
+                    }
+                    uint64_t count = buf.getUint64(skipFlags::SKIP_DELIMITER);
+                    if (count != blocks) {
+                        PAX_LOG_ERROR(1, << "PAX header holds " << count << " block checksums for " << blocks << " blocks");
+                        return PAX_INVALID;
+                    }
+                    // grow with the checksums actually present, not with the claimed count
+                    blockCrcs.reserve(PAX_MIN(count, (uint64_t)4096));
+                    while (blockCrcs.size() < count) {
+                        // checksum lines continue with a space; any other line ends the list early
+                        char * pos = buf.pos();
+                        while (!buf.eof(pos) && (' ' == *pos || '\r' == *pos || ('\n' == *pos && !buf.eof(pos + 1) && ' ' == pos[1]))) ++pos;
+                        bool ended = buf.eof(pos) || '\n' == *pos;
+                        if (!ended) {
+                            buf.pos() = pos;
+                            blockCrcs.push_back(buf.getUint32(skipFlags::SKIP_NOTHING));
+                            ended = (pos == buf.pos());
+                        }
+                        if (ended) {
+                            PAX_LOG_ERROR(1, << "PAX header ends within " << count << " block checksums");
+                            return PAX_INVALID;
+                        }
+                    }
+                    if (!buf.eof() && '\n' == *buf.pos()) ++buf.pos();
+                    PAX_LOG(verbosityLevel, << "Read " << count << " BLOCK_CHECKSUMS");
+                    break;
+                }
+
+                case hlType_t::DATALEN:
+                    // stop at the LF: the raster data may begin with whitespace bytes
+                    dataLen = buf.getUint64(skipFlags::SKIP_DELIMITER);
+                    if (!buf.eof() && '\n' == *buf.pos()) ++buf.pos();
+                    PAX_LOG(verbosityLevel, << "Read DATALEN = " << dataLen);
+                    ++datalencount;
+                    headerDone = true;
+                    break;
+
+                case hlType_t::COMMENT:
+                    if (fastImport) {
+                        nextLine = true;
+                    } else if (_lazyMeta) {
+                        indexMeta(buf);
+                        nextLine = true;
+                    } else {
+                        meta1 = buf.getMeta();
+                        PAX_LOG(verbosityLevel, << "Read comment: " << meta1.second.s);
+                        if (paxMetaDataTypes_e::paxInvalid != meta1.second.type) {
+                            releaseMeta(metaMap()[meta1.first]);
+                            metaMap()[meta1.first] = std::move(meta1.second);
+                        }
+                    }
+                    break;
+
+                case hlType_t::METADATA:
+                    if (fastImport) {
+                        nextLine = true;
+                    } else if (_lazyMeta) {
+                        indexMeta(buf);
+                        nextLine = true;
+                    } else {
+                        meta1 = buf.getMeta();
+                        PAX_LOG(verbosityLevel, << "Read METADATA of type " << (int)meta1.second.type << " = " << meta1.first << " = " << meta1.second.value().c_str());
+                        if (paxMetaDataTypes_e::paxInvalid != meta1.second.type) {
+                            releaseMeta(metaMap()[meta1.first]);
+                            metaMap()[meta1.first] = std::move(meta1.second);
+                        }
+                    }
+                    break;
+                }
+
+                // if finished, we may need to skip one last line
+                if (headerDone) {
+
+                    if (nextLine) {
+                        buf.skipLine();
+                    }
+
+                    break;
+                }
+
+                if (nextLine) {
+
+                    PAX_LOG(verbosityLevel, << "Skipping line in header loop");
+
+                    buf.skipLine();
+                    uint32_t skipped = 1;
+                    // the "line" may be multiple lines, e.g. a meta array
+                    while ((type = buf.getHeaderLineType()) == HEADERLINETYPE::UNKNOWN) {
+                        if (buf.eof()) break;
+                        buf.skipLine();
+                        ++skipped;
+                    }
+
+                    PAX_LOG(verbosityLevel, << "Skipped " << skipped << " line(s) in header loop");
+
+                } else {
+                    type = type = HEADERLINETYPE::NOT_CHECKED;
+                }
+
+            } //         while (!buf.eof ()) {
+
+            // keep a private copy of the header text for decoding pending metadata
+            if (!_lazyIndex.empty()) {
+                size_t headerLen = buf.offset();
+                _headerBuf = std::make_shared<paxBuf_t>(headerLen + 1);
+                memcpy(_headerBuf->data(), buf.pos() - headerLen, headerLen);
+                _headerBuf->data()[headerLen] = '\0';
+            }
+
+            // validate required tags: every dimension exactly once, at least the first two
+            bool dimsValid = dims.size() >= 2;
+            for (size_t i = 0; i < dimcounts.size(); ++i) {
+                if (dimcounts[i] != 1) {
+                    PAX_LOG_ERROR(1, << "Dimension " << i + 1 << " was specified " << dimcounts[i] << " times");
+                    dimsValid = false;
+                }
+            }
+            if (!dimsValid || datalencount != 1) {
+                PAX_LOG_ERROR(1, << "Incorrect PAX tags: dimensions=" << dims.size() << ", datalencount=" << datalencount << ". This may expected if previewing a long header.");
+                return PAX_INVALID;
+            }
+
+            if (PAX_OK != setShape(dims) || PAX_OK != setTiling(tileWidth, tileHeight) || PAX_OK != setCompression(codec, blockLength)) {
+                return PAX_INVALID;
+            }
+
+            // validate parameters
+            int32_t _bpv = getBPV(this->_dataType);
+            if (_bpv != bpv) {
+                PAX_LOG_ERROR(1, << "Incorrect bpv. Read " << bpv << " but expected " << _bpv);
+                return PAX_INVALID;
+            }
+
+            int32_t _vpe = getVPE(this->_dataType);
+            if (_vpe != vpe) {
+                PAX_LOG_ERROR(1, << "Incorrect vpe. Read " << vpe << " but expected " << _vpe);
+                return PAX_INVALID;
+            }
+
+            uint64_t myDataLen = getFileDataLength();
+            if (isCompressed()) {
+                if (uncompressedLength != myDataLen) {
+                    PAX_LOG_ERROR(1, << "uncompressed length in file incorrect! Calculated: " << myDataLen << ", read from file: " << uncompressedLength);
+                    return PAX_INVALID;
+                }
+                _payloadLength = dataLen;
+            } else if (dataLen != myDataLen) {
+                PAX_LOG_ERROR(1, << "datalength in file incorrect! Calculated: " << myDataLen << ", read from file: " << dataLen);
+                return PAX_INVALID;
+            }
+
+            // one checksum per tile or compressed block
+            uint64_t blocks = isCompressed() ? (myDataLen + _blockLength - 1) / _blockLength : getTilesAcross() * getTilesDown();
+            if (!blockCrcs.empty() && (!checksum || blockCrcs.size() != blocks)) {
+                PAX_LOG_ERROR(1, << "PAX header holds " << blockCrcs.size() << " block checksums for " << blocks << " blocks");
+                return PAX_INVALID;
+            }
+            _checksum = checksum;
+            _payloadCrc = payloadCrc;
+            _blockCrcs.swap(blockCrcs);
+
+            return PAX_OK;
+        }
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // baseImport: import an PAX from a buffer and return the base class
+        // 
+        template <paxTypes_e E>
+        static std::shared_ptr<rasterFileBase> baseImport(char *buf, size_t len) {
+        // TODO: baseImport watchout, may cause slicing
+            rasterFile<E> *paxFile = new rasterFile<E>();
+            paxFile->import(buf, len);
+            std::shared_ptr<rasterFileBase> baseFile(paxFile);
+
+            return baseFile;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // read header to preview PAX file from file. The file stays open while
+        // the header is read in chunks that double in size, and the header is
+        // only parsed once its DATA_LENGTH line has been read, so a long
+        // header takes a logarithmic number of reads and a single parse. A
+        // file that does not begin with a PAX tag fails after one read, and
+        // at most PAX_MAX_HEADER_LEN bytes are read.
+        // Metadata are skipped unless withMeta is set; headerLength, if
+        // given, receives the offset of the raster data.
+        //
+        int preview(pax_filestring fileName, bool withMeta = false, uint64_t *headerLength = NULL) {
+
+            PAX_LOG(1, << "Previewing PAX file " << fileName);
+
+            int fd = pax_open(fileName.c_str(), O_BINARY | O_RDONLY, 0660);
+            if (-1 == fd) {
+                PAX_LOG_ERRNO(1, << " opening input file.");
+                PaxStatic::setStatus(PAX_FAIL);
+                return PAX_FAIL;
+            }
+
+            paxBufPtr fileBuf(new paxBuf_t(0));  // header read so far
+            uint64_t chunkLen = CHUNK_LEN;
+            int ret = PAX_FAIL;
+            while (true) {
+                const uint64_t start = fileBuf->size();
+                fileBuf->resize(start + chunkLen);
+                int64_t readRet = readFully(fd, fileBuf->data() + start, chunkLen);
+                if (readRet < 0 || (0 == readRet && 0 == start)) {
+                    // an error has already been reported, or the file is empty
+                    break;
+                }
+                fileBuf->resize(start + readRet);
+
+                // anything but a PAX tag line at the start is not worth reading further
+                if (0 == start) {
+                    char * pos = fileBuf->data();
+                    paxTypes_e type;
+                    float version;
+                    if (!validatePaxTag(pos, type, version, fileBuf->data() + fileBuf->size())) {
+                        PAX_LOG_ERROR(1, << "No PAX tag at the start of " << fileName);
+                        break;
+                    }
+                }
+
+                // a partial chunk is the end of the file: parse what there is
+                const bool eof = (uint64_t)readRet < chunkLen;
+                if (eof || findDataLength(fileBuf->data(), start, fileBuf->size())) {
+                    ret = preview(fileBuf, withMeta, headerLength);
+                    if (PAX_OK == ret || PAX_FAIL == ret || eof) break;
+                }
+
+                // try again with more data, up to PAX_MAX_HEADER_LEN in all
+                if (fileBuf->size() >= PAX_MAX_HEADER_LEN) {
+                    PAX_LOG_ERROR(1, << "No DATA_LENGTH in the first " << PAX_MAX_HEADER_LEN << " bytes of " << fileName);
+                    break;
+                }
+                chunkLen = PAX_MIN(PAX_MIN(2 * chunkLen, (uint64_t)PAX_MAX_IO_LEN), PAX_MAX_HEADER_LEN - fileBuf->size());
+            }
+            pax_close(fd);
+
+            if (PAX_OK != ret) {
+                PAX_LOG_ERROR(1, << "Could not preview PAX header of " << fileName);
+                PaxStatic::setStatus(PAX_FAIL);
+                return PAX_FAIL;
+            }
+
+            return PAX_OK;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Look for a complete DATA_LENGTH line in a buffer that has grown
+        // from from to len bytes. The search starts at the line that was
+        // incomplete before it grew.
+        //
+        static bool findDataLength(const char *buf, uint64_t from, uint64_t len) {
+
+            const uint64_t tagLen = sizeof(DATALEN_TAG) - 1;
+            uint64_t pos = from;
+            while (pos != 0 && '\n' != buf[pos - 1]) --pos;
+            while (pos + tagLen < len) {
+                const char *tag = static_cast<const char*>(memchr(buf + pos, DATALEN_TAG[0], len - tagLen - pos));
+                if (NULL == tag) {
+                    return false;
+                }
+                pos = tag - buf;
+                if ((0 == pos || '\n' == buf[pos - 1]) && 0 == memcmp(tag, DATALEN_TAG, tagLen) &&
+                    NULL != memchr(tag + tagLen, '\n', len - pos - tagLen)) {
+                    return true;
+                }
+                ++pos;
+            }
+
+            return false;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Read (partial) header to preview PAX file from buffer
+        // Return PAX_OK upon success, PAX_FAIL upon failure, or the length that
+        // was successfully imported if not all the header was imported.
+        // Metadata are skipped unless withMeta is set; headerLength, if
+        // given, receives the offset of the raster data.
+        //
+        int preview(paxBufPtr inBuf, bool withMeta = false, uint64_t *headerLength = NULL) {
+
+            PAX_LOG(1, << "Previewing PAX file in buffer of length " << inBuf->size());
+
+            BufMan buf(inBuf->data(), inBuf->size());
+
+            // make sure buf ends at the end of a line, keeping the LF
+            uint64_t eolpos = inBuf->size() - 1;
+            while (eolpos != 0 && buf[eolpos] != '\n') --eolpos;
+            buf.truncate('\n' == buf[eolpos] ? eolpos + 1 : 0);
+
+            uint64_t datalen = 0;
+            int ret = importHeader(buf, datalen, !withMeta);
+
+            if (ret == PAX_INVALID) {
+                return (int)buf.offset();
+            }
+
+            if (PAX_OK == ret && NULL != headerLength) {
+                *headerLength = buf.offset();
+            }
+
+            return ret;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // importMultiple: extract multiple PAX files from a single buffer.
+        // 
+        // This is to facilitate DDS and simplify the topics that contain a variable number of rasters.
+        // Note that this is NOT a valid operation for files (ofc we may change that some day).
+        // The bufCount overload reads each type from its PAX tag; the other takes the types apriori.
+        // Entries after a failed import are left as nullptr.
+        //
+        static std::vector<std::shared_ptr<rasterFileBase>> importMultiple(size_t bufCount, paxBufPtr bufPtr)
+        {
+            std::vector<std::shared_ptr<rasterFileBase>> bufVec(bufCount);
+            char *buf = bufPtr.get()->data();
+            size_t bufLeft = bufPtr->size();
+
+            for (size_t bufnum = 0; bufnum < bufCount; ++bufnum) {
+                std::shared_ptr<rasterFileBase> baseFile = importAny(buf, bufLeft);
+                if (!baseFile) {
+                  // error has already been reported
+                    break;
+                }
+
+                bufVec[bufnum] = baseFile;
+                buf += baseFile->importedLength();
+                bufLeft -= baseFile->importedLength();
+            }
+
+            return bufVec;
+        }
+
+        static std::vector<std::shared_ptr<rasterFileBase>> importMultiple(std::vector<paxTypes_e> types, paxBufPtr bufPtr)
+        {
+            size_t bufCount = types.size();
+            std::vector<std::shared_ptr<rasterFileBase>> bufVec(bufCount);
+            char *buf = bufPtr.get()->data();
+            size_t bufLeft = bufPtr->size();
+
+            for (size_t bufnum = 0; bufnum < bufCount; ++bufnum) {
+                std::shared_ptr<rasterFileBase> baseFile;
+
+                switch (types[bufnum]) {
+
+#define X(name,val,bpv,vpe) case paxTypes::ePAX_ ## name : baseFile = baseImport<paxTypes::ePAX_ ## name> (buf, bufLeft); break;
+                    PAX_TYPE_DATA
+#undef X
+
+                } // switch (types[bufnum])
+
+                bufVec[bufnum] = baseFile;
+                buf += baseFile->importedLength();
+                bufLeft -= baseFile->importedLength();
+            }
+
+            return bufVec;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // importAs: import a PAX of known type from a buffer. Returns nullptr if
+        // the import fails; the error is left in the current context.
+        //
+        template <paxTypes_e E>
+        static rasterFileBasePtr importAs(char *buf, size_t len) {
+            std::shared_ptr<rasterFile<E>> paxFile = std::make_shared<rasterFile<E>>();
+            if (PAX_OK != paxFile->import(buf, len)) {
+                return nullptr;
+            }
+            return paxFile;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // importAny: import a PAX from a buffer, taking its type from the PAX
+        // tag. Returns nullptr if the type is unknown or the import fails.
+        //
+        static rasterFileBasePtr importAny(char *buf, size_t len) {
+            if (NULL == buf || len < MIN_PAX_LENGTH) {
+                PAX_LOG_ERROR(1, << "PAX buffer too short");
+                return nullptr;
+            }
+
+            char *      pos = buf;
+            paxTypes_e  paxType = paxTypes::ePAX_INVALID;
+            float       version = PaxStatic::defaultVersion();
+            if (!validatePaxTag(pos, paxType, version, buf + len)) {
+                PAX_LOG_ERROR(1, << "Invalid PAX tag");
+                return nullptr;
+            }
+
+            switch (paxType) {
+
+#define X(name,val,bpv,vpe) case paxTypes::ePAX_ ## name : return importAs<paxTypes::ePAX_ ## name> (buf, len);
+                PAX_TYPE_DATA
+#undef X
+
+            default:
+                PAX_LOG_ERROR(1, << "Unsupported PAX type " << getTypeName(paxType));
+                return nullptr;
+
+            } // switch (paxType)
+        }
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // convertAs: convert the data of a raster of known type
+        //
+        template <paxTypes_e E>
+        static int convertAs(rasterFileBase *paxIn, paxTypes_e type, void * out, const paxConvert_t & options) {
+            return static_cast<rasterFile<E>*>(paxIn)->convertTo(type, out, options);
+        }
+
+        static rasterFileBasePtr importAny(paxBufPtr bufPtr) {
+            if (!bufPtr) return nullptr;
+            return importAny(bufPtr->data(), bufPtr->size());
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // importBatch: import many independent PAX buffers or files concurrently.
+        //
+        // Each entry is typed from its own PAX tag and imported on the pool;
+        // the results come back in input order. An entry that fails to import
+        // is left as nullptr and its error is copied to the calling thread's
+        // context, which is set to PAX_FAIL. Each job runs at the caller's
+        // verbosity. Buffers are parsed in place, so the same buffer must not
+        // appear twice in one batch.
+        //
+        static std::vector<rasterFileBasePtr> importBatch(const std::vector<paxBufPtr> & bufs, PaxThreadPool & pool = PaxThreadPool::shared()) {
+            return runBatch(bufs.size(), pool, [&bufs](size_t n) { return importAny(bufs[n]); });
+        }
+
+        static std::vector<rasterFileBasePtr> importBatch(const std::vector<pax_filestring> & fileNames, PaxThreadPool & pool = PaxThreadPool::shared()) {
+            return runBatch(fileNames.size(), pool, [&fileNames](size_t n) {
+                paxBufPtr fileBuf = readFile(fileNames[n]);
+                return fileBuf ? importAny(fileBuf) : nullptr;
+            });
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // writeMultiple: writes multiple PAX files to a single buffer.
+        // 
+        // This is to facilitate DDS and simplify the topics that contain a variable number of rasters.
+        // Note that this is NOT a valid operation for files (ofc we may change that some day).
+        // Note that all types must be known apriori!
+        // Each raster is copied once, straight into the combined buffer; use
+        // PaxBatchWriter to write rasters to a file without copying them.
+        //    
+        static paxBufPtr writeMultiple(std::vector<rasterFileBase*> paxVec) {
+            size_t bufCount = paxVec.size();
+            std::vector<std::string> headers(bufCount);
+            std::vector<std::vector<char>> scratch(bufCount);
+            std::vector<paxSegment_t> payloads(bufCount);
+            size_t bufSize = 0;
+
+            PAX_LOG(1, << "Writing " << bufCount << " pax files to a buffer.");
+
+            for (size_t i = 0; i < bufCount; ++i) {
+                if (PAX_OK != paxVec[i]->writeHeader(headers[i], scratch[i], payloads[i])) {
+                    PAX_LOG_ERROR(1, << "could not render raster " << i << " of " << bufCount);
+                    return nullptr;
+                }
+                bufSize += headers[i].length() + payloads[i].second;
+            }
+
+            paxBufPtr bufPtr = std::make_shared<paxBuf_t>(bufSize);
+            size_t bufPos = 0;
+            for (size_t i = 0; i < bufCount; ++i) {
+                memcpy(bufPtr->data() + bufPos, headers[i].c_str(), headers[i].length());
+                bufPos += headers[i].length();
+                if (payloads[i].second > 0) {
+                    memcpy(bufPtr->data() + bufPos, payloads[i].first, payloads[i].second);
+                    bufPos += payloads[i].second;
+                }
+            }
+
+            PAX_LOG(1, << "Wrote a total of " << bufPos << " bytes to the buffer.");
+
+            return bufPtr;
+        }
+
+        static paxBufPtr writeMultiple(std::vector<std::shared_ptr<rasterFileBase>> paxVec)
+        {
+            std::vector<rasterFileBase *> paxVecp;
+
+            for (auto ppax : paxVec) {
+                paxVecp.push_back(ppax.get());
+            }
+
+            paxBufPtr bufPtr = writeMultiple(paxVecp);
+
+            return bufPtr;
+        } // static std::vector<std::shared_ptr<rasterFileBase>> importMultiple
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // helper function to make sure meta exists and is fully decoded
+        //
+        paxMetaMap_t & getMetaRef() {
+            resolveAllMeta();
+            return metaMap();
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // helper function to make sure meta exists. Pending entries are not
+        // decoded.
+        //
+        paxMetaMap_t & metaMap() {
+            if (nullptr == _meta) _meta = std::shared_ptr <paxMetaMap_t>(new paxMetaMap_t());
+            return *_meta;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // helper function to store meta, replacing any pending entry of the
+        // same name. The payload is moved into the file's arena unless it is
+        // already there.
+        //
+        meta_t & storeMeta(const std::string & name, meta_t && meta) {
+            _lazyIndex.erase(name);
+            meta_t & stored = metaMap()[name];
+            releaseMeta(stored);
+            stored = std::move(meta);
+            stored.rehome(metaArena());
+            compactMeta();
+            return stored;
+        }
+        meta_t & storeMeta(const std::string & name, const meta_t & meta) {
+            meta_t copy;
+            copy.clone(meta, metaArena());
+            return storeMeta(name, std::move(copy));
+        }
 
 
-#define PAX_TYPE_DATA                                                         \
-/*    PAX type Name              enum  bpv    vpe                        */   \
-    X(INVALID,                    -1,   0,    ValueSpace::eVPE_UNDEFINED    ) \
-    X(SF_MAG_UCHAR,                0,   1,    ValueSpace::eVPE_MAG          ) \
-    X(SF_MAG_PHASE_USHORT,         1,   2,    ValueSpace::eVPE_MAGPHASE     ) \
-    X(SF_COMPLEX_USHORT,           2,   2,    ValueSpace::eVPE_COMPLEX      ) \
-    X(SF_COMPLEX_UINT,             3,   4,    ValueSpace::eVPE_COMPLEX      ) \
-    X(SF_COMPLEX_ULONG,            4,   8,    ValueSpace::eVPE_COMPLEX      ) \
-    X(SF_MAG_CHAR,                 5,   1,    ValueSpace::eVPE_MAG          ) \
-    X(SF_MAG_PHASE_SHORT,          6,   2,    ValueSpace::eVPE_MAGPHASE     ) \
-    X(SF_COMPLEX_SHORT,            7,   2,    ValueSpace::eVPE_COMPLEX      ) \
-    X(SF_COMPLEX_INT,              8,   4,    ValueSpace::eVPE_COMPLEX      ) \
-    X(SF_COMPLEX_LONG,             9,   8,    ValueSpace::eVPE_COMPLEX      ) \
-    X(SF_COMPLEX_SINGLE,          10,   4,    ValueSpace::eVPE_COMPLEX      ) \
-    X(SF_COMPLEX_DOUBLE,          11,   8,    ValueSpace::eVPE_COMPLEX      ) \
-    X(SF_MAG_PHASE_UCHAR,         12,   1,    ValueSpace::eVPE_MAGPHASE     ) \
-    X(SF_MAG_PHASE_CHAR,          13,   1,    ValueSpace::eVPE_MAGPHASE     ) \
-    X(SF_RGB_UCHAR,               14,   1,    ValueSpace::eVPE_RGB          ) \
-    X(SF_HSV_UCHAR,               15,   1,    ValueSpace::eVPE_HSV          ) \
-    X(SF_UNDEFINED_PIXEL_TYPE,    16,   0,    0                             ) \
-                                                                              \
-    X(CUSTOM,                     99,   0,    ValueSpace::eVPE_UNDEFINED    ) \
-    X(CHAR,                      100,   1,    ValueSpace::eVPE_ONE          ) \
-    X(UCHAR,                     101,   1,    ValueSpace::eVPE_ONE          ) \
-    X(SHORT,                     102,   2,    ValueSpace::eVPE_ONE          ) \
-    X(USHORT,                    103,   2,    ValueSpace::eVPE_ONE          ) \
-    X(INT,                       104,   4,    ValueSpace::eVPE_ONE          ) \
-    X(UINT,                      105,   4,    ValueSpace::eVPE_ONE          ) \
-    X(LONG,                      106,   8,    ValueSpace::eVPE_ONE          ) \
-    X(ULONG,                     107,   8,    ValueSpace::eVPE_ONE          ) \
-    X(HALF,                      108,   2,    ValueSpace::eVPE_ONE          ) \
-    X(FLOAT,                     109,   4,    ValueSpace::eVPE_ONE          ) \
-    X(DOUBLE,                    110,   8,    ValueSpace::eVPE_ONE          ) \
-    X(QUADRUPLE,                 111,  16,    ValueSpace::eVPE_ONE          ) \
-                                                                              \
-    X(META_ONLY,                 199,   0,    ValueSpace::eVPE_UNDEFINED    ) \
-    X(FLOAT3,                    200,   4,    ValueSpace::eVPE_REAL3        ) \
-                                                                              \
-/* NOTE: using PBM_BINARY would require changing bpv to bits per value */     \
-    X(PBM_ASCII,                1001,   1,    ValueSpace::eVPE_BITS         ) \
-    X(PGM_ASCII,                1002,   1,    ValueSpace::eVPE_REAL         ) \
-    X(PPM_ASCII,                1003,   1,    ValueSpace::eVPE_RGB          ) \
-    X(PBM_BINARY,               1004,   1,    ValueSpace::eVPE_BITS         ) \
-    X(PGM_BINARY,               1005,   1,    ValueSpace::eVPE_REAL         ) \
-    X(PPM_BINARY,               1006,   1,    ValueSpace::eVPE_RGB          ) \
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // helper function to report the arena storage of a meta that is about
+        // to be replaced or removed
+        //
+        void releaseMeta(meta_t & meta) {
+            if (nullptr != _metaArena && meta.arena == _metaArena) {
+                _metaArena->release(meta.footprint());
+            }
+        }
 
-#define X(name,val,bpv,vpe) ePAX_ ## name = val,
-    enum class paxTypes : std::int32_t {
-        PAX_TYPE_DATA
-    };
-#undef X
 
-    typedef std::complex<float>           csingle;
-    typedef std::complex<double>          cdouble;
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // helper function to move the live metadata to a fresh arena once
+        // replaced payloads make up most of the current one. Metas copied out
+        // earlier keep the old arena alive until they go away.
+        //
+        void compactMeta() {
+            if (nullptr == _metaArena || !_metaArena->needsCompaction()) return;
+            paxMetaArenaPtr arena = std::make_shared<PaxMetaArena>();
+            PAX_LOG(3, << "compacting metadata arena, " << _metaArena->released() << " of " << _metaArena->bytes() << " bytes released");
+            for (auto & meta : metaMap()) {
+                meta.second.rehome(arena);
+            }
+            _metaArena = arena;
+        }
 
-    using   floatRasterFile = rasterFile<paxTypes::ePAX_FLOAT>;
-    using   floatRasterFilePtr = rasterFilePtr<paxTypes::ePAX_FLOAT>;
-    using   charRasterFile = rasterFile<paxTypes::ePAX_CHAR>;
-    using   charRasterFilePtr = rasterFilePtr<paxTypes::ePAX_CHAR>;
-    using   ucharRasterFile = rasterFile<paxTypes::ePAX_UCHAR>;
-    using   ucharRasterFilePtr = rasterFilePtr<paxTypes::ePAX_UCHAR>;
-    using   float3RasterFile = rasterFile<paxTypes::ePAX_FLOAT3>;
-    using   float3RasterFilePtr = rasterFilePtr<paxTypes::ePAX_FLOAT3>;
 
-  ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-  // 
-  // rasterFile: The templated class associated with raster data files.
-  //
-  // Sample PAX file follows
-  /*
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // helper function to make sure the metadata arena exists
+        //
+        paxMetaArenaPtr & metaArena() {
+            if (nullptr == _metaArena) _metaArena = std::make_shared<PaxMetaArena>();
+            return _metaArena;
+        }
 
-PAX101 : PAX_UCHAR
-#
-# <pax root>/test/data/gold/pax_sample.pax
-# This is a sample PAX file containing metadata. The metadata type is given in square brackets. There is no default type.
-#
-# As PAX is a self-documenting format, use of blank comments is strongly suggested to improve readability.
-#
-# Metadata names never begin with whitespace and are unique. Repeated names cause earlier data to be overwritten and lost.
-# Comments are simply a special type of metadata not having a user-defined name and not requiring the leading description.
-#
-BYTES_PER_VALUE : 1
-VALUES_PER_ELEMENT : 1
-#
-#  This file is a simple 2x2 byte array
-## [double]   total_elements = 4
-#
-ELEMENTS_IN_SEQUENTIAL_DIMENSION : 2
-ELEMENTS_IN_STRIDED_DIMENSION : 2
-#
-#  You can use scientific notation, hex, etc.
-#  For floating-point data, it lets the C++ strstream choose how many significant figures, up to 15.
-#  Additional digits are ignored.
-#  Hex data can be read but not written. Caution, hex values can get weird though, since they are stored as double. Don't use more than ~52 bits!
-#
-## [double]   pi              = 3.1415926535897932384
-## [double]   alpha_centauri  = 4.12E16
-## [double]   crc32_checksum  = 0xFB29C8B3
-#
-DATA_LENGTH : 4
-cHaR
-  */
-  //
 
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // decode one pending metadata entry from the saved header text
+        //
+        meta_t * resolveMeta(std::unordered_map<PaxMetaName, lazyMeta_t, PaxMetaName::hash>::iterator lazy) {
 
-  //////////////////////////////////////////////////////////////////////////
-  // rasterFileBase: A simple parent class to support rasterFile portability
-  //
-    class rasterFileBase
-    {
-      // CXXTest Classes
-        friend class TestRead;
-        friend class TestWrite;
-        friend class NewTestRead;
-        friend class NewTestWrite;
-        friend class TestUtility;
+            PaxMetaName name = lazy->first;
+            lazyMeta_t entry = lazy->second;
+            _lazyIndex.erase(lazy);
+
+            BufMan buf(_headerBuf, _headerBuf->size() - 1);
+            buf.setArena(metaArena());
+            buf.seek(entry.offset);
+            buf.setLoc(entry.loc, entry.index);
+            std::pair<std::string, meta_t> meta1 = buf.getMeta();
+
+            if (_lazyIndex.empty()) {
+                _headerBuf = nullptr;
+            }
+
+            if (paxMetaDataTypes_e::paxInvalid == meta1.second.type) {
+                PAX_LOG_ERROR(1, << "could not decode metadata '" << name.c_str() << "'");
+                return NULL;
+            }
+
+            PAX_LOG(2, << "decoded pending metadata '" << name.c_str() << "'");
+            return &storeMeta(name, std::move(meta1.second));
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // decode all pending metadata
+        //
+        void resolveAllMeta() {
+            while (!_lazyIndex.empty()) {
+                resolveMeta(_lazyIndex.begin());
+            }
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // helper function to organize and sort metadata
+        //
+        std::shared_ptr<std::vector<std::vector<std::pair<std::string, meta_t *>>>>
+            getMetaVecs() {
+
+            std::shared_ptr<std::vector<std::vector<std::pair<std::string, meta_t *>>>> metavecs(new std::vector<std::vector<std::pair<std::string, meta_t *>>>(LOC_COUNT));
+            resolveAllMeta();
+            if (nullptr == _meta) return metavecs;
+
+            for (auto & meta : getMetaRef()) {
+                size_t loc = meta.second.loc;
+                auto &vec = metavecs->at(loc);
+                vec.emplace_back(meta.first, &meta.second);
+            }
+
+            for (int i = 0; i < LOC_COUNT; ++i) {
+                std::vector<std::pair<std::string, meta_t *>> &vec = metavecs->at(i);
+                std::sort(vec.begin(), vec.end(), [](const std::pair<std::string, meta_t *>& lhs, const std::pair<std::string, meta_t *>& rhs) { return lhs.second->index < rhs.second->index; });
+                PAX_LOG(3, << "done sorting metaLoc " << i);
+            }
+
+            return metavecs;
+        }
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // count the metadata in each location, including pending entries
+        //
+        void countMetaLocs() {
+            memset(_metaLocCount, 0, metaLoc_e::LOC_COUNT * sizeof(size_t));
+            if (nullptr != _meta) {
+                for (auto & meta : *_meta) ++_metaLocCount[meta.second.loc];
+            }
+            for (auto & lazy : _lazyIndex) ++_metaLocCount[lazy.second.loc];
+        }
+
+        static void copyMeta(rasterFileBase & dest, rasterFileBase & src) {
+            src.resolveAllMeta();
+            if (nullptr == src._meta) {
+                dest._meta = nullptr;
+                dest._lazyIndex.clear();
+                return;
+            }
+          // allocate a new destination meta map and arena to release the old ones
+            dest._meta = std::shared_ptr <paxMetaMap_t>(new paxMetaMap_t());
+            dest._metaArena = std::make_shared<PaxMetaArena>();
+            PAX_LOG(2, << "copying " << src._meta->size() << " meta elements.");
+            dest._lazyIndex.clear();
+            for (auto & meta : *(src._meta)) {
+                meta_t & stored = (*dest._meta)[meta.first];
+                stored.clone(meta.second, dest._metaArena);
+            }
+            PAX_LOG(2, << "Done copying meta. " << dest._meta->size() << " meta elements were copied.");
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Adds/replaces the given meta object at the (optional) specified location.
+        //
+        // PAX keeps things simple by not allowing insertions. If you add a meta
+        // having the same name as one in a different location, the old one gets
+        // automatically whacked. The count for that location then becomes inaccurate,
+        // but that's ok because it is only used for labeling comments and sorting.
+        // It is not possible for the order to get screwed up. Neat, huh! It would be
+        // a pain to do an insert now. You have to remove all meta from that location
+        // after the insert point, add the new one, then re-add the others using
+        // addComment and addMetaVal to keep the indexes straight. That's ok for now.
+        //
+        int addMeta(std::string name, const meta_t & meta, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+
+            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+
+            size_t index = _metaLocCount[loc]++;
+            if (paxMetaDataTypes_e::paxComment == meta.type) {
+                name = meta_t::getCommentName(loc, index);
+            }
+
+            meta_t & stored = storeMeta(name, meta);
+            stored.loc = loc;
+            stored.index = index;
+
+            _metaLoc = loc;
+
+            return PaxStatic::getStatus();
+
+        } // int addMeta (std::string name, const meta_t & meta, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
+        int addMeta(metaLoc_e loc, std::string name, const meta_t & meta) {
+            return addMeta(name, meta, loc);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Adds the given comment meta at the (optional) specified location
+        //
+        int addComment(const meta_t & meta, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+            return addMeta("", meta, loc);
+        }
+        int addComment(metaLoc_e loc, const meta_t & meta) {
+            return addMeta("", meta, loc);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Adds a comment at the (optional) specified location
+        //
+        int addComment(std::string comment, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+
+            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+
+            meta_t meta;
+            meta.loc = loc;
+            meta.index = _metaLocCount[loc]++;
+
+            std::string name = meta.commentName();
+            meta.arena = metaArena();
+            meta.setString(comment.c_str(), strlen(comment.c_str()));
+            meta.type = paxMetaDataTypes_e::paxComment;
+            meta.stripped = strlen(meta.s) > 0;  // eliminates hanging space for null comments
+
+            storeMeta(name, std::move(meta));
+
+            _metaLoc = loc;
+
+            return PAX_OK;
+        } // int addComment (std::string comment, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) 
+        int addComment(metaLoc_e loc, std::string comment) {
+            return addComment(comment, loc);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Adds/replaces string metadata at the (optional) specified location
+        //
+        int addMetaVal(std::string name, std::string data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+
+            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
 
-        typedef std::shared_ptr<std::unordered_map<std::string, meta_t>>    paxMetaDataPtr;
+            // TODO add meta ctor(s) to reduce line count
+            meta_t meta;
+            meta.loc = loc;
+            meta.index = _metaLocCount[loc]++;
+            meta.arena = metaArena();
+            meta.setString(data.c_str(), strlen(data.c_str()));
+            meta.type = paxMetaDataTypes_e::paxString;
+            meta.stripped = true;
 
-    public:
+            storeMeta(name, std::move(meta));
 
-      //typedef std::shared_ptr<std::vector<char>>                        paxDataBufPtr;
+            _metaLoc = loc;
 
-        rasterFileBase() : _dataType(paxTypes::ePAX_INVALID), _version(PAX_VERSION), _metaLoc(LOC_END) { _importedLength = 0; }
-        rasterFileBase(paxTypes_e dataType) : _version(PAX_VERSION), _metaLoc(LOC_END) { _dataType = dataType; _importedLength = 0; }
+            return PAX_OK;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Return the PAX type
-        //
-        paxTypes_e getType() {
-            return _dataType;
+        } // int addMetaVal (std::string name, std::string data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) 
+        int addMetaVal(metaLoc_e loc, std::string name, std::string data) {
+            return addMetaVal(name, data, loc);
         }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Attempt to validate the given type
+        // Adds/replaces float metadata at the (optional) specified location
         //
-        static bool isPaxType(int32_t t) {
-            paxTypes_e pax = static_cast<paxTypes_e> (t);
+        int addMetaVal(std::string name, float data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
 
-            if (pax == paxTypes_e::ePAX_INVALID) {
-                PAX_LOG(2, << "found PAX type PAX_INVALID");
-                return false;
-            }
+            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
 
-#define X(name,val,bpv,vpe) || (t == val)
-            bool ret = false
-                PAX_TYPE_DATA
-                ;
-#undef X
+            meta_t meta;
+            meta.loc = loc;
+            meta.index = _metaLocCount[loc]++;
+            meta.f = data;
+            meta.type = paxMetaDataTypes_e::paxFloat;
 
-            PAX_LOG(2, << (ret ? "found valid PAX type: " : "found invalid PAX type: ") << t);
+            storeMeta(name, std::move(meta));
 
-            return ret;
+            _metaLoc = loc;
+
+            return PAX_OK;
+
+        } // int addMetaVal (std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
+        int addMetaVal(metaLoc_e loc, std::string name, float data) {
+            return addMetaVal(name, data, loc);
         }
 
+
         //////////////////////////////////////////////////////////////////////////
         //
-        // check that the given string is a valid PAX tag
+        // Adds/replaces double metadata at the (optional) specified location
         //
-        static bool validatePaxTag(char *& pos, paxTypes_e &type, float &version) {
+        int addMetaVal(std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
 
-          // temporarily terminate at the end of line
-            char * eol = strchr(pos, '\n');
-            TempNull tn(eol);
-            size_t tagLen = strlen(PAX_TAG);
-            paxTypes_e paxType = paxTypes::ePAX_INVALID;
+            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
 
-            // 'valid' is used for conditional debug output
-            bool valid = (0 == strncmp(pos, PAX_TAG, tagLen));
-            PAX_LOG(2, << (valid ? "found PAX tag" : "ERROR! invalid PAX tag!"));
-            if (!valid) {
-                return false;
-            }
+            meta_t meta;
+            meta.loc = loc;
+            meta.index = _metaLocCount[loc]++;
+            meta.d = data;
+            meta.type = paxMetaDataTypes_e::paxDouble;
 
-            // get type
-            pos += tagLen;
-            char *oldPos = pos;
-            long ntype = strtol(pos, &pos, 10);
-            valid = (0L != ntype && LONG_MAX != ntype && LONG_MIN != ntype) || (0L == ntype && '0' == *oldPos);
+            storeMeta(name, std::move(meta));
 
-            if (valid) {
-                paxType = getPaxType(ntype);
-                valid = paxTypes_e::ePAX_INVALID != paxType;
-            }
+            _metaLoc = loc;
 
-            { // local scope for TempNull to facilitate printing the converted character(s)
-                TempNull tn2(pos);
-                PAX_LOG(2, << (valid ? "found valid PAX type: " : "ERROR! invalid PAX type: ") << oldPos);
-            }
+            return PAX_OK;
 
-            if (paxTypes_e::ePAX_INVALID == paxType) {
-                PAX_LOG_ERROR(1, << "invalid PAX type discovered");
-                return false;
-            }
+        } // int addMetaVal (std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
+        int addMetaVal(metaLoc_e loc, std::string name, double data) {
+            return addMetaVal(name, data, loc);
+        }
 
-            BufMan::skipDelimiter(pos, false);
 
-            // read version if it is given (did not exist prior to library version 1.0)
-            if (*pos == 'v' || *pos == 'V') {
-                BufMan::skipWS(++pos);
-                version = strtof(pos, &pos);
-                // TODO: verify version
-                BufMan::skipDelimiter(pos, false);
-            }
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Adds/replaces integer metadata at the (optional) specified location
+        //
+        int addMetaVal(std::string name, uint64_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN, paxMetaDataTypes_e type = paxMetaDataTypes::paxUint64) {
 
-            // TODO: verify that PAX type text matches the tag
-            //buf.skipWS (buf.pos ());
-            //assert (':' == buf[0]);
-            //buf.pos ()++;
-            //buf.skipWS (buf.pos ());
+            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
 
-            type = paxType;
-            tn.restore();
-            BufMan::skipLine(pos);
+            meta_t meta;
+            meta.loc = loc;
+            meta.index = _metaLocCount[loc]++;
+            meta.u64 = data;
+            meta.type = type;
 
-            return valid;
-        } // bool validatePaxTag (char * buf)
+            storeMeta(name, std::move(meta));
+
+            _metaLoc = loc;
+
+            return PAX_OK;
+
+        } // int addMetaVal (std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
+        int addMetaVal(std::string name, uint32_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+            int ret = addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint32);
+            return ret;
+        }
+        int addMetaVal(std::string name, uint16_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+            int ret = addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint16);
+            return ret;
+        }
+        int addMetaVal(std::string name, uint8_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+            int ret = addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint8);
+            return ret;
+        }
+        int addMetaVal(metaLoc_e loc, std::string name, uint64_t data) {
+            return addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint64);
+        }
+        int addMetaVal(metaLoc_e loc, std::string name, uint32_t data) {
+            return addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint32);
+        }
+        int addMetaVal(metaLoc_e loc, std::string name, uint16_t data) {
+            return addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint16);
+        }
+        int addMetaVal(metaLoc_e loc, std::string name, uint8_t data) {
+            return addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint8);
+        }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // convert an int to PAX type if possible
+        // Adds/replaces integer metadata at the (optional) specified location
         //
-        static paxTypes_e getPaxType(int32_t t) {
-            if (!isPaxType(t))  return paxTypes_e::ePAX_INVALID;
-            paxTypes_e pax = static_cast<paxTypes_e> (t);
-            return pax;
-        } // paxTypes_e getPaxType (int32_t t)
+        int addMetaVal(std::string name, int64_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN, paxMetaDataTypes_e type = paxMetaDataTypes::paxInt64) {
+
+            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+
+            meta_t meta;
+            meta.loc = loc;
+            meta.index = _metaLocCount[loc]++;
+            meta.n64 = data;
+            meta.type = type;
+
+            storeMeta(name, std::move(meta));
+
+            _metaLoc = loc;
+
+            return PAX_OK;
 
+        } // int addMetaVal (std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
+        int addMetaVal(std::string name, int32_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+            int ret = addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt32);
+            return ret;
+        }
+        int addMetaVal(std::string name, int16_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+            int ret = addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt16);
+            return ret;
+        }
+        int addMetaVal(std::string name, int8_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+            int ret = addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt8);
+            return ret;
+        }
+        int addMetaIntVal(metaLoc_e loc, std::string name, int64_t data) {
+            return addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt64);
+        }
+        int addMetaIntVal(metaLoc_e loc, std::string name, int32_t data) {
+            return addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt32);
+        }
+        int addMetaIntVal(metaLoc_e loc, std::string name, int16_t data) {
+            return addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt16);
+        }
+        int addMetaIntVal(metaLoc_e loc, std::string name, int8_t data) {
+            return addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt8);
+        }
 
+    protected:
         //////////////////////////////////////////////////////////////////////////
         //
-        // Read the PAX type from the given filename
+        // renderHeader: writes the PAX header, up to and including DATA_LENGTH.
+        // The payload length of a compressed raster and the checksums are the
+        // ones recorded by the last encodeData or import, so callers with
+        // data must encode first; writeHeader does.
         //
-        static paxTypes_e getPaxFileType(const std::string& path) {
-            paxBufPtr bufPtr = readFileChunk(path);
+        int renderHeader(std::string &out) {
 
-            PAX_LOG(2, << "Identifying PAX type in file " << path);
-            paxTypes_e paxType = getPaxFileType(bufPtr);
+            size_t _bpv = getBPV(_dataType);
+            size_t _vpe = getVPE(_dataType);
+            uint64_t dataLen = getPayloadLength();
 
-            return paxType;
-        } // paxTypes_e getPaxFileType (const std::string& path)
+            auto meta = getMetaVecs();
 
+            // reserve enough for the fixed lines plus a generous width per metadata value
+            size_t reserve = 256 + 48 * _dims.size();
+            for (auto & metavec : *meta) {
+                for (auto & m : metavec) {
+                    reserve += m.first.length() + 64 + (m.second->isArray() ? 24 * m.second->count() : PAX_MAX_METADATA_STRING_LENGTH);
+                }
+            }
+            out.clear();
+            out.reserve(reserve);
 
-          //////////////////////////////////////////////////////////////////////////
-          //
-          // Read the PAX type from the given filename
-          //
-        static paxTypes_e getPaxFileType(paxBufPtr bufPtr, float *version = NULL) {
-            BufMan buf(bufPtr->data(), bufPtr->size());
+            // write file ID line
+            char version[16];
+#ifdef __cpp_lib_to_chars
+            char * versionEnd = std::to_chars(version, version + sizeof(version), (double)_version, std::chars_format::fixed, 2).ptr;
+#else
+            char * versionEnd = version + snprintf(version, sizeof(version), "%.2f", (double)_version);
+#endif
+            out += PAX_TAG;
+            appendNumber(out, (int)_dataType);
+            out += " : v";
+            out.append(version, versionEnd - version);
+            out += " : ";
+            out += getTypeName(_dataType);
+            out += '\n';
+            PAX_LOG(3, << "typeName = " << getTypeName(_dataType).c_str());
+            PAX_LOG(3, << "version = " << _version);
 
-            paxTypes_e paxType = paxTypes::ePAX_INVALID;
-            float      _version = PaxStatic::defaultVersion();
-            bool valid = validatePaxTag(buf.pos(), paxType, _version);
+            writeMeta(out, (*meta)[LOC_AFTER_TAG]);
+            appendTag(out, BPV_TAG, _bpv);
 
-            if (version != NULL) {
-                *version = _version;
+            writeMeta(out, (*meta)[LOC_AFTER_BPV]);
+            appendTag(out, VPE_TAG, _vpe);
+
+            writeMeta(out, (*meta)[LOC_AFTER_VPE]);
+            appendTag(out, DIM1_TAG, _numSequential);
+
+            writeMeta(out, (*meta)[LOC_AFTER_SEQ]);
+            appendTag(out, DIM2_TAG, _numStrided);
+
+            for (size_t i = 2; i < _dims.size(); ++i) {
+                appendTag(out, PaxStatic::getDimTag(i).c_str(), _dims[i]);
             }
 
-            PAX_LOG(2, << (valid ? "Found PAX type " : "Invalid PAX type: ") << getTypeName(paxType));
+            if (isTiled()) {
+                appendTag(out, TILE_WIDTH_TAG, _tileWidth);
+                appendTag(out, TILE_HEIGHT_TAG, _tileHeight);
+            }
 
-            return paxType;
-        } // paxTypes_e getPaxFileType (const std::string& path)
+            if (isCompressed()) {
+                out.append(COMPRESSION_TAG).append(" : ").append(PaxCodec::getName(_codec)).push_back('\n');
+                appendTag(out, COMPRESSION_BLOCK_TAG, _blockLength);
+                appendTag(out, UNCOMPRESSED_LENGTH_TAG, getFileDataLength());
+            }
+
+            if (_checksum) {
+                out.append(CHECKSUM_TAG).append(" : ").append(CRC32C_NAME).append(" ").append(PaxChecksum::toString(_payloadCrc)).push_back('\n');
+                if (!_blockCrcs.empty()) {
+                    // the count first, then eight checksums per line
+                    out.append(BLOCK_CHECKSUMS_TAG).append(" : ");
+                    appendNumber(out, (uint64_t)_blockCrcs.size());
+                    for (size_t b = 0; b < _blockCrcs.size(); ++b) {
+                        out.append((0 == b % 8) ? "\n " : " ").append(PaxChecksum::toString(_blockCrcs[b]));
+                    }
+                    out.push_back('\n');
+                }
+            }
+
+            writeMeta(out, (*meta)[LOC_AFTER_STR1]);
+            appendTag(out, DATALEN_TAG, dataLen);
+
+            PAX_LOG(3, << "wrote " << out.length() << " header bytes, reserved " << reserve);
+
+            return PAX_OK;
+        }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // extract values per element for given type
-        //
-        static int32_t getVPE(paxTypes_e e) {
-          // sanity check on enum
-            int type = (int)e;
-            if (!isPaxType(type))  return 0;
+        // runBatch: run count imports on the pool, each in its own context,
+        // and report the first failure on the calling thread. An import that
+        // throws, e.g. std::bad_alloc on a huge raster, yields a NULL entry.
+        //
+        template <typename F>
+        static std::vector<rasterFileBasePtr> runBatch(size_t count, PaxThreadPool & pool, F importOne) {
+            std::vector<rasterFileBasePtr>  results(count);
+            std::vector<std::string>        errors(count);
+            const int                       verbosity = PaxContext::current().level();
+
+            pool.parallelFor(count, [&](size_t n) {
+                PaxContext          context;
+                PaxContext::Scope   scope(context);
+                context.setLevel(verbosity);
+
+                // pool jobs must not throw; an allocation failure fails this entry only
+                try {
+                    results[n] = importOne(n);
+                    if (!results[n]) {
+                        errors[n] = context.lastError.empty() ? "import failed" : context.lastError;
+                    }
+                } catch (const std::exception & e) {
+                    results[n] = nullptr;
+                    errors[n] = e.what();
+                } catch (...) {
+                    results[n] = nullptr;
+                    errors[n] = "import threw an exception";
+                }
+            });
+
+            for (size_t n = 0; n < count; ++n) {
+                if (!results[n]) {
+                    PaxStatic::setError(PAX_FAIL, "batch entry " + std::to_string(n) + ": " + errors[n]);
+                    break;
+                }
+            }
+
+            return results;
+        }
+
+
+        paxTypes_e          _dataType;
+        float               _version;
+        size_t              _importedLength;
+        uint64_t            _numValues;
+        uint64_t            _numSequential;
+        uint64_t            _numStrided;
+        std::vector<uint64_t> _dims;        ///< Length of each dimension, sequential first
+        std::vector<uint64_t> _strides;     ///< Elements between consecutive indexes in each dimension
+        paxMetaDataPtr      _meta;
+        paxMetaArenaPtr     _metaArena;     ///< Storage for metadata strings and arrays
+        bool                _lazyMeta;      ///< Index metadata on import, decode on first access
+        std::unordered_map<PaxMetaName, lazyMeta_t, PaxMetaName::hash> _lazyIndex;    ///< Metadata not yet decoded
+        paxBufPtr           _headerBuf;     ///< Header text backing _lazyIndex (NULL-terminated)
+        metaLoc_e      _metaLoc;
+        size_t              _metaLocCount[metaLoc_e::LOC_COUNT];
+        uint64_t            _tileWidth;     ///< Elements per tile row in the file layout, 0 if not tiled
+        uint64_t            _tileHeight;    ///< Rows per tile in the file layout, 0 if not tiled
+        paxCodec_e          _codec;         ///< Codec compressing the file layout
+        uint64_t            _blockLength;   ///< Uncompressed length of each compressed block
+        uint64_t            _payloadLength; ///< Compressed payload length of the last write or import
+        bool                _checksum;      ///< Payload checksums are written and verified
+        uint32_t            _payloadCrc;    ///< CRC32C of the payload of the last write or import
+        std::vector<uint32_t> _blockCrcs;   ///< CRC32C of each block of a tiled or compressed payload
+    };  //   class rasterFileBase
 
-            int32_t _vpe = 0;
 
-#define X(name,val,bpv,vpe) case (paxTypes_e::ePAX_ ## name): _vpe = vpe; break;
+    inline PaxHeader::PaxHeader() : PaxHeader(PAX_UNTYPED) { }
+    inline PaxHeader::PaxHeader(paxTypes_e type) : _raster(std::make_shared<rasterFileBase>(type)) { }
 
-            switch (e) {
-                PAX_TYPE_DATA
-            }
+    inline paxTypes_e PaxHeader::type() { return _raster->_dataType; }
+    inline const std::vector<uint64_t> & PaxHeader::dims() { return _raster->_dims; }
+    inline rasterFileBase & PaxHeader::raster() { return *_raster; }
 
-#undef X
+    inline void PaxHeader::setShape(paxTypes_e type, const std::vector<paxDim_t>& dimsIn) {
 
-            return _vpe;
-        }
+        _raster->_dataType = type;
+        _raster->setShape(std::vector<uint64_t>(dimsIn.begin(), dimsIn.end()));
 
+    } // void PaxHeader::setShape(paxTypes_e type, const std::vector<paxDim_t>& dimsIn)
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // extract bytes per value for given type
-        //
-        static int32_t getBPV(paxTypes_e e) {
-          // sanity check on enum
-            int type = (int)e;
-            if (!isPaxType(type))  return 0;
+    inline int PaxHeader::read(BufMan & buf, uint64_t & dataLen) {
 
-            int32_t _bpv = 0;
+        return _raster->importHeader(buf, dataLen);
 
-#define X(name,val,bpv,VPE) if (val == type) { PAX_LOG (2, << "bpv for pax type " << val << " is " << bpv); _bpv = bpv; }
+    } // int PaxHeader::read(BufMan & buf, uint64_t & dataLen)
 
-            PAX_TYPE_DATA
+    inline int PaxHeader::write(std::string & out) {
 
-#undef X        
+        return _raster->renderHeader(out);
 
-                return _bpv;
-        }
+    } // int PaxHeader::write(std::string & out)
 
+    inline const char * PaxHeader::encode(const char * rowMajor, std::vector<char> & scratch, uint64_t & payloadLen) {
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // extract PAX type name for given type
-        //
-        static std::string getTypeName(paxTypes_e e) {
-          // sanity check on enum
-            int type = (int)e;
-            if (!isPaxType(type))  e = paxTypes_e::ePAX_INVALID;
+        return _raster->encodeData(rowMajor, scratch, payloadLen);
 
-            std::string name;
+    } // const char * PaxHeader::encode(const char * rowMajor, std::vector<char> & scratch, uint64_t & payloadLen)
 
-#define XX(name)            #name
-#define X(name,val,bpv,vpe) case (paxTypes_e::ePAX_ ## name): return XX(PAX_ ## name); \
+    inline int PaxHeader::decode(const char * payload, uint64_t payloadLen, char * rowMajor) {
 
+        return _raster->decodeData(payload, payloadLen, rowMajor);
 
-            switch (e) {
-                PAX_TYPE_DATA
-            }
+    } // int PaxHeader::decode(const char * payload, uint64_t payloadLen, char * rowMajor)
 
-#undef X
-#undef XX
+    inline int32_t PaxHeader::bpv(paxTypes_e type) { return rasterFileBase::getBPV(type); }
+    inline int32_t PaxHeader::vpe(paxTypes_e type) { return rasterFileBase::getVPE(type); }
+    inline paxBufPtr PaxHeader::readFile(const pax_filestring & fileName) { return rasterFileBase::readFile(fileName); }
 
-      // it's impossible to get here but some compilers doesn't know that and it removes the warnings
-            return std::string();
+    inline int PaxHeader::writeFile(const pax_filestring & fileName, const paxSegment_t * segs, size_t count) {
+
+        int fd = rasterFileBase::openForWrite(fileName);
+        if (-1 == fd) {
+            return PAX_FAIL;
         }
 
+        uint64_t len = 0;
+        for (size_t i = 0; i < count; ++i) len += segs[i].second;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Query length of sequential dimension
-        //
-        uint32_t getNumSequential()
-        {
-            return _numSequential;
+        int64_t ret = rasterFileBase::writeSegments(fd, segs, count);
+        pax_close(fd);
+
+        if (ret != (int64_t)len) {
+            PAX_LOG_ERROR(1, << "Failure. Wrote " << ret << " bytes but expected " << len << ".");
+            return PAX_FAIL;
         }
 
+        return PAX_OK;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Query length of strided dimension
-        //
-        uint32_t getNumStrided()
-        {
-            return _numStrided;
-        }
+    } // int PaxHeader::writeFile(const pax_filestring & fileName, const paxSegment_t * segs, size_t count)
 
 
+    template <paxTypes_e E>
+    class rasterFile : public rasterFileBase
+    {
+      // CXXTest Classes
+        friend class TestRead;
+        friend class TestWrite;
+        friend class NewTestRead;
+        friend class NewTestWrite;
+
         //////////////////////////////////////////////////////////////////////////
         //
-        // Query number of elements
-        //
-        uint32_t getNumElements()
-        {
-            return _numStrided * _numSequential;
-        }
+        // ctors/dtors
+        //    
+    public:
 
+        rasterFile() : rasterFileBase(E) { reset(); }
+        rasterFile(int32_t sequential, void *buf) : rasterFileBase(E) { init((uint64_t)sequential, 1, buf); }
+        rasterFile(uint32_t sequential, void *buf) : rasterFileBase(E) { init(sequential, 1, buf); }
+        rasterFile(uint64_t sequential, void *buf) : rasterFileBase(E) { init(sequential, 1, buf); }
+        rasterFile(int32_t sequential, int32_t strided = 1) : rasterFileBase(E) { init((uint64_t)sequential, (uint64_t)strided); }
+        rasterFile(uint32_t sequential, uint32_t strided = 1) : rasterFileBase(E) { init(sequential, strided); }
+        rasterFile(uint64_t sequential, uint32_t strided = 1) : rasterFileBase(E) { init(sequential, strided); }
+        rasterFile(int32_t sequential, int32_t strided, void *buf) : rasterFileBase(E) { init((uint64_t)sequential, (uint64_t)strided, buf); }
+        rasterFile(uint32_t sequential, uint32_t strided, void *buf) : rasterFileBase(E) { init(sequential, strided, buf); }
+        rasterFile(uint64_t sequential, uint32_t strided, void *buf) : rasterFileBase(E) { init(sequential, strided, buf); }
+        rasterFile(const std::vector<uint64_t> &dims, void *buf = NULL) : rasterFileBase(E) { init(dims, buf); }
+        rasterFile(const std::vector<uint64_t> &dims, void *buf, std::function<void(void*)> deleter) : rasterFileBase(E) { adopt(dims, buf, deleter); }
+        template <typename O>
+        rasterFile(const std::vector<uint64_t> &dims, void *buf, std::shared_ptr<O> owner) : rasterFileBase(E) { adopt(dims, buf, owner); }
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Query total number of values in all elements
+        // public functions
         //
-        uint32_t getNumValues()
-        {
-            return _numStrided * _numSequential * getVPE(_dataType);
-        }
+    public:
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Query length of file that was imported
+        // Reset the PAX object
         //
-        size_t importedLength()
-        {
-            return _importedLength;
+        void reset() {
+            setShape({});
+            _buf = nullptr;
+            _meta = nullptr;
+            _metaArena = nullptr;
+            _lazyIndex.clear();
+            _headerBuf = nullptr;
+            _metaLoc = LOC_END;
+            memset(_metaLocCount, 0, metaLoc_e::LOC_COUNT * sizeof(size_t));
+            setTiling(0, 0);
+            setCompression(CODEC_NONE);
+            setChecksum(false);
         }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Direct metadata access
+        // 2D/1D Initializer
         //
-        std::shared_ptr<std::unordered_map<std::string, meta_t>> & meta()
-        {
-            return _meta;
+        int init(uint64_t sequential, uint64_t strided = 1, void * buf = NULL) {
+            return init(std::vector<uint64_t>{ sequential, strided }, buf);
         }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Check for metadata
+        // N-D Initializer. Dimensions are given sequential first.
         //
-        paxMetaDataTypes_e getMetaType(std::string key)
-        {
-            auto iter = _meta->find(key);
-            bool hasit = _meta->end() != iter;
-            if (hasit) {
-                PAX_LOG(2, << "found " << key.c_str() << " of type " << (int)iter->second.type << " in metadata");
-            } else {
-                PAX_LOG_ERROR(1, << "could not find " << key.c_str() << " in metadata");
+        int init(const std::vector<uint64_t> &dims, void * buf = NULL) {
+
+            int32_t bpv = getBPV(E);
+            int32_t vpe = getVPE(E);
+
+            if (/*0 == sequential || 0 == strided ||*/ 0 == bpv || 0 == vpe) {
+
+                std::runtime_error e("PAX init: invalid dimension or PAX type");
+                throw (e);
+
             }
 
-            if (!hasit) {
-                return paxMetaDataTypes_e::paxInvalid;
+            _buf = nullptr;
+            if (PAX_OK != setShape(dims)) {
+                return PAX_INVALID;
             }
 
-            return iter->second.type;
-        } // getMetaType(std::string key)
+            if (_numValues > 0) {
+
+                _buf = std::make_shared<paxBuf_t>(_numValues * bpv * vpe);
+
+                uint64_t bytes = getBPV(E) * getVPE(E) * _numValues;
+                if (buf != NULL) {
+                    memcpy(_buf->data(), buf, bytes);
+                } else {
+                    memset(_buf->data(), 0, bytes);
+                }
+
+            }
+
+            _meta = nullptr;
+            _metaLoc = LOC_END;
+            memset(_metaLocCount, 0, metaLoc_e::LOC_COUNT * sizeof(size_t));
+
+            return PAX_OK;
+
+        } // int init (const std::vector<uint64_t> &dims, void * buf = NULL)
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Extract float from metadata
+        // 1D initializer
         //
-        float getMetaFloat(std::string key)
-        {
-            auto iter = _meta->find(key);
-            float val = std::numeric_limits<float>::quiet_NaN();
-            bool hasit = (_meta->end() != iter);
-            if (!hasit) {
-                PAX_LOG_ERROR(1, << "getting float metadata, could not find '" << key.c_str() << "'");
-                PaxStatic::setStatus(PAX_FAIL);
-                return val;
+        int init(uint64_t sequential, void * buf) {
+            return init(sequential, 1, buf);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // N-D adopting initializer: the raster wraps buf, which holds the
+        // data, instead of copying it. deleter is called with buf once the
+        // raster and every buffer sharing its data are gone. Without one the
+        // raster is only a view, and buf must outlive it. Either way, writes
+        // through the accessors go to buf.
+        //
+        int adopt(const std::vector<uint64_t> &dims, void * buf, std::function<void(void*)> deleter = nullptr) {
+
+            if (0 == getBPV(E) || 0 == getVPE(E)) {
+
+                std::runtime_error e("PAX adopt: invalid PAX type");
+                throw (e);
+
             }
 
-            bool validType = iter->second.type != paxMetaDataTypes::paxInvalid;
-            if (!validType) {
-                PAX_LOG_ERROR(1, << "getting float metadata, invalid type found for '" << key.c_str() << "'");
-                PaxStatic::setStatus(PAX_FAIL);
-                return val;
+            _buf = nullptr;
+            if (PAX_OK != setShape(dims)) {
+                return PAX_INVALID;
             }
 
-            // If the meta is an array the value will be nonsensical. Just let this happen.
-            if (iter->second.isArray()) {
-                PAX_LOG_ERROR(1, << "getting float metadata, accessing array data as scalar for '" << key.c_str() << "'");
-                val = iter->second.fb[0];
+            if (NULL == buf) {
+                if (_numValues > 0) {
+                    PAX_LOG_ERROR(1, << "Cannot adopt a NULL buffer for " << _numValues << " elements");
+                    setShape({});
+                    return PAX_INVALID;
+                }
+            } else if (deleter) {
+                _buf = paxBufPtr(new paxBuf_t(static_cast<char*>(buf), datalen()), [buf, deleter](paxBuf_t * p) { delete p; deleter(buf); });
             } else {
-                val = iter->second.f;
+                _buf = std::make_shared<paxBuf_t>(static_cast<char*>(buf), datalen());
             }
 
-            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << val);
+            _meta = nullptr;
+            _metaLoc = LOC_END;
+            memset(_metaLocCount, 0, metaLoc_e::LOC_COUNT * sizeof(size_t));
 
-            return val;
+            return PAX_OK;
+
+        } // int adopt(const std::vector<uint64_t> &dims, void * buf, std::function<void(void*)> deleter = nullptr)
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Adopting initializer sharing ownership: the data stay valid as long
+        // as owner, which the raster keeps alive, e.g. a shared frame buffer
+        //
+        template <typename O>
+        int adopt(const std::vector<uint64_t> &dims, void * buf, std::shared_ptr<O> owner) {
+            return adopt(dims, buf, [owner](void *) { });
         }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Extract float from metadata (array)
+        // Sets the dimensions without allocating raster storage. Used to
+        // describe a raster whose data is supplied elsewhere (e.g. PaxWriter).
         //
-        float getMetaFloat(std::string key, std::vector<uint32_t> &indices)
-        {
-            auto iter = _meta->find(key);
-            float val = std::numeric_limits<float>::quiet_NaN();
-            bool hasit = (_meta->end() != iter);
-            if (!hasit) {
-                PAX_LOG_ERROR(1, << "getting float metadata, could not find '" << key.c_str() << "'");
-                PaxStatic::setStatus(PAX_FAIL);
-                return val;
-            }
+        int initShape(uint64_t sequential, uint64_t strided = 1) {
+            return initShape(std::vector<uint64_t>{ sequential, strided });
+        }
 
-            bool validType = iter->second.type != paxMetaDataTypes::paxInvalid;
-            if (!validType) {
-                PAX_LOG_ERROR(1, << "getting float metadata, invalid type found for '" << key.c_str() << "'");
-                PaxStatic::setStatus(PAX_FAIL);
-                return val;
-            }
 
-            // If the meta is not an array the value will probably be nonsensical. Just let this happen.
-            if (!(iter->second.num_dims == indices.size())) {
-                PAX_LOG_ERROR(1, << "getting float metadata, accessing scalar data with indexes for '" << key.c_str() << "'");
-                return val;
-            }
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // N-D form of initShape. Dimensions are given sequential first.
+        //
+        int initShape(const std::vector<uint64_t> &dims) {
 
-            size_t index = iter->second.I(indices);
-            if (!PaxStatic::paxNoError()) {
-                return val;
-            }
-            val = iter->second.fb[index];
-            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << val);
+            reset();
 
-            return val;
+            return setShape(dims);
 
-        }
+        } // int initShape (const std::vector<uint64_t> &dims)
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Extract float from metadata (array)
+        // get values per element for internal type
         //
-        float getMetaFloat(std::string key, std::initializer_list<uint32_t> list)
-        {
-            std::vector<uint32_t> indices(list);
-            return getMetaFloat(key, indices);
+        int32_t vpe() {
+            return getVPE(E);
         }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Extract double from metadata
+        // get bytes per value for internal type
         //
-        double getMetaDouble(std::string key)
-        {
-            auto iter = _meta->find(key);
-            double val = std::numeric_limits<double>::quiet_NaN();
-            bool hasit = (_meta->end() != iter);
-            if (!hasit) {
-                PAX_LOG_ERROR(1, << "getting double metadata, could not find '" << key.c_str() << "'");
-                PaxStatic::setStatus(PAX_FAIL);
-                return val;
-            }
+        int32_t bpv() {
+            return getBPV(E);
+        }
 
-            bool validType = iter->second.type != paxMetaDataTypes::paxInvalid;
-            if (!validType) {
-                PAX_LOG_ERROR(1, << "getting double metadata, invalid type found for '" << key.c_str() << "'");
-                PaxStatic::setStatus(PAX_FAIL);
-                return val;
-            }
 
-            // If the meta is an array the value will be nonsensical. Just let this happen.
-            if (iter->second.isArray()) {
-                PAX_LOG_ERROR(1, << "getting double metadata, accessing array data as scalar for '" << key.c_str() << "'");
-            }
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // get data length
+        //
+        uint64_t datalen() {
+            return getBPV(E) * getVPE(E) * _numValues;
+        }
 
-            val = iter->second.d;
-            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << val);
 
-            return val;
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // extract PAX type name for given type
+        //
+        std::string getTypeName() {
+            return rasterFileBase::getTypeName(E);
         }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Extract double from metadata (array)
+        // convertTo: convert the raster data to another PAX type with the same
+        // values per element, value by value (see PaxConvert). out holds
+        // getNumValues() values of the new type.
         //
-        double getMetaDouble(std::string key, std::vector<uint32_t> &indices)
-        {
-            auto iter = _meta->find(key);
-            double val = std::numeric_limits<double>::quiet_NaN();
-            bool hasit = (_meta->end() != iter);
-            if (!hasit) {
-                PAX_LOG_ERROR(1, << "getting double metadata, could not find '" << key.c_str() << "'");
-                return val;
-            }
+        int convertTo(paxTypes_e type, void * out, const paxConvert_t & options = paxConvert_t()) {
 
-            bool validType = iter->second.type != paxMetaDataTypes::paxInvalid;
-            if (!validType) {
-                PAX_LOG_ERROR(1, << "getting double metadata, invalid type found for '" << key.c_str() << "'");
-                return val;
+            if (getVPE(type) != getVPE(E)) {
+                PAX_LOG_ERROR(1, << "Cannot convert " << rasterFileBase::getTypeName(E) << " to " << rasterFileBase::getTypeName(type) << ": values per element differ");
+                return PAX_INVALID;
             }
-
-            // If the meta is not an array the value will probably be nonsensical.
-            if (!(iter->second.num_dims == indices.size())) {
-                PAX_LOG_ERROR(1, << "getting double metadata, accessing scalar data with indexes for '" << key.c_str() << "'");
-                return val;
+            if (getNumValues() > 0 && NULL == buf()) {
+                PAX_LOG_ERROR(1, << "Raster has no data to convert");
+                return PAX_FAIL;
             }
 
-            size_t index = iter->second.I(indices);
-            if (!PaxStatic::paxNoError()) {
-                return val;
-            }
-            val = iter->second.db[index];
-            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << val);
+            return PaxConvert::convert(E, buf(), type, out, getNumValues(), options);
 
-            return val;
-        }
+        } // int convertTo(paxTypes_e type, void * out, const paxConvert_t & options = paxConvert_t())
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Extract float from metadata (array)
+        // convert: copy the raster into a new raster of another PAX type with
+        // the same shape. Returns nullptr if the types cannot be converted.
         //
-        double getMetaDouble(std::string key, std::initializer_list<uint32_t> list)
-        {
-            std::vector<uint32_t> indices(list);
-            return getMetaDouble(key, indices);
-        }
+        template <paxTypes_e D>
+        rasterFilePtr<D> convert(const paxConvert_t & options = paxConvert_t()) {
+
+            rasterFilePtr<D> out = std::make_shared<rasterFile<D>>(getDims());
+            if (PAX_OK != convertTo(D, out->buf(), options)) {
+                return nullptr;
+            }
+
+            return out;
+
+        } // rasterFilePtr<D> convert(const paxConvert_t & options = paxConvert_t())
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Extract integer types from metadata
+        // Convert byte data to float
         //
-        template <typename T>
-        T getMetaInteger(std::string key) {
-
-            T errorcode = std::numeric_limits<T>::max();
-            auto iter = _meta->find(key);
-            bool hasit = (_meta->end() != iter);
-            if (!hasit) {
-                PAX_LOG_ERROR(1, << "getting integer metadata, could not find '" << key.c_str() << "'");
-                return errorcode;
-            }
+        std::shared_ptr<float> byteToFloatData() {
 
-            bool validType = iter->second.type != paxMetaDataTypes::paxInvalid;
-            if (!validType) {
-                PAX_LOG_ERROR(1, << "getting integer metadata, invalid type found for '" << key.c_str() << "'");
-                return errorcode;
-            }
+            std::shared_ptr<float> floatData(new float[getNumElements()], std::default_delete<float[]>());
+            PaxConvert::convert(SCALAR_UINT8, buf(), SCALAR_FLOAT, floatData.get(), getNumElements());
 
-            // If the meta is an array the value will probably be nonsensical.
-            T val = errorcode;
-            if (iter->second.isArray()) {
-                PAX_LOG_ERROR(1, << "getting integer metadata, accessing array data as scalar for '" << key.c_str() << "'");
-                val = static_cast<T>(iter->second.u64b[0]); // static_cast doesn't care about signed-ness. TODO: endian problems though.
+            return floatData;
 
-            } else {
+        } // std::shared_ptr<float> byteToFloatData() 
 
-                val = static_cast<T>(iter->second.u64); // static_cast doesn't care about signed-ness. TODO: endian problems though.
 
-            }
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Convert float data to uint8, clamping to 0..255
+        //
+        std::shared_ptr<uint8_t> floatToByteData() {
 
-            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << +val);
+            std::shared_ptr<uint8_t> byteData(new uint8_t[getNumElements()], std::default_delete<uint8_t[]>());
+            PaxConvert::convert(SCALAR_FLOAT, buf(), SCALAR_UINT8, byteData.get(), getNumElements());
 
-            return val;
+            return byteData;
 
-        }
+        } // std::shared_ptr<uint8_t> floatToByteData() 
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Extract integer types from metadata (array)
+        // Convert the data to a PGM file (currently only valid for UCHAR, CHAR, FLOAT)
+        // Valid values for pgmType are 2 and 5 for P2 (8-bit ascii) and P5 (8-bit binary), respectively.
+        // N-D rasters are written as a stack of 2-D planes.
         //
-        template <typename T>
-        T getMetaInteger(std::string key, std::vector<uint32_t> &indices) {
+        paxBufPtr toPGM(int pgmType = 5) {
 
-            T errorcode = std::numeric_limits<T>::max();
-            auto iter = _meta->find(key);
-            bool hasit = (_meta->end() != iter);
-            if (!hasit) {
-                PAX_LOG_ERROR(1, << "getting integer metadata, could not find '" << key.c_str() << "'");
-                PaxStatic::setStatus(PAX_FAIL);
-                return errorcode;
-            }
+            ucharRasterFile *paxPtr;  // use an abstract pointer to facilitate conversion
+            ucharRasterFilePtr bytePtr;
+            std::shared_ptr<uint8_t> byteData;
 
-            bool validType = iter->second.type != paxMetaDataTypes::paxInvalid;
-            if (!validType) {
-                PAX_LOG_ERROR(1, << "getting integer metadata, invalid type found for '" << key.c_str() << "'");
-                PaxStatic::setStatus(PAX_FAIL);
-                return errorcode;
-            }
+            if (pgmType != 2 && pgmType != 5) return nullptr;
 
-            // If the meta is not an array the value will probably be nonsensical.
-            if (!(iter->second.num_dims == indices.size())) {
-                PAX_LOG_ERROR(1, << "getting integer metadata, accessing array data as scalar for '" << key.c_str() << "'");
-                return errorcode;
+            switch (_dataType) {
+                //paxPtr = this;
+                //break;
+
+            case paxTypes::ePAX_UCHAR:
+            case paxTypes::ePAX_CHAR:
+                paxPtr = reinterpret_cast<ucharRasterFile *>(this);
+                break;
+
+            case paxTypes::ePAX_FLOAT:
+                byteData = floatToByteData();
+                bytePtr = std::make_shared<ucharRasterFile>(_numSequential, getNumRows(), byteData.get());
+                paxPtr = bytePtr.get();
+                break;
+
+            default:
+                return nullptr;
             }
 
-            T *bufPtr = static_cast<T*>(iter->second.bufPtr());
-            size_t index = iter->second.I(indices);
-            if (!PaxStatic::paxNoError()) {
-                return errorcode;
+            // write output file to a pgm file
+            std::ostringstream hdrs;
+            const char *pgmTag = (2 == pgmType) ? "P2\n" : "P5\n";
+            hdrs << pgmTag << _numSequential << " " << getNumRows() << "\n255\n";
+
+            std::string hdr = hdrs.str();
+            size_t hdrLen = hdr.length();
+            size_t dataLen = getNumValues() * sizeof(uint8_t);
+            if (2 == pgmType) {
+                dataLen = 4 * dataLen + 1; // length of ascii buffer is exactly this (all values are 3 digits, plus spaces and LF's, plus NULL)
             }
-            T val = bufPtr[index];
-            PAX_LOG(2, << "getting metadata: '" << key.c_str() << "' = " << +val);
 
-            return val;
+            size_t imgLen = hdrLen + dataLen;
 
-        }
+            paxBufPtr pgmBuf = std::make_shared<paxBuf_t>(imgLen);
+            char *pgmbuf = pgmBuf.get()->data();
+            uint8_t *paxBuf = reinterpret_cast<uint8_t*> (paxPtr->buf());
+
+            // TODO: PAX insertion operator for paxBufData_t
+            memcpy(pgmbuf, hdr.c_str(), hdrLen);
+            pgmbuf += hdrLen;
 
+            if (2 == pgmType) {
+              // write ascii file
+                size_t len = 0;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Extract integer types from metadata (array)
-        //
-        template <typename T>
-        T getMetaInteger(std::string key, std::initializer_list<uint32_t> list) {
-            std::vector<uint32_t> indices(list);
-            return getMetaInteger<T>(key, indices);
-        }
+                for (uint64_t j = 0; j < getNumRows(); ++j) {
+                    for (uint64_t i = 0; i < _numSequential; ++i) {
+                        len += pax_sprintf(pgmbuf + len, "%3d ", *(paxBuf++));
+                    }
+                    pgmbuf[len - 1] = '\n';
+                }
+                pgmbuf[len - 1] = '\n';
+                pgmbuf[len] = ' ';
+
+            } else {
+                memcpy(pgmbuf, paxBuf, dataLen);
+            }
+
+            return pgmBuf;
+
+        } // paxBufPtr toPGM(int pgmType = 5)  
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Extract specific scalar types from metadata
+        // Write the data to a PGM file (currently only valid for ePAX_UCHAR, ePAX_CHAR, ePAX_FLOAT)
+        // Valid values for pgmType are 2 and 5 for P2 (8-bit ascii) and P5 (8-bit binary), respectively.
         //
-        int64_t  getMetaInt64(std::string key) { return getMetaInteger<int64_t>(key); }
-        uint64_t getMetaUint64(std::string key) { return getMetaInteger<uint64_t>(key); }
-        int32_t  getMetaInt32(std::string key) { return getMetaInteger<int32_t>(key); }
-        uint32_t getMetaUint32(std::string key) { return getMetaInteger<uint32_t>(key); }
-        int16_t  getMetaInt16(std::string key) { return getMetaInteger<int16_t>(key); }
-        uint16_t getMetaUint16(std::string key) { return getMetaInteger<uint16_t>(key); }
-        int8_t  getMetaInt8(std::string key) { return getMetaInteger<int8_t>(key); }
-        uint8_t getMetaUint8(std::string key) { return getMetaInteger<uint8_t>(key); }
+        int writeToPGMFile(std::string fileName, int pgmType = 5) {
 
-        // array index via vector
-        int64_t  getMetaInt64(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<int64_t>(key, indices); }
-        uint64_t getMetaUint64(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<uint64_t>(key, indices); }
-        int32_t  getMetaInt32(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<int32_t>(key, indices); }
-        uint32_t getMetaUint32(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<uint32_t>(key, indices); }
-        int16_t  getMetaInt16(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<int16_t>(key, indices); }
-        uint16_t getMetaUint16(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<uint16_t>(key, indices); }
-        int8_t  getMetaInt8(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<int8_t>(key, indices); }
-        uint8_t getMetaUint8(std::string key, std::vector<uint32_t> indices) { return getMetaInteger<uint8_t>(key, indices); }
+            paxBufPtr pgmBuf = toPGM(pgmType);
 
-        //// array index via initializer list
-        //int64_t  getMetaInt64 (std::string key, std::initializer_list<uint32_t> list)    { return getMetaInteger<int64_t> (key, list); }
-        //uint64_t getMetaUint64 (std::string key, std::initializer_list<uint32_t> list)   { return getMetaInteger<uint64_t> (key, list); }
-        //int64_t  getMetaInt32 (std::string key, std::initializer_list<uint32_t> list)    { return getMetaInteger<int32_t> (key, list); }
-        //uint64_t getMetaUint32 (std::string key, std::initializer_list<uint32_t> list)   { return getMetaInteger<uint32_t> (key, list); }
-        //int64_t  getMetaInt16 (std::string key, std::initializer_list<uint32_t> list)    { return getMetaInteger<int16_t> (key, list); }
-        //uint64_t getMetaUint16 (std::string key, std::initializer_list<uint32_t> list)   { return getMetaInteger<uint16_t> (key, list); }
-        //int64_t  getMetaInt8 (std::string key, std::initializer_list<uint32_t> list)     { return getMetaInteger<int8_t> (key, list); }
-        //uint64_t getMetaUint8 (std::string key, std::initializer_list<uint32_t> list)    { return getMetaInteger<uint8_t> (key, list); }
+            if (nullptr == pgmBuf) {
+                PAX_LOG_ERROR(1, << "Error writing PAX to PGM!! Filename was going to be '" << fileName << "'");
+                return PAX_FAIL;
+            }
 
+            int ret = rasterFileBase::writeToFile(pgmBuf, fileName);
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Extract string from metadata
-        //
-        std::string getMetaString(std::string key)
-        {
-            auto iter = _meta->find(key);
-            bool hasit = _meta->end() != iter;
-            if (!hasit) {
-                PAX_LOG_ERROR(1, << "getting metadata, could not find '" << key.c_str() << "'");
-                return "";
+            if (PAX_OK != ret) {
+                PAX_LOG_ERROR(1, << "Error writing PGM file '" << fileName << "'");
             }
 
-            std::string str = iter->second.s;
-            PAX_LOG(2, << "getting metadata: '" << key << "' = " << str);
+            return ret;
 
-            return str;
-        }
+        } // int writeToPGMFile(std::string fileName, int pgmType = 5) 
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Convert the data to float
+        // import PAX file from file
         //
-        static std::shared_ptr<float> getFloatData(rasterFileBase *paxIn)
-        {
-          // not implements
-            PAX_LOG_ERROR(1, << "getFloatData() has not been implemented yet");
-            return nullptr;
-      /*      std::shared_ptr<float> floatData(new float(paxIn->getNumElements()));
-      //      float *data = floatData.get();
-      //
-      //      switch(paxIn->getType()) {
-      //#define X(name, val, vpe)                                     \
-      //        case ePAX_ ## name:                                   \
-      //          { rasterFile<ePAX_ ## name> *pax = (rasterFile<ePAX_ ## name> *)                                                 \
-      //        for (int i = 0; i < paxIn->getNumElements(); ++i) {
-      //          data[i] = (float)
-      //        }
-      //      }
-      //
-      //      PAX_VALUE_SPACE_DATA
-      //#undef X    */
-        }
+        int import(pax_filestring fileName) {
 
+            PAX_LOG(1, << "Importing PAX file " << fileName);
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Checks for existence of the given directory
-        //
-        static bool isDirExist(const std::string& path)
-        {
-            struct pax_stat info;
-            if (pax_stat(path.c_str(), &info) != 0)
-            {
-                return false;
+            paxBufPtr fileBuf = readFile(fileName);
+            if (!fileBuf) {
+              // error has already been reported
+                return PAX_FAIL;
             }
-            return (info.st_mode & pax_ifdir) != 0;
-        }
+
+            if (fileBuf.get()->size() < MIN_PAX_LENGTH) {
+                PAX_LOG_ERROR(1, << ("PAX file too short"));
+                return PAX_FAIL;
+            }
+
+            return import(fileBuf);
+
+        } // int import (pax_filestring fileName)
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // makes the full given path
+        // import PAX file from file by memory-mapping it. The header is parsed
+        // in place and the raster is not copied: the internal buffer points
+        // straight into the mapping, which stays alive as long as the buffer.
+        // Writers do not pad the header, so the data start wherever the header
+        // ends. Only when its length is a multiple of the bytes per value are
+        // the data referenced in place; otherwise they are misaligned for
+        // their type and get copied, as they are for tiled or compressed data.
         //
-        static bool makePath(const std::string& path)
-        {
-#ifndef _WIN32
-            mode_t mode = 0755;
-#endif
-            int ret = pax_mkdir(path.c_str(), mode);
-            if (ret == 0)
-                return true;
+        int importMapped(pax_filestring fileName) {
 
-            switch (errno)
-            {
-            case ENOENT:
-              // parent didn't exist, try to create it
-            {
-                size_t pos = path.find_last_of('/');
-                if (pos == std::string::npos)
-#if defined(_WIN32)
-                    pos = path.find_last_of('\\');
-                if (pos == std::string::npos)
-#endif
-                    return false;
-                if (!makePath(path.substr(0, pos)))
-                    return false;
+            PAX_LOG(1, << "Importing mapped PAX file " << fileName);
+
+            paxMapPtr map = std::make_shared<PaxMap>();
+            if (PAX_OK != map->map(fileName)) {
+              // error has already been reported
+                return PAX_FAIL;
+            }
+
+            if (map->size() < MIN_PAX_LENGTH) {
+                PAX_LOG_ERROR(1, << ("PAX file too short"));
+                return PAX_FAIL;
             }
-            // now, try to create again
-            return 0 == pax_mkdir(path.c_str(), mode);
 
-            case EEXIST:
-              // done!
-                return isDirExist(path);
+            return importBuffer(map->data(), map->size(), map);
 
-            default:
-                return false;
-            }
-        }
+        } // int importMapped (pax_filestring fileName)
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // output given PAX buffer to file
+        // readRegion: import a w x h window of a PAX file, starting at element
+        // x0 of row y0. Only the header and the rows of the window are read:
+        // the file is memory-mapped and each row segment is copied out of the
+        // mapping, so pages outside the window are never touched. In a tiled
+        // file only the tiles overlapping the window are touched, and only
+        // their checksums are verified. A compressed file has to be
+        // decompressed and verified whole first; a plain one is not verified.
+        // Higher dimensions are kept whole, each plane contributing the same
+        // window. The metadata of the file are kept.
         //
-        static int writeToFile(std::ostringstream & oss, pax_filestring fileName) {
-            // TODO: PAX improve writeToFile(ostringstream), needs 2 copies
-            std::string str = oss.str();
-            paxBufPtr buf = std::make_shared<paxBuf_t>(str.length());
-            memcpy(buf->data(), str.c_str(), str.length());
-            return writeToFile(buf, fileName);
-        }
+        int readRegion(pax_filestring fileName, uint64_t x0, uint64_t y0, uint64_t w, uint64_t h) {
 
+            PAX_LOG(1, << "Reading " << w << "x" << h << " region at (" << x0 << ", " << y0 << ") of PAX file " << fileName);
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // output given PAX buffer to file
-        //
-        static int writeToFile(paxBufPtr &buf, pax_filestring fileName) {
-            PAX_LOG(1, << "Writing PAX buffer " << "of size " << buf->size() << " to " << fileName);
+            PaxMap map;
+            std::vector<char> scratch;
+            const char * data = mapHeader(map, fileName, scratch);
+            if (NULL == data) {
+              // error has already been reported
+                return PAX_FAIL;
+            }
 
-            pax_remove(fileName.c_str());
-            int fd = pax_open(fileName.c_str(), O_BINARY | O_CREAT | O_WRONLY, 0660);
-            if (-1 == fd) {
-                PAX_LOG_ERRNO(1, << "Error " << errno << " opening output file.");
+            std::vector<uint64_t> dims = getDims();
+            if (dims.size() < 2 || 0 == _numValues) {
+                PAX_LOG_ERROR(1, << "Cannot read a region of a raster with " << dims.size() << " dimensions and " << _numValues << " values");
+                reset();
+                return PAX_INVALID;
+            }
+            if (0 == w || 0 == h || x0 >= dims[0] || w > dims[0] - x0 || y0 >= dims[1] || h > dims[1] - y0) {
+                PAX_LOG_ERROR(1, << "Region " << w << "x" << h << " at (" << x0 << ", " << y0 << ") lies outside the " << dims[0] << "x" << dims[1] << " raster");
+                reset();
+                return PAX_INVALID;
+            }
+
+            if (!isCompressed() && PAX_OK != verifyRegion(data, x0, y0, w, h)) {
+                reset();
                 return PAX_FAIL;
             }
 
-            int ret = (int)pax_write(fd, buf->data(), (unsigned int)buf->size());
-            pax_close(fd);
+            const uint64_t rowLen = w * bpv() * vpe();
+            const uint64_t planes = _numValues / (dims[0] * dims[1]);
+            if (0 == rowLen || rowLen * h > UINT64_MAX / planes) {
+                PAX_LOG_ERROR(1, << "Region " << w << "x" << h << " of " << planes << " planes is too large");
+                reset();
+                return PAX_INVALID;
+            }
 
-            if (ret == (int)buf->size()) {
-                PAX_LOG(1, << "Successfully wrote " << buf->size() << " bytes.");
-            } else {
-                PAX_LOG(1, << "Failure. Write returned " << ret << " but expected " << buf->size() << ".");
+            paxBufPtr dataBuf = std::make_shared<paxBuf_t>(rowLen * h * planes);
+            char * out = dataBuf->data();
+            for (uint64_t plane = 0; plane < planes; ++plane) {
+                for (uint64_t y = y0; y < y0 + h; ++y) {
+                    copyFileRow(data, x0, plane * dims[1] + y, w, out);
+                    out += rowLen;
+                }
             }
 
+            dims[0] = w;
+            dims[1] = h;
+            setShape(dims);
+            setTiling(0, 0);
+            _buf = dataBuf;
+
             return PAX_OK;
-        }
+
+        } // int readRegion(pax_filestring fileName, uint64_t x0, uint64_t y0, uint64_t w, uint64_t h)
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // open the given file and read its contents on a chunk-by-chunk basis
-        //
-        // note that CHUNK_LEN is tied to size of file read in test_previewmeta_only_multichunk
+        // readTile: import tile (i, j) of a tiled PAX file, i counting across
+        // and j down the grid of tiles. Only that tile is read and verified.
+        // Edge tiles are trimmed to the raster. The result is a 2-D raster
+        // with the file's metadata.
         //
-#define CHUNK_LEN 16384
-        static paxBufPtr readFileChunk(pax_filestring fileName, int nChunk = 0) {
+        int readTile(pax_filestring fileName, uint64_t i, uint64_t j) {
 
-            PAX_LOG(2, << "Reading chunk " << nChunk << " from " << fileName);
+            PAX_LOG(1, << "Reading tile (" << i << ", " << j << ") of PAX file " << fileName);
 
-            // open the file
-            int fd = pax_open(fileName.c_str(), O_BINARY | O_RDONLY, 0660);
-            if (-1 == fd) {
-                PAX_LOG_ERRNO(1, << " opening input file.");
-                return nullptr;
+            PaxMap map;
+            std::vector<char> scratch;
+            const char * data = mapHeader(map, fileName, scratch);
+            if (NULL == data) {
+              // error has already been reported
+                return PAX_FAIL;
             }
 
-            PAX_LOG(2, << "successfully opened file");
+            if (!isTiled() || i >= getTilesAcross() || j >= getTilesDown()) {
+                PAX_LOG_ERROR(1, << "PAX file has no tile (" << i << ", " << j << ")");
+                reset();
+                return PAX_INVALID;
+            }
 
-            // get file size, create buffer
-            long fileLength = pax_lseek(fd, 0, SEEK_END);
-            if (-1L == fileLength) {
-                PAX_LOG_ERRNO(1, << " getting size of input file.");
-                return nullptr;
+            if (!isCompressed() && PAX_OK != verifyTile(data, j * getTilesAcross() + i)) {
+                reset();
+                return PAX_FAIL;
             }
 
-            PAX_LOG(2, << "file length is " << fileLength);
+            const uint64_t x0 = i * _tileWidth;
+            const uint64_t y0 = j * _tileHeight;
+            const uint64_t w = PAX_MIN(_tileWidth, _numSequential - x0);
+            const uint64_t h = PAX_MIN(_tileHeight, getNumRows() - y0);
+            const uint64_t rowLen = w * bpv() * vpe();
 
-            long start = nChunk * CHUNK_LEN;
+            paxBufPtr dataBuf = std::make_shared<paxBuf_t>(rowLen * h);
+            for (uint64_t y = 0; y < h; ++y) {
+                copyFileRow(data, x0, y0 + y, w, dataBuf->data() + y * rowLen);
+            }
 
-            // trivial case: start is past EOF
-            if (start > fileLength) {
-                PAX_LOG_WARN(2, << "start of chunk " << nChunk << " is beyond length of file. Returning empty buffer.");
-                return std::make_shared<paxBuf_t>(0);
+            setShape({ w, h });
+            setTiling(0, 0);
+            _buf = dataBuf;
+
+            return PAX_OK;
+
+        } // int readTile(pax_filestring fileName, uint64_t i, uint64_t j)
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // importConverted: import a PAX file of another type with the same
+        // values per element, converting it to E on the way in (see
+        // PaxConvert), e.g. a HALF file straight into a float working raster.
+        // The file is memory-mapped and a plain payload is converted straight
+        // out of the mapping after its checksum is verified; a tiled or
+        // compressed one is decoded first. The metadata of the file are kept.
+        //
+        int importConverted(pax_filestring fileName, const paxConvert_t & options = paxConvert_t()) {
+
+            PAX_LOG(1, << "Importing PAX file " << fileName << " as " << rasterFileBase::getTypeName(E));
+
+            PaxMap map;
+            if (PAX_OK != map.map(fileName)) {
+              // error has already been reported
+                return PAX_FAIL;
             }
 
-            long length = CHUNK_LEN;
+            if (map.size() < MIN_PAX_LENGTH) {
+                PAX_LOG_ERROR(1, << ("PAX file too short"));
+                return PAX_FAIL;
+            }
 
-            // check for partial chunk
-            if (start + CHUNK_LEN > fileLength) {
-                length = fileLength - start;
-                PAX_LOG_WARN(2, << "End of chunk " << nChunk << " is beyond length of file. Returning partial chunk of length " << length);
+            BufMan fileBuf(map.data(), map.size());
+            PaxHeader header;
+            uint64_t dataLen = 0;
+            if (PAX_OK != header.read(fileBuf, dataLen)) {
+                return PAX_FAIL;
             }
 
-            // allocate buffer for input file
-            paxBufPtr inBuf = std::make_shared<paxBuf_t>(length);
-            if (!inBuf) {
-                PAX_LOG_ERROR(1, " allocating input buffer. Returning null.");
-                return nullptr;
+            rasterFileBase & in = header.raster();
+            if (getVPE(header.type()) != getVPE(E)) {
+                PAX_LOG_ERROR(1, << "Cannot convert " << rasterFileBase::getTypeName(header.type()) << " to " << rasterFileBase::getTypeName(E) << ": values per element differ");
+                return PAX_INVALID;
             }
 
-            // read the file into buffer
-            pax_lseek(fd, nChunk * CHUNK_LEN, SEEK_SET);
-            char *buf = inBuf->data();
-            int readRet = pax_read(fd, buf, length);
+            const char * data = fileBuf.viewData(dataLen);
+            if (NULL == data) {
+                return PAX_FAIL;
+            }
 
-            // close the file
-            pax_close(fd);
-            if (readRet != length) {
-                PAX_LOG_ERROR(1, << " reading input file.");
-                return nullptr;
+            std::vector<char> rowMajor;
+            if (in.isTiled() || in.isCompressed()) {
+                rowMajor.resize(in.getNumValues() * getBPV(header.type()));
+                if (PAX_OK != header.decode(data, dataLen, rowMajor.data())) {
+                    return PAX_FAIL;
+                }
+                data = rowMajor.data();
+            } else if (PAX_OK != in.verifyPayload(data, dataLen)) {
+                return PAX_FAIL;
             }
 
-            PAX_LOG(2, << "readFile done");
+            init(header.dims());
+            int ret = PaxConvert::convert(header.type(), data, E, buf(), getNumValues(), options);
+            if (PAX_OK != ret) {
+                reset();
+                return ret;
+            }
 
-            return inBuf;
+            copyMeta(*this, in);
+            countMetaLocs();
 
-        } // paxBufPtr readFile (pax_filestring fileName)
+            return PAX_OK;
+
+        } // int importConverted(pax_filestring fileName, const paxConvert_t & options = paxConvert_t())
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // open the given file and read its contents
+        // tile: copy tile (i, j) of this raster into a new 2-D raster, using
+        // the tiling set by setTiling() or read from the file. Edge tiles are
+        // trimmed to the raster. Returns nullptr if there is no such tile.
         //
-        static paxBufPtr readFile(pax_filestring fileName) {
-
-            PAX_LOG(1, << "Reading " << fileName);
+        rasterFilePtr<E> tile(uint64_t i, uint64_t j) {
 
-            // open the file
-            int fd = pax_open(fileName.c_str(), O_BINARY | O_RDONLY, 0660);
-            if (-1 == fd) {
-                PAX_LOG_ERRNO(1, << " opening input file.");
+            if (!isTiled() || !_buf || i >= getTilesAcross() || j >= getTilesDown()) {
+                PAX_LOG_ERROR(1, << "Raster has no tile (" << i << ", " << j << ")");
                 return nullptr;
             }
 
-            PAX_LOG(2, << "successfully opened file");
+            const uint64_t x0 = i * _tileWidth;
+            const uint64_t y0 = j * _tileHeight;
+            const uint64_t w = PAX_MIN(_tileWidth, _numSequential - x0);
+            const uint64_t h = PAX_MIN(_tileHeight, getNumRows() - y0);
+            const uint64_t elemLen = (uint64_t)bpv() * vpe();
 
-            // get file size, create buffer
-            long length = pax_lseek(fd, 0, SEEK_END);
-            if (-1L == length) {
-                PAX_LOG_ERRNO(1, << " getting size of input file.");
-                return nullptr;
+            rasterFilePtr<E> out = std::make_shared<rasterFile<E>>(std::vector<uint64_t>{ w, h });
+            for (uint64_t y = 0; y < h; ++y) {
+                memcpy(out->buf() + y * w * elemLen, buf() + ((y0 + y) * _numSequential + x0) * elemLen, w * elemLen);
             }
 
-            PAX_LOG(2, << "file length is " << length);
-
-            // allocate buffer for input file
-            paxBufPtr inBuf = std::make_shared<paxBuf_t>(length);
-            if (!inBuf) {
-                PAX_LOG_ERROR(1, " allocating input buffer.");
-                return nullptr;
-            }
+            return out;
 
-            // read the file into buffer
-            pax_lseek(fd, 0, SEEK_SET);
-            char *buf = inBuf->data();
-            int readRet = pax_read(fd, buf, length);
+        } // rasterFilePtr<E> tile(uint64_t i, uint64_t j)
 
-            // close the file
-            pax_close(fd);
-            if (readRet != length) {
-                PAX_LOG_ERROR(1, << " reading input file.");
-                return nullptr;
-            }
 
-            PAX_LOG(2, << "readFile done");
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // import PAX file from paxBufPtr
+        //
+        int import(paxBufPtr inBuf) {
+            return import(inBuf.get()->data(), inBuf.get()->size());
+        }
 
-            return inBuf;
 
-        } // paxBufPtr readFile (pax_filestring fileName)
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // import PAX file from constant buffer
+        //
+        int import_copy(const unsigned char* inBuf, size_t length) {
+            std::vector<unsigned char> buf(length);
+            memcpy(buf.data(), inBuf, length);
+            PAX_LOG(2, << "PAX import_copy copied an unsigned buffer of length " << length);
+            return import(buf.data(), length);
+        }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // writeToBuffer: writes PAX to a buffer (base class implementation writes header only)
-        // 
-        virtual int writeToBuffer(paxBufPtr &outBuf) {
-          // TODO: rasterFileBase::writeToBuffer
-            return 0;
+        // import PAX file from buffer
+        //
+        int import(unsigned char* inBuf, size_t length) {
+            return import((char*)inBuf, length);
         }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // importHeader: import an PAX header from a buffer
-        // 
-        int importHeader(BufMan & buf, int32_t &dataLen, bool fastImport = false) {
-          // DEVCODE: verbosityLevel in importHeader
-#define verbosityLevel 2
-
-      // sanity check
-            paxTypes_e  paxType = paxTypes_e::ePAX_INVALID;
-            float       version = 0.0f;
-            if (!validatePaxTag(buf.pos(), paxType, version)) {
-                PAX_LOG_ERROR(1, << "not a valid PAX file");
-                return PAX_FAIL;
-            }
+        // import PAX file from const buffer
+        //
+        int import_copy(const char* inBuf, size_t length) {
+            std::vector<char> buf(length);
+            memcpy(buf.data(), inBuf, length);
+            PAX_LOG(2, << "PAX import_copy copied a signed buffer of length " << length);
+            return import(buf.data(), length);
+        }
 
-            _dataType = paxType;
-            _version = version;
 
-            PAX_LOG(2, << "validatePaxTag done");
-            //if (buf.skipLine ()) { reportEOF (); return -1; }
-            PAX_LOG(2, << "begin parsing header lines");
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // import PAX file from buffer
+        //
+        int import(char* inBuf, size_t length) {
+            return importBuffer(inBuf, length, nullptr);
+        }
 
-            int32_t bpv = 0, vpe = 0, dim1count = 0, dim2count = 0, datalencount = 0;
 
-            getMetaRef();
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // import PAX file from buffer. If a mapping is given the buffer lies
+        // within it, and the raster is referenced in place instead of copied.
+        //
+        int importBuffer(char* inBuf, size_t length, paxMapPtr map) {
 
-            hlType_t type = HEADERLINETYPE::NOT_CHECKED;
+            if (_numValues != 0 || _numSequential != 0 || _numStrided != 0 || _buf != nullptr || _meta != nullptr) {
+                reset();
+            }
 
-            // Begin parsing header lines. Check for EOF each line.
-            while (!buf.eof()) {
+            PAX_LOG(1, << "Importing PAX buffer of length " << length);
 
-                bool headerDone = false;
-                bool nextLine = false;
-                std::pair <std::string, meta_t> meta1;
+            // parse the header
+            BufMan buf(inBuf, length);
 
-                if (HEADERLINETYPE::NOT_CHECKED == type) {
-                    type = buf.getHeaderLineType(); // returns the line type but no further checking
-                }
+            uint64_t dataLen = 0;
+            int headerRet = importHeader(buf, dataLen);
 
-                switch (type) {
-                case hlType_t::UNKNOWN:
-                default:
-                    PAX_LOG(verbosityLevel, << "Skipping line of type " << (int)type);
-                    nextLine = true;
-                    break;
+            if (PAX_OK != headerRet) {
+                return PAX_FAIL;
+            }
 
-                case hlType_t::PAX:
-                    PAX_LOG(verbosityLevel, << "Skipping line of type " << (int)type);
-                    buf.setLoc(metaLoc::LOC_AFTER_TAG, _metaLocCount[LOC_AFTER_TAG]);
-                    nextLine = true;
-                    break;
+            char * payload = buf.viewData(dataLen);
+            if (NULL == payload) {
+                return PAX_FAIL;
+            }
 
-                case hlType_t::BPV:
-                    bpv = buf.getUint32(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
-                    PAX_LOG(verbosityLevel, << "Read BPV = " << bpv);
-                    buf.setLoc(metaLoc::LOC_AFTER_TAG, /*LOC_AFTER_BPV, */_metaLocCount[LOC_AFTER_TAG/*LOC_AFTER_BPV*/]);    // TEMPCODE: single meta location
-                    break;
+            // the header length is arbitrary, so the data may sit at an address that typed access cannot use
+            const bool aligned = 0 == reinterpret_cast<uintptr_t>(payload) % getBPV(_dataType);
 
-                case hlType_t::VPE:
-                    vpe = buf.getUint32(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
-                    PAX_LOG(verbosityLevel, << "Read VPE = " << vpe);
-                    buf.setLoc(metaLoc::LOC_AFTER_TAG, /*LOC_AFTER_VPE, */_metaLocCount[LOC_AFTER_TAG/*LOC_AFTER_VPE*/]);    // TEMPCODE: single meta location
-                    break;
+            paxBufPtr dataBuf;
+            if (map && aligned && !isTiled() && !isCompressed()) {
+                // reference the data in place; the deleter holds the mapping open
+                if (PAX_OK != verifyPayload(payload, dataLen)) {
+                    return PAX_FAIL;
+                }
+                dataBuf = paxBufPtr(new paxBuf_t(payload, dataLen), [map](paxBuf_t * p) { delete p; });
+            } else {
+                // copy that data, decompressing and rearranging the tiles into rows
+                dataBuf = std::make_shared <paxBuf_t>(datalen());
+                if (PAX_OK != decodeData(payload, dataLen, dataBuf->data())) {
+                    return PAX_FAIL;
+                }
+            }
 
-                case hlType_t::DIM: {
-                    switch (buf.getDimTagIndex()) {
-                    case 0:
-                        _numSequential = buf.getUint32(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
-                        PAX_LOG(verbosityLevel, << "Read DIM1 = " << _numSequential);
-                        buf.setLoc(metaLoc::LOC_AFTER_TAG, /*LOC_AFTER_SEQ, */_metaLocCount[LOC_AFTER_TAG/*LOC_AFTER_SEQ*/]);    // TEMPCODE: single meta location
-                        ++dim1count;
-                        break;
-                    default:
-                        _numStrided = buf.getUint32(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
-                        PAX_LOG(verbosityLevel, << "Read DIM2 = " << _numStrided);
-                        buf.setLoc(metaLoc::LOC_AFTER_TAG, /*LOC_AFTER_STR1, */_metaLocCount[LOC_AFTER_TAG/*LOC_AFTER_STR1*/]);    // TEMPCODE: single meta location
-                        ++dim2count;
-                        break;
+            // store those metadata counts
+            countMetaLocs();
+
+            if (PaxStatic::getVerbosity() >= 3) {
+                PAX_LOG(3, << "Some data for ya:");
+                float * buf = (float*)dataBuf.get()->data();
+                for (uint64_t i = 0; i < PAX_MIN((uint64_t)8, _numSequential); ++i) {
+                    std::stringstream ss;
+                    for (uint64_t j = 0; j < PAX_MIN((uint64_t)8, _numStrided); ++j) {
+                        ss << std::setw(12) << buf[i + j * _numSequential];
                     }
-                    break;
+                    PAX_LOG(3, << ss.str());
                 }
+            }
 
-                case hlType_t::DATALEN:
-                    dataLen = buf.getUint32(skipFlags::SKIP_DELIMIER_AND_LINEFEED);
-                    PAX_LOG(verbosityLevel, << "Read DATALEN = " << dataLen);
-                    ++datalencount;
-                    headerDone = true;
-                    break;
+            _buf = dataBuf;
+            _importedLength = buf.offset();
 
-                case hlType_t::COMMENT:
-                    if (fastImport) {
-                        nextLine = true;
-                    } else {
-                        meta1 = buf.getMeta();
-                        PAX_LOG(verbosityLevel, << "Read comment: " << meta1.second.s);
-                        getMetaRef()[meta1.first] = meta1.second;
-                    }
-                    break;
+            if (PaxStatic::getVerbosity() >= 3) {
+                std::stringstream ss;
+                ss << "Total imported length = " << _importedLength << " bytes.";
+                PAX_LOG(3, << ss.str());
+            }
 
-                case hlType_t::METADATA:
-                    if (fastImport) {
-                        nextLine = true;
-                    } else {
-                        meta1 = buf.getMeta();
-                        PAX_LOG(verbosityLevel, << "Read METADATA of type " << (int)meta1.second.type << " = " << meta1.first << " = " << meta1.second.value().c_str());
-                        getMetaRef()[meta1.first] = meta1.second;
-                    }
-                    break;
-                }
+            return PAX_OK;
+#undef verbosityLevel
 
-                // if finished, we may need to skip one last line
-                if (headerDone) {
+        } // int importBuffer (char* inBuf, size_t length, paxMapPtr map)
 
-                    if (nextLine) {
-                        buf.skipLine();
-                    }
 
-                    break;
-                }
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // TODO: import PAX file from char string
+        //
+        //int import (char * inBuf) {
+        //  return PAX_FAIL;
+        //}
 
-                if (nextLine) {
 
-                    PAX_LOG(verbosityLevel, << "Skipping line in header loop");
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // render the header, encoding the data first, and locate the payload
+        // (see rasterFileBase)
+        //
+        using rasterFileBase::writeHeader;
+        int writeHeader(std::string &out) {
 
-                    buf.skipLine();
-                    uint32_t skipped = 1;
-                    // the "line" may be multiple lines, e.g. a meta array
-                    while ((type = buf.getHeaderLineType()) == HEADERLINETYPE::UNKNOWN) {
-                        if (buf.eof()) break;
-                        buf.skipLine();
-                        ++skipped;
-                    }
+            if (!_buf) {
+                // only a shape: there is no payload to encode
+                return renderHeader(out);
+            }
 
-                    PAX_LOG(verbosityLevel, << "Skipped " << skipped << " line(s) in header loop");
+            std::vector<char> scratch;
+            paxSegment_t payload;
 
-                } else {
-                    type = type = HEADERLINETYPE::NOT_CHECKED;
-                }
+            return writeHeader(out, scratch, payload);
+        }
 
-            } //         while (!buf.eof ()) {
+        int writeHeader(std::string &out, std::vector<char> &scratch, paxSegment_t &payload) {
 
-            // validate required tags
-            if (dim1count != 1 || dim2count != 1 || datalencount != 1) {
-                PAX_LOG_ERROR(1, << "Incorrect PAX tags: dim1count=" << dim1count << ", dim2count=" << dim2count << ", datalencount=" << datalencount << ". This may expected if previewing a long header.");
-                return PAX_INVALID;
+            payload = { NULL, 0 };
+            if (datalen() > 0 && !_buf) {
+                PAX_LOG_ERROR(1, << "writing PAX, but there is no raster data");
+                return PAX_FAIL;
             }
 
-            // validate parameters
-            int32_t _bpv = getBPV(this->_dataType);
-            if (_bpv != bpv) {
-                PAX_LOG_ERROR(1, << "Incorrect bpv. Read " << bpv << " but expected " << _bpv);
-                return PAX_INVALID;
+            // tile and compress as set, before the header records the payload length
+            payload.first = encodeData(buf(), scratch, payload.second);
+            if (NULL == payload.first && payload.second > 0) {
+                return PAX_FAIL;
             }
 
-            int32_t _vpe = getVPE(this->_dataType);
-            if (_vpe != vpe) {
-                PAX_LOG_ERROR(1, << "Incorrect vpe. Read " << vpe << " but expected " << _vpe);
-                return PAX_INVALID;
+            return renderHeader(out);
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // output PAX file to buffer
+        //
+        int writeToBuffer(paxBufPtr &outBuf) {
+
+            std::string header;
+            std::vector<char> scratch;
+            paxSegment_t payload;
+            if (PAX_OK != writeHeader(header, scratch, payload)) {
+                return PAX_FAIL;
             }
 
-            int32_t elemLen = bpv * vpe;
-            int32_t myDataLen = elemLen * _numSequential * _numStrided;
-            if (dataLen != myDataLen) {
-                PAX_LOG_ERROR(1, << "datalength in file incorrect! Calculated: " << myDataLen << ", read from file: " << dataLen);
-                return PAX_INVALID;
+            size_t headerLen = header.length();
+            size_t bufLen = payload.second + headerLen;
+
+            PAX_LOG(1, << "Wrote to buffer: " << headerLen << " header bytes and " << payload.second << " data bytes for a total of " << bufLen << " bytes");
+
+            paxBufPtr buf = std::make_shared<paxBuf_t>(bufLen);
+            memcpy(buf->data(), header.c_str(), headerLen);
+            if (payload.second > 0) {
+                memcpy(buf->data() + headerLen, payload.first, payload.second);
             }
 
-            _numValues = _numSequential * _numStrided;
+            outBuf = buf;
 
             return PAX_OK;
         }
 
+
         //////////////////////////////////////////////////////////////////////////
         //
-        // baseImport: import an PAX from a buffer and return the base class
-        // 
-        template <paxTypes_e E>
-        static std::shared_ptr<rasterFileBase> baseImport(char *buf, size_t len) {
-        // TODO: baseImport watchout, may cause slicing
-            rasterFile<E> *paxFile = new rasterFile<E>();
-            paxFile->import(buf, len);
-            std::shared_ptr<rasterFileBase> baseFile(paxFile);
+        // output to file. The header and the raster are handed to the OS in a
+        // single gather write, so the raster is never copied. A tiled or
+        // compressed raster is rearranged first.
+        //
+        int writeToFile(pax_filestring fileName) {
+            PAX_LOG(1, << "Writing PAX data " << " to " << fileName);
 
-            return baseFile;
+            std::string header;
+            std::vector<char> scratch;
+            paxSegment_t payload;
+            if (PAX_OK != writeHeader(header, scratch, payload)) {
+                return PAX_FAIL;
+            }
+
+            int fd = openForWrite(fileName);
+            if (-1 == fd) {
+                return PAX_FAIL;
+            }
+
+            paxSegment_t segs[2] = { { header.c_str(), header.length() }, payload };
+            int64_t ret = writeSegments(fd, segs, (payload.second > 0) ? 2 : 1);
+            pax_close(fd);
+
+            if (ret != (int64_t)(header.length() + payload.second)) {
+                PAX_LOG_ERROR(1, << "Failure. Wrote " << ret << " bytes but expected " << header.length() + payload.second << ".");
+                return PAX_FAIL;
+            }
+
+            PAX_LOG(1, << "Successfully wrote " << ret << " bytes.");
+
+            return PAX_OK;
         }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // read header to preview PAX file from file
-        // TODO: preview, improve. For long headers, parsing multiple chunks may be slow. Should leave file open.
+        // Basic buffer access
         //
-        int preview(pax_filestring fileName) {
-
-            PAX_LOG(1, << "Previewing PAX file " << fileName);
+        char * buf() {
+            if (!_buf) return NULL;
+            return _buf.get()->data();
+        }
 
-            int nChunk = 0;
-            paxBufPtr fileBuf(new paxBuf_t(0));  // initial header buffer
 
-            while (true) {
-                int ret = PAX_OK;
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // Read elements from the array. Accessors are defined for both X,Y and R,C
+        // indexing styles. The data is always stored column-major (i.e. X/C is the fast dim).
+        //
+        template <typename T>
+        T & value(uint64_t x, uint64_t y = 0) {
+            T * tbuf = (T*)buf();
+            if (NULL == tbuf || x >= _numSequential || y >= _numStrided) return *((T*)_junk);
+            uint64_t index = x + y * _numSequential;
+            return tbuf[index];
+        }
 
-                paxBufPtr chunk = readFileChunk(fileName, nChunk);
-                if (!chunk) {
-                  // error has already been reported
-                    return PAX_FAIL;
-                }
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // N-D element access. Indexes are given sequential first, e.g.
+        // valueAt<float>({ x, y, z }). Out-of-bounds access returns junk.
+        //
+        template <typename T>
+        T & valueAt(std::initializer_list<uint64_t> idx) {
+            T * tbuf = (T*)buf();
+            uint64_t index = 0;
+            if (NULL == tbuf || !elementIndex(idx.begin(), idx.size(), index)) return *((T*)_junk);
+            return tbuf[index];
+        }
 
-                // add chunk to buffer
-                fileBuf->appendVector(*chunk);
+        float    & floatValXY(uint64_t x, uint64_t y = 0) { return value<float>(x, y); };
+        double   & doubleValXY(uint64_t x, uint64_t y = 0) { return value<double>(x, y); };
+        int8_t   & charValXY(uint64_t x, uint64_t y = 0) { return value<int8_t>(x, y); };
+        int16_t  & shortValXY(uint64_t x, uint64_t y = 0) { return value<int16_t>(x, y); };
+        int32_t  & intValXY(uint64_t x, uint64_t y = 0) { return value<int32_t>(x, y); };
+        int64_t  & longValXY(uint64_t x, uint64_t y = 0) { return value<int64_t>(x, y); };
+        uint8_t  & ucharValXY(uint64_t x, uint64_t y = 0) { return value<uint8_t>(x, y); };
+        uint16_t & ushortValXY(uint64_t x, uint64_t y = 0) { return value<uint16_t>(x, y); };
+        uint32_t & uintValXY(uint64_t x, uint64_t y = 0) { return value<uint32_t>(x, y); };
+        uint64_t & ulongValXY(uint64_t x, uint64_t y = 0) { return value<uint64_t>(x, y); };
+        paxHalf_t & halfValXY(uint64_t x, uint64_t y = 0) { return value<paxHalf_t>(x, y); };
+        csingle  & csingleValXY(uint64_t x, uint64_t y = 0) { return value<csingle>(x, y); };
+        cdouble  & cdoubleValXY(uint64_t x, uint64_t y = 0) { return value<cdouble>(x, y); };
+        pax_float3_t & cfloat3ValXY(uint64_t x, uint64_t y = 0) { return value<pax_float3_t>(x, y); };
 
-                //// cache this chunk
-                //memcpy (fileBuf->data () + (nChunk * CHUNK_LEN), chunk->data(), chunk->size());
+        float    & floatValRC(uint64_t r, uint64_t c = 0) { return value<float>(c, r); };
+        double   & doubleValRC(uint64_t r, uint64_t c = 0) { return value<double>(c, r); };
+        int8_t   & charValRC(uint64_t r, uint64_t c = 0) { return value<int8_t>(c, r); };
+        int16_t  & shortValRC(uint64_t r, uint64_t c = 0) { return value<int16_t>(c, r); };
+        int32_t  & intValRC(uint64_t r, uint64_t c = 0) { return value<int32_t>(c, r); };
+        int64_t  & longValRC(uint64_t r, uint64_t c = 0) { return value<int64_t>(c, r); };
+        uint8_t  & ucharValRC(uint64_t r, uint64_t c = 0) { return value<uint8_t>(c, r); };
+        uint16_t & ushortValRC(uint64_t r, uint64_t c = 0) { return value<uint16_t>(c, r); };
+        uint32_t & uintValRC(uint64_t r, uint64_t c = 0) { return value<uint32_t>(c, r); };
+        uint64_t & ulongValRC(uint64_t r, uint64_t c = 0) { return value<uint64_t>(c, r); };
+        paxHalf_t & halfValRC(uint64_t r, uint64_t c = 0) { return value<paxHalf_t>(c, r); };
+        csingle  & csingleValRC(uint64_t r, uint64_t c = 0) { return value<csingle>(c, r); };
+        cdouble  & cdoubleValRC(uint64_t r, uint64_t c = 0) { return value<cdouble>(c, r); };
+        pax_float3_t & cfloat3ValRC(uint64_t r, uint64_t c = 0) { return value<pax_float3_t>(c, r); };
 
-                // if buffer is full, make sure buffer ends in \n
-                if (chunk->size() == CHUNK_LEN) {
-                    size_t eolpos = (nChunk + 1) * CHUNK_LEN - 1;
-                    char * buf = fileBuf->data();
-                    while (eolpos != 0 && buf[eolpos] != '\n') --eolpos;
-                    //Swapper<'\n'> end(fileBuf->data () + eolpos);
-                    ret = preview(fileBuf);
-                } else {
-                    ret = preview(fileBuf);
-                }
+        float    & floatValAt(std::initializer_list<uint64_t> idx) { return valueAt<float>(idx); };
+        double   & doubleValAt(std::initializer_list<uint64_t> idx) { return valueAt<double>(idx); };
+        int8_t   & charValAt(std::initializer_list<uint64_t> idx) { return valueAt<int8_t>(idx); };
+        int16_t  & shortValAt(std::initializer_list<uint64_t> idx) { return valueAt<int16_t>(idx); };
+        int32_t  & intValAt(std::initializer_list<uint64_t> idx) { return valueAt<int32_t>(idx); };
+        int64_t  & longValAt(std::initializer_list<uint64_t> idx) { return valueAt<int64_t>(idx); };
+        uint8_t  & ucharValAt(std::initializer_list<uint64_t> idx) { return valueAt<uint8_t>(idx); };
+        uint16_t & ushortValAt(std::initializer_list<uint64_t> idx) { return valueAt<uint16_t>(idx); };
+        uint32_t & uintValAt(std::initializer_list<uint64_t> idx) { return valueAt<uint32_t>(idx); };
+        uint64_t & ulongValAt(std::initializer_list<uint64_t> idx) { return valueAt<uint64_t>(idx); };
+        paxHalf_t & halfValAt(std::initializer_list<uint64_t> idx) { return valueAt<paxHalf_t>(idx); };
+        csingle  & csingleValAt(std::initializer_list<uint64_t> idx) { return valueAt<csingle>(idx); };
+        cdouble  & cdoubleValAt(std::initializer_list<uint64_t> idx) { return valueAt<cdouble>(idx); };
+        pax_float3_t & cfloat3ValAt(std::initializer_list<uint64_t> idx) { return valueAt<pax_float3_t>(idx); };
 
-                if (PAX_FAIL == ret) {
-                    PaxStatic::setStatus(PAX_FAIL);
-                    return PAX_FAIL;
-                }
 
-                if (PAX_OK == ret) break; // success!
+        //int import (
+        //  uint32_t      numSequential,
+        //  uint32_t      numStrided,
+        //  paxBufPtr     buf,
+        //  paxMetaDataPtr meta
+        //) {
+        //  _numSequential = numSequential;
+        //  _numStrided = numStrided;
+        //  return 0;
+        //};
 
-                // try again with more data
-                ++nChunk;
-            }
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        //
+        // private functions
+        //
 
-            return PAX_OK;
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // premature end of file error
+        //
+        void reportEOF() {
+            PAX_LOG_ERROR(1, << "premature end to PAX file found");
         }
 
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // Read (partial) header to preview PAX file from buffer
-        // Return PAX_OK upon success, PAX_FAIL upon failure, or the length that
-        // was successfully imported if not all the header was imported.
+        // data operator access does not work because we can't infer the type at runtime
+        //
+        //E operator[](size_t idx) {
+        //  size_t x = idx % _numSequential;
+        //  size_t y = idx / _numSequential;
+        //  E val = value<E> (x, y);
+        //  return E;
+        //}
+        //E operator[](size_t x, size_t y) {
+        //  E val = value<E> (x, y);
+        //  return E;
+        //}
+        //E operator()(size_t r, size_t c) {
+        //  E val = value<E> (c, r);
+        //  return E;
+        //}
+
+
+        //////////////////////////////////////////////////////////////////////////
         //
-        // TODO: PAX fast preview (don't process metadata)
+        // metadata operator access
         //
-        int preview(paxBufPtr inBuf) {
+        double operator[](std::string key) {
+            return getMetaDouble(key);
+        }
+        std::string operator()(std::string key) {
+            return getMetaString(key);
+        }
 
-            PAX_LOG(1, << "Previewing PAX file in buffer of length " << inBuf->size());
 
-            BufMan buf(inBuf->data(), inBuf->size());
+      //////////////////////////////////////////////////////////////////////////
+      // internal functions
+    protected:
 
-            // make sure buf ends at the end of a line
-            uint64_t eolpos = inBuf->size() - 1;
-            while (eolpos != 0 && buf[eolpos] != '\n') --eolpos;
-            buf.truncate(eolpos);
 
-            int32_t datalen = 0;
-            int ret = importHeader(buf, datalen, true);
+        //////////////////////////////////////////////////////////////////////////
+        //
+        // mapHeader: map a PAX file and import its header. Returns the raster
+        // data laid out as in the file, tiled or not, or NULL on failure. They
+        // lie within the mapping, or in scratch if they had to be decompressed.
+        //
+        const char * mapHeader(PaxMap & map, pax_filestring fileName, std::vector<char> & scratch) {
+
+            if (PAX_OK != map.map(fileName)) {
+              // error has already been reported
+                return NULL;
+            }
 
-            if (ret == PAX_INVALID) {
-                return (int)buf.offset();
+            if (map.size() < MIN_PAX_LENGTH) {
+                PAX_LOG_ERROR(1, << ("PAX file too short"));
+                return NULL;
             }
 
-            return ret;
-        }
+            if (_numValues != 0 || _numSequential != 0 || _numStrided != 0 || _buf != nullptr || _meta != nullptr) {
+                reset();
+            }
 
+            BufMan buf(map.data(), map.size());
+            uint64_t dataLen = 0;
+            if (PAX_OK != importHeader(buf, dataLen)) {
+                return NULL;
+            }
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // importMultiple: extract multiple PAX files from a single buffer.
-        // 
-        // This is to facilitate DDS and simplify the topics that contain a variable number of rasters.
-        // Note that this is NOT a valid operation for files (ofc we may change that some day).
-        // Note that all types must be known apriori!
-        //
-        static std::vector<std::shared_ptr<rasterFileBase>> importMultiple(size_t bufCount, paxBufPtr bufPtr)
-        {
-            std::vector<std::shared_ptr<rasterFileBase>> bufVec(bufCount);
-            char *buf = bufPtr.get()->data();
-            size_t bufLeft = bufPtr->size();
+            char * data = buf.viewData(dataLen);
+            countMetaLocs();
+            _importedLength = buf.offset();
 
-            for (size_t bufnum = 0; bufnum < bufCount; ++bufnum) {
-              // TODO: import using inheritance
+            // a compressed payload is read whole anyway, so it is verified whole
+            if (NULL == data || (isCompressed() && PAX_OK != verifyPayload(data, dataLen))) {
+                return NULL;
             }
 
-            return bufVec;
-        }
+            return decompressData(data, dataLen, scratch);
 
-        static std::vector<std::shared_ptr<rasterFileBase>> importMultiple(std::vector<paxTypes_e> types, paxBufPtr bufPtr)
-        {
-            size_t bufCount = types.size();
-            std::vector<std::shared_ptr<rasterFileBase>> bufVec(bufCount);
-            char *buf = bufPtr.get()->data();
-            size_t bufLeft = bufPtr->size();
+        } // const char * mapHeader(PaxMap & map, pax_filestring fileName, std::vector<char> & scratch)
 
-            for (size_t bufnum = 0; bufnum < bufCount; ++bufnum) {
-                std::shared_ptr<rasterFileBase> baseFile;
 
-                switch (types[bufnum]) {
+      //////////////////////////////////////////////////////////////////////////
+      // internal data
+    protected:
+        paxBufPtr           _buf;
+        uint8_t             _junk[32];  // garbage data for accessors that have to return references
+    };  // template <paxTypes_e E> class rasterFile
 
-#define X(name,val,bpv,vpe) case paxTypes::ePAX_ ## name : baseFile = baseImport<paxTypes::ePAX_ ## name> (buf, bufLeft); break;
-                    PAX_TYPE_DATA
-#undef X
+///@}
 
-                } // switch (types[bufnum])
 
-                bufVec[bufnum] = baseFile;
-                buf += baseFile->importedLength();
-                bufLeft -= baseFile->importedLength();
-            }
+/************************************************************************************************************
+ * @class PaxWriter
+ * Streaming PAX file writer. The header is written first and the raster is then appended straight from
+ * the caller's buffers as it is produced, whole, row by row, or tile by tile. The full file is never
+ * held in memory. Metadata can be added through header() until the first data are written.
+ * @tparam E PAX type of the raster
+ ***********************************************************************************************************/
+    template <paxTypes_e E>
+    class PaxWriter {
 
-            return bufVec;
+    public:
+/************************************************************************************************************
+ * Default ctor. Call open() before writing.
+ ***********************************************************************************************************/
+        PaxWriter() : _fd(-1), _headerLen(0), _dataLen(0), _appended(0), _failed(false) { }
+
+/************************************************************************************************************
+ * Ctor that opens the output file.
+ * @param[in]       fileName    Output file
+ * @param[in]       sequential  Number of elements in the sequential dimension
+ * @param[in]       strided     Number of elements in the strided dimension
+ ***********************************************************************************************************/
+        PaxWriter(pax_filestring fileName, uint64_t sequential, uint64_t strided = 1) : PaxWriter() {
+            open(fileName, sequential, strided);
         }
 
+/************************************************************************************************************
+ * Dtor. Closes the file if it is still open.
+ ***********************************************************************************************************/
+        ~PaxWriter() { close(); }
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // writeMultiple: writes multiple PAX files to a single buffer.
-        // 
-        // This is to facilitate DDS and simplify the topics that contain a variable number of rasters.
-        // Note that this is NOT a valid operation for files (ofc we may change that some day).
-        // Note that all types must be known apriori!
-        //    
-        static paxBufPtr writeMultiple(std::vector<rasterFileBase*> paxVec) {
-            size_t bufCount = paxVec.size();
-            std::vector<paxBufPtr> bufVec;
-            size_t bufSize = 0;
+        PaxWriter(const PaxWriter&) = delete;
+        PaxWriter& operator = (const PaxWriter&) = delete;
 
-            PAX_LOG(1, << "Writing " << bufCount << " pax files to a buffer.");
+/************************************************************************************************************
+ * Opens the output file and sets the raster dimensions. Nothing is written until data arrive.
+ * @param[in]       fileName    Output file
+ * @param[in]       sequential  Number of elements in the sequential dimension
+ * @param[in]       strided     Number of elements in the strided dimension
+ * @return                      PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int open(pax_filestring fileName, uint64_t sequential, uint64_t strided = 1) {
 
-            for (auto paxBuf : paxVec) {
-                paxBufPtr bufPtr = nullptr;
-                paxBuf->writeToBuffer(bufPtr);
-                bufVec.push_back(bufPtr);
-                bufSize += bufPtr->size();
-            }
+            return open(fileName, std::vector<uint64_t>{ sequential, strided });
 
-            paxBufPtr bufPtr = std::make_shared<paxBuf_t>(bufSize);
-            size_t bufPos = 0;
-            for (auto buf : bufVec) {
-                memcpy(bufPtr->data() + bufPos, buf->data(), buf->size());
-                bufPos += buf->size();
-            }
+        } // int open(pax_filestring fileName, uint64_t sequential, uint64_t strided = 1)
 
-            PAX_LOG(1, << "Wrote a total of " << bufPos << " bytes to the buffer.");
+/************************************************************************************************************
+ * Opens the output file for an N-D raster. Rows then span all dimensions above the sequential one.
+ * @param[in]       fileName    Output file
+ * @param[in]       dims        Number of elements in each dimension, sequential first
+ * @return                      PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int open(pax_filestring fileName, const std::vector<uint64_t> &dims) {
 
-            return bufPtr;
-        }
+            close();
 
-        static paxBufPtr writeMultiple(std::vector<std::shared_ptr<rasterFileBase>> paxVec)
-        {
-            std::vector<rasterFileBase *> paxVecp;
+            _hdr.initShape(dims);
+            _dataLen = _hdr.getFileDataLength();
+            _headerLen = _appended = 0;
+            _ranges.clear();
+            _failed = false;
 
-            for (auto ppax : paxVec) {
-                paxVecp.push_back(ppax.get());
+            _fd = rasterFileBase::openForWrite(fileName);
+            if (-1 == _fd) {
+                return PAX_FAIL;
             }
 
-            paxBufPtr bufPtr = writeMultiple(paxVecp);
-
-            return bufPtr;
-        } // static std::vector<std::shared_ptr<rasterFileBase>> importMultiple
-
+            PAX_LOG(1, << "Streaming " << _dataLen << " bytes of PAX data to " << fileName);
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // helper function to make sure meta exists
-        //
-        std::unordered_map<std::string, pax::meta_t> & getMetaRef() {
-            if (nullptr == _meta) _meta = std::shared_ptr <std::unordered_map<std::string, pax::meta_t>>(new std::unordered_map<std::string, pax::meta_t>());
-            return *_meta;
-        }
+            return PAX_OK;
 
+        } // int open(pax_filestring fileName, const std::vector<uint64_t> &dims)
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // helper function to organize and sort metadata
-        //
-        std::shared_ptr<std::vector<std::vector<std::pair<std::string, meta_t>>>>
-            getMetaVecs() {
+/************************************************************************************************************
+ * Header access. Metadata added after the first write are not written.
+ * @return          Reference to the raster describing the header
+ ***********************************************************************************************************/
+        rasterFile<E> & header() { return _hdr; }
 
-            std::shared_ptr<std::vector<std::vector<std::pair<std::string, meta_t>>>> metavecs(new std::vector<std::vector<std::pair<std::string, meta_t>>>(LOC_COUNT));
-            if (nullptr == _meta) return metavecs;
+/************************************************************************************************************
+ * Stores the raster in tiles (see rasterFileBase::setTiling). Call after open() and before any data are
+ * written. Data given to write() are then taken in file order, tile after tile.
+ * @param[in]       tileWidth   Elements per tile row
+ * @param[in]       tileHeight  Rows per tile
+ * @return                      PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int setTiling(uint64_t tileWidth, uint64_t tileHeight) {
 
-            for (auto meta : getMetaRef()) {
-                size_t loc = meta.second.loc;
-                auto &vec = metavecs->at(loc);
-                vec.push_back(meta);
+            if (headerWritten() || -1 == _fd) {
+                PAX_LOG_ERROR(1, << "PAX stream tiling must be set after open and before writing");
+                return PAX_FAIL;
             }
 
-            for (int i = 0; i < LOC_COUNT; ++i) {
-                std::vector<std::pair<std::string, meta_t>> &vec = metavecs->at(i);
-                std::sort(vec.begin(), vec.end(), [](const std::pair<std::string, meta_t>& lhs, const std::pair<std::string, meta_t>& rhs) { return lhs.second.index < rhs.second.index; });
-                PAX_LOG(3, << "done sorting metaLoc " << i);
+            if (PAX_OK != _hdr.setTiling(tileWidth, tileHeight)) {
+                return PAX_FAIL;
             }
+            _dataLen = _hdr.getFileDataLength();
 
-            return metavecs;
-        }
+            return PAX_OK;
 
-        static void copyMeta(rasterFileBase & dest, rasterFileBase & src) {
-          // allocate a new destination meta map to release the old one
-            dest._meta = std::shared_ptr <std::unordered_map<std::string, pax::meta_t>>(new std::unordered_map<std::string, pax::meta_t>());
-            PAX_LOG(2, << "copying " << src._meta->size() << " meta elements.");
-            for (auto meta : *(src._meta)) {
-                dest._meta->insert(meta);
+        } // int setTiling(uint64_t tileWidth, uint64_t tileHeight)
+
+/************************************************************************************************************
+ * Appends raster data. The first call writes the header in the same gather write.
+ * @param[in]       data        Raster bytes
+ * @param[in]       len         Number of bytes
+ * @return                      PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int write(const void * data, uint64_t len) {
+
+            if (_appended + len > _dataLen) {
+                PAX_LOG_ERROR(1, << "writing " << len << " bytes would overrun the raster. " << _dataLen - _appended << " bytes remain.");
+                return PAX_FAIL;
             }
-            PAX_LOG(2, << "Done copying meta. " << dest._meta->size() << " meta elements were copied.");
-        }
 
-    protected:
-        paxTypes_e          _dataType;
-        float               _version;
-        size_t              _importedLength;
-        uint32_t            _numValues;
-        uint32_t            _numSequential;
-        uint32_t            _numStrided;
-        paxMetaDataPtr      _meta;
-        metaLoc_e      _metaLoc;
-        size_t              _metaLocCount[metaLoc_e::LOC_COUNT];
-    };  //   class rasterFileBase
+            paxSegment_t segs[2];
+            size_t count = 0;
+            uint64_t offset = _headerLen + _appended;
+            std::string header;
+            if (!headerWritten()) {
+                header = headerString();
+                segs[count++] = { header.c_str(), header.length() };
+                offset = 0;
+            }
+            segs[count++] = { static_cast<const char*>(data), len };
 
+            if (PAX_OK != claim(_appended, len) || PAX_OK != writeAt(offset, segs, count)) {
+                return PAX_FAIL;
+            }
+            _appended += len;
 
-    template <paxTypes_e E>
-    class rasterFile : public rasterFileBase
-    {
-      // CXXTest Classes
-        friend class TestRead;
-        friend class TestWrite;
-        friend class NewTestRead;
-        friend class NewTestWrite;
+            return PAX_OK;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // ctors/dtors
-        //    
-    public:
+        } // int write(const void * data, uint64_t len)
 
-        rasterFile() : rasterFileBase(E) { reset(); }
-        rasterFile(int32_t sequential, void *buf) : rasterFileBase(E) { init((uint32_t)sequential, 1, buf); }
-        rasterFile(uint32_t sequential, void *buf) : rasterFileBase(E) { init((uint32_t)sequential, 1, buf); }
-        rasterFile(uint64_t sequential, void *buf) : rasterFileBase(E) { init((uint32_t)sequential, 1, buf); }
-        rasterFile(int32_t sequential, int32_t strided = 1) : rasterFileBase(E) { init((uint32_t)sequential, (uint32_t)strided); }
-        rasterFile(uint32_t sequential, uint32_t strided = 1) : rasterFileBase(E) { init(sequential, strided); }
-        rasterFile(uint64_t sequential, uint32_t strided = 1) : rasterFileBase(E) { init(sequential, strided); }
-        rasterFile(int32_t sequential, int32_t strided, void *buf) : rasterFileBase(E) { init((uint32_t)sequential, (uint32_t)strided, buf); }
-        rasterFile(uint32_t sequential, uint32_t strided, void *buf) : rasterFileBase(E) { init(sequential, strided, buf); }
-        rasterFile(uint64_t sequential, uint32_t strided, void *buf) : rasterFileBase(E) { init(sequential, strided, buf); }
+/************************************************************************************************************
+ * Appends whole rows (runs of sequential elements).
+ * @param[in]       data        Raster rows
+ * @param[in]       rows        Number of rows
+ * @return                      PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int writeRows(const void * data, uint64_t rows) {
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // public functions
-        //
-    public:
+            return write(data, rowBytes() * rows);
 
+        } // int writeRows(const void * data, uint64_t rows)
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Reset the PAX object
-        //
-        void reset() {
-            _numValues = 0;
-            _numSequential = 0;
-            _numStrided = 0;
-            _buf = nullptr;
-            _meta = nullptr;
-            _metaLoc = LOC_END;
-            memset(_metaLocCount, 0, metaLoc_e::LOC_COUNT * sizeof(size_t));
-        }
+/************************************************************************************************************
+ * Writes a rectangular tile at its final position in the file. Tiles may arrive in any order but must
+ * not overlap each other or data written with write(). In a tiled file the tile must be one tile of the
+ * grid: aligned to it and full size, or trimmed to the raster at the edges. It is written as one
+ * contiguous block, padded if trimmed.
+ * @param[in]       data        Tile data, row-major with w elements per row
+ * @param[in]       x0          Sequential index of the first element of the tile
+ * @param[in]       y0          Row index of the first element of the tile
+ * @param[in]       w           Tile width in elements
+ * @param[in]       h           Tile height in elements
+ * @return                      PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int writeTile(const void * data, uint64_t x0, uint64_t y0, uint64_t w, uint64_t h) {
 
+            if (x0 + w > _hdr.getNumSequential() || y0 + h > _hdr.getNumRows()) {
+                PAX_LOG_ERROR(1, << "tile at (" << x0 << ", " << y0 << ") of size " << w << "x" << h << " is outside the raster");
+                return PAX_FAIL;
+            }
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // 2D/1D Initializer
-        //
-        int init(uint32_t sequential, uint32_t strided = 1, void * buf = NULL) {
+            if (!headerWritten()) {
+                std::string header = headerString();
+                paxSegment_t seg{ header.c_str(), header.length() };
+                if (PAX_OK != writeAt(0, &seg, 1)) {
+                    return PAX_FAIL;
+                }
+            }
 
-            int32_t bpv = getBPV(E);
-            int32_t vpe = getVPE(E);
+            uint64_t elemBytes = (uint64_t)_hdr.bpv() * _hdr.vpe();
+            uint64_t tileRowBytes = elemBytes * w;
+            const char * src = static_cast<const char*>(data);
 
-            if (/*0 == sequential || 0 == strided ||*/ 0 == bpv || 0 == vpe) {
+            if (_hdr.isTiled()) {
+                return writeGridTile(src, x0, y0, w, h);
+            }
 
-                std::runtime_error e("PAX init: invalid dimension or PAX type");
-                throw (e);
+            if (w == _hdr.getNumSequential()) {
+                // full-width tiles are contiguous in the file
+                paxSegment_t seg{ src, tileRowBytes * h };
+                if (PAX_OK != claim(rowBytes() * y0, seg.second)) {
+                    return PAX_FAIL;
+                }
+                return writeAt(_headerLen + rowBytes() * y0, &seg, 1);
+            }
 
+            for (uint64_t y = 0; y < h; ++y) {
+                paxSegment_t seg{ src + y * tileRowBytes, tileRowBytes };
+                const uint64_t offset = rowBytes() * (y0 + y) + elemBytes * x0;
+                if (PAX_OK != claim(offset, tileRowBytes) || PAX_OK != writeAt(_headerLen + offset, &seg, 1)) {
+                    return PAX_FAIL;
+                }
             }
 
-            _numValues = sequential * strided;
-            _numSequential = sequential;
-            _numStrided = strided;
+            return PAX_OK;
 
-            if (0 == _numSequential || 0 == _numStrided) {
+        } // int writeTile(const void * data, uint64_t x0, uint64_t y0, uint64_t w, uint64_t h)
 
-                _numSequential = _numStrided = 0;
-                _buf = nullptr;
+/************************************************************************************************************
+ * Finishes the file. Fails if any raster data the header promises were not written, or if a write failed
+ * or overlapped earlier data.
+ * @return          PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int close() {
 
+            if (-1 == _fd) {
+                return PAX_OK;
             }
 
-            if (_numValues > 0) {
-
-                _buf = std::make_shared<paxBuf_t>(_numValues * bpv * vpe);
+            int ret = PAX_OK;
+            if (!headerWritten()) {
+                std::string header = headerString();
+                paxSegment_t seg{ header.c_str(), header.length() };
+                ret = writeAt(0, &seg, 1);
+            }
 
-                if (buf != NULL) {
-                    size_t bytes = getBPV(E) * getVPE(E) * _numValues;
-                    memcpy(_buf->data(), buf, bytes);
-                }
+            pax_close(_fd);
+            _fd = -1;
 
+            const bool complete = (0 == _dataLen) || (1 == _ranges.size() && 0 == _ranges.begin()->first && _dataLen == _ranges.begin()->second);
+            if (PAX_OK == ret && (_failed || !complete)) {
+                uint64_t written = 0;
+                for (auto & range : _ranges) written += range.second - range.first;
+                PAX_LOG_ERROR(1, << "closing PAX stream after " << written << " of " << _dataLen << " data bytes in " << _ranges.size() << " ranges" << (_failed ? ", after a failed write" : ""));
+                ret = PAX_FAIL;
             }
 
-            _meta = nullptr;
-            _metaLoc = LOC_END;
-            memset(_metaLocCount, 0, metaLoc_e::LOC_COUNT * sizeof(size_t));
+            return ret;
 
-            return PAX_OK;
+        } // int close()
 
-        } // int init (uint32_t sequential, uint32_t strided = 1, void * buf = NULL) 
+    protected:
+/************************************************************************************************************
+ * Renders the header and fixes the data offset. Streamed data are never compressed, and have no
+ * checksum, as the header is written before them.
+ * @return          The header text
+ ***********************************************************************************************************/
+        std::string headerString() {
 
+            if (_hdr.isCompressed()) {
+                PAX_LOG(1, << "PAX streams are written uncompressed");
+                _hdr.setCompression(CODEC_NONE);
+            }
+            if (_hdr.hasChecksum()) {
+                PAX_LOG(1, << "PAX streams are written without checksums");
+                _hdr.setChecksum(false);
+            }
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // 1D initializer
-        //
-        int init(uint32_t sequential, void * buf) {
-            return init(sequential, 1, buf);
-        }
+            std::string header;
+            _hdr.renderHeader(header);
+            _headerLen = header.length();
 
+            return header;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Adds/replaces the given meta object at the (optional) specified location.
-        //
-        // PAX keeps things simple by not allowing insertions. If you add a meta
-        // having the same name as one in a different location, the old one gets
-        // automatically whacked. The count for that location then becomes inaccurate,
-        // but that's ok because it is only used for labeling comments and sorting.
-        // It is not possible for the order to get screwed up. Neat, huh! It would be
-        // a pain to do an insert now. You have to remove all meta from that location
-        // after the insert point, add the new one, then re-add the others using
-        // addComment and addMetaVal to keep the indexes straight. That's ok for now.
-        //
-        int addMeta(std::string name, meta_t meta, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+        } // std::string headerString()
 
-            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+/************************************************************************************************************
+ * Writes segments at the given file offset.
+ ***********************************************************************************************************/
+        int writeAt(uint64_t offset, const paxSegment_t * segs, size_t count) {
 
-            meta.loc = loc;
-            meta.index = _metaLocCount[loc]++;
-            if (paxMetaDataTypes_e::paxComment == meta.type) {
-                meta.commentName();
+            if (-1 == _fd) {
+                PAX_LOG_ERROR(1, << "PAX stream is not open");
+                return PAX_FAIL;
             }
 
-            getMetaRef()[name] = meta;
+            uint64_t len = 0;
+            for (size_t i = 0; i < count; ++i) len += segs[i].second;
 
-            _metaLoc = loc;
+            int64_t ret = rasterFileBase::writeSegmentsAt(_fd, offset, segs, count);
+            if (ret != (int64_t)len) {
+                PAX_LOG_ERROR(1, << "PAX stream wrote " << ret << " of " << len << " bytes");
+                _failed = true;
+                return PAX_FAIL;
+            }
 
-            return PaxStatic::getStatus();
+            return PAX_OK;
 
-        } // int addMeta (std::string name, meta_t meta, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
-        int addMeta(metaLoc_e loc, std::string name, meta_t meta) {
-            return addMeta(name, meta, loc);
-        }
+        } // int writeAt(uint64_t offset, const paxSegment_t * segs, size_t count)
 
+/************************************************************************************************************
+ * Records raster bytes [start, start + len) as written, merging adjacent ranges. Fails, and fails close(),
+ * if any of them were written before.
+ ***********************************************************************************************************/
+        int claim(uint64_t start, uint64_t len) {
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Adds the given comment meta at the (optional) specified location
-        //
-        int addComment(meta_t meta, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
-            return addMeta("", meta, loc);
-        }
-        int addComment(metaLoc_e loc, meta_t meta) {
-            return addMeta("", meta, loc);
-        }
+            if (0 == len) {
+                return PAX_OK;
+            }
 
+            uint64_t end = start + len;
+            auto next = _ranges.upper_bound(start);
+            auto prev = (next == _ranges.begin()) ? _ranges.end() : std::prev(next);
+            if ((next != _ranges.end() && next->first < end) || (prev != _ranges.end() && prev->second > start)) {
+                PAX_LOG_ERROR(1, << "PAX stream data bytes " << start << " to " << end << " overlap data already written");
+                _failed = true;
+                return PAX_FAIL;
+            }
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Adds a comment at the (optional) specified location
-        //
-        int addComment(std::string comment, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+            if (next != _ranges.end() && next->first == end) {
+                end = next->second;
+                _ranges.erase(next);
+            }
+            if (prev != _ranges.end() && prev->second == start) {
+                prev->second = end;
+            } else {
+                _ranges[start] = end;
+            }
 
-            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+            return PAX_OK;
 
-            meta_t meta;
-            meta.loc = loc;
-            meta.index = _metaLocCount[loc]++;
+        } // int claim(uint64_t start, uint64_t len)
 
-            std::string name = meta.commentName();
-            meta.s[0] = '\0';
-            strncat(meta.s, comment.c_str(), PAX_MAX_METADATA_STRING_LENGTH - 1);
-            meta.type = paxMetaDataTypes_e::paxComment;
-            meta.stripped = strlen(meta.s) > 0;  // eliminates hanging space for null comments
+/************************************************************************************************************
+ * Writes one tile of a tiled file at its offset, padding a trimmed edge tile to full size.
+ ***********************************************************************************************************/
+        int writeGridTile(const char * src, uint64_t x0, uint64_t y0, uint64_t w, uint64_t h) {
 
-            getMetaRef()[name] = meta;
+            const uint64_t tw = _hdr.getTileWidth();
+            const uint64_t th = _hdr.getTileHeight();
+            if (x0 % tw || y0 % th || w != PAX_MIN(tw, _hdr.getNumSequential() - x0) || h != PAX_MIN(th, _hdr.getNumRows() - y0)) {
+                PAX_LOG_ERROR(1, << "tile at (" << x0 << ", " << y0 << ") of size " << w << "x" << h << " is not a tile of the " << tw << "x" << th << " grid");
+                return PAX_FAIL;
+            }
 
-            _metaLoc = loc;
+            const uint64_t elemBytes = (uint64_t)_hdr.bpv() * _hdr.vpe();
+            std::vector<char> padded;
+            if (w != tw || h != th) {
+                padded.resize(tw * th * elemBytes);
+                for (uint64_t y = 0; y < h; ++y) {
+                    memcpy(padded.data() + y * tw * elemBytes, src + y * w * elemBytes, w * elemBytes);
+                }
+                src = padded.data();
+            }
 
-            return PAX_OK;
-        } // int addComment (std::string comment, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) 
-        int addComment(metaLoc_e loc, std::string comment) {
-            return addComment(comment, loc);
-        }
+            paxSegment_t seg{ src, tw * th * elemBytes };
+            if (PAX_OK != claim(_hdr.getTiledOffset(x0, y0), seg.second)) {
+                return PAX_FAIL;
+            }
+            return writeAt(_headerLen + _hdr.getTiledOffset(x0, y0), &seg, 1);
 
+        } // int writeGridTile(const char * src, uint64_t x0, uint64_t y0, uint64_t w, uint64_t h)
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Adds/replaces string metadata at the (optional) specified location
-        //
-        int addMetaVal(std::string name, std::string data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+        bool headerWritten() { return _headerLen != 0; }
+        uint64_t rowBytes() { return (uint64_t)_hdr.bpv() * _hdr.vpe() * _hdr.getNumSequential(); }
 
-            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+        rasterFile<E>   _hdr;           ///< Describes the raster; holds metadata but no data
+        int             _fd;            ///< Output file
+        uint64_t        _headerLen;     ///< Length of the written header (0 until written)
+        uint64_t        _dataLen;       ///< Total raster bytes promised by the header
+        uint64_t        _appended;      ///< Raster bytes written sequentially by write()
+        std::map<uint64_t, uint64_t> _ranges;  ///< Raster bytes written, as disjoint [start, end) ranges by start
+        bool            _failed;        ///< A write failed or overlapped earlier data
 
-            // TODO add meta ctor(s) to reduce line count
-            meta_t meta;
-            meta.loc = loc;
-            meta.index = _metaLocCount[loc]++;
-            meta.name = name;
-            meta.s[0] = '\0';
-            strncat(meta.s, data.c_str(), PAX_MAX_METADATA_STRING_LENGTH - 1);
-            meta.type = paxMetaDataTypes_e::paxString;
-            meta.stripped = true;
+    }; // class PaxWriter
 
-            getMetaRef()[name] = meta;
 
-            _metaLoc = loc;
+/************************************************************************************************************
+ * @struct paxBundleEntry_t
+ * Table of contents entry for one raster in a PAX bundle
+ ***********************************************************************************************************/
+    struct paxBundleEntry_t {
+        uint64_t                offset;         ///< Offset of the raster's PAX tag from the start of the bundle
+        uint64_t                length;         ///< Length of the raster, header and data
+        uint64_t                headerLength;   ///< Length of the header; the data follow it
+        paxTypes_e              type;           ///< PAX type of the raster
+        std::vector<uint64_t>   dims;           ///< Length of each dimension, sequential first
+    };
 
-            return PAX_OK;
+/************************************************************************************************************
+ * @struct paxRendered_t
+ * A raster ready to be written: its header, and its payload in place or in scratch.
+ ***********************************************************************************************************/
+    struct paxRendered_t {
+        std::string             header;         ///< Header text
+        std::vector<char>       scratch;        ///< Storage for a tiled or compressed payload
+        paxSegment_t            payload;        ///< Data following the header
+    };
 
-        } // int addMetaVal (std::string name, std::string data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) 
-        int addMetaVal(metaLoc_e loc, std::string name, std::string data) {
-            return addMetaVal(name, data, loc);
-        }
 
+/************************************************************************************************************
+ * @class PaxBundle
+ * Several rasters in one file, followed by a table of contents. A reader can go straight to any raster, or
+ * load any subset of them in parallel, without parsing the ones before it. The rasters are stored back to
+ * back exactly as writeMultiple() stores them, so importMultiple() still reads a bundle. The table of
+ * contents follows the last raster:
+ *
+ *     PAX_BUNDLE : <count>
+ *     <offset> <length> <header length> <type> <number of dims> <dim> ...     (one line per raster)
+ *     PAX_BUNDLE_INDEX : <offset of the PAX_BUNDLE line, 20 digits>
+ *
+ * The trailer has a fixed length, so the table is found from the end of the file.
+ ***********************************************************************************************************/
+    class PaxBundle {
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Adds/replaces float metadata at the (optional) specified location
-        //
-        int addMetaVal(std::string name, float data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+        friend class PaxBatchWriter;
 
-            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+    public:
+/************************************************************************************************************
+ * Default ctor. Call open() before reading.
+ ***********************************************************************************************************/
+        PaxBundle() { }
 
-            meta_t meta;
-            meta.loc = loc;
-            meta.index = _metaLocCount[loc]++;
-            meta.name = name;
-            meta.f = data;
-            meta.type = paxMetaDataTypes_e::paxFloat;
+/************************************************************************************************************
+ * Writes rasters as a bundle to a buffer.
+ * @param[in]       rasters Rasters to write, in order
+ * @param[out]      outBuf  Buffer holding the bundle
+ * @return          PAX_OK upon success
+ ***********************************************************************************************************/
+        static int write(const std::vector<rasterFileBase*> & rasters, paxBufPtr & outBuf) {
 
-            getMetaRef()[name] = meta;
+            std::vector<paxRendered_t> rendered;
+            std::string index;
+            if (PAX_OK != render(rasters, rendered, index)) {
+                return PAX_FAIL;
+            }
 
-            _metaLoc = loc;
+            uint64_t len = index.length();
+            for (auto & r : rendered) len += r.header.length() + r.payload.second;
+
+            outBuf = std::make_shared<paxBuf_t>(len);
+            char * pos = outBuf->data();
+            for (auto & r : rendered) {
+                memcpy(pos, r.header.c_str(), r.header.length());
+                pos += r.header.length();
+                if (r.payload.second > 0) {
+                    memcpy(pos, r.payload.first, r.payload.second);
+                    pos += r.payload.second;
+                }
+            }
+            memcpy(pos, index.c_str(), index.length());
 
             return PAX_OK;
 
-        } // int addMetaVal (std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
-        int addMetaVal(metaLoc_e loc, std::string name, float data) {
-            return addMetaVal(name, data, loc);
-        }
+        } // static int write(const std::vector<rasterFileBase*> & rasters, paxBufPtr & outBuf)
 
+/************************************************************************************************************
+ * Writes rasters as a bundle to a file through a PaxBatchWriter. Each raster is gathered straight from its
+ * own buffer.
+ * @param[in]       rasters     Rasters to write, in order
+ * @param[in]       fileName    Output file
+ * @param[in]       backend     How the writes reach the file
+ * @return          PAX_OK upon success
+ ***********************************************************************************************************/
+        static int writeFile(const std::vector<rasterFileBase*> & rasters, const pax_filestring & fileName, paxIoBackend_e backend = IO_AUTO);
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Adds/replaces double metadata at the (optional) specified location
-        //
-        int addMetaVal(std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
+/************************************************************************************************************
+ * Opens a bundle held in memory and reads its table of contents. Loading parses headers in place, so the
+ * buffer is written to (and restored) while a raster is loaded.
+ * @param[in]       buf     Buffer holding the bundle
+ * @return          PAX_OK upon success, PAX_INVALID if the table of contents is malformed
+ ***********************************************************************************************************/
+        int open(paxBufPtr buf) {
 
-            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+            _map = nullptr;
+            _buf = buf;
 
-            meta_t meta;
-            meta.loc = loc;
-            meta.index = _metaLocCount[loc]++;
-            meta.name = name;
-            meta.d = data;
-            meta.type = paxMetaDataTypes_e::paxDouble;
+            return readIndex();
 
-            getMetaRef()[name] = meta;
+        } // int open(paxBufPtr buf)
 
-            _metaLoc = loc;
+/************************************************************************************************************
+ * Opens a bundle file by memory-mapping it and reads its table of contents. Only the pages of the rasters
+ * that are loaded are read from disk.
+ * @param[in]       fileName    Bundle file
+ * @return          PAX_OK upon success, PAX_INVALID if the table of contents is malformed
+ ***********************************************************************************************************/
+        int open(const pax_filestring & fileName) {
 
-            return PAX_OK;
+            _buf = nullptr;
+            _map = std::make_shared<PaxMap>();
+            if (PAX_OK != _map->map(fileName)) {
+              // error has already been reported
+                _map = nullptr;
+                return PAX_FAIL;
+            }
 
-        } // int addMetaVal (std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
-        int addMetaVal(metaLoc_e loc, std::string name, double data) {
-            return addMetaVal(name, data, loc);
-        }
+            paxMapPtr map = _map;
+            _buf = paxBufPtr(new paxBuf_t(map->data(), map->size()), [map](paxBuf_t * p) { delete p; });
 
+            return readIndex();
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Adds/replaces integer metadata at the (optional) specified location
-        //
-        int addMetaVal(std::string name, uint64_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN, paxMetaDataTypes_e type = paxMetaDataTypes::paxUint64) {
+        } // int open(const pax_filestring & fileName)
 
-            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+/************************************************************************************************************
+ * Number of rasters in the bundle
+ * @return          raster count
+ ***********************************************************************************************************/
+        size_t size() const { return _entries.size(); }
 
-            meta_t meta;
-            meta.loc = loc;
-            meta.index = _metaLocCount[loc]++;
-            meta.name = name;
-            meta.u64 = data;
-            meta.type = type;
+/************************************************************************************************************
+ * Table of contents entry for a raster
+ * @param[in]       n       Raster index
+ * @return          entry describing the raster
+ ***********************************************************************************************************/
+        const paxBundleEntry_t & entry(size_t n) const { return _entries.at(n); }
 
-            getMetaRef()[name] = meta;
+/************************************************************************************************************
+ * Loads one raster, without parsing any other.
+ * @param[in]       n       Raster index
+ * @return          the raster, or nullptr upon failure
+ ***********************************************************************************************************/
+        rasterFileBasePtr load(size_t n) {
 
-            _metaLoc = loc;
+            if (n >= _entries.size()) {
+                PAX_LOG_ERROR(1, << "bundle has no raster " << n << "; it holds " << _entries.size());
+                return nullptr;
+            }
 
-            return PAX_OK;
+            return rasterFileBase::importAny(view(n));
 
-        } // int addMetaVal (std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
-        int addMetaVal(std::string name, uint32_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
-            int ret = addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint32);
-            return ret;
-        }
-        int addMetaVal(std::string name, uint16_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
-            int ret = addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint16);
-            return ret;
-        }
-        int addMetaVal(std::string name, uint8_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
-            int ret = addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint8);
-            return ret;
-        }
-        int addMetaVal(metaLoc_e loc, std::string name, uint64_t data) {
-            return addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint64);
-        }
-        int addMetaVal(metaLoc_e loc, std::string name, uint32_t data) {
-            return addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint32);
-        }
-        int addMetaVal(metaLoc_e loc, std::string name, uint16_t data) {
-            return addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint16);
-        }
-        int addMetaVal(metaLoc_e loc, std::string name, uint8_t data) {
-            return addMetaVal(name, (uint64_t)data, loc, paxMetaDataTypes::paxUint8);
-        }
+        } // rasterFileBasePtr load(size_t n)
 
+/************************************************************************************************************
+ * Loads a subset of the rasters concurrently. Results are in the order of the indexes given; an index
+ * must not appear twice.
+ * @param[in]       indexes Raster indexes
+ * @param[in]       pool    Threads to load on
+ * @return          the rasters, nullptr for any that failed
+ ***********************************************************************************************************/
+        std::vector<rasterFileBasePtr> load(const std::vector<size_t> & indexes, PaxThreadPool & pool = PaxThreadPool::shared()) {
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Adds/replaces integer metadata at the (optional) specified location
-        //
-        int addMetaVal(std::string name, int64_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN, paxMetaDataTypes_e type = paxMetaDataTypes::paxInt64) {
+            std::vector<paxBufPtr> views;
+            for (size_t n : indexes) {
+                views.push_back(n < _entries.size() ? view(n) : nullptr);
+            }
 
-            if (metaLoc_e::LOC_UNKNOWN >= loc || metaLoc_e::LOC_COUNT <= loc) loc = _metaLoc;
+            return rasterFileBase::importBatch(views, pool);
 
-            meta_t meta;
-            meta.loc = loc;
-            meta.index = _metaLocCount[loc]++;
-            meta.name = name;
-            meta.n64 = data;
-            meta.type = type;
+        } // std::vector<rasterFileBasePtr> load(const std::vector<size_t> & indexes, PaxThreadPool & pool)
 
-            getMetaRef()[name] = meta;
+/************************************************************************************************************
+ * Loads every raster concurrently.
+ * @param[in]       pool    Threads to load on
+ * @return          the rasters in bundle order, nullptr for any that failed
+ ***********************************************************************************************************/
+        std::vector<rasterFileBasePtr> loadAll(PaxThreadPool & pool = PaxThreadPool::shared()) {
 
-            _metaLoc = loc;
+            std::vector<size_t> indexes(_entries.size());
+            std::iota(indexes.begin(), indexes.end(), 0);
 
-            return PAX_OK;
+            return load(indexes, pool);
 
-        } // int addMetaVal (std::string name, double data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN)
-        int addMetaVal(std::string name, int32_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
-            int ret = addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt32);
-            return ret;
-        }
-        int addMetaVal(std::string name, int16_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
-            int ret = addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt16);
-            return ret;
-        }
-        int addMetaVal(std::string name, int8_t data, metaLoc_e loc = metaLoc_e::LOC_UNKNOWN) {
-            int ret = addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt8);
-            return ret;
-        }
-        int addMetaIntVal(metaLoc_e loc, std::string name, int64_t data) {
-            return addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt64);
-        }
-        int addMetaIntVal(metaLoc_e loc, std::string name, int32_t data) {
-            return addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt32);
-        }
-        int addMetaIntVal(metaLoc_e loc, std::string name, int16_t data) {
-            return addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt16);
-        }
-        int addMetaIntVal(metaLoc_e loc, std::string name, int8_t data) {
-            return addMetaVal(name, (int64_t)data, loc, paxMetaDataTypes::paxInt8);
-        }
+        } // std::vector<rasterFileBasePtr> loadAll(PaxThreadPool & pool)
 
+    protected:
+/************************************************************************************************************
+ * Renders each raster and the table of contents describing them.
+ ***********************************************************************************************************/
+        static int render(const std::vector<rasterFileBase*> & rasters, std::vector<paxRendered_t> & rendered, std::string & index) {
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // get values per element for internal type
-        //
-        int32_t vpe() {
-            return getVPE(E);
-        }
+            std::string entries;
+            entries.reserve(rasters.size() * 64);
+            rendered.resize(rasters.size());
 
+            uint64_t offset = 0;
+            for (size_t n = 0; n < rasters.size(); ++n) {
+                paxRendered_t & r = rendered[n];
+                if (!rasters[n] || PAX_OK != rasters[n]->writeHeader(r.header, r.scratch, r.payload)) {
+                    PAX_LOG_ERROR(1, << "could not render raster " << n << " of bundle");
+                    return PAX_FAIL;
+                }
+                appendEntry(entries, *rasters[n], offset, r.header.length(), r.payload.second);
+                offset += r.header.length() + r.payload.second;
+            }
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // get bytes per value for internal type
-        //
-        int32_t bpv() {
-            return getBPV(E);
-        }
+            index = renderIndex(rasters.size(), entries, offset);
 
+            return PAX_OK;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // get data length
-        //
-        int32_t datalen() {
-            return getBPV(E) * getVPE(E) * _numValues;
-        }
+        } // static int render(...)
 
+/************************************************************************************************************
+ * Appends the table of contents line of a raster.
+ * @param[in,out]   entries     Lines of the rasters before it
+ * @param[in]       raster      The raster
+ * @param[in]       offset      Offset of its PAX tag from the start of the bundle
+ * @param[in]       headerLen   Length of its header
+ * @param[in]       payloadLen  Length of the data following the header
+ ***********************************************************************************************************/
+        static void appendEntry(std::string & entries, rasterFileBase & raster, uint64_t offset, uint64_t headerLen, uint64_t payloadLen) {
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // extract PAX type name for given type
-        //
-        std::string getTypeName() {
-            return rasterFileBase::getTypeName(E);
-        }
+            const std::vector<uint64_t> & dims = raster.getDims();
+            for (uint64_t val : { offset, headerLen + payloadLen, headerLen, (uint64_t)raster.getType(), (uint64_t)dims.size() }) {
+                rasterFileBase::appendNumber(entries, val);
+                entries.push_back(' ');
+            }
+            for (uint64_t dim : dims) {
+                rasterFileBase::appendNumber(entries, dim);
+                entries.push_back(' ');
+            }
+            entries.back() = '\n';
+
+        } // static void appendEntry(...)
+
+/************************************************************************************************************
+ * Renders the table of contents.
+ * @param[in]       count       Number of rasters
+ * @param[in]       entries     Their lines
+ * @param[in]       offset      Offset of the table, just past the last raster
+ * @return          The table of contents and trailer
+ ***********************************************************************************************************/
+        static std::string renderIndex(size_t count, const std::string & entries, uint64_t offset) {
 
+            std::string index;
+            index.reserve(32 + entries.length() + BUNDLE_TRAILER_LEN);
+            index.append(BUNDLE_TAG).append(" : ");
+            rasterFileBase::appendNumber(index, (uint64_t)count);
+            index.push_back('\n');
+            index.append(entries);
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Convert byte data to float
-        //
-        std::shared_ptr<float> byteToFloatData() {
-            std::shared_ptr<float> floatData(new float[getNumElements()]);
-            float *data = floatData.get();
+            char trailer[BUNDLE_TRAILER_LEN + 1];
+            snprintf(trailer, sizeof(trailer), "%s : %020llu\n", BUNDLE_INDEX_TAG, (unsigned long long)offset);
+            index.append(trailer, BUNDLE_TRAILER_LEN);
 
-            for (uint32_t y = 0; y < _numStrided; ++y) {
-                for (uint32_t x = 0; x < _numSequential; ++x) {
-                    data[y * _numSequential + x] = (float)ucharValXY(x, y);
-                }
-            }
+            return index;
 
-            return floatData;
+        } // static std::string renderIndex(size_t count, const std::string & entries, uint64_t offset)
 
-        } // std::shared_ptr<float> byteToFloatData() 
+/************************************************************************************************************
+ * Parses the trailer and the table of contents.
+ ***********************************************************************************************************/
+        int readIndex() {
 
+            _entries.clear();
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Convert float data to uint8
-        //
-        std::shared_ptr<uint8_t> floatToByteData() {
+            const char * start = _buf->data();
+            const uint64_t len = _buf->size();
+            const size_t tagLen = strlen(BUNDLE_INDEX_TAG);
+            if (len < BUNDLE_TRAILER_LEN) {
+                PAX_LOG_ERROR(1, << "PAX bundle too short");
+                return PAX_INVALID;
+            }
 
-            std::shared_ptr<uint8_t> floatData(new uint8_t[getNumElements()]);
-            uint8_t *data = floatData.get();
+            const char * end = start + len - BUNDLE_TRAILER_LEN;
+            const char * pos = end + tagLen + 3;     // past " : "
+            uint64_t indexOffset = 0;
+            if (0 != memcmp(end, BUNDLE_INDEX_TAG, tagLen) || !readNumber(pos, start + len, indexOffset) || indexOffset > len - BUNDLE_TRAILER_LEN) {
+                PAX_LOG_ERROR(1, << "PAX bundle has no valid " << BUNDLE_INDEX_TAG << " trailer");
+                return PAX_INVALID;
+            }
+
+            pos = start + indexOffset;
+            const size_t bundleTagLen = strlen(BUNDLE_TAG);
+            uint64_t count = 0;
+            bool ok = (uint64_t)(end - pos) > bundleTagLen + 3 && 0 == memcmp(pos, BUNDLE_TAG, bundleTagLen);
+            if (ok) {
+                pos += bundleTagLen + 3;
+                ok = readNumber(pos, end, count) && count <= (uint64_t)(end - pos);
+            }
+            if (!ok) {
+                PAX_LOG_ERROR(1, << "PAX bundle table of contents is malformed");
+                return PAX_INVALID;
+            }
 
-            float val;
-            uint8_t byte;
-            for (uint32_t y = 0; y < _numStrided; ++y) {
-                for (uint32_t x = 0; x < _numSequential; ++x) {
-                    val = floatValXY(x, y);
-                    byte = (val <= 0) ? 0 : ((val >= 255.0f) ? 255 : (uint8_t)val);
-                    data[y * _numSequential + x] = byte;
+            _entries.resize(count);
+            for (auto & entry : _entries) {
+                uint64_t type = 0, numDims = 0;
+                ok = readNumber(pos, end, entry.offset) && readNumber(pos, end, entry.length)
+                    && readNumber(pos, end, entry.headerLength) && readNumber(pos, end, type)
+                    && readNumber(pos, end, numDims) && numDims <= PAX_MAX_DIMS;
+                if (ok) {
+                    entry.dims.resize(numDims);
+                    for (auto & dim : entry.dims) ok = ok && readNumber(pos, end, dim);
                 }
+                if (!ok || !rasterFileBase::isPaxType((int32_t)type) || entry.offset > indexOffset
+                    || entry.length > indexOffset - entry.offset || entry.headerLength > entry.length) {
+                    PAX_LOG_ERROR(1, << "PAX bundle table of contents entry " << (&entry - _entries.data()) << " is malformed");
+                    _entries.clear();
+                    return PAX_INVALID;
+                }
+                entry.type = rasterFileBase::getPaxType((int32_t)type);
             }
 
-            return floatData;
+            PAX_LOG(1, << "Opened PAX bundle of " << count << " rasters");
 
-        } // std::shared_ptr<uint8_t> floatToByteData() 
+            return PAX_OK;
 
+        } // int readIndex()
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Convert the data to a PGM file (currently only valid for UCHAR, CHAR, FLOAT)
-        // Valid values for pgmType are 2 and 5 for P2 (8-bit ascii) and P5 (8-bit binary), respectively.
-        //
-        paxBufPtr toPGM(int pgmType = 5) {
+/************************************************************************************************************
+ * Reads a decimal number, skipping the whitespace before it.
+ ***********************************************************************************************************/
+        static bool readNumber(const char *& pos, const char * end, uint64_t & val) {
 
-            ucharRasterFile *paxPtr;  // use an abstract pointer to facilitate conversion
-            ucharRasterFilePtr bytePtr;
-            std::shared_ptr<uint8_t> byteData;
+            while (pos < end && (' ' == *pos || '\n' == *pos)) ++pos;
+            std::from_chars_result res = std::from_chars(pos, end, val);
+            pos = res.ptr;
 
-            if (pgmType != 2 && pgmType != 5) return nullptr;
+            return std::errc() == res.ec;
 
-            switch (_dataType) {
-                //paxPtr = this;
-                //break;
+        } // static bool readNumber(const char *& pos, const char * end, uint64_t & val)
 
-            case paxTypes::ePAX_UCHAR:
-            case paxTypes::ePAX_CHAR:
-                paxPtr = reinterpret_cast<ucharRasterFile *>(this);
-                break;
+/************************************************************************************************************
+ * A buffer viewing one raster of the bundle, which keeps the bundle alive.
+ ***********************************************************************************************************/
+        paxBufPtr view(size_t n) {
 
-            case paxTypes::ePAX_FLOAT:
-                byteData = floatToByteData();
-                bytePtr = std::make_shared<ucharRasterFile>(_numSequential, _numStrided, byteData.get());
-                paxPtr = bytePtr.get();
-                break;
+            paxBufPtr bundle = _buf;
+            const paxBundleEntry_t & entry = _entries[n];
 
-            default:
-                return nullptr;
-            }
+            return paxBufPtr(new paxBuf_t(bundle->data() + entry.offset, entry.length), [bundle](paxBuf_t * p) { delete p; });
 
-            // write output file to a pgm file
-            std::ostringstream hdrs;
-            const char *pgmTag = (2 == pgmType) ? "P2\n" : "P5\n";
-            hdrs << pgmTag << _numSequential << " " << _numStrided << "\n255\n";
+        } // paxBufPtr view(size_t n)
 
-            std::string hdr = hdrs.str();
-            size_t hdrLen = hdr.length();
-            size_t dataLen = getNumValues() * sizeof(uint8_t);
-            if (2 == pgmType) {
-                dataLen = 4 * dataLen + 1; // length of ascii buffer is exactly this (all values are 3 digits, plus spaces and LF's, plus NULL)
-            }
+        paxBufPtr                       _buf;           ///< The whole bundle
+        paxMapPtr                       _map;           ///< Mapping backing _buf when opened from a file
+        std::vector<paxBundleEntry_t>   _entries;       ///< Table of contents
 
-            size_t imgLen = hdrLen + dataLen;
+    }; // class PaxBundle
 
-            paxBufPtr pgmBuf = std::make_shared<paxBuf_t>(imgLen);
-            char *pgmbuf = pgmBuf.get()->data();
-            uint8_t *paxBuf = reinterpret_cast<uint8_t*> (paxPtr->buf());
 
-            // TODO: PAX insertion operator for paxBufData_t
-            memcpy(pgmbuf, hdr.c_str(), hdrLen);
-            pgmbuf += hdrLen;
+/************************************************************************************************************
+ * @class PaxBatchWriter
+ * Writes many rasters back to back into one file, as writeMultiple() lays them out, optionally followed by
+ * the table of contents of a PaxBundle. Only the headers are rendered; each payload is gathered straight
+ * from its raster, or from the tiled or compressed copy if one is needed. The segments are collected into
+ * large batches, and each batch goes to the file in one gather write, or on io_uring as several writes in
+ * flight at once. A raster must stay alive and unchanged until the batch holding it is written: by the
+ * next flush() or close(), or sooner by add() once a batch is full.
+ ***********************************************************************************************************/
+    class PaxBatchWriter {
 
-            if (2 == pgmType) {
-              // write ascii file
-                size_t len = 0;
+    public:
+/************************************************************************************************************
+ * Ctor. Call open() before adding rasters.
+ * @param[in]       backend     How the writes reach the file
+ * @param[in]       batchBytes  Bytes to collect before writing them
+ ***********************************************************************************************************/
+        explicit PaxBatchWriter(paxIoBackend_e backend = IO_AUTO, uint64_t batchBytes = PAX_BATCH_BYTES)
+            : _requested(backend), _backend(IO_WRITEV), _batchBytes(batchBytes) { }
 
-                for (uint32_t j = 0; j < _numStrided; ++j) {
-                    for (uint32_t i = 0; i < _numSequential; ++i) {
-                        len += pax_sprintf(pgmbuf + len, "%3d ", *(paxBuf++));
-                    }
-                    pgmbuf[len - 1] = '\n';
-                }
-                pgmbuf[len - 1] = '\n';
-                pgmbuf[len] = ' ';
+/************************************************************************************************************
+ * Dtor. Closes the file if it is still open.
+ ***********************************************************************************************************/
+        ~PaxBatchWriter() { close(); }
 
-            } else {
-                memcpy(pgmbuf, paxBuf, dataLen);
+        PaxBatchWriter(const PaxBatchWriter &) = delete;
+        PaxBatchWriter & operator = (const PaxBatchWriter &) = delete;
+
+/************************************************************************************************************
+ * Creates the output file, replacing any existing one.
+ * @param[in]       fileName    Output file
+ * @param[in]       bundle      Append a PaxBundle table of contents on close()
+ * @return          PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int open(const pax_filestring & fileName, bool bundle = false) {
+
+            close();
+
+            _fd = rasterFileBase::openForWrite(fileName);
+            if (-1 == _fd) {
+                return PAX_FAIL;
             }
 
-            return pgmBuf;
+            _bundle = bundle;
+            _failed = false;
+            _offset = _written = _count = 0;
+            _entries.clear();
 
-        } // paxBufPtr toPGM(int pgmType = 5)  
+            _backend = IO_WRITEV;
+#ifdef PAX_IO_URING
+            if (IO_WRITEV != _requested && PAX_OK == _ring.open(PAX_IO_DEPTH)) {
+                _backend = IO_URING;
+            }
+#endif
+            PAX_LOG(1, << "Batch writing to " << fileName << " with " << (IO_URING == _backend ? "io_uring" : "writev"));
 
+            return PAX_OK;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Write the data to a PGM file (currently only valid for ePAX_UCHAR, ePAX_CHAR, ePAX_FLOAT)
-        // Valid values for pgmType are 2 and 5 for P2 (8-bit ascii) and P5 (8-bit binary), respectively.
-        //
-        int writeToPGMFile(std::string fileName, int pgmType = 5) {
+        } // int open(const pax_filestring & fileName, bool bundle = false)
 
-            paxBufPtr pgmBuf = toPGM(pgmType);
+/************************************************************************************************************
+ * Adds a raster after the ones already added. Writes the batch once it is full.
+ * @param[in]       raster      The raster
+ * @return          PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int add(rasterFileBase & raster) {
 
-            if (nullptr == pgmBuf) {
-                PAX_LOG_ERROR(1, << "Error writing PAX to PGM!! Filename was going to be '" << fileName << "'");
+            if (-1 == _fd || _failed) {
+                PAX_LOG_ERROR(1, << "Batch writer is not open, or has failed");
                 return PAX_FAIL;
             }
 
-            int ret = rasterFileBase::writeToFile(pgmBuf, fileName);
+            _pending.emplace_back();
+            paxRendered_t & r = _pending.back();
+            if (PAX_OK != raster.writeHeader(r.header, r.scratch, r.payload)) {
+                _pending.pop_back();
+                return PAX_FAIL;
+            }
 
-            if (PAX_OK != ret) {
-                PAX_LOG_ERROR(1, << "Error writing PGM file '" << fileName << "'");
+            const uint64_t len = r.header.length() + r.payload.second;
+            _segs.push_back({ r.header.c_str(), r.header.length() });
+            if (r.payload.second > 0) {
+                _segs.push_back(r.payload);
+            }
+            if (_bundle) {
+                PaxBundle::appendEntry(_entries, raster, _offset, r.header.length(), r.payload.second);
             }
+            _offset += len;
+            ++_count;
 
-            return ret;
+            return (_offset - _written >= _batchBytes) ? flush() : PAX_OK;
 
-        } // int writeToPGMFile(std::string fileName, int pgmType = 5) 
+        } // int add(rasterFileBase & raster)
 
+/************************************************************************************************************
+ * Writes everything added so far. The rasters may then change or go away.
+ * @return          PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int flush() {
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // import PAX file from file
-        //
-        int import(pax_filestring fileName) {
+            if (_segs.empty() || _failed) {
+                return _failed ? PAX_FAIL : PAX_OK;
+            }
 
-            PAX_LOG(1, << "Importing PAX file " << fileName);
+            const uint64_t len = _offset - _written;
+            int ret = PAX_OK;
+#ifdef PAX_IO_URING
+            if (IO_URING == _backend) {
+                ret = writeRing();
+            } else
+#endif
+            if ((int64_t)len != rasterFileBase::writeSegments(_fd, _segs.data(), _segs.size())) {
+                PAX_LOG_ERROR(1, << "Failure writing a batch of " << len << " bytes");
+                ret = PAX_FAIL;
+            }
 
-            paxBufPtr fileBuf = readFile(fileName);
-            if (!fileBuf) {
-              // error has already been reported
-                return PAX_FAIL;
+            _segs.clear();
+            _pending.clear();
+            _written = _offset;
+            _failed = (PAX_OK != ret);
+
+            return ret;
+
+        } // int flush()
+
+/************************************************************************************************************
+ * Writes everything added so far and the table of contents, if asked for, and closes the file.
+ * @return          PAX_OK if every raster was written, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int close() {
+
+            if (-1 == _fd) {
+                return PAX_OK;
             }
 
-            if (fileBuf.get()->size() < MIN_PAX_LENGTH) {
-                PAX_LOG_ERROR(1, << ("PAX file too short"));
-                return PAX_FAIL;
+            std::string index;
+            if (_bundle && !_failed) {
+                index = PaxBundle::renderIndex(_count, _entries, _offset);
+                _segs.push_back({ index.c_str(), index.length() });
+                _offset += index.length();
             }
 
-            return import(fileBuf);
+            int ret = flush();
+#ifdef PAX_IO_URING
+            _ring.close();
+#endif
+            pax_close(_fd);
+            _fd = -1;
 
-        } // int import (pax_filestring fileName)
+            if (PAX_OK == ret) {
+                PAX_LOG(1, << "Batch wrote " << _count << " rasters, " << _offset << " bytes");
+            }
 
+            return ret;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // import PAX file from paxBufPtr
-        //
-        int import(paxBufPtr inBuf) {
-            return import(inBuf.get()->data(), inBuf.get()->size());
-        }
+        } // int close()
 
+/************************************************************************************************************
+ * How the writes reach the file.
+ * @return          IO_URING or IO_WRITEV, once the file is open
+ ***********************************************************************************************************/
+        paxIoBackend_e getBackend() { return _backend; }
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // import PAX file from constant buffer
-        //
-        int import_copy(const unsigned char* inBuf, size_t length) {
-            std::vector<unsigned char> buf(length);
-            memcpy(buf.data(), inBuf, length);
-            PAX_LOG(2, << "PAX import_copy copied an unsigned buffer of length " << length);
-            return import(buf.data(), length);
-        }
+/************************************************************************************************************
+ * Number of rasters added.
+ * @return          raster count
+ ***********************************************************************************************************/
+        size_t size() { return _count; }
 
+/************************************************************************************************************
+ * Length of the file once everything added is written.
+ * @return          bytes
+ ***********************************************************************************************************/
+        uint64_t getLength() { return _offset; }
 
+    private:
+#ifdef PAX_IO_URING
         //////////////////////////////////////////////////////////////////////////
         //
-        // import PAX file from buffer
-        //
-        int import(unsigned char* inBuf, size_t length) {
-            return import((char*)inBuf, length);
-        }
+        // Write the batch on io_uring: the segments are split into writes of
+        // at most PAX_MAX_IOV segments and PAX_MAX_IO_LEN bytes, of which at
+        // most PAX_IO_DEPTH are kept in flight. A short write is finished
+        // synchronously. No write is left in flight on return, as the
+        // segments may go away then.
+        //
+        int writeRing() {
+
+            struct write_t { size_t first; size_t count; uint64_t offset; uint64_t len; };
+            std::vector<struct iovec> iov;
+            std::vector<write_t> writes;
+            uint64_t offset = _written;
+            for (const paxSegment_t & seg : _segs) {
+                for (uint64_t done = 0; done < seg.second; ) {
+                    if (writes.empty() || writes.back().count == PAX_MAX_IOV || writes.back().len == PAX_MAX_IO_LEN) {
+                        writes.push_back({ iov.size(), 0, offset, 0 });
+                    }
+                    write_t & w = writes.back();
+                    const uint64_t len = PAX_MIN(seg.second - done, PAX_MAX_IO_LEN - w.len);
+                    iov.push_back({ const_cast<char*>(seg.first + done), (size_t)len });
+                    ++w.count;
+                    w.len += len;
+                    offset += len;
+                    done += len;
+                }
+            }
 
+            int ret = PAX_OK;
+            size_t next = 0, inFlight = 0;
+            while (next < writes.size() || inFlight > 0) {
+                while (PAX_OK == ret && next < writes.size() && inFlight < PAX_IO_DEPTH &&
+                       _ring.writev(_fd, iov.data() + writes[next].first, (uint32_t)writes[next].count, writes[next].offset, next)) {
+                    ++next;
+                    ++inFlight;
+                }
+                uint64_t tag;
+                int32_t result;
+                if (PAX_OK != _ring.submit(1)) {
+                    // the kernel took none of the queued writes; wait for the ones it has without it
+                    inFlight -= _ring.retract();
+                    while (inFlight > 0) {
+                        if (_ring.result(tag, result)) {
+                            --inFlight;
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                    return PAX_FAIL;
+                }
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // import PAX file from const buffer
-        //
-        int import_copy(const char* inBuf, size_t length) {
-            std::vector<char> buf(length);
-            memcpy(buf.data(), inBuf, length);
-            PAX_LOG(2, << "PAX import_copy copied a signed buffer of length " << length);
-            return import(buf.data(), length);
-        }
+                while (_ring.result(tag, result)) {
+                    --inFlight;
+                    const write_t & w = writes[tag];
+                    if (result < 0) {
+                        PAX_LOG_ERROR(1, << "io_uring write of " << w.len << " bytes at offset " << w.offset << " failed: errno " << -result);
+                        ret = PAX_FAIL;
+                    } else if ((uint64_t)result < w.len && PAX_OK != finish(iov.data() + w.first, w.count, w.offset, result)) {
+                        ret = PAX_FAIL;
+                    }
+                }
+            }
+
+            return ret;
 
+        } // int writeRing()
 
         //////////////////////////////////////////////////////////////////////////
         //
-        // import PAX file from buffer
+        // Finish a short write, skipping the bytes that were written
         //
-        int import(char* inBuf, size_t length) {
+        int finish(const struct iovec * iov, size_t count, uint64_t offset, uint64_t done) {
 
-            if (_numValues != 0 || _numSequential != 0 || _numStrided != 0 || _buf != nullptr || _meta != nullptr) {
-                reset();
+            std::vector<paxSegment_t> rest;
+            uint64_t len = 0;
+            uint64_t skip = done;
+            for (size_t i = 0; i < count; ++i) {
+                const uint64_t from = PAX_MIN(skip, (uint64_t)iov[i].iov_len);
+                skip -= from;
+                if (from < iov[i].iov_len) {
+                    rest.push_back({ static_cast<const char*>(iov[i].iov_base) + from, iov[i].iov_len - from });
+                    len += rest.back().second;
+                }
             }
 
-            PAX_LOG(1, << "Importing PAX buffer of length " << length);
-
-            // parse the header
-            BufMan buf(inBuf, length);
-
-            int32_t dataLen = 0;
-            int headerRet = importHeader(buf, dataLen);
-
-            if (PAX_OK != headerRet) {
+            if ((int64_t)len != rasterFileBase::writeSegmentsAt(_fd, offset + done, rest.data(), rest.size())) {
+                PAX_LOG_ERROR(1, << "Failure finishing a short io_uring write at offset " << offset + done);
                 return PAX_FAIL;
             }
 
-            // copy that data
-            paxBufPtr dataBuf = std::make_shared <paxBuf_t>(dataLen);
-            buf.copyData(dataBuf.get()->data(), dataLen);
+            return PAX_OK;
 
-            // store those metadata counts
-            auto metavecs = getMetaVecs();
-            int i = 0;
-            for (auto vec : (*metavecs)) {
-                _metaLocCount[i] = vec.size();
-                ++i;
-            }
+        } // int finish(...)
+#endif
 
-            if (PaxStatic::getVerbosity() >= 3) {
-                PAX_LOG(3, << "Some data for ya:");
-                float * buf = (float*)dataBuf.get()->data();
-                for (uint32_t i = 0; i < PAX_MIN(8, _numSequential); ++i) {
-                    std::stringstream ss;
-                    for (uint32_t j = 0; j < PAX_MIN(8, _numStrided); ++j) {
-                        ss << std::setw(12) << buf[i + j * _numSequential];
-                    }
-                    PAX_LOG(3, << ss.str());
-                }
-            }
+        int                         _fd = -1;           ///< Output file
+        bool                        _bundle = false;    ///< Append a bundle table of contents
+        bool                        _failed = false;    ///< A write failed; nothing more is written
+        paxIoBackend_e              _requested;         ///< Backend asked for
+        paxIoBackend_e              _backend;           ///< Backend in use
+        uint64_t                    _batchBytes;        ///< Bytes to collect before writing them
+        std::deque<paxRendered_t>   _pending;           ///< Rasters of the batch; a deque keeps their headers in place
+        std::vector<paxSegment_t>   _segs;              ///< Segments of the batch, in file order
+        uint64_t                    _offset = 0;        ///< Bytes added
+        uint64_t                    _written = 0;       ///< Bytes written; the batch starts here
+        size_t                      _count = 0;         ///< Rasters added
+        std::string                 _entries;           ///< Table of contents lines
+#ifdef PAX_IO_URING
+        PaxIoRing                   _ring;              ///< The ring, when the backend is IO_URING
+#endif
 
-            _buf = dataBuf;
-            _importedLength = buf.offset();
+    }; // class PaxBatchWriter
 
-            if (PaxStatic::getVerbosity() >= 3) {
-                std::stringstream ss;
-                ss << "Total imported length = " << _importedLength << " bytes.";
-                PAX_LOG(3, << ss.str());
-            }
+    inline int PaxBundle::writeFile(const std::vector<rasterFileBase*> & rasters, const pax_filestring & fileName, paxIoBackend_e backend) {
 
-            return PAX_OK;
-#undef verbosityLevel
+        PaxBatchWriter writer(backend);
+        if (PAX_OK != writer.open(fileName, true)) {
+            return PAX_FAIL;
+        }
 
-        } // int import (char* inBuf, size_t length)
+        for (size_t n = 0; n < rasters.size(); ++n) {
+            if (!rasters[n] || PAX_OK != writer.add(*rasters[n])) {
+                PAX_LOG_ERROR(1, << "could not render raster " << n << " of bundle");
+                writer.close();
+                return PAX_FAIL;
+            }
+        }
 
+        return writer.close();
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // TODO: import PAX file from char string
-        //
-        //int import (char * inBuf) {
-        //  return PAX_FAIL;
-        //}
+    } // int PaxBundle::writeFile(...)
 
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Helper function to write metadata. Assumes the given data have been sorted.
-        //
-        int writeMeta(pax_stringstream &ss, std::vector<std::pair<std::string, meta_t>> &metavec) {
+/************************************************************************************************************
+ * @struct paxCatalogMeta_t
+ * One scalar metadata value recorded in a PAX catalog
+ ***********************************************************************************************************/
+    struct paxCatalogMeta_t {
+        paxMetaDataTypes_e      type;           ///< Metadata type
+        std::string             value;          ///< Value as text; numbers read back exactly
+        double                  number;         ///< Numeric value, NaN for a string
+    };
+
+/************************************************************************************************************
+ * @struct paxCatalogEntry_t
+ * The header of one PAX file recorded in a PAX catalog
+ ***********************************************************************************************************/
+    struct paxCatalogEntry_t {
+        std::string             path;           ///< Absolute path of the file, UTF-8
+        uint64_t                size;           ///< File size when the header was read
+        int64_t                 mtime;          ///< File modification time when the header was read, in file clock ticks
+        paxTypes_e              type;           ///< PAX type of the raster
+        std::vector<uint64_t>   dims;           ///< Length of each dimension, sequential first
+        uint64_t                headerLength;   ///< Length of the header; the data follow it
+        uint64_t                dataLength;     ///< Length of the data as stored
+        std::map<std::string, paxCatalogMeta_t> meta;  ///< Scalar metadata by name
+        std::vector<std::string> skipped;       ///< Names of the array metadata and comments, sorted; their values are not recorded
+    };
 
-            for (auto meta : metavec) {
+/************************************************************************************************************
+ * @class PaxCatalog
+ * The headers of every PAX file under one or more directories, for answering queries on type, shape and
+ * metadata without reading the files again. scan() previews each file's header, including its scalar
+ * metadata, and rescans only read the files whose size or modification time changed. Numeric metadata
+ * are indexed by value, so a range query is a binary search. The catalog is saved as text:
+ *
+ *     PAX_CATALOG : <count>
+ *     <size> <mtime> <type> <header length> <data length> <number of dims> <dim> ... <number of metadata> <number skipped> <path>
+ *     <metadata type> <name> <value>      (one line per metadata)
+ *     <name>                              (one line per skipped metadata)
+ *
+ * where path, name and value are each written as their length in bytes, a space, and the bytes. Array
+ * metadata and comments are skipped: only their names are recorded, in paxCatalogEntry_t::skipped.
+ ***********************************************************************************************************/
+    class PaxCatalog {
 
-                pax_stringstream ssmeta;
-                std::streamsize prec = ssmeta.precision(15);
-                paxMetaDataTypes_e type = meta.second.type;
+    public:
+/************************************************************************************************************
+ * Default ctor. An empty catalog; scan() or load() fills it.
+ ***********************************************************************************************************/
+        PaxCatalog() { }
 
-                // handle trivial and nonnumeric types first
-                switch (type) {
+/************************************************************************************************************
+ * Brings the catalog up to date with a directory and everything below it. Files that are new, or whose
+ * size or modification time changed, have their headers read, in parallel; files that are gone are
+ * dropped. Entries outside the directory are kept.
+ * @param[in]       dir         Directory to scan
+ * @param[in]       extension   Extension of the files to catalog, including the dot; empty for all files
+ * @param[in]       pool        Threads to read headers on
+ * @return          PAX_OK on success, PAX_FAIL if the directory could not be walked
+ ***********************************************************************************************************/
+        int scan(const pax_filestring & dir, const std::string & extension = ".pax", PaxThreadPool & pool = PaxThreadPool::shared()) {
 
-                case paxMetaDataTypes_e::paxComment:
-                    ss << (meta.second.stripped ? "# " : "#") << meta.second.s /*+ skip*/ << '\n';
+            std::error_code ec;
+            const std::filesystem::path root = std::filesystem::absolute(std::filesystem::path(dir), ec).lexically_normal();
+            if (ec || !std::filesystem::is_directory(root, ec)) {
+                PAX_LOG_ERROR(1, << "Cannot catalog " << dir << ": not a directory");
+                return PAX_FAIL;
+            }
+            const std::string prefix = (root / "").u8string();
+
+            // stat everything first; only changed files are read
+            std::vector<bool> keep(_entries.size(), false);
+            std::vector<paxCatalogEntry_t> fresh;
+            std::vector<std::filesystem::path> paths;
+            std::filesystem::recursive_directory_iterator it(root, std::filesystem::directory_options::skip_permission_denied, ec);
+            for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+                std::error_code fileEc;
+                if (!it->is_regular_file(fileEc) || (!extension.empty() && it->path().extension().u8string() != extension)) {
                     continue;
+                }
 
-                case paxMetaDataTypes_e::paxString:
-                    ss << "@ [" << METATYPE_STRING_TAG << "]   ";
-                    ss << meta.first << (meta.second.stripped ? " = " : " =") << meta.second.s /*+ skip */ << '\n';
+                paxCatalogEntry_t entry{};
+                entry.path = it->path().u8string();
+                entry.size = it->file_size(fileEc);
+                entry.mtime = (int64_t)it->last_write_time(fileEc).time_since_epoch().count();
+                if (fileEc) {
                     continue;
+                }
 
-                case paxMetaDataTypes_e::paxInvalid:
-                    continue;
+                auto known = _byPath.find(entry.path);
+                if (known != _byPath.end() && _entries[known->second].size == entry.size && _entries[known->second].mtime == entry.mtime) {
+                    keep[known->second] = true;
+                } else {
+                    fresh.push_back(std::move(entry));
+                    paths.push_back(it->path());
+                }
+            }
+            if (ec) {
+                PAX_LOG_ERROR(1, << "Failure walking " << dir << ": " << ec.message());
+                return PAX_FAIL;
+            }
 
-                default: break;
+            std::vector<char> valid(fresh.size(), 0);
+            pool.parallelFor(fresh.size(), [&](size_t n) {
+                try {
+                    valid[n] = (PAX_OK == readEntry(paths[n], fresh[n]));
+                } catch (const std::exception & e) {
+                    PAX_LOG_ERROR(1, << "Not cataloging " << fresh[n].path << ": " << e.what());
+                }
+            });
 
-                } // switch (type), trivial types
+            // entries outside the directory stay; inside it, only those still current
+            std::vector<paxCatalogEntry_t> entries;
+            for (size_t n = 0; n < _entries.size(); ++n) {
+                if (keep[n] || 0 != _entries[n].path.compare(0, prefix.length(), prefix)) {
+                    entries.push_back(std::move(_entries[n]));
+                }
+            }
+            _read = 0;
+            for (size_t n = 0; n < fresh.size(); ++n) {
+                if (valid[n]) {
+                    entries.push_back(std::move(fresh[n]));
+                    ++_read;
+                }
+            }
+            _entries.swap(entries);
+            reindex();
 
-                size_t count = meta.second.count();
-                size_t subrowlength = 1;
-                size_t rowlength = 1;
+            PAX_LOG(1, << "Cataloged " << dir << ": read " << _read << " headers, " << _entries.size() << " files in the catalog");
 
-                pax_stringstream sstypetag;
-                sstypetag << "[" << PaxStatic::getMetaTypeTag(type) << "]      ";
-                ssmeta << "@ " << sstypetag.str().substr(0, 11) << meta.first;  // write the type tag and name
+            return PAX_OK;
 
-                if (meta.second.dimCount() >= 1) {
+        } // int scan(const pax_filestring & dir, const std::string & extension, PaxThreadPool & pool)
 
-                  // choose a reasonable length for separating data into rows
-                    for (int i = 0; i < meta.second.num_dims && rowlength < 16; ++i) {
-                        rowlength *= meta.second.dims[i];
-                        if (subrowlength * meta.second.dims[i] < 8) subrowlength *= meta.second.dims[i];
-                    }
+/************************************************************************************************************
+ * Saves the catalog. The file is replaced only once the new one is complete.
+ * @param[in]       fileName    Catalog file
+ * @return          PAX_OK on success, PAX_FAIL otherwise
+ ***********************************************************************************************************/
+        int save(const pax_filestring & fileName) {
 
-                    // write the array index tags and values
-                    ssmeta << " [";
-                    for (size_t i = 0; i < meta.second.dimCount(); ++i) {
-                        ssmeta << " " << PaxStatic::getMetaArrayIndexTag((uint32_t)i) << " = " << meta.second.dims[i];
-                    }
-                    ssmeta << " ]";
+            std::string out;
+            out.append(CATALOG_TAG).append(" : ");
+            rasterFileBase::appendNumber(out, (uint64_t)_entries.size());
+            out.push_back('\n');
 
+            for (const paxCatalogEntry_t & entry : _entries) {
+                for (int64_t val : { (int64_t)entry.size, entry.mtime, (int64_t)entry.type, (int64_t)entry.headerLength, (int64_t)entry.dataLength, (int64_t)entry.dims.size() }) {
+                    rasterFileBase::appendNumber(out, val);
+                    out.push_back(' ');
+                }
+                for (uint64_t dim : entry.dims) {
+                    rasterFileBase::appendNumber(out, dim);
+                    out.push_back(' ');
+                }
+                rasterFileBase::appendNumber(out, (uint64_t)entry.meta.size());
+                out.push_back(' ');
+                rasterFileBase::appendNumber(out, (uint64_t)entry.skipped.size());
+                out.push_back(' ');
+                appendText(out, entry.path);
+                out.push_back('\n');
+
+                for (const auto & meta : entry.meta) {
+                    rasterFileBase::appendNumber(out, (int32_t)meta.second.type);
+                    out.push_back(' ');
+                    appendText(out, meta.first);
+                    out.push_back(' ');
+                    appendText(out, meta.second.value);
+                    out.push_back('\n');
                 }
+                for (const std::string & name : entry.skipped) {
+                    appendText(out, name);
+                    out.push_back('\n');
+                }
+            }
+
+            std::filesystem::path temp(fileName);
+            temp += ".tmp";
+            paxSegment_t seg{ out.c_str(), out.length() };
+            if (PAX_OK != PaxHeader::writeFile(fileString(temp), &seg, 1)) {
+                return PAX_FAIL;
+            }
 
-                ssmeta << " ="; // write delimiter
+            std::error_code ec;
+            std::filesystem::rename(temp, std::filesystem::path(fileName), ec);
+            if (ec) {
+                PAX_LOG_ERROR(1, << "Failure replacing catalog " << fileName << ": " << ec.message());
+                std::filesystem::remove(temp, ec);
+                return PAX_FAIL;
+            }
 
-                // multidimensional arrays begin on a new line and indented
-                for (uint32_t i = 0; i < count; ++i) {
+            PAX_LOG(1, << "Saved catalog of " << _entries.size() << " files, " << out.length() << " bytes");
 
-                    if (0 == (i % rowlength) && meta.second.dimCount() > 1) {
-                        ssmeta << "\n ";
-                    }
+            return PAX_OK;
 
-                    switch (type) {
+        } // int save(const pax_filestring & fileName)
 
-                    case paxMetaDataTypes_e::paxFloat:      ssmeta << " " << meta.second.fb[i];       break;
+/************************************************************************************************************
+ * Loads a saved catalog, replacing the current one.
+ * @param[in]       fileName    Catalog file
+ * @return          PAX_OK on success, PAX_FAIL if it cannot be read, PAX_INVALID if it is malformed
+ ***********************************************************************************************************/
+        int load(const pax_filestring & fileName) {
 
-                    case paxMetaDataTypes_e::paxDouble:     ssmeta << " " << meta.second.db[i];       break;
+            paxBufPtr fileBuf = rasterFileBase::readFile(fileName);
+            if (!fileBuf) {
+                return PAX_FAIL;
+            }
 
-                    case paxMetaDataTypes_e::paxInt64:      ssmeta << " " << meta.second.n64b[i];     break;
+            const char * pos = fileBuf->data();
+            const char * end = pos + fileBuf->size();
+            const size_t tagLen = strlen(CATALOG_TAG);
+            uint64_t count = 0;
+            if ((uint64_t)(end - pos) < tagLen + 3 || 0 != memcmp(pos, CATALOG_TAG, tagLen) || 0 != memcmp(pos + tagLen, " : ", 3)) {
+                PAX_LOG_ERROR(1, << fileName << " is not a PAX catalog");
+                return PAX_INVALID;
+            }
+            pos += tagLen + 3;
+
+            std::vector<paxCatalogEntry_t> entries;
+            bool ok = readNumber(pos, end, count);
+            for (uint64_t n = 0; ok && n < count; ++n) {
+                paxCatalogEntry_t entry{};
+                int32_t type = 0;
+                uint64_t numDims = 0, numMeta = 0, numSkipped = 0;
+                ok = readNumber(pos, end, entry.size) && readNumber(pos, end, entry.mtime) && readNumber(pos, end, type)
+                    && readNumber(pos, end, entry.headerLength) && readNumber(pos, end, entry.dataLength)
+                    && readNumber(pos, end, numDims) && numDims <= PAX_MAX_DIMS && rasterFileBase::isPaxType(type);
+                if (ok) {
+                    entry.type = rasterFileBase::getPaxType(type);
+                    entry.dims.resize(numDims);
+                    for (auto & dim : entry.dims) ok = ok && readNumber(pos, end, dim);
+                    ok = ok && readNumber(pos, end, numMeta) && readNumber(pos, end, numSkipped) && readText(pos, end, entry.path);
+                }
+                for (uint64_t m = 0; ok && m < numMeta; ++m) {
+                    std::string name;
+                    paxCatalogMeta_t meta;
+                    int32_t metaType = 0;
+                    ok = readNumber(pos, end, metaType) && metaType >= (int32_t)paxMetaDataTypes_e::paxMetaStart && metaType <= (int32_t)paxMetaDataTypes_e::paxMetaEnd
+                        && readText(pos, end, name) && readText(pos, end, meta.value);
+                    if (ok) {
+                        meta.type = static_cast<paxMetaDataTypes_e>(metaType);
+                        meta.number = std::numeric_limits<double>::quiet_NaN();
+                        ok = (paxMetaDataTypes_e::paxString == meta.type) || readValue(meta.value, meta.type, meta.number);
+                        entry.meta.emplace(std::move(name), std::move(meta));
+                    }
+                }
+                for (uint64_t m = 0; ok && m < numSkipped; ++m) {
+                    entry.skipped.emplace_back();
+                    ok = readText(pos, end, entry.skipped.back());
+                }
+                entries.push_back(std::move(entry));
+            }
+            if (!ok) {
+                PAX_LOG_ERROR(1, << "PAX catalog " << fileName << " is malformed at entry " << entries.size());
+                return PAX_INVALID;
+            }
 
-                    case paxMetaDataTypes_e::paxUint64:     ssmeta << " " << meta.second.u64b[i];     break;
+            _entries.swap(entries);
+            _read = 0;
+            reindex();
 
-                    case paxMetaDataTypes_e::paxInt32:      ssmeta << " " << meta.second.n32b[i];     break;
+            PAX_LOG(1, << "Loaded catalog of " << _entries.size() << " files");
 
-                    case paxMetaDataTypes_e::paxUint32:     ssmeta << " " << meta.second.u32b[i];     break;
+            return PAX_OK;
 
-                    case paxMetaDataTypes_e::paxInt16:      ssmeta << " " << meta.second.n16b[i];     break;
+        } // int load(const pax_filestring & fileName)
 
-                    case paxMetaDataTypes_e::paxUint16:     ssmeta << " " << meta.second.u16b[i];     break;
+/************************************************************************************************************
+ * Number of files in the catalog.
+ * @return          file count
+ ***********************************************************************************************************/
+        size_t size() { return _entries.size(); }
 
-                    case paxMetaDataTypes_e::paxInt8:       ssmeta << " " << +meta.second.n8b[i];     break;
+/************************************************************************************************************
+ * An entry of the catalog. Entries are sorted by path.
+ * @param[in]       n       Entry index
+ * @return          the entry
+ ***********************************************************************************************************/
+        const paxCatalogEntry_t & entry(size_t n) { return _entries[n]; }
 
-                    case paxMetaDataTypes_e::paxUint8:      ssmeta << " " << +meta.second.u8b[i];     break;
+/************************************************************************************************************
+ * Number of headers the last scan() had to read.
+ * @return          header count
+ ***********************************************************************************************************/
+        size_t getRead() { return _read; }
 
-                    default: continue;
+/************************************************************************************************************
+ * Finds the files whose numeric metadata lies in a range.
+ * @param[in]       name    Metadata name
+ * @param[in]       lo      Lowest value, inclusive
+ * @param[in]       hi      Highest value, inclusive
+ * @return          indexes of the entries found, ascending
+ ***********************************************************************************************************/
+        std::vector<size_t> find(const std::string & name, double lo, double hi) {
 
-                    } // switch (type)
+            std::vector<size_t> found;
+            auto values = _ranges.find(name);
+            if (values == _ranges.end()) {
+                return found;
+            }
 
-                } // for (uin32_t i = 0; i < count; ++i)
+            auto it = std::lower_bound(values->second.begin(), values->second.end(), std::make_pair(lo, (size_t)0));
+            for (; it != values->second.end() && it->first <= hi; ++it) {
+                found.push_back(it->second);
+            }
+            std::sort(found.begin(), found.end());
 
-                ss << ssmeta.str() << "\n";
+            return found;
 
-            } // for (auto meta : metavec) 
+        } // std::vector<size_t> find(const std::string & name, double lo, double hi)
 
-            return PAX_OK;
-        }
+/************************************************************************************************************
+ * Finds the files whose metadata has the given value, as text.
+ * @param[in]       name    Metadata name
+ * @param[in]       value   Value
+ * @return          indexes of the entries found, ascending
+ ***********************************************************************************************************/
+        std::vector<size_t> find(const std::string & name, const std::string & value) {
 
+            std::vector<size_t> found;
+            for (size_t n = 0; n < _entries.size(); ++n) {
+                auto meta = _entries[n].meta.find(name);
+                if (meta != _entries[n].meta.end() && meta->second.value == value) {
+                    found.push_back(n);
+                }
+            }
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // output PAX file to buffer
-        //
-        int writeToBuffer(paxBufPtr &outBuf) {
+            return found;
 
-            pax_stringstream ss;
-            size_t _bpv = bpv();
-            size_t _vpe = vpe();
-            size_t dataLen = _bpv * _vpe * _numSequential * _numStrided;
-            int32_t metaLoc = LOC_UNKNOWN;
+        } // std::vector<size_t> find(const std::string & name, const std::string & value)
 
-            auto meta = getMetaVecs();
+    private:
+/************************************************************************************************************
+ * Reads the header of one file into its entry.
+ ***********************************************************************************************************/
+        static int readEntry(const std::filesystem::path & path, paxCatalogEntry_t & entry) {
 
-            // write file ID line
-            ss << PAX_TAG << (int)_dataType << " : v" << std::fixed << std::setprecision(2) << _version << " : " << getTypeName() << '\n';
-            PAX_LOG(3, << "typeName = " << getTypeName().c_str());
-            PAX_LOG(3, << "version = " << _version);
+            PaxHeader header;
+            rasterFileBase & raster = header.raster();
+            if (PAX_OK != raster.preview(fileString(path), true, &entry.headerLength)) {
+                PAX_LOG_WARN(1, << "Not cataloging " << entry.path << ": no valid PAX header");
+                return PAX_FAIL;
+            }
 
-            ss.unsetf(std::ios::floatfield);
+            entry.type = header.type();
+            entry.dims = header.dims();
+            entry.dataLength = raster.getPayloadLength();
+            for (auto & meta : raster.getMetaRef()) {
+                paxCatalogMeta_t value;
+                if (metaValue(meta.second, value)) {
+                    entry.meta.emplace(meta.first, std::move(value));
+                } else {
+                    entry.skipped.push_back(meta.first);
+                }
+            }
+            std::sort(entry.skipped.begin(), entry.skipped.end());
 
-            metaLoc = LOC_AFTER_TAG;
-            std::vector<std::pair<std::string, meta_t>> &metavec = (*meta)[metaLoc];
-            PAX_LOG(3, << "writing " << metavec.size() << " metadata lines at location " << metaLoc);
-            writeMeta(ss, metavec);
+            return PAX_OK;
 
-            ss << BPV_TAG << " : " << _bpv << '\n';
+        } // static int readEntry(const std::filesystem::path & path, paxCatalogEntry_t & entry)
 
-            metaLoc = LOC_AFTER_BPV;
-            metavec = (*meta)[metaLoc];
-            PAX_LOG(3, << "writing " << metavec.size() << " metadata lines at location " << metaLoc);
-            writeMeta(ss, metavec);
+/************************************************************************************************************
+ * Records a scalar metadata value; false for arrays and comments.
+ ***********************************************************************************************************/
+        static bool metaValue(meta_t & meta, paxCatalogMeta_t & out) {
 
-            ss << VPE_TAG << " : " << _vpe << '\n';
+            if (meta.isArray()) {
+                return false;
+            }
 
-            metaLoc = LOC_AFTER_VPE;
-            metavec = (*meta)[metaLoc];
-            PAX_LOG(3, << "writing " << metavec.size() << " metadata lines at location " << metaLoc);
-            writeMeta(ss, metavec);
-            ss << DIM1_TAG << " : " << _numSequential << '\n';
+            auto number = [&out](auto val) {
+                rasterFileBase::appendNumber(out.value, val);
+                out.number = (double)val;
+            };
 
-            metaLoc = LOC_AFTER_SEQ;
-            metavec = (*meta)[metaLoc];
-            PAX_LOG(3, << "writing " << metavec.size() << " metadata lines at location " << metaLoc);
-            writeMeta(ss, metavec);
-            ss << DIM2_TAG << " : " << _numStrided << '\n';
+            switch (meta.type) {
+            case paxMetaDataTypes_e::paxString:
+                out.value = meta.s;
+                out.number = std::numeric_limits<double>::quiet_NaN();
+                break;
+            case paxMetaDataTypes_e::paxFloat:  number(meta.f);   break;
+            case paxMetaDataTypes_e::paxDouble: number(meta.d);   break;
+            case paxMetaDataTypes_e::paxInt64:  number(meta.n64); break;
+            case paxMetaDataTypes_e::paxUint64: number(meta.u64); break;
+            case paxMetaDataTypes_e::paxInt32:  number(meta.n32); break;
+            case paxMetaDataTypes_e::paxUint32: number(meta.u32); break;
+            case paxMetaDataTypes_e::paxInt16:  number(meta.n16); break;
+            case paxMetaDataTypes_e::paxUint16: number(meta.u16); break;
+            case paxMetaDataTypes_e::paxInt8:   number((int32_t)meta.n8);  break;
+            case paxMetaDataTypes_e::paxUint8:  number((uint32_t)meta.u8); break;
+            default:
+                return false;
+            }
+            out.type = meta.type;
 
-            metaLoc = LOC_AFTER_STR1;
-            metavec = (*meta)[metaLoc];
-            PAX_LOG(3, << "writing " << metavec.size() << " metadata lines at location " << metaLoc);
-            writeMeta(ss, metavec);
+            return true;
 
-            ss << DATALEN_TAG << " : " << dataLen << '\n';
+        } // static bool metaValue(meta_t & meta, paxCatalogMeta_t & out)
 
-            std::string header = ss.str();
-            size_t headerLen = pax_strlen(header.c_str());
-            size_t bufLen = dataLen + headerLen;
+/************************************************************************************************************
+ * Sorts the entries by path and rebuilds the lookups.
+ ***********************************************************************************************************/
+        void reindex() {
 
-            PAX_LOG(1, << "Wrote to buffer: " << headerLen << " header bytes and " << dataLen << " data bytes for a total of " << bufLen << " bytes");
+            std::sort(_entries.begin(), _entries.end(), [](const paxCatalogEntry_t & a, const paxCatalogEntry_t & b) { return a.path < b.path; });
 
-            paxBufPtr buf = std::make_shared<paxBuf_t>(bufLen);
-            memcpy(buf->data(), header.c_str(), headerLen);
-            if (dataLen > 0) {
-                memcpy(buf->data() + headerLen, _buf->data(), dataLen);
+            _byPath.clear();
+            _ranges.clear();
+            for (size_t n = 0; n < _entries.size(); ++n) {
+                _byPath[_entries[n].path] = n;
+                for (const auto & meta : _entries[n].meta) {
+                    if (!std::isnan(meta.second.number)) {
+                        _ranges[meta.first].emplace_back(meta.second.number, n);
+                    }
+                }
+            }
+            for (auto & values : _ranges) {
+                std::sort(values.second.begin(), values.second.end());
             }
 
-            outBuf = buf;
-
-            return PAX_OK;
-        }
+        } // void reindex()
 
+/************************************************************************************************************
+ * Appends text as its length, a space and the bytes.
+ ***********************************************************************************************************/
+        static void appendText(std::string & out, const std::string & text) {
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // output to file
-        //
-        int writeToFile(pax_filestring fileName) {
-            PAX_LOG(1, << "Writing PAX data " << " to " << fileName);
+            rasterFileBase::appendNumber(out, (uint64_t)text.length());
+            out.push_back(' ');
+            out.append(text);
 
-            paxBufPtr buf;
-            writeToBuffer(buf);
+        } // static void appendText(std::string & out, const std::string & text)
 
-            return rasterFileBase::writeToFile(buf, fileName);
-        }
+/************************************************************************************************************
+ * Reads text written by appendText, skipping the whitespace before it.
+ ***********************************************************************************************************/
+        static bool readText(const char *& pos, const char * end, std::string & text) {
 
+            uint64_t len = 0;
+            if (!readNumber(pos, end, len) || pos == end || ' ' != *pos || len > (uint64_t)(end - pos - 1)) {
+                return false;
+            }
+            text.assign(pos + 1, len);
+            pos += len + 1;
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Basic buffer access
-        //
-        char * buf() {
-            if (!_buf) return NULL;
-            return _buf.get()->data();
-        }
+            return true;
 
+        } // static bool readText(const char *& pos, const char * end, std::string & text)
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // Read elements from the array. Accessors are defined for both X,Y and R,C
-        // indexing styles. The data is always stored column-major (i.e. X/C is the fast dim).
-        //
+/************************************************************************************************************
+ * Reads a decimal number, skipping the whitespace before it.
+ ***********************************************************************************************************/
         template <typename T>
-        T & value(uint64_t x, uint64_t y = 0) {
-            T * tbuf = (T*)buf();
-            if (NULL == tbuf || x >= _numSequential || y >= _numStrided) return *((T*)_junk);
-            uint64_t index = x + y * _numSequential;
-            return tbuf[index];
-        }
-
-        float    & floatValXY(uint64_t x, uint64_t y = 0) { return value<float>(x, y); };
-        double   & doubleValXY(uint64_t x, uint64_t y = 0) { return value<double>(x, y); };
-        int8_t   & charValXY(uint64_t x, uint64_t y = 0) { return value<int8_t>(x, y); };
-        int16_t  & shortValXY(uint64_t x, uint64_t y = 0) { return value<int16_t>(x, y); };
-        int32_t  & intValXY(uint64_t x, uint64_t y = 0) { return value<int32_t>(x, y); };
-        int64_t  & longValXY(uint64_t x, uint64_t y = 0) { return value<int64_t>(x, y); };
-        uint8_t  & ucharValXY(uint64_t x, uint64_t y = 0) { return value<uint8_t>(x, y); };
-        uint16_t & ushortValXY(uint64_t x, uint64_t y = 0) { return value<uint16_t>(x, y); };
-        uint32_t & uintValXY(uint64_t x, uint64_t y = 0) { return value<uint32_t>(x, y); };
-        uint64_t & ulongValXY(uint64_t x, uint64_t y = 0) { return value<uint64_t>(x, y); };
-        csingle  & csingleValXY(uint64_t x, uint64_t y = 0) { return value<csingle>(x, y); };
-        cdouble  & cdoubleValXY(uint64_t x, uint64_t y = 0) { return value<cdouble>(x, y); };
-        pax_float3_t & cfloat3ValXY(uint64_t x, uint64_t y = 0) { return value<pax_float3_t>(x, y); };
-
-        float    & floatValRC(uint64_t r, uint64_t c = 0) { return value<float>(c, r); };
-        double   & doubleValRC(uint64_t r, uint64_t c = 0) { return value<double>(c, r); };
-        int8_t   & charValRC(uint64_t r, uint64_t c = 0) { return value<int8_t>(c, r); };
-        int16_t  & shortValRC(uint64_t r, uint64_t c = 0) { return value<int16_t>(c, r); };
-        int32_t  & intValRC(uint64_t r, uint64_t c = 0) { return value<int32_t>(c, r); };
-        int64_t  & longValRC(uint64_t r, uint64_t c = 0) { return value<int64_t>(c, r); };
-        uint8_t  & ucharValRC(uint64_t r, uint64_t c = 0) { return value<uint8_t>(c, r); };
-        uint16_t & ushortValRC(uint64_t r, uint64_t c = 0) { return value<uint16_t>(c, r); };
-        uint32_t & uintValRC(uint64_t r, uint64_t c = 0) { return value<uint32_t>(c, r); };
-        uint64_t & ulongValRC(uint64_t r, uint64_t c = 0) { return value<uint64_t>(c, r); };
-        csingle  & csingleValRC(uint64_t r, uint64_t c = 0) { return value<csingle>(c, r); };
-        cdouble  & cdoubleValRC(uint64_t r, uint64_t c = 0) { return value<cdouble>(c, r); };
-        pax_float3_t & cfloat3ValRC(uint64_t r, uint64_t c = 0) { return value<pax_float3_t>(c, r); };
+        static bool readNumber(const char *& pos, const char * end, T & val) {
 
+            while (pos < end && (' ' == *pos || '\n' == *pos)) ++pos;
+            std::from_chars_result res = std::from_chars(pos, end, val);
+            pos = res.ptr;
 
-        //int import (
-        //  uint32_t      numSequential,
-        //  uint32_t      numStrided,
-        //  paxBufPtr     buf,
-        //  paxMetaDataPtr meta
-        //) {
-        //  _numSequential = numSequential;
-        //  _numStrided = numStrided;
-        //  return 0;
-        //};
+            return std::errc() == res.ec;
 
-        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        //
-        // private functions
-        //
+        } // static bool readNumber(const char *& pos, const char * end, T & val)
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // premature end of file error
-        //
-        void reportEOF() {
-            PAX_LOG_ERROR(1, << "premature end to PAX file found");
-        }
+/************************************************************************************************************
+ * Reads the numeric value of a metadata from its text. A float reads back as the float it was, as scan()
+ * records it.
+ ***********************************************************************************************************/
+        static bool readValue(const std::string & text, paxMetaDataTypes_e type, double & number) {
+
+            const char * end = text.data() + text.length();
+#ifdef __cpp_lib_to_chars
+            std::from_chars_result res;
+            if (paxMetaDataTypes_e::paxFloat == type) {
+                float val = 0;
+                res = std::from_chars(text.data(), end, val);
+                number = val;
+            } else {
+                res = std::from_chars(text.data(), end, number);
+            }
 
+            return std::errc() == res.ec && end == res.ptr;
+#else
+            char * stop = NULL;
+            number = (paxMetaDataTypes_e::paxFloat == type) ? (double)strtof(text.c_str(), &stop) : strtod(text.c_str(), &stop);
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // data operator access does not work because we can't infer the type at runtime
-        //
-        //E operator[](size_t idx) {
-        //  size_t x = idx % _numSequential;
-        //  size_t y = idx / _numSequential;
-        //  E val = value<E> (x, y);
-        //  return E;
-        //}
-        //E operator[](size_t x, size_t y) {
-        //  E val = value<E> (x, y);
-        //  return E;
-        //}
-        //E operator()(size_t r, size_t c) {
-        //  E val = value<E> (c, r);
-        //  return E;
-        //}
+            return !text.empty() && end == stop;
+#endif
 
+        } // static bool readValue(const std::string & text, paxMetaDataTypes_e type, double & number)
 
-        //////////////////////////////////////////////////////////////////////////
-        //
-        // metadata operator access
-        //
-        double operator[](std::string key) {
-            return getMetaDouble(key);
-        }
-        std::string operator()(std::string key) {
-            return getMetaString(key);
+/************************************************************************************************************
+ * A path as the file functions take it.
+ ***********************************************************************************************************/
+        static pax_filestring fileString(const std::filesystem::path & path) {
+#if defined(_WIN32) && defined(UNICODE)
+            return path.wstring();
+#else
+            return path.string();
+#endif
         }
 
+        std::vector<paxCatalogEntry_t>      _entries;       ///< One entry per file, sorted by path
+        std::unordered_map<std::string, size_t> _byPath;    ///< Entry index by path
+        std::unordered_map<std::string, std::vector<std::pair<double, size_t>>> _ranges;   ///< Numeric metadata by name: sorted values and their entries
+        size_t                              _read = 0;      ///< Headers read by the last scan
 
-      //////////////////////////////////////////////////////////////////////////
-      // internal data
-    protected:
-        paxBufPtr           _buf;
-        uint8_t             _junk[32];  // garbage data for accessors that have to return references
-    };  // template <paxTypes_e E> class rasterFile
-
-///@}
+    }; // class PaxCatalog
 
 } // namespace pax
 
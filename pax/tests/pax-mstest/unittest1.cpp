@@ -1,4 +1,6 @@
 #include <memory>
+#include <random>
+#include <thread>
 
 #include "../../pax/pax.h"
 
@@ -53,5 +55,1416 @@ namespace paxmstest
             Assert::AreEqual(piPrecise,     floatInFile.getMetaDouble("pi"));
         }
 
+		TEST_METHOD(mappedImport)
+		{
+            Logger::WriteMessage("Starting mappedImport");
+
+            vector<float> floatData { 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f };
+            floatRasterFile floatFile{ 3, 2, static_cast<void*>(floatData.data()) };
+            floatFile.addMetaVal("pi", 3.1416f);
+
+            string floatFileName{ "mappedFile.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToFile(floatFileName));
+
+            floatRasterFile mappedFile;
+            Assert::AreEqual(static_cast<int>(PAX_OK), mappedFile.importMapped(floatFileName));
+            Assert::AreEqual(1.5f,          mappedFile.floatValXY(0, 0));
+            Assert::AreEqual(6.5f,          mappedFile.floatValXY(2, 1));
+            Assert::AreEqual(3.1416f,       mappedFile.getMetaFloat("pi"));
+            Assert::AreEqual(static_cast<uintptr_t>(0), reinterpret_cast<uintptr_t>(mappedFile.buf()) % alignof(float));
+
+            // the mapping is private, so writes must not reach the file
+            mappedFile.floatValXY(0, 0) = -1.0f;
+            floatRasterFile fileAgain;
+            Assert::AreEqual(static_cast<int>(PAX_OK), fileAgain.import(floatFileName));
+            Assert::AreEqual(1.5f,          fileAgain.floatValXY(0, 0));
+
+            // the writer does not pad the header: data that it leaves float-aligned are used in place
+            // (at the header length into the page-aligned mapping), the others are copied
+            for (size_t padLen = 1; padLen <= 4; ++padLen) {
+                floatFile.addMetaVal("pad", string(padLen, 'x'));
+                Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToFile(floatFileName));
+                floatRasterFile padded;
+                Assert::AreEqual(static_cast<int>(PAX_OK), padded.importMapped(floatFileName));
+                Assert::AreEqual(6.5f,      padded.floatValXY(2, 1));
+                uintptr_t address = reinterpret_cast<uintptr_t>(padded.buf());
+                uint64_t headerLen = padded.importedLength() - padded.datalen();
+                Assert::AreEqual(static_cast<uintptr_t>(0), address % alignof(float));
+                Assert::AreEqual(0 == headerLen % sizeof(float), 0 == (address - headerLen) % 4096);
+            }
+            remove(floatFileName.c_str());
+        }
+
+		TEST_METHOD(streamingWriter)
+		{
+            Logger::WriteMessage("Starting streamingWriter");
+
+            const uint64_t seq = 4, strided = 4;
+            vector<float> floatData(seq * strided);
+            for (size_t i = 0; i < floatData.size(); ++i) floatData[i] = static_cast<float>(i);
+
+            // top half by rows, bottom half as two 2x2 tiles written out of order
+            string floatFileName{ "streamedFile.pax" };
+            {
+                PaxWriter<paxTypes::ePAX_FLOAT> writer{ floatFileName, seq, strided };
+                writer.header().addMetaVal("pi", 3.1416f);
+                Assert::AreEqual(static_cast<int>(PAX_OK), writer.writeRows(floatData.data(), 2));
+
+                vector<float> right{ 10.0f, 11.0f, 14.0f, 15.0f };
+                vector<float> left{ 8.0f, 9.0f, 12.0f, 13.0f };
+                Assert::AreEqual(static_cast<int>(PAX_OK), writer.writeTile(right.data(), 2, 2, 2, 2));
+                Assert::AreEqual(static_cast<int>(PAX_OK), writer.writeTile(left.data(), 0, 2, 2, 2));
+                Assert::AreEqual(static_cast<int>(PAX_OK), writer.close());
+            }
+
+            floatRasterFile streamedFile;
+            Assert::AreEqual(static_cast<int>(PAX_OK), streamedFile.import(floatFileName));
+            Assert::AreEqual(seq,           streamedFile.getNumSequential());
+            Assert::AreEqual(strided,       streamedFile.getNumStrided());
+            Assert::AreEqual(3.1416f,       streamedFile.getMetaFloat("pi"));
+            for (uint64_t y = 0; y < strided; ++y) {
+                for (uint64_t x = 0; x < seq; ++x) {
+                    Assert::AreEqual(floatData[y * seq + x], streamedFile.floatValXY(x, y));
+                }
+            }
+
+            // a short stream is reported on close
+            PaxWriter<paxTypes::ePAX_FLOAT> shortWriter{ floatFileName, seq, strided };
+            Assert::AreEqual(static_cast<int>(PAX_OK), shortWriter.writeRows(floatData.data(), 1));
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), shortWriter.close());
+
+            // overlapping tiles that add up to the full length still leave a hole
+            PaxWriter<paxTypes::ePAX_FLOAT> holeWriter{ floatFileName, seq, strided };
+            Assert::AreEqual(static_cast<int>(PAX_OK), holeWriter.writeRows(floatData.data(), 2));
+            Assert::AreEqual(static_cast<int>(PAX_OK), holeWriter.writeTile(floatData.data(), 0, 2, 2, 2));
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), holeWriter.writeTile(floatData.data(), 1, 2, 2, 2));
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), holeWriter.close());
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(largeHeader)
+		{
+            Logger::WriteMessage("Starting largeHeader");
+
+            // 8 GiB of floats: describe it without allocating, then parse the header back
+            const uint64_t seq = 1ull << 16, strided = 1ull << 15;
+            floatRasterFile bigFile;
+            bigFile.initShape(seq, strided);
+            Assert::AreEqual(seq * strided * sizeof(float), bigFile.datalen());
+
+            pax_stringstream ss;
+            bigFile.writeHeader(ss);
+            string header = ss.str();
+
+            floatRasterFile previewFile;
+            paxBufPtr headerBuf = std::make_shared<paxBuf_t>(header.length());
+            memcpy(headerBuf->data(), header.c_str(), header.length());
+            Assert::AreEqual(static_cast<int>(PAX_OK), previewFile.preview(headerBuf));
+            Assert::AreEqual(seq,           previewFile.getNumSequential());
+            Assert::AreEqual(strided,       previewFile.getNumStrided());
+            Assert::AreEqual(seq * strided, previewFile.getNumValues());
+        }
+
+		TEST_METHOD(multiDimensional)
+		{
+            Logger::WriteMessage("Starting multiDimensional");
+
+            // 4 x 3 x 2 cube, sequential first
+            floatRasterFile cubeFile{ vector<uint64_t>{ 4, 3, 2 } };
+            Assert::AreEqual(static_cast<size_t>(3), cubeFile.getNumDims());
+            Assert::AreEqual(static_cast<uint64_t>(24), cubeFile.getNumElements());
+            Assert::AreEqual(static_cast<uint64_t>(6), cubeFile.getNumRows());
+            Assert::AreEqual(static_cast<uint64_t>(12), cubeFile.getStrides()[2]);
+            for (uint64_t z = 0; z < 2; ++z) {
+                for (uint64_t y = 0; y < 3; ++y) {
+                    for (uint64_t x = 0; x < 4; ++x) {
+                        cubeFile.floatValAt({ x, y, z }) = static_cast<float>(100 * z + 10 * y + x);
+                    }
+                }
+            }
+
+            string cubeFileName{ "cubeFile.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), cubeFile.writeToFile(cubeFileName));
+
+            floatRasterFile cubeAgain;
+            Assert::AreEqual(static_cast<int>(PAX_OK), cubeAgain.import(cubeFileName));
+            Assert::AreEqual(static_cast<size_t>(3), cubeAgain.getNumDims());
+            Assert::AreEqual(static_cast<uint64_t>(2), cubeAgain.getDim(2));
+            Assert::AreEqual(123.0f,        cubeAgain.floatValAt({ 3, 2, 1 }));
+            Assert::AreEqual(12.0f,         cubeAgain.floatValAt({ 2, 1 }));
+
+            // every legal spelling of a dimension tag parses to the same index
+            uint64_t index = 0;
+            Assert::IsTrue(PaxStatic::parseDimTag("ELEMENTS_IN_THIRD_DIMENSION : 2", index) > 0);
+            Assert::AreEqual(static_cast<uint64_t>(2), index);
+            Assert::IsTrue(PaxStatic::parseDimTag("elements_in_3rd_dimension : 2", index) > 0);
+            Assert::AreEqual(static_cast<uint64_t>(2), index);
+            Assert::IsTrue(PaxStatic::parseDimTag("ELEMENTS_IN_FOURTEENTH_DIMENSION : 2", index) > 0);
+            Assert::AreEqual(static_cast<uint64_t>(13), index);
+            Assert::IsTrue(PaxStatic::parseDimTag("ELEMENTS_IN_112TH_DIMENSION : 2", index) > 0);
+            Assert::AreEqual(static_cast<uint64_t>(111), index);
+            Assert::AreEqual(static_cast<size_t>(0), PaxStatic::parseDimTag("ELEMENTS_IN_2ST_DIMENSION : 2", index));
+            Assert::AreEqual(string("ELEMENTS_IN_21ST_DIMENSION"), PaxStatic::getDimTag(20));
+
+            // ordinals and shapes that overflow 64 bits are rejected rather than wrapped
+            Assert::AreEqual(static_cast<size_t>(0), PaxStatic::parseDimTag("ELEMENTS_IN_18446744073709551617ST_DIMENSION : 2", index));
+            string header = "PAX109 : v1.00 : PAX_FLOAT\nBYTES_PER_VALUE : 4\nVALUES_PER_ELEMENT : 1\n"
+                            "ELEMENTS_IN_SEQUENTIAL_DIMENSION : 4\nELEMENTS_IN_STRIDED_DIMENSION : 4611686018427387905\n"
+                            "DATA_LENGTH : 16\n";
+            paxBufPtr headerBuf = make_shared<paxBuf_t>(header.length());
+            memcpy(headerBuf->data(), header.c_str(), header.length());
+            floatRasterFile hugeFile;
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), hugeFile.preview(headerBuf));
+            Assert::AreEqual(static_cast<uint64_t>(0), hugeFile.getNumElements());
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(templatedEngine)
+		{
+            Logger::WriteMessage("Starting templatedEngine");
+
+            // typed scalar raster: write through the unchecked accessors, round-trip through a file
+            PaxScalar<float> scalar{ vector<paxDim_t>{ 3, 2 } };
+            Assert::AreEqual(static_cast<size_t>(6), scalar.elements());
+            for (size_t i = 0; i < scalar.elements(); ++i) scalar[i] = 0.5f * i;
+            scalar.at(2, 1) = 42.0f;
+            scalar.header().raster().addMetaVal("pi", 3.1416f);
+
+            string scalarFileName{ "scalarFile.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), scalar.writeToFile(scalarFileName));
+
+            // the engine and rasterFile read each other's files
+            floatRasterFile legacy;
+            Assert::AreEqual(static_cast<int>(PAX_OK), legacy.import(scalarFileName));
+            Assert::AreEqual(1.0f,          legacy.floatValXY(2, 0));
+            Assert::AreEqual(42.0f,         legacy.floatValXY(2, 1));
+
+            PaxScalar<float> scalarAgain{ scalarFileName };
+            Assert::AreEqual(static_cast<size_t>(3), scalarAgain.getDims()[0]);
+            Assert::AreEqual(42.0f,         scalarAgain.at({ 2, 1 }));
+            Assert::AreEqual(3.1416f,       scalarAgain.header().raster().getMetaFloat("pi"));
+
+            // a type with a different PAX tag is rejected, an untyped raster of the same size is not
+            PaxScalar<int32_t> wrongType;
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), wrongType.importFile(scalarFileName));
+            Pax<4, 1> untyped;
+            Assert::AreEqual(static_cast<int>(PAX_OK), untyped.importFile(scalarFileName));
+            Assert::IsTrue(paxTypes::ePAX_FLOAT == untyped.type());
+
+            // vector raster with interleaved values
+            PaxVector<float, 3> vec{ vector<paxDim_t>{ 2, 2 } };
+            vec.at(3, 2) = 7.0f;
+            paxBufPtr vecBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), vec.writeToBuffer(vecBuf));
+            PaxVector<float, 3> vecAgain;
+            PaxBuf inBuf(vecBuf);
+            Assert::AreEqual(static_cast<int>(PAX_OK), vecAgain.import(inBuf));
+            Assert::AreEqual(7.0f,          vecAgain[3][2]);
+        }
+
+		TEST_METHOD(lazyMetadata)
+		{
+            Logger::WriteMessage("Starting lazyMetadata");
+
+            vector<float> floatData{ 1.0f, 2.0f, 3.0f, 4.0f };
+            floatRasterFile floatFile{ 2, 2, static_cast<void*>(floatData.data()) };
+            floatFile.addMetaVal("pi", 3.1416f);
+            floatFile.addMetaVal("e", 2.718281828459045);
+            floatFile.addMetaVal("name", string("lazy raster"));
+            floatFile.addComment("a comment");
+            paxBufPtr floatBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(floatBuf));
+
+            // values are only indexed on import and decoded when first requested
+            floatRasterFile lazyFile;
+            lazyFile.setLazyMeta(true);
+            Assert::AreEqual(static_cast<int>(PAX_OK), lazyFile.import(floatBuf));
+            Assert::AreEqual(static_cast<size_t>(4), lazyFile.getPendingMetaCount());
+            Assert::AreEqual(3.1416f,       lazyFile.getMetaFloat("pi"));
+            Assert::AreEqual(static_cast<size_t>(3), lazyFile.getPendingMetaCount());
+            Assert::AreEqual(string("lazy raster"), lazyFile.getMetaString("name"));
+            Assert::AreEqual(4.0f,          lazyFile.floatValXY(1, 1));
+
+            // a pending entry is replaced, not decoded, when overwritten
+            lazyFile.addMetaVal("e", 2.5f);
+            Assert::AreEqual(static_cast<size_t>(1), lazyFile.getPendingMetaCount());
+
+            // writing decodes everything still pending
+            paxBufPtr lazyBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), lazyFile.writeToBuffer(lazyBuf));
+            Assert::AreEqual(static_cast<size_t>(0), lazyFile.getPendingMetaCount());
+
+            floatRasterFile eagerFile;
+            Assert::AreEqual(static_cast<int>(PAX_OK), eagerFile.import(lazyBuf));
+            Assert::AreEqual(3.1416f,       eagerFile.getMetaFloat("pi"));
+            Assert::AreEqual(2.5f,          eagerFile.getMetaFloat("e"));
+            Assert::AreEqual(string("lazy raster"), eagerFile.getMetaString("name"));
+            Assert::AreEqual(static_cast<size_t>(4), eagerFile.meta()->size());
+        }
+
+		TEST_METHOD(compactMetadata)
+		{
+            Logger::WriteMessage("Starting compactMetadata");
+
+            // scalars no longer carry inline string storage
+            Assert::IsTrue(sizeof(meta_t) < PAX_MAX_METADATA_STRING_LENGTH / 2);
+
+            vector<int32_t> gridData{ 1, 2, 3, 4, 5, 6 };
+            meta_t grid{ paxMetaDataTypes::paxInt32, { 2, 3 }, gridData.data() };
+
+            vector<float> floatData{ 1.0f, 2.0f, 3.0f, 4.0f };
+            floatRasterFile floatFile{ 2, 2, static_cast<void*>(floatData.data()) };
+            floatFile.addMeta("grid", grid);
+            floatFile.addMetaVal("name", string("compact"));
+            floatFile.addMetaVal("count", static_cast<uint16_t>(7));
+
+            // stored arrays are copied into the file's arena, and copies get storage of their own
+            meta_t * stored = floatFile.findMeta("grid");
+            Assert::IsTrue(grid.arena != stored->arena);
+            meta_t copy = *stored;
+            Assert::IsTrue(copy.bufPtr() != stored->bufPtr());
+            copy.n32b[5] = 60;
+            Assert::AreEqual(6, static_cast<int>(stored->n32b[5]));
+            meta_t assigned;
+            assigned = copy;
+            assigned.n32b[5] = 600;
+            Assert::AreEqual(60, static_cast<int>(copy.n32b[5]));
+            Assert::AreEqual(6, static_cast<int>(stored->n32b[5]));
+
+            paxBufPtr floatBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(floatBuf));
+
+            floatRasterFile inFile;
+            Assert::AreEqual(static_cast<int>(PAX_OK), inFile.import(floatBuf));
+            PaxStatic::setStatus(PAX_OK);   // array access checks the sticky status
+            Assert::AreEqual(6,             static_cast<int>(inFile.getMetaInt32("grid", { 1, 2 })));
+            Assert::AreEqual(string("compact"), inFile.getMetaString("name"));
+            Assert::AreEqual(7,             static_cast<int>(inFile.getMetaUint16("count")));
+            Assert::IsTrue(inFile.findMeta("grid")->arena == inFile.findMeta("name")->arena);
+
+            // names are interned once for every file
+            Assert::IsTrue(&floatFile.meta()->find("name")->first.str() == &inFile.meta()->find("name")->first.str());
+
+            // looking up unknown names does not intern them
+            size_t interned = PaxMetaName::count();
+            for (int i = 0; i < 100; ++i) {
+                Assert::IsNull(inFile.findMeta("missing" + to_string(i)));
+            }
+            Assert::AreEqual(interned, PaxMetaName::count());
+
+            // a converted copy moves the metadata into its own arena
+            string compactName{ "compactFile.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToFile(compactName));
+            floatRasterFile convFile;
+            Assert::AreEqual(static_cast<int>(PAX_OK), convFile.importConverted(compactName));
+            remove(compactName.c_str());
+            convFile.addMetaVal("extra", string("local"));
+            Assert::IsTrue(convFile.findMeta("grid")->arena == convFile.findMeta("extra")->arena);
+
+            // replaced payloads are reclaimed by compacting the arena
+            for (int i = 0; i < 1000; ++i) {
+                floatFile.addMetaVal("note", string(200, static_cast<char>('a' + i % 26)));
+            }
+            Assert::IsTrue(floatFile.findMeta("note")->arena->bytes() < 8 * PaxMetaArena::CHUNK_SIZE);
+            Assert::AreEqual(string(200, static_cast<char>('a' + 999 % 26)), floatFile.getMetaString("note"));
+            Assert::AreEqual(6,             static_cast<int>(floatFile.getMetaInt32("grid", { 1, 2 })));
+            Assert::AreEqual(string("compact"), floatFile.getMetaString("name"));
+        }
+
+		TEST_METHOD(headerLineClassifier)
+		{
+            Logger::WriteMessage("Starting headerLineClassifier");
+
+            uint64_t index = 0;
+            Assert::IsTrue(hlType_t::PAX      == PaxStatic::classifyHeaderLine("PAX109 : v1.00", index));
+            Assert::IsTrue(hlType_t::BPV      == PaxStatic::classifyHeaderLine("bytes_per_value : 4", index));
+            Assert::IsTrue(hlType_t::VPE      == PaxStatic::classifyHeaderLine("VALUES_PER_ELEMENT : 1", index));
+            Assert::IsTrue(hlType_t::DATALEN  == PaxStatic::classifyHeaderLine("DATA_LENGTH : 16", index));
+            Assert::IsTrue(hlType_t::COMMENT  == PaxStatic::classifyHeaderLine("# note", index));
+            Assert::IsTrue(hlType_t::METADATA == PaxStatic::classifyHeaderLine("@ [float] pi = 3", index));
+
+            Assert::IsTrue(hlType_t::DIM      == PaxStatic::classifyHeaderLine("ELEMENTS_IN_STRIDED_DIMENSION : 2", index));
+            Assert::AreEqual(static_cast<uint64_t>(1), index);
+            Assert::IsTrue(hlType_t::DIM      == PaxStatic::classifyHeaderLine("elements_in_fourteenth_dimension : 2", index));
+            Assert::AreEqual(static_cast<uint64_t>(13), index);
+            Assert::IsTrue(hlType_t::DIM      == PaxStatic::classifyHeaderLine("ELEMENTS_IN_21ST_DIMENSION : 2", index));
+            Assert::AreEqual(static_cast<uint64_t>(20), index);
+
+            Assert::IsTrue(hlType_t::UNKNOWN  == PaxStatic::classifyHeaderLine("ELEMENTS_IN_OTHER_DIMENSION : 2", index));
+            Assert::IsTrue(hlType_t::UNKNOWN  == PaxStatic::classifyHeaderLine("BYTES : 4", index));
+            Assert::IsTrue(hlType_t::UNKNOWN  == PaxStatic::classifyHeaderLine("XYZ", index));
+        }
+
+		TEST_METHOD(numericParsing)
+		{
+            Logger::WriteMessage("Starting numericParsing");
+
+            // the last value is cut short by the buffer length, not by the text
+            char text[] = "0x1F -1 2.5e3 +7 \n 8 9.25 123456";
+            BufMan buf(text, sizeof(text) - 4);
+            Assert::AreEqual(31,            static_cast<int>(buf.getInt32(skipFlags::SKIP_NOTHING)));
+            Assert::AreEqual(0xFFFFFFFFu,   buf.getUint32(skipFlags::SKIP_NOTHING));
+            Assert::AreEqual(2500.0,        buf.getDouble(skipFlags::SKIP_NOTHING));
+            Assert::AreEqual(static_cast<int64_t>(7), buf.getInt64(skipFlags::SKIP_NOTHING));
+            Assert::AreEqual(8,             static_cast<int>(buf.getUint8(skipFlags::SKIP_NOTHING)));
+            Assert::AreEqual(9.25f,         buf.getFloat(skipFlags::SKIP_NOTHING));
+            Assert::AreEqual(static_cast<uint64_t>(123), buf.getUint64(skipFlags::SKIP_NOTHING));
+
+            // array-heavy metadata survives a round trip
+            vector<double> values(64);
+            for (size_t i = 0; i < values.size(); ++i) values[i] = 0.1 * static_cast<double>(i) - 3.0;
+            meta_t arr{ paxMetaDataTypes::paxDouble, { 8, 8 }, values.data() };
+            vector<float> floatData{ 1.0f, 2.0f, 3.0f, 4.0f };
+            floatRasterFile floatFile{ 2, 2, static_cast<void*>(floatData.data()) };
+            floatFile.addMeta("values", arr);
+            paxBufPtr floatBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(floatBuf));
+
+            floatRasterFile inFile;
+            Assert::AreEqual(static_cast<int>(PAX_OK), inFile.import(floatBuf));
+            meta_t * found = inFile.findMeta("values");
+            Assert::IsTrue(NULL != found);
+            for (size_t i = 0; i < values.size(); ++i) {
+                Assert::AreEqual(values[i], found->db[i], 1e-12);
+            }
+
+            // parsing stops at the end of a buffer that is cut short anywhere in the header
+            string header(floatBuf->data(), floatBuf->size());
+            size_t headerLen = header.find('\n', header.find("DATA_LENGTH")) + 1;
+            for (size_t len = 1; len < headerLen; ++len) {
+                paxBufPtr cut = make_shared<paxBuf_t>(len);
+                memcpy(cut->data(), header.data(), len);
+                floatRasterFile cutFile;
+                cutFile.import(cut);
+                floatRasterFile lazyFile;
+                lazyFile.setLazyMeta(true);
+                lazyFile.import(cut);
+                lazyFile.findMeta("values");
+            }
+            PaxStatic::setStatus(PAX_OK);
+
+            // an array too large to fit in the buffer is skipped, not allocated
+            header.replace(header.find("second = 8"), 10, "second = 4000000000");
+            paxBufPtr huge = make_shared<paxBuf_t>(header.size());
+            memcpy(huge->data(), header.data(), header.size());
+            floatRasterFile hugeFile;
+            hugeFile.import(huge);
+            Assert::IsTrue(NULL == hugeFile.findMeta("values"));
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(exactMetadataWrite)
+		{
+            Logger::WriteMessage("Starting exactMetadataWrite");
+
+            // values that need all 17 significant digits to read back exactly
+            vector<double> values{ 0.1 + 0.2, 1.0 / 3.0, -3.2969999999999997, 1e-300, 6.02214076e23 };
+            meta_t arr{ paxMetaDataTypes::paxDouble, { 5 }, values.data() };
+
+            vector<float> floatData{ 1.0f, 2.0f, 3.0f, 4.0f };
+            floatRasterFile floatFile{ 2, 2, static_cast<void*>(floatData.data()) };
+            floatFile.addMeta("values", arr);
+            floatFile.addMetaVal("third", 1.0f / 3.0f);
+            floatFile.addMetaVal("big", static_cast<uint64_t>(18446744073709551615ull));
+            floatFile.addMetaVal("small", static_cast<int8_t>(-128));
+            paxBufPtr floatBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(floatBuf));
+
+            // floats are written in their shortest exact form
+            string header(floatBuf->data(), floatBuf->size() - 16);
+            Assert::IsTrue(string::npos != header.find("@ [float]    third = 0.33333334\n"));
+
+            floatRasterFile inFile;
+            Assert::AreEqual(static_cast<int>(PAX_OK), inFile.import(floatBuf));
+            meta_t * found = inFile.findMeta("values");
+            for (size_t i = 0; i < values.size(); ++i) {
+                Assert::AreEqual(values[i], found->db[i]);
+            }
+            Assert::AreEqual(1.0f / 3.0f,   inFile.getMetaFloat("third"));
+            Assert::AreEqual(static_cast<uint64_t>(18446744073709551615ull), inFile.getMetaUint64("big"));
+            Assert::AreEqual(-128,          static_cast<int>(inFile.getMetaInt8("small")));
+        }
+
+		TEST_METHOD(perThreadContext)
+		{
+            Logger::WriteMessage("Starting perThreadContext");
+
+            vector<float> floatData{ 1.0f, 2.0f, 3.0f, 4.0f };
+            floatRasterFile floatFile{ 2, 2, static_cast<void*>(floatData.data()) };
+            floatFile.addMetaVal("pi", 3.1416f);
+            paxBufPtr floatBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(floatBuf));
+            PaxStatic::setStatus(PAX_OK);
+
+            // odd threads fail a lookup; the failure stays on that thread
+            const int numThreads = 4;
+            vector<int> status(numThreads);
+            vector<string> lastError(numThreads);
+            vector<thread> threads;
+            for (int t = 0; t < numThreads; ++t) {
+                threads.emplace_back([&, t]() {
+                    for (int i = 0; i < 50; ++i) {
+                        // each importer parses its own copy, as it would its own file
+                        paxBufPtr inBuf = make_shared<paxBuf_t>(floatBuf->size());
+                        memcpy(inBuf->data(), floatBuf->data(), floatBuf->size());
+                        floatRasterFile inFile;
+                        inFile.import(inBuf);
+                        inFile.getMetaFloat((t & 1) ? "missing" : "pi");
+                    }
+                    status[t] = PaxStatic::getStatus();
+                    lastError[t] = PaxStatic::getLastError();
+                });
+            }
+            for (auto & th : threads) th.join();
+
+            for (int t = 0; t < numThreads; ++t) {
+                Assert::AreEqual(static_cast<int>((t & 1) ? PAX_FAIL : PAX_OK), status[t]);
+                Assert::AreEqual((t & 1) != 0, string::npos != lastError[t].find("missing"));
+            }
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxStatic::getStatus());
+
+            // an explicit context collects the status of everything run in its scope
+            PaxContext context;
+            {
+                PaxContext::Scope scope(context);
+                floatFile.getMetaFloat("missing");
+            }
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), context.status);
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxStatic::getStatus());
+        }
+
+		TEST_METHOD(logLevels)
+		{
+            Logger::WriteMessage("Starting logLevels");
+
+            Assert::IsTrue(PAX_MAX_LOG_LEVEL >= 0);
+
+            PaxStatic::setVerbosity(2);
+            Assert::IsTrue(PaxContext::logEnabled(2));
+            Assert::IsFalse(PaxContext::logEnabled(3));
+
+            // the ceiling follows the highest verbosity still in use
+            PaxStatic::setVerbosity(0);
+            Assert::IsTrue(PaxContext::logEnabled(0));
+            Assert::IsFalse(PaxContext::logEnabled(1));
+            Assert::IsTrue(PaxContext::logCeiling().load() < 2);
+            {
+                PaxContext context;
+                context.setLevel(3);
+                Assert::AreEqual(3, PaxContext::logCeiling().load());
+                Assert::IsFalse(PaxContext::logEnabled(3));
+            }
+            Assert::IsTrue(PaxContext::logCeiling().load() < 2);
+
+            // contexts coming and going on several threads leave the ceiling where it was
+            vector<thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([]() {
+                    for (int i = 0; i < 1000; ++i) {
+                        PaxContext context;
+                        context.setLevel(1 + i % 4);
+                    }
+                });
+            }
+            for (auto & th : threads) th.join();
+            Assert::IsTrue(PaxContext::logCeiling().load() < 2);
+
+            // error messages are formatted into a fixed buffer and truncated, not grown
+            PAX_LOG_ERROR(1, << "bad value " << 42 << " at " << 1.5);
+            Assert::AreEqual(string("bad value 42 at 1.5"), PaxStatic::getLastError());
+            PAX_LOG_ERROR(1, << string(2000, 'x'));
+            Assert::IsTrue(PaxStatic::getLastError().length() < 2000);
+            Assert::AreEqual(string::npos, PaxStatic::getLastError().find_first_not_of('x'));
+
+            // the chain is evaluated once even when the error is also logged, and errno is read first
+            PaxStatic::setVerbosity(1);
+            int evaluated = 0;
+            PAX_LOG_ERROR(1, << "evaluated " << ++evaluated);
+            Assert::AreEqual(1, evaluated);
+            errno = EINVAL;
+            PAX_LOG_ERRNO(1, << " then " << (errno = 0));
+            Assert::AreEqual(to_string(EINVAL) + " then 0", PaxStatic::getLastError());
+            PaxStatic::setVerbosity(0);
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+
+		TEST_METHOD(batchImport)
+		{
+            Logger::WriteMessage("Starting batchImport");
+
+            // alternate float and int rasters, each holding its own index
+            const int numFiles = 24;
+            vector<paxBufPtr> bufs;
+            for (int n = 0; n < numFiles; ++n) {
+                paxBufPtr buf;
+                if (n & 1) {
+                    vector<int32_t> intData{ n, -n };
+                    rasterFile<paxTypes::ePAX_INT> intFile{ 2, 1, static_cast<void*>(intData.data()) };
+                    Assert::AreEqual(static_cast<int>(PAX_OK), intFile.writeToBuffer(buf));
+                } else {
+                    vector<float> floatData{ n * 0.5f, 1.0f };
+                    floatRasterFile floatFile{ 2, 1, static_cast<void*>(floatData.data()) };
+                    Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(buf));
+                }
+                bufs.push_back(buf);
+            }
+            paxBufPtr badBuf = make_shared<paxBuf_t>(bufs[0]->size());
+            memcpy(badBuf->data(), bufs[0]->data(), bufs[0]->size());
+            badBuf->data()[0] = 'X';
+            bufs[5] = badBuf;
+            PaxStatic::setStatus(PAX_OK);
+
+            PaxThreadPool pool(4);
+            vector<rasterFileBasePtr> files = rasterFileBase::importBatch(bufs, pool);
+            Assert::AreEqual(static_cast<size_t>(numFiles), files.size());
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), PaxStatic::getStatus());
+            Assert::IsTrue(string::npos != PaxStatic::getLastError().find("batch entry 5"));
+            Assert::IsTrue(nullptr == files[5]);
+
+            for (int n = 0; n < numFiles; ++n) {
+                if (5 == n) continue;
+                if (n & 1) {
+                    auto intFile = dynamic_pointer_cast<rasterFile<paxTypes::ePAX_INT>>(files[n]);
+                    Assert::IsTrue(nullptr != intFile);
+                    Assert::AreEqual(n, intFile->intValXY(0));
+                    Assert::AreEqual(-n, intFile->intValXY(1));
+                } else {
+                    auto floatFile = dynamic_pointer_cast<floatRasterFile>(files[n]);
+                    Assert::IsTrue(nullptr != floatFile);
+                    Assert::AreEqual(n * 0.5f, floatFile->floatValXY(0));
+                }
+            }
+            PaxStatic::setStatus(PAX_OK);
+
+            // several rasters in one buffer, typed from their tags
+            paxBufPtr multiBuf = rasterFileBase::writeMultiple(vector<rasterFileBase*>{ files[0].get(), files[1].get() });
+            vector<rasterFileBasePtr> multi = rasterFileBase::importMultiple(2, multiBuf);
+            Assert::IsTrue(paxTypes::ePAX_FLOAT == multi[0]->getType());
+            Assert::IsTrue(paxTypes::ePAX_INT == multi[1]->getType());
+
+            // an import that throws fails its own entry, not the pool
+            struct SmallOnly : PaxAllocator {
+                paxBlock_t allocate(uint64_t len) override {
+                    if (len > 4096) throw bad_alloc();
+                    return PaxAllocator::allocate(len);
+                }
+            } smallOnly;
+            vector<float> bigData(64 * 64, 1.0f);
+            floatRasterFile bigFile{ 64, 64, static_cast<void*>(bigData.data()) };
+            string bigName{ "batchBig.pax" };
+            string smallName{ "batchSmall.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), bigFile.writeToFile(bigName));
+            Assert::AreEqual(static_cast<int>(PAX_OK), dynamic_pointer_cast<floatRasterFile>(files[0])->writeToFile(smallName));
+            PaxAllocator::setDefault(&smallOnly);
+            vector<rasterFileBasePtr> thrown = rasterFileBase::importBatch(vector<pax_filestring>{ smallName, bigName, smallName }, pool);
+            PaxAllocator::setDefault(NULL);
+            remove(bigName.c_str());
+            remove(smallName.c_str());
+            Assert::IsTrue(nullptr != thrown[0] && nullptr != thrown[2]);
+            Assert::IsTrue(nullptr == thrown[1]);
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), PaxStatic::getStatus());
+            Assert::IsTrue(string::npos != PaxStatic::getLastError().find("batch entry 1"));
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(bundleTableOfContents)
+		{
+            Logger::WriteMessage("Starting bundleTableOfContents");
+
+            vector<float> floatData{ 1.5f, 2.5f, 3.5f, 4.5f };
+            floatRasterFile floatFile{ 2, 2, static_cast<void*>(floatData.data()) };
+            floatFile.addMetaVal("frame", 0);
+            vector<int32_t> intData{ 9, 10, 32 };
+            rasterFile<paxTypes::ePAX_INT> intFile{ 3, 1, static_cast<void*>(intData.data()) };
+            vector<uint8_t> ucharData{ 1, 2, 3, 4, 5, 6, 7, 8 };
+            ucharRasterFile ucharFile{ vector<uint64_t>{ 2, 2, 2 }, static_cast<void*>(ucharData.data()) };
+            vector<rasterFileBase*> rasters{ &floatFile, &intFile, &ucharFile };
+
+            paxBufPtr bundleBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxBundle::write(rasters, bundleBuf));
+
+            PaxBundle bundle;
+            Assert::AreEqual(static_cast<int>(PAX_OK), bundle.open(bundleBuf));
+            Assert::AreEqual(static_cast<size_t>(3), bundle.size());
+            Assert::IsTrue(paxTypes::ePAX_INT == bundle.entry(1).type);
+            Assert::AreEqual(static_cast<size_t>(3), bundle.entry(2).dims.size());
+            Assert::AreEqual(static_cast<uint64_t>(12), bundle.entry(1).length - bundle.entry(1).headerLength);
+            Assert::AreEqual(0, memcmp("PAX", bundleBuf->data() + bundle.entry(2).offset, 3));
+
+            // straight to the last raster, then a subset out of order
+            auto ucharIn = dynamic_pointer_cast<ucharRasterFile>(bundle.load(2));
+            Assert::IsTrue(nullptr != ucharIn);
+            Assert::AreEqual(static_cast<uint64_t>(8), ucharIn->getNumValues());
+            Assert::AreEqual(static_cast<uint8_t>(8), ucharIn->ucharValAt({ 1, 1, 1 }));
+
+            vector<rasterFileBasePtr> subset = bundle.load(vector<size_t>{ 1, 0 });
+            auto intIn = dynamic_pointer_cast<rasterFile<paxTypes::ePAX_INT>>(subset[0]);
+            auto floatIn = dynamic_pointer_cast<floatRasterFile>(subset[1]);
+            Assert::IsTrue(nullptr != intIn && nullptr != floatIn);
+            Assert::AreEqual(32, intIn->intValXY(2));
+            Assert::AreEqual(4.5f, floatIn->floatValXY(1, 1));
+            Assert::AreEqual(0, floatIn->getMetaInt32("frame"));
+
+            // the rasters lead the bundle, so it still reads sequentially
+            vector<rasterFileBasePtr> sequential = rasterFileBase::importMultiple(3, bundleBuf);
+            Assert::IsTrue(paxTypes::ePAX_UCHAR == sequential[2]->getType());
+
+            // from a mapped file
+            string bundleName{ "bundle.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxBundle::writeFile(rasters, bundleName));
+            PaxBundle fileBundle;
+            Assert::AreEqual(static_cast<int>(PAX_OK), fileBundle.open(bundleName));
+            vector<rasterFileBasePtr> all = fileBundle.loadAll();
+            Assert::AreEqual(static_cast<size_t>(3), all.size());
+            Assert::AreEqual(10, dynamic_pointer_cast<rasterFile<paxTypes::ePAX_INT>>(all[1])->intValXY(1));
+            remove(bundleName.c_str());
+
+            // a plain raster has no table of contents
+            paxBufPtr floatBuf;
+            floatFile.writeToBuffer(floatBuf);
+            Assert::AreEqual(static_cast<int>(PAX_INVALID), bundle.open(floatBuf));
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(regionRead)
+		{
+            Logger::WriteMessage("Starting regionRead");
+
+            // 6x4 raster in two planes, each value its own linear index
+            vector<float> floatData(6 * 4 * 2);
+            iota(floatData.begin(), floatData.end(), 0.0f);
+            floatRasterFile floatFile{ vector<uint64_t>{ 6, 4, 2 }, static_cast<void*>(floatData.data()) };
+            floatFile.addMetaVal("pi", 3.1416f);
+            string regionName{ "region.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToFile(regionName));
+
+            floatRasterFile region;
+            Assert::AreEqual(static_cast<int>(PAX_OK), region.readRegion(regionName, 1, 2, 3, 2));
+            Assert::AreEqual(static_cast<uint64_t>(3), region.getDim(0));
+            Assert::AreEqual(static_cast<uint64_t>(2), region.getDim(1));
+            Assert::AreEqual(static_cast<uint64_t>(2), region.getDim(2));
+            Assert::AreEqual(13.0f,         region.floatValAt({ 0, 0, 0 }));
+            Assert::AreEqual(21.0f,         region.floatValAt({ 2, 1, 0 }));
+            Assert::AreEqual(37.0f,         region.floatValAt({ 0, 0, 1 }));
+            Assert::AreEqual(3.1416f,       region.getMetaFloat("pi"));
+
+            // the window must lie inside the raster
+            Assert::AreEqual(static_cast<int>(PAX_INVALID), region.readRegion(regionName, 4, 0, 3, 1));
+            Assert::AreEqual(static_cast<uint64_t>(0), region.getNumValues());
+
+            // and the raster must have rows to cut from
+            string emptyHeader = "PAX109 : v1.00 : PAX_FLOAT\nBYTES_PER_VALUE : 4\nVALUES_PER_ELEMENT : 1\n"
+                                 "ELEMENTS_IN_SEQUENTIAL_DIMENSION : 4\nELEMENTS_IN_STRIDED_DIMENSION : 0\nDATA_LENGTH : 0\n";
+            paxBufPtr emptyBuf = make_shared<paxBuf_t>(emptyHeader.length());
+            memcpy(emptyBuf->data(), emptyHeader.c_str(), emptyHeader.length());
+            Assert::AreEqual(static_cast<int>(PAX_OK), rasterFileBase::writeToFile(emptyBuf, regionName));
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), region.readRegion(regionName, 0, 0, 1, 1));
+            Assert::AreEqual(static_cast<uint64_t>(0), region.getNumValues());
+            remove(regionName.c_str());
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(tiledLayout)
+		{
+            Logger::WriteMessage("Starting tiledLayout");
+
+            // 5x3 raster in 2x2 tiles: a 3x2 grid with padded edge tiles
+            const uint64_t seq = 5, rows = 3;
+            vector<float> floatData(seq * rows);
+            iota(floatData.begin(), floatData.end(), 0.0f);
+            floatRasterFile floatFile{ seq, rows, static_cast<void*>(floatData.data()) };
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.setTiling(2, 2));
+            Assert::AreEqual(static_cast<uint64_t>(3), floatFile.getTilesAcross());
+            Assert::AreEqual(static_cast<uint64_t>(2), floatFile.getTilesDown());
+            Assert::AreEqual(static_cast<uint64_t>(6 * 4 * sizeof(float)), floatFile.getFileDataLength());
+
+            paxBufPtr tiledBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(tiledBuf));
+            string header(tiledBuf->data(), tiledBuf->size() - floatFile.getFileDataLength());
+            Assert::IsTrue(string::npos != header.find("TILE_WIDTH : 2"));
+            // tile (1, 0) holds elements 2, 3 of rows 0 and 1
+            // the header length is arbitrary, so copy the values out rather than cast
+            vector<float> tiles(floatFile.getFileDataLength() / sizeof(float));
+            memcpy(tiles.data(), tiledBuf->data() + header.length(), floatFile.getFileDataLength());
+            Assert::AreEqual(2.0f,          tiles[4]);
+            Assert::AreEqual(8.0f,          tiles[7]);
+
+            floatRasterFile tiledIn;
+            Assert::AreEqual(static_cast<int>(PAX_OK), tiledIn.import(tiledBuf));
+            Assert::IsTrue(tiledIn.isTiled());
+            for (uint64_t i = 0; i < floatData.size(); ++i) {
+                Assert::AreEqual(floatData[i], tiledIn.floatValXY(i % seq, i / seq));
+            }
+            floatRasterFilePtr corner = tiledIn.tile(2, 1);
+            Assert::AreEqual(static_cast<uint64_t>(1), corner->getNumElements());
+            Assert::AreEqual(14.0f,         corner->floatValXY(0, 0));
+
+            // tiles and windows straight from the file
+            string tiledName{ "tiledFile.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToFile(tiledName));
+            floatRasterFile part;
+            Assert::AreEqual(static_cast<int>(PAX_OK), part.readTile(tiledName, 1, 0));
+            Assert::AreEqual(7.0f,          part.floatValXY(0, 1));
+            Assert::AreEqual(static_cast<int>(PAX_OK), part.readRegion(tiledName, 1, 1, 4, 2));
+            Assert::AreEqual(6.0f,          part.floatValXY(0, 0));
+            Assert::AreEqual(14.0f,         part.floatValXY(3, 1));
+
+            // streamed one grid tile at a time, out of order
+            {
+                PaxWriter<paxTypes::ePAX_FLOAT> writer{ tiledName, seq, rows };
+                Assert::AreEqual(static_cast<int>(PAX_OK), writer.setTiling(2, 2));
+                for (uint64_t j = 2; j-- > 0; ) {
+                    for (uint64_t i = 3; i-- > 0; ) {
+                        floatRasterFilePtr t = tiledIn.tile(i, j);
+                        Assert::AreEqual(static_cast<int>(PAX_OK), writer.writeTile(t->buf(), 2 * i, 2 * j, t->getNumSequential(), t->getNumRows()));
+                    }
+                }
+                Assert::AreEqual(static_cast<int>(PAX_FAIL), writer.writeTile(floatData.data(), 1, 0, 2, 2));
+                Assert::AreEqual(static_cast<int>(PAX_OK), writer.close());
+            }
+            PaxScalar<float> engine{ tiledName };
+            Assert::AreEqual(13.0f,         engine.at({ 3, 2 }));
+            remove(tiledName.c_str());
+
+            // a tile may not be larger than the raster, nor wrap the tiled length around to match DATA_LENGTH
+            Assert::AreEqual(static_cast<int>(PAX_INVALID), floatFile.setTiling(seq + 1, 1));
+            Assert::AreEqual(static_cast<uint64_t>(2), floatFile.getTileWidth());
+            string crafted{ "PAX109 : v1.00 : PAX_FLOAT\nBYTES_PER_VALUE : 4\nVALUES_PER_ELEMENT : 1\n"
+                "ELEMENTS_IN_SEQUENTIAL_DIMENSION : 256\nELEMENTS_IN_STRIDED_DIMENSION : 2\n"
+                "TILE_WIDTH : 4611686018427387904\nTILE_HEIGHT : 1\nDATA_LENGTH : 0\n" };
+            paxBufPtr craftedBuf = make_shared<paxBuf_t>(crafted.size());
+            memcpy(craftedBuf->data(), crafted.data(), crafted.size());
+            floatRasterFile craftedIn;
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), craftedIn.import(craftedBuf));
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(compressedPayload)
+		{
+            Logger::WriteMessage("Starting compressedPayload");
+
+            // the codec on its own: repetitive and random data round trip
+            vector<char> text(5000);
+            for (size_t i = 0; i < text.size(); ++i) {
+                text[i] = "abcabcabd"[i % 9];
+            }
+            vector<char> packed(PaxCodec::lzBound(text.size()));
+            uint64_t packedLen = PaxCodec::lzCompress(text.data(), text.size(), packed.data());
+            Assert::IsTrue(packedLen < text.size() / 10);
+            vector<char> unpacked(text.size());
+            Assert::AreEqual(static_cast<int64_t>(text.size()), PaxCodec::lzDecompress(packed.data(), packedLen, unpacked.data(), unpacked.size()));
+            Assert::IsTrue(text == unpacked);
+            mt19937 gen{ 17 };
+            for (auto & c : text) {
+                c = static_cast<char>(gen());
+            }
+            packed.resize(PaxCodec::lzBound(text.size()));
+            packedLen = PaxCodec::lzCompress(text.data(), text.size(), packed.data());
+            Assert::AreEqual(static_cast<int64_t>(text.size()), PaxCodec::lzDecompress(packed.data(), packedLen, unpacked.data(), unpacked.size()));
+            Assert::IsTrue(text == unpacked);
+            Assert::AreEqual(static_cast<int64_t>(-1), PaxCodec::lzDecompress(packed.data(), packedLen, unpacked.data(), unpacked.size() - 1));
+
+            // a smooth float raster, shuffled and compressed in several blocks
+            const uint64_t seq = 40, rows = 30;
+            vector<float> floatData(seq * rows);
+            for (uint64_t i = 0; i < floatData.size(); ++i) {
+                floatData[i] = 100.0f + static_cast<float>(i % seq) * 0.5f + static_cast<float>(i / seq);
+            }
+            floatRasterFile floatFile{ seq, rows, static_cast<void*>(floatData.data()) };
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.setCompression(CODEC_SHUFFLE_LZ, 1024));
+            paxBufPtr packedBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(packedBuf));
+            Assert::IsTrue(floatFile.getPayloadLength() < floatFile.datalen() / 2);
+            string header(packedBuf->data(), packedBuf->size() - floatFile.getPayloadLength());
+            Assert::IsTrue(string::npos != header.find("COMPRESSION : SHUFFLE_LZ"));
+            Assert::IsTrue(string::npos != header.find("UNCOMPRESSED_LENGTH : 4800"));
+
+            floatRasterFile packedIn;
+            Assert::AreEqual(static_cast<int>(PAX_OK), packedIn.import(packedBuf));
+            Assert::AreEqual(static_cast<int>(CODEC_SHUFFLE_LZ), static_cast<int>(packedIn.getCompression()));
+            Assert::AreEqual(0, memcmp(floatData.data(), packedIn.buf(), packedIn.datalen()));
+
+            // compressed tiles, read back a window at a time and through the engine
+            string packedName{ "packedFile.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.setTiling(16, 8));
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToFile(packedName));
+            floatRasterFile part;
+            Assert::AreEqual(static_cast<int>(PAX_OK), part.readRegion(packedName, 10, 20, 25, 10));
+            Assert::AreEqual(floatData[20 * seq + 10], part.floatValXY(0, 0));
+            Assert::AreEqual(floatData[29 * seq + 34], part.floatValXY(24, 9));
+            Assert::AreEqual(static_cast<int>(PAX_OK), part.readTile(packedName, 2, 3));
+            Assert::AreEqual(floatData[24 * seq + 32], part.floatValXY(0, 0));
+            PaxScalar<float> engine{ packedName };
+            Assert::AreEqual(floatData[7 * seq + 3], engine.at({ 3, 7 }));
+            engine.at({ 3, 7 }) = -1.0f;
+            Assert::AreEqual(static_cast<int>(PAX_OK), engine.writeToFile(packedName));
+            Assert::AreEqual(static_cast<int>(PAX_OK), packedIn.import(packedName));
+            Assert::IsTrue(packedIn.isTiled() && packedIn.isCompressed());
+            Assert::AreEqual(-1.0f,         packedIn.floatValXY(3, 7));
+            remove(packedName.c_str());
+
+            // damage is detected rather than decoded
+            packedBuf->data()[packedBuf->size() - 10] ^= 0x5a;
+            packedBuf->data()[header.length()] ^= 0x5a;
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), packedIn.import(packedBuf));
+            PaxStatic::setStatus(PAX_OK);
+
+            // a header written on its own encodes first, so its length and checksum are current
+            vector<float> freshData(256, 2.0f);
+            floatRasterFile freshFile{ 16, 16, static_cast<void*>(freshData.data()) };
+            Assert::AreEqual(static_cast<int>(PAX_OK), freshFile.setCompression(CODEC_LZ));
+            freshFile.setChecksum();
+            pax_stringstream freshStream;
+            Assert::AreEqual(static_cast<int>(PAX_OK), freshFile.writeHeader(freshStream));
+            string freshHeader = freshStream.str();
+            paxBufPtr freshBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), freshFile.writeToBuffer(freshBuf));
+            Assert::AreEqual(freshHeader.length() + freshFile.getPayloadLength(), static_cast<uint64_t>(freshBuf->size()));
+            Assert::AreEqual(0, memcmp(freshBuf->data(), freshHeader.data(), freshHeader.length()));
+
+            // an empty raster round-trips with and without compression
+            for (paxCodec_e codec : { CODEC_NONE, CODEC_SHUFFLE_LZ }) {
+                floatRasterFile emptyFile{ 0, 0, nullptr };
+                Assert::AreEqual(static_cast<int>(PAX_OK), emptyFile.setCompression(codec));
+                paxBufPtr emptyBuf;
+                Assert::AreEqual(static_cast<int>(PAX_OK), emptyFile.writeToBuffer(emptyBuf));
+                floatRasterFile emptyIn;
+                Assert::AreEqual(static_cast<int>(PAX_OK), emptyIn.import(emptyBuf));
+                Assert::AreEqual(static_cast<uint64_t>(0), emptyIn.datalen());
+            }
+        }
+
+		TEST_METHOD(payloadChecksum)
+		{
+            Logger::WriteMessage("Starting payloadChecksum");
+
+            // the standard check value, in hardware and in software, chained and fused with a copy
+            const string check{ "123456789" };
+            Assert::AreEqual(0xE3069283u,   PaxChecksum::crc32c(check.data(), check.size()));
+            Assert::AreEqual(0xE3069283u,   PaxChecksum::crc32cPortable(check.data(), check.size()));
+            Assert::AreEqual(0xE3069283u,   PaxChecksum::crc32c(check.data() + 4, 5, PaxChecksum::crc32c(check.data(), 4)));
+            vector<char> bytes(100000);
+            mt19937 gen{ 18 };
+            for (auto & c : bytes) {
+                c = static_cast<char>(gen());
+            }
+            vector<char> copied(bytes.size());
+            uint32_t crc = PaxChecksum::crc32cCopy(copied.data(), bytes.data(), bytes.size());
+            Assert::AreEqual(PaxChecksum::crc32cPortable(bytes.data() + 3, bytes.size() - 3, PaxChecksum::crc32cPortable(bytes.data(), 3)), crc);
+            Assert::IsTrue(bytes == copied);
+
+            // a plain payload is verified as it is copied
+            const uint64_t seq = 12, rows = 10;
+            vector<float> floatData(seq * rows);
+            iota(floatData.begin(), floatData.end(), 0.0f);
+            floatRasterFile floatFile{ seq, rows, static_cast<void*>(floatData.data()) };
+            floatFile.setChecksum();
+            paxBufPtr plainBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(plainBuf));
+            string header(plainBuf->data(), plainBuf->size() - floatFile.getPayloadLength());
+            Assert::IsTrue(string::npos != header.find("CHECKSUM : CRC32C " + PaxChecksum::toString(PaxChecksum::crc32c(reinterpret_cast<char*>(floatData.data()), floatFile.datalen()))));
+            floatRasterFile floatIn;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatIn.import(plainBuf));
+            Assert::IsTrue(floatIn.hasChecksum());
+            plainBuf->data()[header.length() + 17] ^= 1;
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), floatIn.import(plainBuf));
+
+            // a damaged tile is pinned down, and the others still read
+            string tiledName{ "checkedFile.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.setTiling(4, 4));
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToFile(tiledName));
+            Assert::AreEqual(static_cast<size_t>(9), floatFile.getBlockChecksums().size());
+            {
+                // tile (2, 1) holds element (8, 4) first
+                FILE * file = fopen(tiledName.c_str(), "r+b");
+                Assert::IsNotNull(file);
+                fseek(file, 0, SEEK_END);
+                long payload = ftell(file) - static_cast<long>(floatFile.getPayloadLength());
+                fseek(file, payload + static_cast<long>(5 * 16 * sizeof(float)), SEEK_SET);
+                fputc(0x7f, file);
+                fclose(file);
+            }
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatIn.readTile(tiledName, 1, 1));
+            Assert::AreEqual(floatData[4 * seq + 4], floatIn.floatValXY(0, 0));
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatIn.readRegion(tiledName, 0, 0, 8, 10));
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), floatIn.readTile(tiledName, 2, 1));
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), floatIn.readRegion(tiledName, 6, 3, 3, 3));
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), floatIn.import(tiledName));
+            Assert::IsTrue(string::npos != PaxStatic::getLastError().find("block(s) 5"));
+            remove(tiledName.c_str());
+
+            // tiles of an N-D raster run down all its rows
+            vector<float> cubeData(4 * 4 * 3);
+            iota(cubeData.begin(), cubeData.end(), 0.0f);
+            floatRasterFile cube{ vector<uint64_t>{ 4, 4, 3 }, cubeData.data(), nullptr };
+            Assert::AreEqual(static_cast<int>(PAX_OK), cube.setTiling(2, 2));
+            cube.setChecksum(true);
+            paxBufPtr cubeBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), cube.writeToBuffer(cubeBuf));
+            Assert::AreEqual(static_cast<size_t>(12), cube.getBlockChecksums().size());
+            floatRasterFile cubeIn;
+            Assert::AreEqual(static_cast<int>(PAX_OK), cubeIn.import(cubeBuf));
+            Assert::AreEqual(0, memcmp(cubeData.data(), cubeIn.buf(), cubeIn.datalen()));
+
+            // compressed blocks are checked before they are decompressed
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.setCompression(CODEC_LZ, 128));
+            paxBufPtr packedBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(packedBuf));
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatIn.import(packedBuf));
+            Assert::AreEqual(0, memcmp(floatData.data(), floatIn.buf(), floatIn.datalen()));
+            packedBuf->data()[packedBuf->size() - 1] ^= 1;
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), floatIn.import(packedBuf));
+
+            // a corrupt block count is rejected before any checksum is read, and a short list is caught
+            string packed(packedBuf->data(), packedBuf->size());
+            size_t countPos = packed.find("BLOCK_CHECKSUMS : ") + strlen("BLOCK_CHECKSUMS : ");
+            size_t countEnd = packed.find('\n', countPos);
+            string badCount = packed;
+            badCount.replace(countPos, countEnd - countPos, "900000000000");
+            paxBufPtr badBuf = make_shared<paxBuf_t>(badCount.size());
+            memcpy(badBuf->data(), badCount.data(), badCount.size());
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), floatIn.import(badBuf));
+            Assert::IsTrue(string::npos != PaxStatic::getLastError().find("900000000000 block checksums"));
+            string shortList = packed;
+            size_t listEnd = shortList.find("\nDATA_LENGTH");
+            size_t lastCrc = shortList.rfind(' ', listEnd);
+            shortList.erase(lastCrc, listEnd - lastCrc);
+            badBuf = make_shared<paxBuf_t>(shortList.size());
+            memcpy(badBuf->data(), shortList.data(), shortList.size());
+            Assert::AreNotEqual(static_cast<int>(PAX_OK), floatIn.import(badBuf));
+            Assert::IsTrue(string::npos != PaxStatic::getLastError().find("within"));
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(typeConversion)
+		{
+            Logger::WriteMessage("Starting typeConversion");
+
+            // floats to bytes saturate, truncating or rounding; NaN becomes 0
+            vector<float> floatData{ -3.0f, 0.4f, 1.5f, 2.5f, 254.6f, 300.0f, nanf(""), 1e10f, 7.0f, 8.0f, 9.9f };
+            floatRasterFile floatFile{ static_cast<uint64_t>(floatData.size()), static_cast<void*>(floatData.data()) };
+            ucharRasterFilePtr bytes = floatFile.convert<paxTypes::ePAX_UCHAR>();
+            Assert::IsNotNull(bytes.get());
+            const uint8_t truncated[]{ 0, 0, 1, 2, 254, 255, 0, 255, 7, 8, 9 };
+            Assert::AreEqual(0, memcmp(truncated, bytes->buf(), sizeof(truncated)));
+            paxConvert_t rounding;
+            rounding.round = true;
+            vector<int8_t> chars(floatData.size());
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.convertTo(paxTypes::ePAX_CHAR, chars.data(), rounding));
+            const int8_t rounded[]{ -3, 0, 2, 2, 127, 127, 0, 127, 7, 8, 10 };
+            Assert::AreEqual(0, memcmp(rounded, chars.data(), sizeof(rounded)));
+
+            // scale and offset, and wrapping instead of saturation
+            paxConvert_t affine;
+            affine.scale = 0.5;
+            affine.offset = -1.0;
+            rasterFilePtr<paxTypes::ePAX_DOUBLE> doubles = bytes->convert<paxTypes::ePAX_DOUBLE>(affine);
+            Assert::AreEqual(126.5,         doubles->doubleValXY(5, 0));
+            vector<int32_t> ints{ 70000, -1, 65535, 65536 };
+            vector<uint16_t> shorts(ints.size());
+            paxConvert_t wrapping;
+            wrapping.saturate = false;
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxConvert::convert(paxTypes::ePAX_INT, ints.data(), paxTypes::ePAX_USHORT, shorts.data(), ints.size(), wrapping));
+            Assert::AreEqual(static_cast<uint16_t>(70000 - 65536), shorts[0]);
+            Assert::AreEqual(static_cast<uint16_t>(65535), shorts[1]);
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxConvert::convert(paxTypes::ePAX_INT, ints.data(), paxTypes::ePAX_USHORT, shorts.data(), ints.size()));
+            Assert::AreEqual(static_cast<uint16_t>(0), shorts[1]);
+            Assert::AreEqual(static_cast<uint16_t>(65535), shorts[3]);
+
+            // 64-bit integers convert exactly
+            vector<int64_t> longs{ INT64_MAX, -2, 1 };
+            vector<uint64_t> ulongs(longs.size());
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxConvert::convert(paxTypes::ePAX_LONG, longs.data(), paxTypes::ePAX_ULONG, ulongs.data(), longs.size()));
+            Assert::AreEqual(static_cast<uint64_t>(INT64_MAX), ulongs[0]);
+            Assert::AreEqual(static_cast<uint64_t>(0), ulongs[1]);
+
+            // half precision rounds to nearest even and keeps every half exactly
+            Assert::AreEqual(static_cast<uint16_t>(0x3c00), PaxConvert::floatToHalf(1.0f).bits);
+            Assert::AreEqual(static_cast<uint16_t>(0x3c00), PaxConvert::floatToHalf(1.0f + 1.0f / 2048).bits);
+            Assert::AreEqual(static_cast<uint16_t>(0x7c00), PaxConvert::floatToHalf(65520.0f).bits);
+            Assert::AreEqual(static_cast<uint16_t>(0x0001), PaxConvert::floatToHalf(5.97e-8f).bits);
+            for (uint32_t h = 0; h < 0x7c00; ++h) {
+                paxHalf_t half{ static_cast<uint16_t>(h) };
+                Assert::AreEqual(half.bits, PaxConvert::floatToHalf(PaxConvert::halfToFloat(half)).bits);
+            }
+
+            // complex rasters convert value by value; the values per element must match
+            vector<int16_t> iq{ 1, -2, 300, -400 };
+            rasterFile<paxTypes::ePAX_SF_COMPLEX_SHORT> iqFile{ 2, static_cast<void*>(iq.data()) };
+            vector<float> iqFloat(iq.size());
+            Assert::AreEqual(static_cast<int>(PAX_OK), rasterFileBase::convert(&iqFile, paxTypes::ePAX_SF_COMPLEX_SINGLE, iqFloat.data()));
+            Assert::AreEqual(-400.0f,       iqFloat[3]);
+            Assert::AreEqual(static_cast<int>(PAX_INVALID), iqFile.convertTo(paxTypes::ePAX_FLOAT, iqFloat.data()));
+
+            // whole rasters of any type, long enough for the vector kernels and the thread pool
+            vector<uint16_t> ramp(200000);
+            for (size_t i = 0; i < ramp.size(); ++i) {
+                ramp[i] = static_cast<uint16_t>(i * 7);
+            }
+            rasterFileBasePtr rampFile = std::make_shared<rasterFile<paxTypes::ePAX_USHORT>>(static_cast<uint64_t>(ramp.size()), static_cast<void*>(ramp.data()));
+            std::shared_ptr<float> rampFloat = rasterFileBase::getFloatData(rampFile.get());
+            for (size_t i = 0; i < ramp.size(); i += 997) {
+                Assert::AreEqual(static_cast<float>(ramp[i]), rampFloat.get()[i]);
+            }
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(halfRaster)
+		{
+            Logger::WriteMessage("Starting halfRaster");
+
+            // half rasters are set and read through the typed accessors
+            const uint64_t seq = 40, rows = 30;
+            halfRasterFile halfFile{ seq, rows };
+            for (uint64_t y = 0; y < rows; ++y) {
+                for (uint64_t x = 0; x < seq; ++x) {
+                    halfFile.halfValXY(x, y) = paxHalf_t::fromFloat(static_cast<float>(x) - 0.25f * static_cast<float>(y));
+                }
+            }
+            Assert::AreEqual(-2.5f,         halfFile.halfValRC(10, 0).toFloat());
+            Assert::AreEqual(static_cast<uint16_t>(0x3c00), halfFile.halfValAt({ 1, 0 }).bits);
+            Assert::IsTrue(PaxTypeOf<paxHalf_t, 1>::value == paxTypes::ePAX_HALF);
+
+            // bulk conversion matches the value by value one, NaN included
+            vector<paxHalf_t> halves(65536);
+            for (size_t h = 0; h < halves.size(); ++h) {
+                halves[h].bits = static_cast<uint16_t>(h);
+            }
+            vector<float> floats(halves.size());
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxConvert::halfToFloat(halves.data(), floats.data(), floats.size()));
+            vector<paxHalf_t> back(halves.size());
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxConvert::floatToHalf(floats.data(), back.data(), back.size()));
+            for (size_t h = 0; h < halves.size(); ++h) {
+                const float f = PaxConvert::halfToFloat(halves[h]);
+                Assert::AreEqual(0, memcmp(&f, &floats[h], sizeof(f)));
+                Assert::AreEqual(PaxConvert::floatToHalf(floats[h]).bits, back[h].bits);
+            }
+
+            // a half file reads straight into a float raster, plain or tiled and compressed
+            string halfName{ "halfFile.pax" };
+            halfFile.setChecksum();
+            halfFile.addMetaVal("scale", 0.25f);
+            Assert::AreEqual(static_cast<int>(PAX_OK), halfFile.writeToFile(halfName));
+            floatRasterFile floatIn;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatIn.importConverted(halfName));
+            Assert::AreEqual(seq,           floatIn.getNumSequential());
+            Assert::AreEqual(rows,          floatIn.getNumStrided());
+            Assert::AreEqual(32.25f,        floatIn.floatValXY(39, 27));
+            Assert::AreEqual(0.25f,         floatIn.getMetaFloat("scale"));
+            Assert::AreEqual(static_cast<int>(PAX_OK), halfFile.setTiling(16, 16));
+            Assert::AreEqual(static_cast<int>(PAX_OK), halfFile.setCompression(CODEC_LZ));
+            Assert::AreEqual(static_cast<int>(PAX_OK), halfFile.writeToFile(halfName));
+            paxConvert_t scaled;
+            scaled.scale = 4.0;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatIn.importConverted(halfName, scaled));
+            Assert::AreEqual(129.0f,        floatIn.floatValXY(39, 27));
+            float3RasterFile float3In;
+            Assert::AreEqual(static_cast<int>(PAX_INVALID), float3In.importConverted(halfName));
+            remove(halfName.c_str());
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(bufferAllocation)
+		{
+            Logger::WriteMessage("Starting bufferAllocation");
+
+            // storage is aligned for SIMD, and survives growth, copies and moves
+            paxBuf_t buf(1000);
+            Assert::AreEqual(static_cast<uintptr_t>(0), reinterpret_cast<uintptr_t>(buf.data()) % PAX_ALIGNMENT);
+            iota(buf.data(), buf.data() + buf.size(), static_cast<char>(0));
+            paxBuf_t tail(24);
+            memset(tail.data(), 'x', tail.size());
+            buf.appendVector(tail);
+            Assert::AreEqual(static_cast<uint64_t>(1024), buf.size());
+            Assert::AreEqual(static_cast<char>(999 % 256), buf.data()[999]);
+            Assert::AreEqual('x', buf.data()[1023]);
+            paxBuf_t copy(buf);
+            paxBuf_t moved(std::move(copy));
+            Assert::AreEqual(0, memcmp(buf.data(), moved.data(), 1024));
+            Assert::AreEqual(static_cast<uint64_t>(0), copy.size());
+
+            // size classes are a quarter of a power of two apart
+            Assert::AreEqual(PAX_ALIGNMENT, PaxBufferPool::sizeClass(1));
+            Assert::AreEqual(static_cast<uint64_t>(512), PaxBufferPool::sizeClass(512));
+            Assert::AreEqual(static_cast<uint64_t>(640), PaxBufferPool::sizeClass(513));
+            Assert::AreEqual(static_cast<uint64_t>(5) << 20, PaxBufferPool::sizeClass((4 << 20) + 1));
+
+            // a pool hands released buffers back out for the same size class
+            PaxBufferPool pool;
+            char * first = NULL;
+            {
+                paxBuf_t pooled(100000, pool);
+                first = pooled.data();
+            }
+            Assert::AreEqual(PaxBufferPool::sizeClass(100000), pool.getRetained());
+            {
+                paxBuf_t pooled(99000, pool);
+                Assert::IsTrue(first == pooled.data());
+            }
+            Assert::AreEqual(static_cast<uint64_t>(1), pool.getReused());
+
+            // installed as the default, it serves repeated imports of same-sized rasters
+            vector<float> floatData(64 * 64, 1.5f);
+            floatRasterFile floatFile{ 64, 64, static_cast<void*>(floatData.data()) };
+            paxBufPtr fileBuf;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToBuffer(fileBuf));
+            PaxAllocator::setDefault(&pool);
+            for (int i = 0; i < 3; ++i) {
+                floatRasterFile floatIn;
+                Assert::AreEqual(static_cast<int>(PAX_OK), floatIn.import(fileBuf));
+                Assert::AreEqual(1.5f,      floatIn.floatValXY(63, 63));
+            }
+            PaxAllocator::setDefault(NULL);
+            Assert::IsTrue(pool.getReused() >= 3);
+            pool.trim();
+            Assert::AreEqual(static_cast<uint64_t>(0), pool.getRetained());
+
+            // huge pages back large buffers when asked, or the heap does
+            PaxAllocator::setHugePages(PAX_HUGE_PAGE);
+            {
+                paxBuf_t large(3 * PAX_HUGE_PAGE + 5);
+                Assert::AreEqual(static_cast<uintptr_t>(0), reinterpret_cast<uintptr_t>(large.data()) % PAX_ALIGNMENT);
+                memset(large.data(), 7, large.size());
+                Assert::AreEqual(static_cast<char>(7), large.data()[large.size() - 1]);
+            }
+            PaxAllocator::setHugePages(0);
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(adoptedBuffers)
+		{
+            Logger::WriteMessage("Starting adoptedBuffers");
+
+            // a view wraps the caller's frame in place, for reading, writing and output
+            vector<float> frame(16 * 8);
+            iota(frame.begin(), frame.end(), 0.0f);
+            floatRasterFile view{ { 16, 8 }, frame.data(), nullptr };
+            Assert::IsTrue(reinterpret_cast<char*>(frame.data()) == view.buf());
+            view.floatValXY(3, 2) = -1.0f;
+            Assert::AreEqual(-1.0f,         frame[2 * 16 + 3]);
+            string viewName{ "viewFile.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), view.writeToFile(viewName));
+            floatRasterFile floatIn;
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatIn.import(viewName));
+            Assert::AreEqual(0, memcmp(frame.data(), floatIn.buf(), floatIn.datalen()));
+            remove(viewName.c_str());
+
+            // an adopted buffer is freed by its deleter once nothing shares it
+            bool freed = false;
+            float * owned = new float[4 * 4]();
+            floatRasterFilePtr copy;
+            {
+                floatRasterFile adopted{ { 4, 4 }, owned, [&freed](void * p) { delete[] static_cast<float*>(p); freed = true; } };
+                Assert::AreEqual(0.0f,      adopted.floatValXY(3, 3));
+                copy = make_shared<floatRasterFile>(adopted);
+            }
+            Assert::IsFalse(freed);
+            Assert::IsTrue(reinterpret_cast<char*>(owned) == copy->buf());
+            copy = nullptr;
+            Assert::IsTrue(freed);
+
+            // shared ownership keeps the frame's owner alive
+            auto shared = make_shared<vector<uint16_t>>(8 * 8, static_cast<uint16_t>(7));
+            {
+                rasterFile<paxTypes::ePAX_USHORT> sharing{ { 8, 8 }, shared->data(), shared };
+                Assert::AreEqual(2L,        shared.use_count());
+                Assert::AreEqual(static_cast<uint16_t>(7), sharing.ushortValRC(7, 7));
+            }
+            Assert::AreEqual(1L,            shared.use_count());
+
+            // there is nothing to adopt in a NULL buffer
+            floatRasterFile empty;
+            Assert::AreEqual(static_cast<int>(PAX_INVALID), empty.adopt({ 4, 4 }, NULL));
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(batchWriter)
+		{
+            Logger::WriteMessage("Starting batchWriter");
+
+            // many frames, one tiled and one compressed, in batches small enough to need several writes
+            const size_t frames = 40;
+            vector<vector<float>> frameData(frames, vector<float>(32 * 16));
+            vector<floatRasterFilePtr> files;
+            vector<rasterFileBase*> rasters;
+            for (size_t n = 0; n < frames; ++n) {
+                iota(frameData[n].begin(), frameData[n].end(), static_cast<float>(n));
+                files.push_back(make_shared<floatRasterFile>(vector<uint64_t>{ 32, 16 }, frameData[n].data(), nullptr));
+                files[n]->addMetaVal("frame", static_cast<int32_t>(n));
+                rasters.push_back(files[n].get());
+            }
+            Assert::AreEqual(static_cast<int>(PAX_OK), files[3]->setTiling(8, 8));
+            Assert::AreEqual(static_cast<int>(PAX_OK), files[5]->setCompression(CODEC_LZ));
+
+            string batchName{ "batchFile.pax" };
+            for (paxIoBackend_e backend : { IO_WRITEV, IO_AUTO }) {
+                PaxBatchWriter writer(backend, 4096);
+                Assert::AreEqual(static_cast<int>(PAX_OK), writer.open(batchName));
+                for (rasterFileBase * raster : rasters) {
+                    Assert::AreEqual(static_cast<int>(PAX_OK), writer.add(*raster));
+                }
+                Assert::AreEqual(frames, writer.size());
+                Assert::AreEqual(static_cast<int>(PAX_OK), writer.close());
+
+                // the same bytes writeMultiple lays out in memory
+                paxBufPtr multiBuf = rasterFileBase::writeMultiple(rasters);
+                PaxMap mapped;
+                Assert::AreEqual(static_cast<int>(PAX_OK), mapped.map(batchName));
+                Assert::AreEqual(static_cast<uint64_t>(multiBuf->size()), writer.getLength());
+                Assert::AreEqual(static_cast<uint64_t>(multiBuf->size()), mapped.size());
+                Assert::AreEqual(0, memcmp(multiBuf->data(), mapped.data(), multiBuf->size()));
+            }
+            remove(batchName.c_str());
+
+            // a bundle on whichever backend is available
+            string bundleName{ "batchBundle.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), PaxBundle::writeFile(rasters, bundleName, IO_URING));
+            PaxBundle bundle;
+            Assert::AreEqual(static_cast<int>(PAX_OK), bundle.open(bundleName));
+            vector<rasterFileBasePtr> all = bundle.loadAll();
+            Assert::AreEqual(frames, all.size());
+            for (size_t n = 0; n < frames; ++n) {
+                auto floatIn = dynamic_pointer_cast<floatRasterFile>(all[n]);
+                Assert::IsTrue(nullptr != floatIn);
+                Assert::AreEqual(static_cast<int32_t>(n), floatIn->getMetaInt32("frame"));
+                Assert::AreEqual(0, memcmp(frameData[n].data(), floatIn->buf(), floatIn->datalen()));
+            }
+            remove(bundleName.c_str());
+
+            // nothing is added before the file is open
+            PaxBatchWriter closed;
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), closed.add(*rasters[0]));
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(previewHeader)
+		{
+            Logger::WriteMessage("Starting previewHeader");
+
+            // a header several chunks long, on a payload that must not be read
+            vector<float> floatData(64 * 32, 1.0f);
+            floatRasterFile floatFile{ 64, 32, static_cast<void*>(floatData.data()) };
+            for (int32_t n = 0; n < 4000; ++n) {
+                floatFile.addMetaVal("frame_" + to_string(n), n);
+            }
+            string previewName{ "previewFile.pax" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToFile(previewName));
+
+            floatRasterFile previewFile;
+            Assert::AreEqual(static_cast<int>(PAX_OK), previewFile.preview(previewName));
+            Assert::AreEqual(static_cast<uint64_t>(64), previewFile.getNumSequential());
+            Assert::AreEqual(static_cast<uint64_t>(32), previewFile.getNumStrided());
+            Assert::AreEqual(floatFile.datalen(), previewFile.datalen());
+            remove(previewName.c_str());
+
+            // the DATA_LENGTH line is found across a chunk boundary
+            const char * header = "x\nDATA_LENGTH : 4\n";
+            Assert::IsFalse(rasterFileBase::findDataLength(header, 0, 8));
+            Assert::IsFalse(rasterFileBase::findDataLength(header, 8, 17));
+            Assert::IsTrue(rasterFileBase::findDataLength(header, 17, 18));
+
+            // an empty file has no header
+            string emptyName{ "emptyFile.pax" };
+            fclose(fopen(emptyName.c_str(), "wb"));
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), previewFile.preview(emptyName));
+            remove(emptyName.c_str());
+
+            // neither does a file without a PAX tag, however long
+            string junkName{ "junkFile.pax" };
+            paxBufPtr junk = make_shared<paxBuf_t>(1 << 20);
+            memset(junk->data(), 'x', junk->size());
+            Assert::AreEqual(static_cast<int>(PAX_OK), rasterFileBase::writeToFile(junk, junkName));
+            Assert::AreEqual(static_cast<int>(PAX_FAIL), previewFile.preview(junkName));
+            remove(junkName.c_str());
+            PaxStatic::setStatus(PAX_OK);
+        }
+
+		TEST_METHOD(headerCatalog)
+		{
+            Logger::WriteMessage("Starting headerCatalog");
+
+            // a directory of frames, with a subdirectory, a stray file and a file that is not PAX
+            string dir{ "catalogDir" };
+            filesystem::remove_all(dir);
+            filesystem::create_directories(dir + "/night");
+            vector<float> floatData(8 * 4, 1.0f);
+            for (int32_t n = 0; n < 10; ++n) {
+                floatRasterFile floatFile{ 8, 4, static_cast<void*>(floatData.data()) };
+                floatFile.addMetaVal("frame", n);
+                floatFile.addMetaVal("exposure", 0.1f * n);
+                floatFile.addMetaVal("camera", string(n % 2 ? "left" : "right"));
+                floatFile.addMeta("bias", meta_t{ paxMetaDataTypes::paxFloat, { 2 }, floatData.data() });
+                Assert::AreEqual(static_cast<int>(PAX_OK), floatFile.writeToFile(dir + (n < 5 ? "/" : "/night/") + "frame" + to_string(n) + ".pax"));
+            }
+            fclose(fopen((dir + "/notes.txt").c_str(), "wb"));
+            FILE * junk = fopen((dir + "/junk.pax").c_str(), "wb");
+            fputs("not a raster\n", junk);
+            fclose(junk);
+
+            PaxCatalog catalog;
+            Assert::AreEqual(static_cast<int>(PAX_OK), catalog.scan(dir));
+            Assert::AreEqual(static_cast<size_t>(10), catalog.size());
+            Assert::AreEqual(static_cast<size_t>(10), catalog.getRead());
+            const paxCatalogEntry_t & first = catalog.entry(0);
+            Assert::IsTrue(paxTypes::ePAX_FLOAT == first.type);
+            Assert::AreEqual(static_cast<uint64_t>(8 * 4 * sizeof(float)), first.dataLength);
+            Assert::AreEqual(first.size, first.headerLength + first.dataLength);
+            Assert::AreEqual(static_cast<size_t>(1), first.skipped.size());
+            Assert::AreEqual(string("bias"), first.skipped[0]);
+
+            // range and value queries
+            vector<size_t> bright = catalog.find("exposure", 0.25, 0.55);
+            Assert::AreEqual(static_cast<size_t>(3), bright.size());
+            for (size_t n : bright) {
+                Assert::IsTrue(catalog.entry(n).meta.at("frame").number >= 3 && catalog.entry(n).meta.at("frame").number <= 5);
+            }
+            Assert::AreEqual(static_cast<size_t>(5), catalog.find("camera", string("left")).size());
+            Assert::AreEqual(static_cast<size_t>(0), catalog.find("gain", 0.0, 1.0).size());
+
+            // the saved catalog answers the same
+            string catalogName{ "catalog.txt" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), catalog.save(catalogName));
+            PaxCatalog loaded;
+            Assert::AreEqual(static_cast<int>(PAX_OK), loaded.load(catalogName));
+            Assert::AreEqual(catalog.size(), loaded.size());
+            Assert::IsTrue(bright == loaded.find("exposure", 0.25, 0.55));
+            Assert::AreEqual(catalog.entry(7).path, loaded.entry(7).path);
+            Assert::AreEqual(catalog.entry(7).mtime, loaded.entry(7).mtime);
+            Assert::IsTrue(catalog.entry(7).skipped == loaded.entry(7).skipped);
+            Assert::AreEqual(catalog.entry(7).meta.at("exposure").number, loaded.entry(7).meta.at("exposure").number);
+
+            // a numeric value that does not parse makes the catalog malformed
+            paxBufPtr saved = rasterFileBase::readFile(catalogName);
+            string text(saved->data(), saved->size());
+            text.replace(text.find("5 frame 1 3"), 11, "5 frame 1 x");
+            paxBufPtr edited = make_shared<paxBuf_t>(text.size());
+            memcpy(edited->data(), text.data(), text.size());
+            string editedName{ "editedCatalog.txt" };
+            Assert::AreEqual(static_cast<int>(PAX_OK), rasterFileBase::writeToFile(edited, editedName));
+            PaxCatalog malformed;
+            Assert::AreEqual(static_cast<int>(PAX_INVALID), malformed.load(editedName));
+            remove(editedName.c_str());
+
+            // a rescan reads only what changed
+            Assert::AreEqual(static_cast<int>(PAX_OK), loaded.scan(dir));
+            Assert::AreEqual(static_cast<size_t>(0), loaded.getRead());
+            floatRasterFile changed{ 8, 4, static_cast<void*>(floatData.data()) };
+            changed.addMetaVal("frame", 42);
+            changed.addMetaVal("gain", 2.0);
+            Assert::AreEqual(static_cast<int>(PAX_OK), changed.writeToFile(dir + "/frame1.pax"));
+            filesystem::remove(dir + "/night/frame9.pax");
+            Assert::AreEqual(static_cast<int>(PAX_OK), loaded.scan(dir));
+            Assert::AreEqual(static_cast<size_t>(1), loaded.getRead());
+            Assert::AreEqual(static_cast<size_t>(9), loaded.size());
+            Assert::AreEqual(static_cast<size_t>(1), loaded.find("gain", 2.0, 2.0).size());
+            Assert::AreEqual(static_cast<size_t>(0), loaded.find("frame", 9.0, 9.0).size());
+
+            // not a catalog
+            Assert::AreEqual(static_cast<int>(PAX_INVALID), loaded.load(dir + "/junk.pax"));
+            remove(catalogName.c_str());
+            filesystem::remove_all(dir);
+            PaxStatic::setStatus(PAX_OK);
+        }
 	};
 }